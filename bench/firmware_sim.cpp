@@ -0,0 +1,386 @@
+/**
+ * @file firmware_sim.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Whole firmware, setup() and loop() of the sketch, run on the virtual clock against the
+ *        emulated modem and GNSS of host/, built by the native_sim environment
+ *        pio run -e native_sim && .pio/build/native_sim/program [-t hours] [-s seed] [-v] [-e]
+ *                                  [-d downlink %] [-g no fix %] [-b minutes] [-l loop us] [-c file]
+ *        -t  virtual hours to run, 24 by default
+ *        -s  seed of the modem and the GNSS, a run is repeated exactly with the same seed
+ *        -v  console output of the firmware on stdout
+ *        -e  log of the modem emulator on stderr, one line per command and event
+ *        -d  uplinks answered by a downlink, 10 % by default, without them the firmware
+ *            reconnects every NOT_CONN_LIMIT_BEF_RESTART seconds
+ *        -g  seconds without a GNSS fix, 0 % by default
+ *        -b  button pressed every that many minutes, it cycles the sidewalk modes, never by default
+ *        -l  virtual time of one loop() besides its own delays, 1000 us by default
+ *        -c  capture of the mcm and gnss traffic written to the file at the end, the last
+ *            UART_CAPTURE_BUFFER_SIZE bytes of records, for the native_replay environment
+ *        The schedule of the sketch is set with build flags, e.g. -DCSS_UPLINK_INTERVAL_SECONDS=30,
+ *        so a schedule change is compared on the same seed. The run prints the uplinks and the
+ *        time on air of every hour, then the totals and a hash of the console output: two runs
+ *        with the same seed and the same build print the same hash.
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "gnss_emulator.h"
+#include "lrwan_sidewalk_ex.h"
+#include "mcm_emulator.h"
+#include "mcm_rover.h"
+#include "uart_capture.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+extern HardwareSerial GPS_Serial;
+extern MCM mcm;
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define SIM_DEFAULT_HOURS 24
+#define SIM_DEFAULT_DOWNLINK_PCT 10
+#define SIM_DEFAULT_LOOP_US 1000
+#define SIM_GNSS_RESET_PIN 18         // GNSS_RESET_PIN of gnss.cpp
+#define SIM_BUTTON_PRESS_MS 100
+#define SIM_US_PER_HOUR (3600ULL * 1000000ULL)
+
+#define SIM_FNV_OFFSET 2166136261u
+#define SIM_FNV_PRIME 16777619u
+#define SIM_POINTER_DIGITS 12         // hex digits of a user space address of x86_64, a value of the firmware is shorter
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static HardwareSerial modem_port(3);
+static HardwareSerial gnss_port(4);
+static McmEmulator emulator(modem_port);
+static GnssEmulator gnss(gnss_port);
+
+static bool is_console_echo = false;
+static uint32_t console_hash = SIM_FNV_OFFSET;
+static uint64_t console_bytes = 0;
+static uint32_t restart_count = 0;
+static uint32_t button_period_min = 0;
+static uint32_t button_presses = 0;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void hash_byte(uint8_t data)
+{
+    console_hash = (console_hash ^ data) * SIM_FNV_PRIME;
+}
+
+/**
+ * @brief Hashes a byte of the console, a pointer printed with %p is hashed as "0xp"
+ *
+ * The addresses of the stack change with every run, the logs of mcm_rover.cpp print some.
+ */
+static void hash_console_byte(uint8_t data)
+{
+    static char hex[SIM_POINTER_DIGITS];
+    static size_t hex_len = 0;
+    static bool is_hex = false;
+
+    if (is_hex && isxdigit(data))
+    {
+        if (hex_len < sizeof(hex))
+        {
+            hex[hex_len++] = (char)data;
+        }
+        return;
+    }
+    if (is_hex)
+    {
+        if (hex_len < sizeof(hex))
+        {
+            for (size_t i = 0; i < hex_len; i++)
+            {
+                hash_byte(hex[i]);
+            }
+        }
+        else
+        {
+            hash_byte('p');
+        }
+        is_hex = false;
+    }
+    hash_byte(data);
+
+    static uint8_t last = 0;
+    if (('0' == last) && ('x' == data))
+    {
+        is_hex = true;
+        hex_len = 0;
+    }
+    last = data;
+}
+
+/**
+ * @brief Write function of the console stream, hashes what the firmware prints
+ */
+static ssize_t console_write(void *cookie, const char *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash_console_byte((uint8_t)buffer[i]);
+    }
+    console_bytes += size;
+    if (is_console_echo)
+    {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return (ssize_t)size;
+}
+
+static void on_restart()
+{
+    // the sketch has no state to carry over a reboot but the nvs, the run goes on
+    restart_count++;
+}
+
+/**
+ * @brief Reset lines of the modem and the GNSS follow the pins of the sketch
+ */
+static void on_gpio_write(uint8_t pin, uint8_t level)
+{
+    if (RESET_PIN == pin)
+    {
+        emulator.set_reset_line(level);
+    }
+    else if (SIM_GNSS_RESET_PIN == pin)
+    {
+        gnss.set_reset_line(level);
+    }
+}
+
+/**
+ * @brief Presses the button of the board every button_period_min minutes
+ */
+static void button_task(void *ctx)
+{
+    for (;;)
+    {
+        host_os_sleep_us(button_period_min * 60ULL * 1000000ULL);
+        host_gpio_set_input(BUTTON_PIN, LOW);
+        host_os_sleep_us(SIM_BUTTON_PRESS_MS * 1000ULL);
+        host_gpio_set_input(BUTTON_PIN, HIGH);
+        button_presses++;
+    }
+}
+
+static double wall_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static bool save_capture(const char *p_path)
+{
+    uint8_t buffer[UART_CAPTURE_BUFFER_SIZE];
+    uint32_t offset = 0;
+    uint32_t read_size;
+
+    FILE *file = fopen(p_path, "wb");
+    if (NULL == file)
+    {
+        return false;
+    }
+    uart_capture_start(0);
+    while ((read_size = uart_capture_read_file(offset, buffer, sizeof(buffer))) > 0)
+    {
+        fwrite(buffer, 1, read_size, file);
+        offset += read_size;
+    }
+    return (0 == fclose(file));
+}
+
+static void print_hour(uint32_t hour, const mcm_emulator_stats_t *p_stats, const mcm_emulator_stats_t *p_last)
+{
+    uint64_t airtime_us = p_stats->airtime_us - p_last->airtime_us;
+
+    printf("%5u %8u %10.3f %7.4f %6u %6u\n", hour, p_stats->uplinks - p_last->uplinks, airtime_us / 1e6,
+           (airtime_us * 100.0) / SIM_US_PER_HOUR, p_stats->joins - p_last->joins,
+           p_stats->resets - p_last->resets);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint32_t hours = SIM_DEFAULT_HOURS;
+    uint32_t seed = 1;
+    bool is_emulator_log = false;
+    uint8_t downlink_pct = SIM_DEFAULT_DOWNLINK_PCT;
+    uint8_t no_fix_pct = 0;
+    uint32_t loop_us = SIM_DEFAULT_LOOP_US;
+    const char *p_capture_path = NULL;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:s:ved:g:b:l:c:")) != -1)
+    {
+        switch (option)
+        {
+        case 't':
+            hours = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'v':
+            is_console_echo = true;
+            break;
+        case 'e':
+            is_emulator_log = true;
+            break;
+        case 'd':
+            downlink_pct = (uint8_t)atoi(optarg);
+            break;
+        case 'g':
+            no_fix_pct = (uint8_t)atoi(optarg);
+            break;
+        case 'b':
+            button_period_min = (uint32_t)atoi(optarg);
+            break;
+        case 'l':
+            loop_us = (uint32_t)atoi(optarg);
+            break;
+        case 'c':
+            p_capture_path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t hours] [-s seed] [-v] [-e] [-d downlink %%] [-g no fix %%] [-b minutes] "
+                            "[-l loop us] [-c file]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (0 == loop_us)
+    {
+        fprintf(stderr, "a loop needs some time, -l above 0\n");
+        return 1;
+    }
+
+    host_os_set_clock(HOST_CLOCK_VIRTUAL);
+    host_os_set_restart_handler(on_restart);
+    cookie_io_functions_t console_functions = {NULL, console_write, NULL, NULL};
+    FILE *console = fopencookie(NULL, "w", console_functions);
+    if (NULL == console)
+    {
+        fprintf(stderr, "unable to open the console stream\n");
+        return 1;
+    }
+    // line buffered, the echo comes in the order of the results
+    setvbuf(console, NULL, _IOLBF, 0);
+    Serial.attach_output(console);
+    host_gpio_set_write_cb(on_gpio_write);
+
+    modem_port.begin(MCM_EMULATOR_BAUD_RATE);
+    modem_port.attach_line(Serial1);
+    mcm_emulator_config_t modem_config = McmEmulator::get_default_config();
+    modem_config.seed = seed;
+    modem_config.downlink_pct = downlink_pct;
+    emulator.set_config(modem_config);
+    emulator.set_log(is_emulator_log ? stderr : NULL);
+
+    gnss_port.begin(GNSS_EMULATOR_BAUD_RATE);
+    gnss_port.attach_line(GPS_Serial);
+    gnss_emulator_config_t gnss_config = GnssEmulator::get_default_config();
+    gnss_config.seed = seed;
+    gnss_config.no_fix_pct = no_fix_pct;
+    gnss.set_config(gnss_config);
+
+    if (!emulator.begin() || !gnss.begin())
+    {
+        fprintf(stderr, "unable to start the emulators\n");
+        return 1;
+    }
+    if ((button_period_min > 0) && (NULL == host_os_task_create(button_task, NULL, "button", 0)))
+    {
+        fprintf(stderr, "unable to start the button task\n");
+        return 1;
+    }
+
+    printf("%u h, seed %u, %u %% downlinks, %u %% no fix, loop %u us, uplink every %u/%u/%u s (css/fsk/ble), "
+           "reconnect after %u s\n\n",
+           hours, seed, downlink_pct, no_fix_pct, loop_us, (unsigned)CSS_UPLINK_INTERVAL_SECONDS,
+           (unsigned)FSK_UPLINK_INTERVAL_SECONDS, (unsigned)BLE_UPLINK_INTERVAL_SECONDS,
+           (unsigned)NOT_CONN_LIMIT_BEF_RESTART);
+    printf("%5s %8s %10s %7s %6s %6s\n", "hour", "uplinks", "airtime s", "duty %", "joins", "resets");
+    fflush(stdout);
+
+    uint64_t end_us = hours * SIM_US_PER_HOUR;
+    uint64_t next_hour_us = SIM_US_PER_HOUR;
+    uint32_t hour = 0;
+    uint64_t loops = 0;
+    mcm_emulator_stats_t last_stats = {};
+    mcm_emulator_stats_t stats;
+    double start_s = wall_seconds();
+
+    setup();
+    if (NULL != p_capture_path)
+    {
+        // setup() starts the streams of UART_CAPTURE_BOOT_MASK
+        uart_capture_start(UART_CAPTURE_MASK_ALL);
+    }
+    while (host_os_micros() < end_us)
+    {
+        loop();
+        loops++;
+        host_os_sleep_us(loop_us);
+
+        if (host_os_micros() >= next_hour_us)
+        {
+            emulator.get_stats(&stats);
+            print_hour(++hour, &stats, &last_stats);
+            last_stats = stats;
+            next_hour_us += SIM_US_PER_HOUR;
+        }
+    }
+    fflush(console);
+
+    double wall_s = wall_seconds() - start_s;
+    double sim_s = host_os_micros() / 1e6;
+    gnss_emulator_stats_t gnss_stats;
+    mcm_downlink_stats_t downlink_stats;
+    emulator.get_stats(&stats);
+    gnss.get_stats(&gnss_stats);
+    mcm.get_downlink_stats(&downlink_stats);
+
+    printf("\n%.0f s of firmware time in %.2f s, %.0fx real time, %llu loops\n", sim_s, wall_s, sim_s / wall_s,
+           (unsigned long long)loops);
+    printf("uplinks %u, %.1f/h, airtime %.3f s, duty %.4f %%\n", stats.uplinks, stats.uplinks / (sim_s / 3600.0),
+           stats.airtime_us / 1e6, (stats.airtime_us * 100.0) / (sim_s * 1e6));
+    printf("joins %u, modem resets %u, restarts %u, button presses %u\n", stats.joins, stats.resets, restart_count,
+           button_presses);
+    printf("downlinks %u received, %u dropped, gnss %u fixes, %u without\n", downlink_stats.received_count,
+           downlink_stats.dropped_count, gnss_stats.fixes, gnss_stats.no_fixes);
+    printf("console %llu B, hash %08x\n", (unsigned long long)console_bytes, console_hash);
+
+    if ((NULL != p_capture_path) && !save_capture(p_capture_path))
+    {
+        fprintf(stderr, "unable to write %s\n", p_capture_path);
+        return 1;
+    }
+
+    return 0;
+}
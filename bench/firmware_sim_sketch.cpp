@@ -0,0 +1,13 @@
+/**
+ * @file firmware_sim_sketch.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Sketch of the firmware built as a C++ source for the native_sim environment, the
+ *        Arduino builder does the same with the .ino of src/
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "lrwan_sidewalk_ex.ino"
@@ -0,0 +1,584 @@
+/**
+ * @file fw_patch_tool.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Makes compressed and delta firmware images for the host update path, built by the native_patch environment
+ *        pio run -e native_patch
+ *        .pio/build/native_patch/program encode <new.bin> <patch.oxp> [running.bin]
+ *        .pio/build/native_patch/program decode <patch.oxp> <new.bin> [running.bin]
+ *        .pio/build/native_patch/program bench <new.bin> [running.bin]
+ *        Without the running image the patch is compressed only, with it the unchanged parts are copied from it.
+ * @version 0.1
+ * @date 2025-01-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "checksum.h"
+#include "fw_patch.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define TOOL_WINDOW_BITS            FW_PATCH_MAX_WINDOW_BITS
+#define TOOL_WINDOW_SIZE            (1UL << TOOL_WINDOW_BITS)
+#define TOOL_HASH_BITS              16
+#define TOOL_MIN_MATCH              4       // bytes hashed to find a match
+#define TOOL_MAX_CHAIN              64      // candidates looked at per position and source
+#define TOOL_NO_POS                 UINT32_MAX
+#define TOOL_BENCH_RUNS             20
+#define TOOL_LINE_BYTES_PER_S       (9600 / 10)
+#define TOOL_YMODEM_EFFICIENCY      (1024.0 / (1024 + 5))
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t *p_data;
+    uint32_t u32_len;
+} tool_buffer_t;
+
+/**
+ * @brief Positions of the 4 byte sequences of a buffer, the newest first
+ */
+typedef struct
+{
+    uint32_t *p_head;
+    uint32_t *p_prev;
+} tool_index_t;
+
+typedef struct
+{
+    uint32_t u32_len;
+    uint32_t u32_arg;       // distance, or zigzag offset from the end of the previous base copy
+    uint8_t u8_op;
+    int32_t i32_gain;       // bytes saved against literals
+} tool_match_t;
+
+typedef struct
+{
+    tool_buffer_t h_out;
+    uint32_t u32_room;
+    uint32_t u32_literal_start;
+    uint32_t u32_literal_len;
+    uint32_t u32_ops[3];
+} tool_encoder_t;
+
+typedef struct
+{
+    const tool_buffer_t *p_base;
+    tool_buffer_t h_image;
+} tool_decoder_t;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint64_t tool_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static bool tool_load(const char *p_path, tool_buffer_t *p_buffer)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    long size;
+
+    if (NULL == p_file)
+    {
+        fprintf(stderr, "cannot open %s\n", p_path);
+        return false;
+    }
+    fseek(p_file, 0, SEEK_END);
+    size = ftell(p_file);
+    fseek(p_file, 0, SEEK_SET);
+    p_buffer->p_data = (uint8_t *)malloc(size ? size : 1);
+    p_buffer->u32_len = (uint32_t)size;
+    if (fread(p_buffer->p_data, 1, size, p_file) != (size_t)size)
+    {
+        fprintf(stderr, "cannot read %s\n", p_path);
+        fclose(p_file);
+        return false;
+    }
+    fclose(p_file);
+    return true;
+}
+
+static bool tool_save(const char *p_path, const tool_buffer_t *p_buffer)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    bool is_saved;
+
+    if (NULL == p_file)
+    {
+        fprintf(stderr, "cannot create %s\n", p_path);
+        return false;
+    }
+    is_saved = (fwrite(p_buffer->p_data, 1, p_buffer->u32_len, p_file) == p_buffer->u32_len);
+    fclose(p_file);
+    return is_saved;
+}
+
+/********************** encoder **********************/
+static uint32_t tool_hash(const uint8_t *p_data)
+{
+    uint32_t u32_word = (uint32_t)p_data[0] | ((uint32_t)p_data[1] << 8) | ((uint32_t)p_data[2] << 16) |
+                        ((uint32_t)p_data[3] << 24);
+    return (u32_word * 2654435761u) >> (32 - TOOL_HASH_BITS);
+}
+
+static void tool_index_init(tool_index_t *p_index, uint32_t u32_len)
+{
+    p_index->p_head = (uint32_t *)malloc(sizeof(uint32_t) << TOOL_HASH_BITS);
+    p_index->p_prev = (uint32_t *)malloc(sizeof(uint32_t) * (u32_len ? u32_len : 1));
+    memset(p_index->p_head, 0xFF, sizeof(uint32_t) << TOOL_HASH_BITS);
+}
+
+static void tool_index_add(tool_index_t *p_index, const tool_buffer_t *p_buffer, uint32_t u32_pos)
+{
+    if ((u32_pos + TOOL_MIN_MATCH) <= p_buffer->u32_len)
+    {
+        uint32_t u32_hash = tool_hash(&p_buffer->p_data[u32_pos]);
+        p_index->p_prev[u32_pos] = p_index->p_head[u32_hash];
+        p_index->p_head[u32_hash] = u32_pos;
+    }
+}
+
+static void tool_index_free(tool_index_t *p_index)
+{
+    free(p_index->p_head);
+    free(p_index->p_prev);
+}
+
+static uint32_t tool_varint_size(uint32_t u32_value)
+{
+    uint32_t u32_size = 1;
+    while (u32_value >= 0x80)
+    {
+        u32_value >>= 7;
+        u32_size++;
+    }
+    return u32_size;
+}
+
+static uint32_t tool_match_len(const uint8_t *p_a, const uint8_t *p_b, uint32_t u32_max)
+{
+    uint32_t u32_len = 0;
+    while ((u32_len < u32_max) && (p_a[u32_len] == p_b[u32_len]))
+    {
+        u32_len++;
+    }
+    return u32_len;
+}
+
+/**
+ * @brief Bytes taken by an operation, without its literal bytes
+ */
+static uint32_t tool_op_cost(uint8_t u8_op, uint32_t u32_len, uint32_t u32_arg)
+{
+    static const uint8_t min_len[] = {FW_PATCH_MIN_LITERAL, FW_PATCH_MIN_WINDOW, FW_PATCH_MIN_BASE};
+    uint32_t u32_extra = u32_len - min_len[u8_op];
+    uint32_t u32_cost = 1 + ((FW_PATCH_OP_LITERAL == u8_op) ? 0 : tool_varint_size(u32_arg));
+
+    if (u32_extra >= FW_PATCH_LEN_EXTENDED)
+    {
+        u32_cost += tool_varint_size(u32_extra - FW_PATCH_LEN_EXTENDED);
+    }
+    return u32_cost;
+}
+
+static void tool_consider(tool_match_t *p_best, uint8_t u8_op, uint32_t u32_len, uint32_t u32_arg)
+{
+    static const uint8_t min_len[] = {FW_PATCH_MIN_LITERAL, FW_PATCH_MIN_WINDOW, FW_PATCH_MIN_BASE};
+    if (u32_len < min_len[u8_op])
+    {
+        return;
+    }
+
+    int32_t i32_gain = (int32_t)u32_len - (int32_t)tool_op_cost(u8_op, u32_len, u32_arg);
+    if (i32_gain > p_best->i32_gain)
+    {
+        p_best->u8_op = u8_op;
+        p_best->u32_len = u32_len;
+        p_best->u32_arg = u32_arg;
+        p_best->i32_gain = i32_gain;
+    }
+}
+
+static uint32_t tool_zigzag(uint32_t u32_offset, uint32_t u32_base_next)
+{
+    int32_t i32_delta = (int32_t)(u32_offset - u32_base_next);
+    return ((uint32_t)i32_delta << 1) ^ (uint32_t)(i32_delta >> 31);
+}
+
+/**
+ * @brief Longest profitable match at a position, in the window or in the running image
+ */
+static tool_match_t tool_find_match(const tool_buffer_t *p_image, const tool_index_t *p_window,
+                                    const tool_buffer_t *p_base, const tool_index_t *p_base_index,
+                                    uint32_t u32_pos, uint32_t u32_base_next)
+{
+    tool_match_t h_best = {0, 0, FW_PATCH_OP_LITERAL, 0};
+    uint32_t u32_max = p_image->u32_len - u32_pos;
+    const uint8_t *p_cur = &p_image->p_data[u32_pos];
+
+    if (u32_max < TOOL_MIN_MATCH)
+    {
+        return h_best;
+    }
+
+    uint32_t u32_candidate = p_window->p_head[tool_hash(p_cur)];
+    for (uint32_t i = 0; (i < TOOL_MAX_CHAIN) && (TOOL_NO_POS != u32_candidate); i++)
+    {
+        uint32_t u32_distance = u32_pos - u32_candidate;
+        if (u32_distance > TOOL_WINDOW_SIZE)
+        {
+            break;
+        }
+        tool_consider(&h_best, FW_PATCH_OP_WINDOW,
+                      tool_match_len(&p_image->p_data[u32_candidate], p_cur, u32_max), u32_distance);
+        u32_candidate = p_window->p_prev[u32_candidate];
+    }
+
+    if (NULL == p_base)
+    {
+        return h_best;
+    }
+
+    // where the previous copy ends is the likeliest, the unchanged code follows it
+    if (u32_base_next < p_base->u32_len)
+    {
+        uint32_t u32_base_max = p_base->u32_len - u32_base_next;
+        tool_consider(&h_best, FW_PATCH_OP_BASE,
+                      tool_match_len(&p_base->p_data[u32_base_next], p_cur,
+                                     (u32_max < u32_base_max) ? u32_max : u32_base_max), 0);
+    }
+    u32_candidate = p_base_index->p_head[tool_hash(p_cur)];
+    for (uint32_t i = 0; (i < TOOL_MAX_CHAIN) && (TOOL_NO_POS != u32_candidate); i++)
+    {
+        uint32_t u32_base_max = p_base->u32_len - u32_candidate;
+        uint32_t u32_len = tool_match_len(&p_base->p_data[u32_candidate], p_cur,
+                                          (u32_max < u32_base_max) ? u32_max : u32_base_max);
+        tool_consider(&h_best, FW_PATCH_OP_BASE, u32_len, tool_zigzag(u32_candidate, u32_base_next));
+        u32_candidate = p_base_index->p_prev[u32_candidate];
+    }
+
+    return h_best;
+}
+
+static void tool_put(tool_encoder_t *p_enc, uint8_t u8_byte)
+{
+    if (p_enc->h_out.u32_len == p_enc->u32_room)
+    {
+        p_enc->u32_room *= 2;
+        p_enc->h_out.p_data = (uint8_t *)realloc(p_enc->h_out.p_data, p_enc->u32_room);
+    }
+    p_enc->h_out.p_data[p_enc->h_out.u32_len++] = u8_byte;
+}
+
+static void tool_put_varint(tool_encoder_t *p_enc, uint32_t u32_value)
+{
+    while (u32_value >= 0x80)
+    {
+        tool_put(p_enc, (uint8_t)(u32_value | 0x80));
+        u32_value >>= 7;
+    }
+    tool_put(p_enc, (uint8_t)u32_value);
+}
+
+static void tool_put_u32(tool_encoder_t *p_enc, uint32_t u32_value)
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        tool_put(p_enc, (uint8_t)(u32_value >> (8 * i)));
+    }
+}
+
+static void tool_put_op(tool_encoder_t *p_enc, uint8_t u8_op, uint32_t u32_len)
+{
+    static const uint8_t min_len[] = {FW_PATCH_MIN_LITERAL, FW_PATCH_MIN_WINDOW, FW_PATCH_MIN_BASE};
+    uint32_t u32_extra = u32_len - min_len[u8_op];
+
+    p_enc->u32_ops[u8_op]++;
+    if (u32_extra < FW_PATCH_LEN_EXTENDED)
+    {
+        tool_put(p_enc, (uint8_t)((u8_op << FW_PATCH_OP_SHIFT) | u32_extra));
+    }
+    else
+    {
+        tool_put(p_enc, (uint8_t)((u8_op << FW_PATCH_OP_SHIFT) | FW_PATCH_LEN_EXTENDED));
+        tool_put_varint(p_enc, u32_extra - FW_PATCH_LEN_EXTENDED);
+    }
+}
+
+static void tool_flush_literal(tool_encoder_t *p_enc, const tool_buffer_t *p_image)
+{
+    if (0 != p_enc->u32_literal_len)
+    {
+        tool_put_op(p_enc, FW_PATCH_OP_LITERAL, p_enc->u32_literal_len);
+        for (uint32_t i = 0; i < p_enc->u32_literal_len; i++)
+        {
+            tool_put(p_enc, p_image->p_data[p_enc->u32_literal_start + i]);
+        }
+        p_enc->u32_literal_len = 0;
+    }
+}
+
+/**
+ * @brief Greedy parse with one step of lazy matching
+ */
+static tool_buffer_t tool_encode(const tool_buffer_t *p_image, const tool_buffer_t *p_base, uint32_t au32_ops[3])
+{
+    tool_encoder_t h_enc = {{NULL, 0}, 4096, 0, 0, {0, 0, 0}};
+    tool_index_t h_window;
+    tool_index_t h_base_index = {NULL, NULL};
+    uint32_t u32_base_next = 0;
+    uint32_t u32_pos = 0;
+
+    h_enc.h_out.p_data = (uint8_t *)malloc(h_enc.u32_room);
+    tool_put_u32(&h_enc, FW_PATCH_MAGIC);
+    tool_put(&h_enc, FW_PATCH_FORMAT_VERSION);
+    tool_put(&h_enc, TOOL_WINDOW_BITS);
+    tool_put(&h_enc, 0);
+    tool_put(&h_enc, 0);
+    tool_put_u32(&h_enc, p_image->u32_len);
+    tool_put_u32(&h_enc, p_base ? p_base->u32_len : 0);
+    tool_put_u32(&h_enc, p_base ? checksum_crc32_update(CHECKSUM_CRC32_INIT, p_base->p_data, p_base->u32_len) : 0);
+
+    tool_index_init(&h_window, p_image->u32_len);
+    if (NULL != p_base)
+    {
+        tool_index_init(&h_base_index, p_base->u32_len);
+        for (uint32_t i = 0; i < p_base->u32_len; i++)
+        {
+            tool_index_add(&h_base_index, p_base, i);
+        }
+    }
+
+    while (u32_pos < p_image->u32_len)
+    {
+        tool_match_t h_match = tool_find_match(p_image, &h_window, p_base, &h_base_index, u32_pos, u32_base_next);
+        if (h_match.i32_gain > 1)
+        {
+            tool_index_add(&h_window, p_image, u32_pos);
+            tool_match_t h_next = tool_find_match(p_image, &h_window, p_base, &h_base_index, u32_pos + 1, u32_base_next);
+            if (h_next.i32_gain > (h_match.i32_gain + 1))
+            {
+                // a literal now buys a better match at the next byte
+                h_match.i32_gain = 0;
+            }
+        }
+        else
+        {
+            tool_index_add(&h_window, p_image, u32_pos);
+        }
+
+        if (h_match.i32_gain <= 1)
+        {
+            if (0 == h_enc.u32_literal_len)
+            {
+                h_enc.u32_literal_start = u32_pos;
+            }
+            h_enc.u32_literal_len++;
+            u32_pos++;
+            continue;
+        }
+
+        tool_flush_literal(&h_enc, p_image);
+        tool_put_op(&h_enc, h_match.u8_op, h_match.u32_len);
+        tool_put_varint(&h_enc, h_match.u32_arg);
+        if (FW_PATCH_OP_BASE == h_match.u8_op)
+        {
+            int32_t i32_delta = (int32_t)(h_match.u32_arg >> 1) ^ -(int32_t)(h_match.u32_arg & 1);
+            u32_base_next += (uint32_t)i32_delta + h_match.u32_len;
+        }
+        for (uint32_t i = 1; i < h_match.u32_len; i++)
+        {
+            tool_index_add(&h_window, p_image, u32_pos + i);
+        }
+        u32_pos += h_match.u32_len;
+    }
+    tool_flush_literal(&h_enc, p_image);
+
+    tool_index_free(&h_window);
+    if (NULL != p_base)
+    {
+        tool_index_free(&h_base_index);
+    }
+    if (NULL != au32_ops)
+    {
+        memcpy(au32_ops, h_enc.u32_ops, sizeof(h_enc.u32_ops));
+    }
+    return h_enc.h_out;
+}
+
+/********************** decoder **********************/
+static bool tool_read_base(uint32_t u32_offset, uint8_t *p_data, uint32_t u32_len, void *user_context)
+{
+    tool_decoder_t *p_dec = (tool_decoder_t *)user_context;
+    if ((NULL == p_dec->p_base) || ((u32_offset + u32_len) > p_dec->p_base->u32_len))
+    {
+        return false;
+    }
+    memcpy(p_data, &p_dec->p_base->p_data[u32_offset], u32_len);
+    return true;
+}
+
+static bool tool_write_image(const uint8_t *p_data, uint32_t u32_len, void *user_context)
+{
+    tool_decoder_t *p_dec = (tool_decoder_t *)user_context;
+    memcpy(&p_dec->h_image.p_data[p_dec->h_image.u32_len], p_data, u32_len);
+    p_dec->h_image.u32_len += u32_len;
+    return true;
+}
+
+/**
+ * @brief Decodes the patch in ymodem blocks, as the receiver does
+ */
+static fw_patch_status_t tool_decode(const tool_buffer_t *p_patch, const tool_buffer_t *p_base, tool_buffer_t *p_image)
+{
+    static fw_patch_t h_patch;
+    fw_patch_header_t h_header;
+    tool_decoder_t h_dec = {p_base, {NULL, 0}};
+    fw_patch_status_t e_status = FW_PATCH_SUCCESS;
+
+    if (!fw_patch_read_header(p_patch->p_data, p_patch->u32_len, &h_header))
+    {
+        return FW_PATCH_INVALID_FORMAT;
+    }
+    h_dec.h_image.p_data = (uint8_t *)malloc(h_header.u32_image_size);
+    fw_patch_init(&h_patch, tool_read_base, tool_write_image, &h_dec);
+    for (uint32_t u32_pos = 0; (FW_PATCH_SUCCESS == e_status) && (u32_pos < p_patch->u32_len); u32_pos += 1024)
+    {
+        uint32_t u32_len = p_patch->u32_len - u32_pos;
+        e_status = fw_patch_feed(&h_patch, &p_patch->p_data[u32_pos], (u32_len > 1024) ? 1024 : u32_len);
+    }
+    if (FW_PATCH_SUCCESS == e_status)
+    {
+        e_status = fw_patch_finish(&h_patch);
+    }
+    *p_image = h_dec.h_image;
+    return e_status;
+}
+
+/********************** commands **********************/
+static int tool_cmd_encode(const char *p_image_path, const char *p_patch_path, const char *p_base_path)
+{
+    tool_buffer_t h_image;
+    tool_buffer_t h_base;
+    tool_buffer_t h_patch;
+
+    if (!tool_load(p_image_path, &h_image) || (p_base_path && !tool_load(p_base_path, &h_base)))
+    {
+        return 1;
+    }
+    h_patch = tool_encode(&h_image, p_base_path ? &h_base : NULL, NULL);
+    printf("%s: %u -> %u bytes (%.1f %%)\n", p_patch_path, h_image.u32_len, h_patch.u32_len,
+           (100.0 * h_patch.u32_len) / h_image.u32_len);
+    return tool_save(p_patch_path, &h_patch) ? 0 : 1;
+}
+
+static int tool_cmd_decode(const char *p_patch_path, const char *p_image_path, const char *p_base_path)
+{
+    tool_buffer_t h_patch;
+    tool_buffer_t h_base;
+    tool_buffer_t h_image;
+    fw_patch_status_t e_status;
+
+    if (!tool_load(p_patch_path, &h_patch) || (p_base_path && !tool_load(p_base_path, &h_base)))
+    {
+        return 1;
+    }
+    e_status = tool_decode(&h_patch, p_base_path ? &h_base : NULL, &h_image);
+    if (FW_PATCH_SUCCESS != e_status)
+    {
+        fprintf(stderr, "decoding failed (%d)\n", e_status);
+        return 1;
+    }
+    return tool_save(p_image_path, &h_image) ? 0 : 1;
+}
+
+static bool tool_bench_one(const char *p_name, const tool_buffer_t *p_image, const tool_buffer_t *p_base)
+{
+    uint32_t au32_ops[3];
+    uint64_t u64_start = tool_now_ns();
+    tool_buffer_t h_patch = tool_encode(p_image, p_base, au32_ops);
+    uint64_t u64_encode = tool_now_ns() - u64_start;
+    uint64_t u64_decode = UINT64_MAX;
+    bool is_valid = true;
+
+    for (uint8_t i = 0; i < TOOL_BENCH_RUNS; i++)
+    {
+        tool_buffer_t h_decoded;
+        u64_start = tool_now_ns();
+        fw_patch_status_t e_status = tool_decode(&h_patch, p_base, &h_decoded);
+        uint64_t u64_run = tool_now_ns() - u64_start;
+        u64_decode = (u64_run < u64_decode) ? u64_run : u64_decode;
+        is_valid &= (FW_PATCH_SUCCESS == e_status) && (h_decoded.u32_len == p_image->u32_len) &&
+                    (0 == memcmp(h_decoded.p_data, p_image->p_data, p_image->u32_len));
+        free(h_decoded.p_data);
+    }
+
+    double line_s = 1.0 / (TOOL_LINE_BYTES_PER_S * TOOL_YMODEM_EFFICIENCY);
+    printf("%-10s %9u -> %9u B  ratio %5.2f  ops lit/win/base %u/%u/%u  encode %6.0f ms  decode %7.1f MB/s  "
+           "9600 baud %6.0f -> %6.0f s  %s\n",
+           p_name, p_image->u32_len, h_patch.u32_len, (double)p_image->u32_len / h_patch.u32_len,
+           au32_ops[0], au32_ops[1], au32_ops[2], u64_encode / 1e6, (p_image->u32_len * 1e3) / (double)u64_decode,
+           p_image->u32_len * line_s, h_patch.u32_len * line_s, is_valid ? "ok" : "MISMATCH");
+    free(h_patch.p_data);
+    return is_valid;
+}
+
+static int tool_cmd_bench(const char *p_image_path, const char *p_base_path)
+{
+    tool_buffer_t h_image;
+    tool_buffer_t h_base;
+    bool is_valid;
+
+    if (!tool_load(p_image_path, &h_image) || (p_base_path && !tool_load(p_base_path, &h_base)))
+    {
+        return 1;
+    }
+    is_valid = tool_bench_one("compress", &h_image, NULL);
+    if (NULL != p_base_path)
+    {
+        is_valid &= tool_bench_one("delta", &h_image, &h_base);
+    }
+    return is_valid ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *p_base_path = NULL;
+
+    if ((argc >= 4) && (0 == strcmp(argv[1], "encode")))
+    {
+        p_base_path = (argc > 4) ? argv[4] : NULL;
+        return tool_cmd_encode(argv[2], argv[3], p_base_path);
+    }
+    if ((argc >= 4) && (0 == strcmp(argv[1], "decode")))
+    {
+        p_base_path = (argc > 4) ? argv[4] : NULL;
+        return tool_cmd_decode(argv[2], argv[3], p_base_path);
+    }
+    if ((argc >= 3) && (0 == strcmp(argv[1], "bench")))
+    {
+        p_base_path = (argc > 3) ? argv[3] : NULL;
+        return tool_cmd_bench(argv[2], p_base_path);
+    }
+
+    fprintf(stderr, "usage: %s encode <new.bin> <patch.oxp> [running.bin]\n"
+                    "       %s decode <patch.oxp> <new.bin> [running.bin]\n"
+                    "       %s bench <new.bin> [running.bin]\n",
+            argv[0], argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,464 @@
+/**
+ * @file fw_resume_sim.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Reset injection simulation of the resumable firmware download, built by the native_resume environment
+ *        pio run -e native_resume && .pio/build/native_resume/program
+ *        A ymodem sender sends an image over a simulated 9600 baud line and the
+ *        receiver resets at random points. After each reset the sender times out and
+ *        the transfer starts again from the first block, the way the modem does it.
+ *        The partition is a file and the NVS record a variable, both survive the resets.
+ *        Every run checks the final image, with and without the progress record. An image
+ *        changed under the same version is written again from its first differing sector.
+ * @version 0.1
+ * @date 2025-01-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checksum.h"
+#include "fw_partition.h"
+#include "fw_resume.h"
+#include "ymodem_rx.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define SIM_BAUD_RATE               9600
+#define SIM_BYTE_US                 ((10 * 1000000ULL) / SIM_BAUD_RATE)  // start, 8 data and stop bit
+#define SIM_REBOOT_US               (3 * 1000000ULL)     // boot, join and the file status request
+#define SIM_SENDER_TIMEOUT_US       (10 * 1000000ULL)    // sender gives up on a missing ACK
+#define SIM_IMAGE_SIZE              (96 * 1024 + 300)
+#define SIM_IMAGE_VERSION           FW_RESUME_VERSION(1, 2, 3)
+#define SIM_RUNS                    20
+#define SIM_MAX_ATTEMPTS            1000
+#define SIM_PARTITION_PATH          "fw_resume_sim.bin"
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    const char *p_name;
+    uint8_t u8_reset_pct;       // packets during which the receiver resets
+    uint16_t u16_forced_reset;  // data block during which the first attempt resets, 0 for none
+    uint32_t u32_change_offset; // byte changed in the image of the same version sent after the first reset, 0 for none
+} sim_scenario_t;
+
+/**
+ * @brief File partition counting the bytes written, as a measure of the flash wear
+ */
+class SimFwPartition : public FileFwPartition
+{
+public:
+    SimFwPartition() : FileFwPartition(SIM_PARTITION_PATH, SIM_IMAGE_SIZE) {}
+
+    bool write(const uint8_t *data, uint32_t len) override
+    {
+        this->flash_bytes += len;
+        return FileFwPartition::write(data, len);
+    }
+
+    static uint64_t flash_bytes;
+};
+
+uint64_t SimFwPartition::flash_bytes = 0;
+
+/**
+ * @brief RAM state of the receiver, lost on each reset. Same answers as YModem::handleRxEvent().
+ */
+typedef struct
+{
+    ymodem_rx_t h_rx;
+    fw_resume_t h_resume;
+    SimFwPartition *p_partition;
+    bool b_in_data;
+    uint32_t u32_remaining;
+    uint8_t u8_reply;       // byte sent back for the last packet
+    bool b_done;            // image verified
+} sim_receiver_t;
+
+typedef struct
+{
+    uint64_t u64_time_us;
+    uint64_t u64_flash_bytes;
+    uint32_t u32_attempts;
+    uint32_t u32_resets;
+    uint32_t u32_saves;
+    uint32_t u32_mismatches;
+    uint32_t u32_rewrites;
+    bool b_image_ok;
+} sim_result_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static uint32_t sim_rng_state = 0x7F4A7C15;
+static uint8_t sim_images[2][SIM_IMAGE_SIZE];
+
+// non volatile storage
+static fw_resume_record_t sim_nvs_record;
+static bool sim_nvs_valid = false;
+static uint32_t sim_nvs_saves = 0;
+static uint32_t sim_mismatches = 0;
+static uint32_t sim_rewrites = 0;
+
+// the forced reset at block 40 leaves 9 sectors committed
+static const sim_scenario_t sim_scenarios[] = {
+    {"no reset", 0, 0, 0},
+    {"1% of packets reset", 1, 0, 0},
+    {"2% of packets reset", 2, 0, 0},
+    {"4% of packets reset", 4, 0, 0},
+    {"new image after reset", 0, 40, 1000},
+    {"new image, 8th sector", 0, 40, 30000},
+};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint32_t sim_rand(void)
+{
+    // xorshift32
+    sim_rng_state ^= sim_rng_state << 13;
+    sim_rng_state ^= sim_rng_state >> 17;
+    sim_rng_state ^= sim_rng_state << 5;
+    return sim_rng_state;
+}
+
+static bool sim_load(fw_resume_record_t *p_record, void *user_context)
+{
+    if (sim_nvs_valid)
+    {
+        memcpy(p_record, &sim_nvs_record, FW_RESUME_RECORD_SIZE(sim_nvs_record.u32_committed));
+    }
+    return sim_nvs_valid;
+}
+
+static bool sim_save(const fw_resume_record_t *p_record, void *user_context)
+{
+    sim_nvs_valid = (NULL != p_record);
+    if (sim_nvs_valid)
+    {
+        // only the crcs of the committed sectors are stored, as on the board
+        memcpy(&sim_nvs_record, p_record, FW_RESUME_RECORD_SIZE(p_record->u32_committed));
+        sim_nvs_saves++;
+    }
+    return true;
+}
+
+static void sim_on_event(ymodem_rx_event_t event, uint8_t u8_block, const uint8_t *p_data, uint16_t u16_len, void *ctx)
+{
+    sim_receiver_t *p_recv = (sim_receiver_t *)ctx;
+
+    switch (event)
+    {
+    case YMODEM_RX_EVT_BLOCK:
+        if (!p_recv->b_in_data)
+        {
+            if (0 == p_data[0])
+            {
+                // end of batch
+                p_recv->u8_reply = ACK;
+                break;
+            }
+            p_recv->u32_remaining = (uint32_t)atol((const char *)&p_data[strlen((const char *)p_data) + 1]);
+            uint32_t u32_offset = fw_resume_begin(&p_recv->h_resume, SIM_IMAGE_VERSION, p_recv->u32_remaining);
+            if ((0 != u32_offset) && !p_recv->p_partition->resume(p_recv->u32_remaining, u32_offset))
+            {
+                fw_resume_finish(&p_recv->h_resume);
+                u32_offset = fw_resume_begin(&p_recv->h_resume, SIM_IMAGE_VERSION, p_recv->u32_remaining);
+            }
+            if ((0 == u32_offset) && !p_recv->p_partition->begin(p_recv->u32_remaining))
+            {
+                p_recv->u8_reply = CAN;
+                break;
+            }
+            p_recv->b_in_data = true;
+            p_recv->u8_reply = ACK;
+        }
+        else
+        {
+            uint32_t u32_len = (p_recv->u32_remaining > u16_len) ? u16_len : p_recv->u32_remaining;
+            fw_resume_action_t action = fw_resume_check_block(&p_recv->h_resume, p_data, u32_len);
+            if (FW_RESUME_MISMATCH == action)
+            {
+                sim_mismatches++;
+                fw_resume_finish(&p_recv->h_resume);
+                p_recv->p_partition->abort();
+                p_recv->u8_reply = CAN;
+                break;
+            }
+            if (FW_RESUME_REWRITE == action)
+            {
+                uint32_t u32_sector_offset;
+                uint32_t u32_sector_len;
+                const uint8_t *p_sector = fw_resume_get_sector(&p_recv->h_resume, &u32_sector_offset, &u32_sector_len);
+                sim_rewrites++;
+                if (!p_recv->p_partition->resume(SIM_IMAGE_SIZE, u32_sector_offset) ||
+                    !p_recv->p_partition->write(p_sector, u32_sector_len))
+                {
+                    p_recv->u8_reply = CAN;
+                    break;
+                }
+                fw_resume_commit(&p_recv->h_resume, p_sector, u32_sector_len);
+            }
+            if (FW_RESUME_WRITE == action)
+            {
+                if (!p_recv->p_partition->write(p_data, u32_len))
+                {
+                    p_recv->u8_reply = CAN;
+                    break;
+                }
+                fw_resume_commit(&p_recv->h_resume, p_data, u32_len);
+            }
+            p_recv->u32_remaining -= u32_len;
+            p_recv->u8_reply = ACK;
+        }
+        break;
+
+    case YMODEM_RX_EVT_DUPLICATE:
+        p_recv->u8_reply = ACK;
+        break;
+
+    case YMODEM_RX_EVT_EOT:
+        p_recv->b_done = p_recv->b_in_data && p_recv->p_partition->end();
+        fw_resume_finish(&p_recv->h_resume);
+        p_recv->b_in_data = false;
+        ymodem_rx_init(&p_recv->h_rx, 0);
+        p_recv->u8_reply = ACK;
+        break;
+
+    default:
+        p_recv->u8_reply = NAK;
+        break;
+    }
+}
+
+/**
+ * @brief Receiver coming out of a reset, only the NVS record and the partition are left
+ */
+static void sim_boot(sim_receiver_t *p_recv, bool b_use_resume)
+{
+    p_recv->p_partition = new SimFwPartition();
+    fw_resume_init(&p_recv->h_resume, b_use_resume ? sim_load : NULL, b_use_resume ? sim_save : NULL, NULL);
+    p_recv->b_done = false;
+}
+
+static void sim_start_transfer(sim_receiver_t *p_recv)
+{
+    ymodem_rx_init(&p_recv->h_rx, 0);
+    p_recv->b_in_data = false;
+}
+
+static uint16_t sim_make_packet(uint8_t *p_packet, uint8_t u8_block, const uint8_t *p_data, uint16_t u16_len)
+{
+    uint16_t u16_size = (u16_len > YMODEM_BLOCK_SIZE_SOH) ? YMODEM_BLOCK_SIZE_STX : YMODEM_BLOCK_SIZE_SOH;
+
+    p_packet[0] = (YMODEM_BLOCK_SIZE_STX == u16_size) ? STX : SOH;
+    p_packet[1] = u8_block;
+    p_packet[2] = 0xFF - u8_block;
+    memset(&p_packet[3], 0x1A, u16_size);
+    memcpy(&p_packet[3], p_data, u16_len);
+    uint16_t u16_crc = checksum_crc16_update(CHECKSUM_CRC16_INIT, &p_packet[3], u16_size);
+    p_packet[3 + u16_size] = u16_crc >> 8;
+    p_packet[4 + u16_size] = u16_crc & 0xFF;
+
+    return u16_size + YMODEM_PACKET_OVERHEAD;
+}
+
+/**
+ * @brief Sends one packet, the receiver may reset while it comes in
+ * @return true if the receiver answered, false if it reset
+ */
+static bool sim_send(sim_receiver_t *p_recv, sim_result_t *p_result, const uint8_t *p_packet, uint16_t u16_len,
+                     bool b_reset)
+{
+    if (b_reset)
+    {
+        // part of the packet is on the line when the power goes
+        p_result->u64_time_us += (sim_rand() % u16_len) * SIM_BYTE_US;
+        delete p_recv->p_partition;
+        p_result->u32_resets++;
+        return false;
+    }
+    p_result->u64_time_us += u16_len * SIM_BYTE_US;
+    p_recv->u8_reply = 0;
+    ymodem_rx_feed(&p_recv->h_rx, p_packet, u16_len, (uint32_t)(p_result->u64_time_us / 1000), sim_on_event, p_recv);
+    p_result->u64_time_us += SIM_BYTE_US;
+    return true;
+}
+
+/**
+ * @brief One transfer attempt from the header to the end of batch
+ * @return true if the receiver is still up at its end
+ */
+static bool sim_attempt(sim_receiver_t *p_recv, sim_result_t *p_result, const sim_scenario_t *p_scenario,
+                        const uint8_t *p_image)
+{
+    static uint8_t packet[YMODEM_PACKET_MAX_SIZE];
+    char header[YMODEM_BLOCK_SIZE_SOH];
+    uint16_t u16_len;
+
+    sim_start_transfer(p_recv);
+
+    memset(header, 0, sizeof(header));
+    int header_len = snprintf(header, sizeof(header), "fw.bin%c%u", 0, (unsigned)SIM_IMAGE_SIZE) + 1;
+    u16_len = sim_make_packet(packet, 0, (const uint8_t *)header, (uint16_t)header_len);
+    if (!sim_send(p_recv, p_result, packet, u16_len, (sim_rand() % 100) < p_scenario->u8_reset_pct))
+    {
+        return false;
+    }
+    if (ACK != p_recv->u8_reply)
+    {
+        return true;
+    }
+
+    uint8_t u8_block = 1;
+    for (uint32_t u32_offset = 0; u32_offset < SIM_IMAGE_SIZE; u32_offset += YMODEM_BLOCK_SIZE_STX, u8_block++)
+    {
+        uint32_t u32_chunk = SIM_IMAGE_SIZE - u32_offset;
+        if (u32_chunk > YMODEM_BLOCK_SIZE_STX)
+        {
+            u32_chunk = YMODEM_BLOCK_SIZE_STX;
+        }
+        bool b_reset = ((sim_rand() % 100) < p_scenario->u8_reset_pct) ||
+                       ((1 == p_result->u32_attempts) && (u8_block == p_scenario->u16_forced_reset));
+        u16_len = sim_make_packet(packet, u8_block, &p_image[u32_offset], (uint16_t)u32_chunk);
+        if (!sim_send(p_recv, p_result, packet, u16_len, b_reset))
+        {
+            return false;
+        }
+        if (ACK != p_recv->u8_reply)
+        {
+            // cancelled, the host asks for the transfer again
+            return true;
+        }
+    }
+
+    packet[0] = EOT;
+    if (!sim_send(p_recv, p_result, packet, 1, false))
+    {
+        return false;
+    }
+    u16_len = sim_make_packet(packet, 0, (const uint8_t *)"", 1);
+    return sim_send(p_recv, p_result, packet, u16_len, false);
+}
+
+static bool sim_check_image(const uint8_t *p_image)
+{
+    static uint8_t read_back[SIM_IMAGE_SIZE];
+    FILE *p_file = fopen(SIM_PARTITION_PATH, "rb");
+    size_t read = 0;
+
+    if (NULL != p_file)
+    {
+        read = fread(read_back, 1, sizeof(read_back), p_file);
+        fclose(p_file);
+    }
+    return (SIM_IMAGE_SIZE == read) && (0 == memcmp(read_back, p_image, SIM_IMAGE_SIZE));
+}
+
+static sim_result_t sim_run(const sim_scenario_t *p_scenario, bool b_use_resume)
+{
+    sim_receiver_t h_recv;
+    sim_result_t h_result;
+    const uint8_t *p_image = sim_images[0];
+
+    memset(&h_result, 0, sizeof(h_result));
+    remove(SIM_PARTITION_PATH);
+    sim_nvs_valid = false;
+    sim_nvs_saves = 0;
+    sim_mismatches = 0;
+    sim_rewrites = 0;
+    SimFwPartition::flash_bytes = 0;
+
+    sim_boot(&h_recv, b_use_resume);
+    while (!h_recv.b_done && (h_result.u32_attempts < SIM_MAX_ATTEMPTS))
+    {
+        h_result.u32_attempts++;
+        if (!sim_attempt(&h_recv, &h_result, p_scenario, p_image))
+        {
+            h_result.u64_time_us += SIM_REBOOT_US + SIM_SENDER_TIMEOUT_US;
+            sim_boot(&h_recv, b_use_resume);
+            if (0 != p_scenario->u32_change_offset)
+            {
+                p_image = sim_images[1];
+            }
+        }
+    }
+    delete h_recv.p_partition;
+
+    h_result.b_image_ok = h_recv.b_done && sim_check_image(p_image);
+    h_result.u64_flash_bytes = SimFwPartition::flash_bytes;
+    h_result.u32_saves = sim_nvs_saves;
+    h_result.u32_mismatches = sim_mismatches;
+    h_result.u32_rewrites = sim_rewrites;
+    return h_result;
+}
+
+int main(void)
+{
+    for (uint32_t i = 0; i < SIM_IMAGE_SIZE; i++)
+    {
+        sim_images[0][i] = (uint8_t)sim_rand();
+    }
+    sim_images[0][0] = FW_PARTITION_IMAGE_MAGIC;
+
+    printf("image %u B at %u baud, %u runs per scenario, a reset costs %llu s\n\n", (unsigned)SIM_IMAGE_SIZE,
+           (unsigned)SIM_BAUD_RATE, (unsigned)SIM_RUNS,
+           (unsigned long long)((SIM_REBOOT_US + SIM_SENDER_TIMEOUT_US) / 1000000ULL));
+    printf("%-24s %-8s %8s %8s %9s %12s %7s %10s %8s %6s\n", "scenario", "resume", "attempts", "resets", "time s",
+           "flash KB", "saves", "mismatches", "rewrites", "ok");
+
+    uint32_t u32_failures = 0;
+    for (size_t s = 0; s < sizeof(sim_scenarios) / sizeof(sim_scenarios[0]); s++)
+    {
+        // same version and size, one byte differs
+        memcpy(sim_images[1], sim_images[0], SIM_IMAGE_SIZE);
+        if (0 != sim_scenarios[s].u32_change_offset)
+        {
+            sim_images[1][sim_scenarios[s].u32_change_offset] ^= 0x5A;
+        }
+
+        for (int resume = 0; resume < 2; resume++)
+        {
+            uint32_t u32_seed = sim_rng_state;
+            uint64_t u64_time = 0, u64_flash = 0;
+            uint32_t u32_attempts = 0, u32_resets = 0, u32_saves = 0, u32_mismatches = 0, u32_rewrites = 0, u32_ok = 0;
+
+            for (uint32_t run = 0; run < SIM_RUNS; run++)
+            {
+                sim_result_t h_result = sim_run(&sim_scenarios[s], (0 != resume));
+                u64_time += h_result.u64_time_us;
+                u64_flash += h_result.u64_flash_bytes;
+                u32_attempts += h_result.u32_attempts;
+                u32_resets += h_result.u32_resets;
+                u32_saves += h_result.u32_saves;
+                u32_mismatches += h_result.u32_mismatches;
+                u32_rewrites += h_result.u32_rewrites;
+                u32_ok += h_result.b_image_ok ? 1 : 0;
+            }
+            u32_failures += SIM_RUNS - u32_ok;
+            printf("%-24s %-8s %8.1f %8.1f %9.0f %12.0f %7.1f %10.1f %8.1f %3u/%u\n", sim_scenarios[s].p_name,
+                   resume ? "on" : "off", (double)u32_attempts / SIM_RUNS, (double)u32_resets / SIM_RUNS,
+                   (double)u64_time / SIM_RUNS / 1e6, (double)u64_flash / SIM_RUNS / 1024.0,
+                   (double)u32_saves / SIM_RUNS, (double)u32_mismatches / SIM_RUNS, (double)u32_rewrites / SIM_RUNS,
+                   (unsigned)u32_ok, (unsigned)SIM_RUNS);
+            // both modes see the same resets
+            if (0 == resume)
+            {
+                sim_rng_state = u32_seed;
+            }
+        }
+    }
+    remove(SIM_PARTITION_PATH);
+
+    printf("\n%s\n", (0 == u32_failures) ? "all images verified" : "IMAGE CHECK FAILED");
+    return (0 == u32_failures) ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file host_shim_run.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief MCM, YModem and GNSS code of the firmware run on the host, built by the native_host environment
+ *        pio run -e native_host && .pio/build/native_host/program [-r] [-q] [-p] [-n uplinks]
+ *        -r  real clock, the default virtual one runs faster than real time
+ *        -q  no console output of the firmware, for perf record
+ *        -p  the MCM port is a pty for a modem emulator, its path is printed
+ *        -n  number of uplinks, 1000 by default
+ *        Without -p a minimal modem answers every command with MROVER_RC_OK and a zeroed
+ *        payload of the expected length. The GNSS emulator of host/ answers the PAIR commands
+ *        of init_gnss() and sends a GGA and an RMC sentence every second. Each uplink carries
+ *        the last fix.
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "frame_parse.h"
+#include "gnss.h"
+#include "gnss_emulator.h"
+#include "mcm_rover.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+extern HardwareSerial GPS_Serial;
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define RUN_DEFAULT_UPLINKS 1000
+#define RUN_UPLINK_PORT 2
+
+#define MODEM_BAUD_RATE 9600
+#define MODEM_CMD_HEADER_LEN 5 // command type, command code and length
+#define MODEM_FRAME_SIZE (MODEM_CMD_HEADER_LEN + MAX_SERIAL_SEND_PAYLOAD_SIZE + 1)
+
+#define MODEM_RSP_LEN_CASE(cc, type, rsp_len_policy, rsp_len, parser, name) \
+    case (cc):                                                              \
+        return (rsp_len);
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static HardwareSerial modem_port(3);
+static HardwareSerial gnss_port(4);
+static GnssEmulator gnss(gnss_port);
+static MCM mcm(Serial1, 0, 0, 0);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint16_t modem_rsp_len(uint16_t cmd_code)
+{
+    switch (cmd_code)
+    {
+        MROVER_COMMAND_LIST(MODEM_RSP_LEN_CASE)
+    default:
+        return 0;
+    }
+}
+
+static void modem_respond(const uint8_t *p_cmd)
+{
+    uint8_t rsp[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+    uint16_t cmd_code = (p_cmd[1] << 8) | p_cmd[2];
+    uint16_t payload_len = modem_rsp_len(cmd_code);
+
+    rsp[0] = MROVER_RC_OK;
+    rsp[1] = p_cmd[0];
+    rsp[2] = p_cmd[1];
+    rsp[3] = p_cmd[2];
+    rsp[4] = payload_len >> 8;
+    rsp[5] = payload_len & 0xFF;
+    memset(&rsp[FP_RESPONSE_HEADER_LEN], 0, payload_len);
+    if (MROVER_CC_GET_EVENT == cmd_code)
+    {
+        rsp[FP_RESPONSE_HEADER_LEN] = MODEM_EVENT_NONE;
+    }
+    rsp[FP_RESPONSE_HEADER_LEN + payload_len] = fp_crc_update(0, rsp, FP_RESPONSE_HEADER_LEN + payload_len);
+    modem_port.write(rsp, FP_RESPONSE_FRAME_OVERHEAD + payload_len);
+}
+
+/**
+ * @brief Minimal modem, every command is answered with MROVER_RC_OK
+ */
+static void modem_task(void *ctx)
+{
+    uint8_t frame[MODEM_FRAME_SIZE];
+    uint16_t len = 0;
+
+    for (;;)
+    {
+        int data = modem_port.read();
+        if (data < 0)
+        {
+            delay(1);
+            continue;
+        }
+
+        frame[len++] = (uint8_t)data;
+        if (len < MODEM_CMD_HEADER_LEN)
+        {
+            continue;
+        }
+        uint16_t frame_len = MODEM_CMD_HEADER_LEN + ((frame[3] << 8) | frame[4]) + 1;
+        if (frame_len > sizeof(frame))
+        {
+            len = 0;
+        }
+        else if (len == frame_len)
+        {
+            if (0 == fp_crc_update(0, frame, frame_len))
+            {
+                modem_respond(frame);
+            }
+            len = 0;
+        }
+    }
+}
+
+static double wall_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    bool is_real_clock = false;
+    bool is_pty = false;
+    uint32_t uplinks = RUN_DEFAULT_UPLINKS;
+    int option;
+
+    while ((option = getopt(argc, argv, "rqpn:")) != -1)
+    {
+        switch (option)
+        {
+        case 'r':
+            is_real_clock = true;
+            break;
+        case 'q':
+            Serial.attach_output(NULL);
+            break;
+        case 'p':
+            is_pty = true;
+            break;
+        case 'n':
+            uplinks = (uint32_t)atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-r] [-q] [-p] [-n uplinks]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (is_pty && !is_real_clock)
+    {
+        fprintf(stderr, "a pty needs the real clock, use -r\n");
+        return 1;
+    }
+    host_os_set_clock(is_real_clock ? HOST_CLOCK_REAL : HOST_CLOCK_VIRTUAL);
+    SPIFFS.begin(true);
+
+    if (is_pty)
+    {
+        const char *p_path = Serial1.attach_pty();
+        if (NULL == p_path)
+        {
+            fprintf(stderr, "unable to open a pty\n");
+            return 1;
+        }
+        printf("MCM port: %s\n", p_path);
+        fflush(stdout);
+    }
+    else
+    {
+        modem_port.begin(MODEM_BAUD_RATE);
+        modem_port.attach_line(Serial1);
+        xTaskCreate(modem_task, "modem", 0, NULL, 1, NULL);
+    }
+    gnss_port.begin(GNSS_EMULATOR_BAUD_RATE);
+    gnss_port.attach_line(GPS_Serial);
+    gnss.begin();
+
+    init_gnss();
+    if (MCM_STATUS::MCM_OK != mcm.begin())
+    {
+        fprintf(stderr, "mcm begin failed\n");
+        return 1;
+    }
+    mcm.set_connect_mode(ConnectionMode::CONNECTION_MODE_LORAWAN);
+
+    gnss_data_t fix = {};
+    uint32_t fixes = 0;
+    uint32_t done = 0;
+    uint32_t start_ms = millis();
+    double start_s = wall_seconds();
+
+    for (uint32_t i = 0; i < uplinks; i++)
+    {
+        uint8_t payload[16];
+        int32_t lat = (int32_t)(fix.latitude * 1e7);
+        int32_t lon = (int32_t)(fix.longitude * 1e7);
+        memcpy(&payload[0], &lat, sizeof(lat));
+        memcpy(&payload[4], &lon, sizeof(lon));
+        memcpy(&payload[8], &i, sizeof(i));
+        memcpy(&payload[12], &fixes, sizeof(fixes));
+
+        if (MCM_STATUS::MCM_OK != mcm.send_uplink_async(payload, sizeof(payload), RUN_UPLINK_PORT,
+                                                        MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF))
+        {
+            break;
+        }
+        while (mcm.is_command_pending())
+        {
+            mcm.poll();
+            if (gnssCheckin(&fix))
+            {
+                fixes++;
+            }
+            delay(1);
+        }
+        if (MCM_CMD_STATUS::MCM_CMD_DONE == mcm.get_command_status())
+        {
+            done++;
+        }
+    }
+
+    double wall_s = wall_seconds() - start_s;
+    double sim_s = (millis() - start_ms) / 1000.0;
+    mcm_rx_stats_t rx_stats;
+    mcm.get_rx_stats(&rx_stats);
+
+    printf("uplinks %u of %u done, %u gnss fixes\n", done, uplinks, fixes);
+    printf("%.1f s of firmware time in %.3f s, %.0f uplinks/s, %.1fx real time\n", sim_s, wall_s,
+           done / wall_s, sim_s / wall_s);
+    printf("rx items %u, dropped %u, stream overflow %u B, garbage %u B\n", rx_stats.items_count,
+           rx_stats.items_dropped, rx_stats.stream_overflow_bytes, rx_stats.garbage_bytes);
+
+    return (done == uplinks) ? 0 : 1;
+}
@@ -0,0 +1,659 @@
+/**
+ * @file mcm_emulator_bench.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief MCM driver against the emulated modem of host/mcm_emulator.h, built by the native_emulator environment
+ *        pio run -e native_emulator && .pio/build/native_emulator/program [-v] [-n uplinks] [-s seed]
+ *        pio run -e native_emulator && .pio/build/native_emulator/program -d /dev/pts/N
+ *        -v  log of the emulator, one line per command and event
+ *        -n  uplinks of each scenario, 200 by default
+ *        -s  seed of the faults, a run is repeated exactly with the same seed
+ *        -d  no benchmark, the emulator serves the tty on the real clock, e.g. the pty printed by
+ *            native_host -r -p, or a usb serial adapter wired to a board
+ *        Each scenario joins once, sends its uplinks one after the other on the virtual clock
+ *        and prints the round trip times of the uplink requests, the time to their TXDONE
+ *        event and what the faults cost. The file scenarios announce a host image with
+ *        segmented file download events and send it with ymodem, the partition is checked.
+ *        In the middle of the transfer the cli scenario runs the blocking calls of the cli and
+ *        the button, the silent one holds the modem in reset while only poll() is called.
+ *        Last the full event fifo is read by drain_pending_events() and by the former loop
+ *        of one GET_EVENT at a time. Before the scenarios the downlink pool of a second
+ *        instance is checked against a slot released twice.
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "fw_partition.h"
+#include "host_fuota.h"
+#include "mcm_emulator.h"
+#include "mcm_rover.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define BENCH_DEFAULT_UPLINKS 200
+#define BENCH_UPLINK_PORT 2
+#define BENCH_UPLINK_SIZE 24
+#define BENCH_JOIN_TIMEOUT_MS 60000
+#define BENCH_TXDONE_TIMEOUT_MS 10000       // past the tx delay, the TXDONE event was lost
+#define BENCH_BURST_PERIOD 20               // uplinks between two bursts of downlinks
+#define BENCH_BURST_SIZE 12                 // above MAX_PENDING_MESSAGES, the last ones are lost
+#define BENCH_FILE_TIMEOUT_MS (30 * 60 * 1000)
+#define BENCH_IMAGE_SIZE (128 * 1024 + 100)
+#define BENCH_PARTITION_PATH "mcm_emulator_fw.bin"
+#define BENCH_PARTITION_SIZE 0x140000
+#define BENCH_MID_TRANSFER_PACKET 10        // ymodem packets sent before the mid transfer action
+#define BENCH_DRAIN_ROUNDS 20               // fifo fills read by each way of draining
+#define BENCH_DRAIN_TIMEOUT_MS 5000
+#define BENCH_DRAIN_APP_MS 20               // downlink handling of the application, printing and nvs writes
+
+#define BENCH_MID_NONE 0
+#define BENCH_MID_CLI 1                     // protocol switch, connect, event drain and uplink of the cli
+#define BENCH_MID_SILENT 2                  // modem stops sending, held in reset
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint32_t response_delay_us;
+    uint32_t response_jitter_us;
+    uint8_t loss_pct;
+    uint8_t crc_error_pct;
+    bool is_coalesced;
+    uint8_t downlink_pct;
+    bool is_burst;              // bursts of downlinks overflow the event fifo
+    bool is_file;               // file download and ymodem transfer instead of uplinks
+    uint8_t mid_transfer;       // BENCH_MID_ action in the middle of the ymodem transfer
+} bench_scenario_t;
+
+typedef struct
+{
+    bool is_complete;
+    MCM_CMD_STATUS status;
+    uint64_t complete_us;
+} bench_uplink_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static HardwareSerial modem_port(3);
+static McmEmulator emulator(modem_port);
+static MCM mcm(Serial1, 0, 0, 0);
+static MCM pool_mcm(Serial2, 0, 0, 0);          // never started, only its downlink pool is used
+static FileFwPartition partition(BENCH_PARTITION_PATH, BENCH_PARTITION_SIZE);
+static uint32_t restart_count = 0;
+static uint32_t drain_app_ms = 0;
+
+static const bench_scenario_t bench_scenarios[] = {
+    // name                        delay   jitter  loss crc coalesced dl% burst  file   mid transfer
+    {"clean",                      2000,   0,      0,   0,  false,    0,  false, false, BENCH_MID_NONE},
+    {"50 ms latency, 50 ms jitter", 50000, 50000,  0,   0,  false,    0,  false, false, BENCH_MID_NONE},
+    {"1% loss",                    2000,   0,      1,   0,  false,    0,  false, false, BENCH_MID_NONE},
+    {"1% crc errors",              2000,   0,      0,   1,  false,    0,  false, false, BENCH_MID_NONE},
+    {"coalesced, 50% downlinks",   2000,   0,      0,   0,  true,     50, false, false, BENCH_MID_NONE},
+    {"downlink bursts",            2000,   0,      0,   0,  false,    0,  true,  false, BENCH_MID_NONE},
+    {"file transfer",              2000,   0,      0,   0,  false,    0,  false, true,  BENCH_MID_NONE},
+    {"file transfer, cli",         2000,   0,      0,   0,  false,    0,  false, true,  BENCH_MID_CLI},
+    {"file transfer, modem silent", 2000,  0,      0,   0,  false,    0,  false, true,  BENCH_MID_SILENT},
+    {"file transfer, 1% faults",   2000,   0,      1,   1,  false,    0,  false, true,  BENCH_MID_NONE},
+};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void on_restart()
+{
+    // firmware would boot the new image, the bench goes on
+    restart_count++;
+}
+
+static void on_uplink_complete(mrover_cc_codes_t cmd_code, MCM_CMD_STATUS status, mrover_return_code_t return_code,
+                               void *user_ctx)
+{
+    bench_uplink_t *uplink = (bench_uplink_t *)user_ctx;
+    uplink->is_complete = true;
+    uplink->status = status;
+    uplink->complete_us = micros();
+}
+
+static void on_drain_downlink(uint8_t *data, uint16_t len, int8_t rssi, int8_t snr, uint16_t seq_port)
+{
+    // the modem is free to answer the next GET_EVENT meanwhile, only the pipelined drain has sent it
+    delay(drain_app_ms);
+}
+
+static double wall_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static double percentile_ms(std::vector<uint64_t> &samples_us, uint32_t pct)
+{
+    if (samples_us.empty())
+    {
+        return 0.0;
+    }
+    std::sort(samples_us.begin(), samples_us.end());
+    size_t index = ((samples_us.size() - 1) * pct) / 100;
+    return samples_us[index] / 1000.0;
+}
+
+/**
+ * @brief Loop of the application, events are drained and the downlinks read
+ * @return downlinks read
+ */
+/**
+ * @brief A slot released twice while another is held must not be handed out to two owners
+ */
+static bool check_downlink_pool()
+{
+    mcm_downlink_t *first = pool_mcm.alloc_downlink(BENCH_UPLINK_SIZE);
+    mcm_downlink_t *held = pool_mcm.alloc_downlink(BENCH_UPLINK_SIZE);
+    pool_mcm.release_downlink(first);
+    pool_mcm.release_downlink(first);
+
+    // every free slot is handed out once, the held one not at all
+    std::vector<mcm_downlink_t *> taken;
+    mcm_downlink_t *downlink;
+    while (nullptr != (downlink = pool_mcm.alloc_downlink(BENCH_UPLINK_SIZE)))
+    {
+        taken.push_back(downlink);
+    }
+    std::sort(taken.begin(), taken.end());
+    bool is_ok = (taken.size() == (MCM_DOWNLINK_POOL_SLOTS - 1)) &&
+                 (std::adjacent_find(taken.begin(), taken.end()) == taken.end()) &&
+                 (std::find(taken.begin(), taken.end(), held) == taken.end());
+
+    mcm_downlink_stats_t stats;
+    pool_mcm.get_downlink_stats(&stats);
+    is_ok = is_ok && (1 == stats.bad_release_count);
+    for (mcm_downlink_t *slot : taken)
+    {
+        pool_mcm.release_downlink(slot);
+    }
+    pool_mcm.release_downlink(held);
+    printf("downlink pool: slot released twice, %u of %u slots handed out once, %u bad release: %s\n",
+           (unsigned)taken.size(), (unsigned)(MCM_DOWNLINK_POOL_SLOTS - 1), stats.bad_release_count,
+           is_ok ? "ok" : "FAILED");
+    return is_ok;
+}
+
+static uint32_t run_loop(uint32_t duration_ms)
+{
+    uint32_t downlinks = 0;
+    uint32_t start_ms = millis();
+
+    do
+    {
+        mcm.handle_rx_events();
+        while (mcm.is_downlink_available())
+        {
+            uint8_t data[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+            uint16_t len;
+            int8_t rssi, snr;
+            uint16_t seq_port;
+            mcm.get_downlink_data(data, &len, &rssi, &snr, &seq_port);
+            downlinks++;
+        }
+        delay(1);
+    } while ((millis() - start_ms) < duration_ms);
+
+    return downlinks;
+}
+
+static bool join(uint32_t *join_ms)
+{
+    uint32_t start_ms = millis();
+
+    if (MCM_STATUS::MCM_OK != mcm.connect_network_async())
+    {
+        return false;
+    }
+    while (!mcm.is_connected() && ((millis() - start_ms) < BENCH_JOIN_TIMEOUT_MS))
+    {
+        run_loop(1);
+    }
+    *join_ms = millis() - start_ms;
+    return mcm.is_connected();
+}
+
+static void run_uplinks(const bench_scenario_t *scenario, uint32_t uplinks)
+{
+    std::vector<uint64_t> rtt_us;
+    std::vector<uint64_t> txdone_us;
+    uint32_t done = 0, failed = 0, timeouts = 0, txdone_missing = 0, downlinks = 0;
+    uint32_t start_ms = millis();
+    double start_s = wall_seconds();
+
+    for (uint32_t i = 0; i < uplinks; i++)
+    {
+        uint8_t payload[BENCH_UPLINK_SIZE];
+        bench_uplink_t uplink = {};
+
+        memset(payload, 0, sizeof(payload));
+        memcpy(payload, &i, sizeof(i));
+        if (scenario->is_burst && (0 == (i % BENCH_BURST_PERIOD)))
+        {
+            for (uint8_t j = 0; j < BENCH_BURST_SIZE; j++)
+            {
+                emulator.queue_downlink(payload, sizeof(payload), BENCH_UPLINK_PORT);
+            }
+            emulator.notify();
+        }
+
+        uint64_t submit_us = micros();
+        if (MCM_STATUS::MCM_OK != mcm.send_uplink_async(payload, sizeof(payload), BENCH_UPLINK_PORT,
+                                                        MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF,
+                                                        on_uplink_complete, &uplink))
+        {
+            // an event drain or another command is in flight
+            downlinks += run_loop(1);
+            i--;
+            continue;
+        }
+        while (!uplink.is_complete)
+        {
+            downlinks += run_loop(1);
+        }
+
+        if (MCM_CMD_STATUS::MCM_CMD_DONE != uplink.status)
+        {
+            (MCM_CMD_STATUS::MCM_CMD_TIMEOUT == uplink.status) ? timeouts++ : failed++;
+            continue;
+        }
+        done++;
+        rtt_us.push_back(uplink.complete_us - submit_us);
+
+        uint32_t wait_ms = millis();
+        while (mcm.is_last_uplink_pending() && ((millis() - wait_ms) < BENCH_TXDONE_TIMEOUT_MS))
+        {
+            downlinks += run_loop(1);
+        }
+        if (mcm.is_last_uplink_pending())
+        {
+            txdone_missing++;
+        }
+        else
+        {
+            txdone_us.push_back(micros() - submit_us);
+        }
+    }
+    // last downlinks and bursts are drained
+    downlinks += run_loop(3000);
+
+    double wall_s = wall_seconds() - start_s;
+    double sim_s = (millis() - start_ms) / 1000.0;
+    mcm_emulator_stats_t emu;
+    api_metrics_t metrics;
+    emulator.get_stats(&emu);
+    mcm.get_metrics(&metrics, true);
+
+    printf("%-28s %5u %4u %4u %6.2f %6.2f %7.2f %7.0f %7.0f %5u %5u %4u %4u %4u %6.1f %8.0f\n", scenario->name,
+           done, timeouts, failed, percentile_ms(rtt_us, 50), percentile_ms(rtt_us, 99),
+           rtt_us.empty() ? 0.0 : (*std::max_element(rtt_us.begin(), rtt_us.end()) / 1000.0),
+           percentile_ms(txdone_us, 50), percentile_ms(txdone_us, 99), txdone_missing, downlinks, emu.events_lost,
+           metrics.h_link.u32_crc_errors, metrics.h_link.u32_resync_count, (done * 60.0) / sim_s, sim_s / wall_s);
+}
+
+/**
+ * @brief Calls of the cli and the button while the modem sends the file, none of them may wait for its end
+ * @return longest time one of them blocked the loop
+ */
+static uint32_t run_cli_commands()
+{
+    uint8_t payload[BENCH_UPLINK_SIZE] = {0};
+    uint32_t longest_ms = 0;
+
+    for (uint8_t step = 0; step < 4; step++)
+    {
+        uint32_t start_ms = millis();
+        switch (step)
+        {
+        case 0:
+            // protocol switch of the cli, see switch_protocol_mode()
+            mcm.stop_network();
+            break;
+        case 1:
+            mcm.connect_network();
+            break;
+        case 2:
+            mcm.drain_pending_events();
+            break;
+        default:
+            // held for the end of the transfer
+            mcm.send_uplink(payload, sizeof(payload), BENCH_UPLINK_PORT, MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF);
+            break;
+        }
+        longest_ms = std::max(longest_ms, (uint32_t)(millis() - start_ms));
+    }
+    return longest_ms;
+}
+
+/**
+ * @brief Modem stops in the middle of the file, poll() alone has to give the transfer up
+ * @return time the transfer took to be given up
+ */
+static uint32_t run_silent_modem()
+{
+    uint32_t start_ms = millis();
+
+    emulator.set_reset_line(0);
+    while (mcm.is_file_transfer_active() && ((millis() - start_ms) < BENCH_FILE_TIMEOUT_MS))
+    {
+        mcm.poll();
+        delay(1);
+    }
+    uint32_t given_up_ms = millis() - start_ms;
+    emulator.set_reset_line(1);
+    return given_up_ms;
+}
+
+static void run_file_transfer(const bench_scenario_t *scenario, uint8_t patch)
+{
+    std::vector<uint8_t> image(BENCH_IMAGE_SIZE);
+    ver_type_1_t version = {1, 2, patch};
+    uint32_t seed = 0x2545F491 + patch;
+
+    for (size_t i = 0; i < image.size(); i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        image[i] = (uint8_t)seed;
+    }
+    image[0] = FW_PARTITION_IMAGE_MAGIC;
+    remove(BENCH_PARTITION_PATH);
+
+    mcm_emulator_stats_t emu;
+    uint32_t start_ms = millis();
+    double start_s = wall_seconds();
+    emulator.set_file_image(image, version);
+    emulator.queue_file_download(FUOTA_BINARY_TYPE_HOST, SEG_SIZE_64);
+
+    bool is_downloaded = false;
+    while (!is_downloaded && ((millis() - start_ms) < BENCH_FILE_TIMEOUT_MS))
+    {
+        run_loop(1);
+        is_downloaded = mcm.is_new_firmware();
+    }
+    uint32_t download_ms = millis() - start_ms;
+
+    uint32_t transfer_ms = millis();
+    uint32_t uplinks = emu.uplinks;
+    uint32_t mid_ms = 0;
+    bool is_mid_done = (BENCH_MID_NONE == scenario->mid_transfer);
+    bool is_sent = false;
+    emulator.get_stats(&emu);
+    if (is_downloaded && (MCM_STATUS::MCM_OK == mcm.process_fw_update()))
+    {
+        do
+        {
+            run_loop(1);
+            emulator.get_stats(&emu);
+            if (!is_mid_done && (emu.ymodem_packets >= BENCH_MID_TRANSFER_PACKET))
+            {
+                is_mid_done = true;
+                mid_ms = (BENCH_MID_CLI == scenario->mid_transfer) ? run_cli_commands() : run_silent_modem();
+            }
+        } while ((emu.ymodem_transfers + emu.ymodem_cancels == 0) &&
+                 !(is_mid_done && (BENCH_MID_SILENT == scenario->mid_transfer)) &&
+                 ((millis() - transfer_ms) < BENCH_FILE_TIMEOUT_MS));
+        is_sent = (emu.ymodem_transfers > 0);
+    }
+    transfer_ms = millis() - transfer_ms;
+    // image is checked and the firmware restarts after it
+    run_loop(6000);
+
+    std::vector<uint8_t> written(image.size());
+    FILE *file = fopen(BENCH_PARTITION_PATH, "rb");
+    bool is_image_ok = (NULL != file) && (fread(written.data(), 1, written.size(), file) == written.size()) &&
+                       (written == image);
+    if (NULL != file)
+    {
+        fclose(file);
+    }
+
+    emulator.get_stats(&emu);
+    if (BENCH_MID_SILENT == scenario->mid_transfer)
+    {
+        // no image is expected, only the driver getting out of the transfer
+        printf("%-28s modem silent after %u packets, transfer given up by poll() after %u ms, %s\n", scenario->name,
+               (unsigned)BENCH_MID_TRANSFER_PACKET, mid_ms, mcm.is_file_transfer_active() ? "STUCK" : "ok");
+        return;
+    }
+    printf("%-28s download %u ms, ymodem %u B in %u ms (%.0f B/s), %u packets, %u retries, %u cancels, "
+           "image %s, restart %s, %.0fx real time\n",
+           scenario->name, download_ms, (unsigned)image.size(), transfer_ms,
+           (transfer_ms > 0) ? (image.size() * 1000.0) / transfer_ms : 0.0, emu.ymodem_packets, emu.ymodem_retries,
+           emu.ymodem_cancels, (is_sent && is_image_ok) ? "ok" : "BAD", (restart_count > 0) ? "yes" : "no",
+           ((millis() - start_ms) / 1000.0) / (wall_seconds() - start_s));
+    if (BENCH_MID_CLI == scenario->mid_transfer)
+    {
+        printf("%-28s cli calls blocked the loop %u ms at most, held uplink %s\n", "", mid_ms,
+               (emu.uplinks > uplinks) ? "sent after the transfer" : "NOT SENT");
+    }
+}
+
+/**
+ * @brief Fills the event fifo of the modem, reads it with the pipelined drain or one GET_EVENT at a time
+ * @param is_pipelined drain_pending_events() if true, else the loop of get_event_async() and its response
+ * @param app_ms time the application takes for each downlink
+ * @param[out] events_read events read by the rounds
+ * @return average time to empty the fifo, from the notification seen to the last event read
+ */
+static double run_event_drain(bool is_pipelined, uint32_t app_ms, uint32_t *events_read)
+{
+    uint8_t payload[BENCH_UPLINK_SIZE] = {0};
+    uint64_t total_us = 0;
+    mcm_emulator_stats_t emu;
+
+    drain_app_ms = app_ms;
+    mcm.set_on_rx_callback(on_drain_downlink);
+    emulator.reset_stats();
+    for (uint32_t round = 0; round < BENCH_DRAIN_ROUNDS; round++)
+    {
+        for (uint8_t i = 0; i < MAX_PENDING_MESSAGES; i++)
+        {
+            payload[0] = i;
+            emulator.queue_downlink(payload, sizeof(payload), BENCH_UPLINK_PORT);
+        }
+        emulator.notify();
+
+        // notification only, the drain of handle_rx_events() is not started
+        uint32_t start_ms = millis();
+        while ((MAX_PENDING_MESSAGES != api_processor_get_pending_events(mcm.get_module_handle())) &&
+               ((millis() - start_ms) < BENCH_DRAIN_TIMEOUT_MS))
+        {
+            mcm.poll();
+            delay(1);
+        }
+
+        uint64_t drain_us = micros();
+        if (is_pipelined)
+        {
+            mcm.drain_pending_events();
+        }
+        else
+        {
+            // before the pipelined drain, each event was requested once the previous one was read
+            while ((0 < api_processor_get_pending_events(mcm.get_module_handle())) &&
+                   (MCM_STATUS::MCM_OK == mcm.get_event_async()))
+            {
+                // same wait as wait_for_command(), the rx queue is polled until the response
+                while (mcm.is_command_pending())
+                {
+                    mcm.poll();
+                    delay(1);
+                }
+            }
+        }
+        total_us += micros() - drain_us;
+        run_loop(1);
+    }
+
+    mcm.set_on_rx_callback(nullptr);
+    emulator.get_stats(&emu);
+    *events_read = emu.events_read;
+    return (total_us / 1000.0) / BENCH_DRAIN_ROUNDS;
+}
+
+static int run_device(const char *path)
+{
+    host_os_set_clock(HOST_CLOCK_REAL);
+    modem_port.begin(MCM_EMULATOR_BAUD_RATE);
+    if (!modem_port.attach_device(path))
+    {
+        fprintf(stderr, "unable to open %s\n", path);
+        return 1;
+    }
+    emulator.set_log(stdout);
+    if (!emulator.begin())
+    {
+        return 1;
+    }
+    printf("MCM emulator on %s\n", path);
+    fflush(stdout);
+
+    for (;;)
+    {
+        delay(1000);
+        fflush(stdout);
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint32_t uplinks = BENCH_DEFAULT_UPLINKS;
+    uint32_t seed = 1;
+    bool is_verbose = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "vn:s:d:")) != -1)
+    {
+        switch (option)
+        {
+        case 'v':
+            is_verbose = true;
+            break;
+        case 'n':
+            uplinks = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            return run_device(optarg);
+        default:
+            fprintf(stderr, "usage: %s [-v] [-n uplinks] [-s seed] | -d tty\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!check_downlink_pool())
+    {
+        return 1;
+    }
+    host_os_set_clock(HOST_CLOCK_VIRTUAL);
+    host_os_set_restart_handler(on_restart);
+    SPIFFS.begin(true);
+    // firmware console is the noise of the run, the results are printed on stdout
+    Serial.attach_output(NULL);
+    emulator.set_log(is_verbose ? stderr : NULL);
+
+    modem_port.begin(MCM_EMULATOR_BAUD_RATE);
+    modem_port.attach_line(Serial1);
+    mcm_emulator_config_t config = McmEmulator::get_default_config();
+    config.seed = seed;
+    emulator.set_config(config);
+    if (!emulator.begin() || (MCM_STATUS::MCM_OK != mcm.begin()))
+    {
+        fprintf(stderr, "unable to start the emulator or the mcm\n");
+        return 1;
+    }
+    mcm.ymodem.setPartition(&partition);
+    mcm.set_host_app_version({1, 0, 0});
+    mcm.set_connect_mode(ConnectionMode::CONNECTION_MODE_LORAWAN);
+
+    // reset event of the power up
+    run_loop(500);
+    uint32_t join_ms = 0;
+    if (!join(&join_ms))
+    {
+        fprintf(stderr, "join failed\n");
+        return 1;
+    }
+    printf("joined in %u ms, %u uplinks of %u B per scenario, seed %u, %u baud\n\n", join_ms, uplinks,
+           (unsigned)BENCH_UPLINK_SIZE, seed, (unsigned)MCM_EMULATOR_BAUD_RATE);
+    printf("%-28s %5s %4s %4s %6s %6s %7s %7s %7s %5s %5s %4s %4s %4s %6s %8s\n", "scenario", "done", "tmo",
+           "fail", "rtt50", "rtt99", "rttmax", "txd50", "txd99", "notxd", "dl", "lost", "crc", "sync", "up/min",
+           "x real");
+
+    uint8_t patch = 3;
+    for (size_t s = 0; s < sizeof(bench_scenarios) / sizeof(bench_scenarios[0]); s++)
+    {
+        const bench_scenario_t *scenario = &bench_scenarios[s];
+        config.response_delay_us = scenario->response_delay_us;
+        config.response_jitter_us = scenario->response_jitter_us;
+        config.loss_pct = scenario->loss_pct;
+        config.crc_error_pct = scenario->crc_error_pct;
+        config.is_coalesced = scenario->is_coalesced;
+        config.downlink_pct = scenario->downlink_pct;
+        config.seed = seed + s;
+        emulator.set_config(config);
+        emulator.reset_stats();
+
+        if (scenario->is_file)
+        {
+            run_file_transfer(scenario, patch++);
+        }
+        else
+        {
+            run_uplinks(scenario, uplinks);
+        }
+    }
+
+    config = McmEmulator::get_default_config();
+    config.seed = seed;
+    emulator.set_config(config);
+    printf("\n%-28s %8s %8s %9s %8s %6s\n", "fifo drain", "app ms", "single", "pipelined", "read", "gain");
+    const uint32_t app_costs_ms[] = {0, BENCH_DRAIN_APP_MS};
+    for (size_t c = 0; c < sizeof(app_costs_ms) / sizeof(app_costs_ms[0]); c++)
+    {
+        uint32_t single_events = 0;
+        uint32_t pipelined_events = 0;
+        double single_ms = run_event_drain(false, app_costs_ms[c], &single_events);
+        double pipelined_ms = run_event_drain(true, app_costs_ms[c], &pipelined_events);
+        printf("%-28s %8u %8.1f %9.1f %4u/%-3u %5.2fx\n", "full fifo", app_costs_ms[c], single_ms, pipelined_ms,
+               single_events, pipelined_events, (pipelined_ms > 0) ? single_ms / pipelined_ms : 0.0);
+    }
+
+    printf("\nrtt: uplink request to its response, txd: to the TXDONE event, notxd: TXDONE lost, dl: downlinks read\n");
+    printf("lost: events of a full fifo, crc and sync: bad frames seen by the reassembler, x real: virtual over wall time\n");
+    printf("fifo drain: ms to read %u events, single: one GET_EVENT at a time, pipelined: drain_pending_events()\n",
+           (unsigned)MAX_PENDING_MESSAGES);
+    return 0;
+}
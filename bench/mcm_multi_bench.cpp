@@ -0,0 +1,348 @@
+/**
+ * @file mcm_multi_bench.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Several MCM instances, each against its own emulated modem, built by the native_multi environment
+ *        pio run -e native_multi && .pio/build/native_multi/program [-n uplinks] [-s seed]
+ *        -n  uplinks of each modem in each round, 50 by default
+ *        -s  seed of the modems, a run is repeated exactly with the same seed
+ *        Each modem is driven by its own task, the even ones on lorawan, the odd ones on
+ *        sidewalk fsk, like a gateway board with one modem per uart. The rounds run 1, 2 and
+ *        BENCH_MAX_MODEMS of them side by side on the virtual clock. Every modem reports its
+ *        own firmware version and echoes the uplinks of its instance only, so a version, an
+ *        event or a downlink which reaches the wrong MCM is counted as a leak. The uplink rate
+ *        of a round is the sum over its modems, it grows with their count as long as nothing
+ *        is shared between the instances.
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "mcm_emulator.h"
+#include "mcm_rover.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define BENCH_MAX_MODEMS 4
+#define BENCH_DEFAULT_UPLINKS 50
+#define BENCH_UPLINK_PORT 2
+#define BENCH_UPLINK_SIZE 24
+#define BENCH_DOWNLINK_PCT 50
+#define BENCH_JOIN_TIMEOUT_MS 60000
+#define BENCH_TXDONE_TIMEOUT_MS 10000
+#define BENCH_ROUND_TIMEOUT_MS (60 * 60 * 1000)
+#define BENCH_DEVICE_UART 10                // first uart of the mcm instances, the modems follow them
+#define BENCH_MODEM_UART (BENCH_DEVICE_UART + BENCH_MAX_MODEMS)
+#define BENCH_TASK_STACK_SIZE 8192
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+/**
+ * @brief One modem and the MCM instance driving it, with what the instance saw
+ */
+typedef struct
+{
+    uint8_t index;
+    HardwareSerial *device_port;
+    HardwareSerial *modem_port;
+    McmEmulator *emulator;
+    MCM *mcm;
+    uint32_t uplinks;           // to send in the round
+    uint32_t done;              // uplinks with their TXDONE event
+    uint32_t failed;            // request failed or TXDONE event missing
+    uint32_t downlinks;         // echoes of this instance
+    uint32_t leaks;             // version, event or downlink of another instance
+    bool is_version_ok;
+    bool is_running;
+} bench_link_t;
+
+typedef struct
+{
+    bool is_complete;
+    MCM_CMD_STATUS status;
+} bench_uplink_t;
+
+/******************************************************************************
+ * PRIVATE VARIABLES
+ ******************************************************************************/
+static bench_link_t bench_links[BENCH_MAX_MODEMS];
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void on_uplink_complete(mrover_cc_codes_t cmd_code, MCM_CMD_STATUS status, mrover_return_code_t return_code,
+                               void *user_ctx)
+{
+    bench_uplink_t *uplink = (bench_uplink_t *)user_ctx;
+    uplink->is_complete = true;
+    uplink->status = status;
+}
+
+static double wall_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Events and downlinks of the instance, every echo must carry its index
+ */
+static void run_loop(bench_link_t *link)
+{
+    link->mcm->handle_rx_events();
+    while (link->mcm->is_downlink_available())
+    {
+        uint8_t data[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+        uint16_t len;
+        int8_t rssi, snr;
+        uint16_t seq_port;
+        link->mcm->get_downlink_data(data, &len, &rssi, &snr, &seq_port);
+        if ((BENCH_UPLINK_SIZE == len) && (link->index == data[0]))
+        {
+            link->downlinks++;
+        }
+        else
+        {
+            link->leaks++;
+        }
+    }
+    delay(1);
+}
+
+static bool join(bench_link_t *link)
+{
+    uint32_t start_ms = millis();
+
+    if (MCM_STATUS::MCM_OK != link->mcm->connect_network_async())
+    {
+        return false;
+    }
+    while (!link->mcm->is_connected() && ((millis() - start_ms) < BENCH_JOIN_TIMEOUT_MS))
+    {
+        run_loop(link);
+    }
+    return link->mcm->is_connected();
+}
+
+static void link_task(void *arg)
+{
+    bench_link_t *link = (bench_link_t *)arg;
+    char expected[32];
+
+    do
+    {
+        // the version response of another modem would show its patch number
+        snprintf(expected, sizeof(expected), "Modem firmware: 2.1.%u\n", link->index + 1);
+        link->is_version_ok = (link->mcm->print_version().indexOf(expected) >= 0);
+        if (!link->is_version_ok)
+        {
+            link->leaks++;
+        }
+
+        if (!link->mcm->is_connected() && !join(link))
+        {
+            link->failed = link->uplinks;
+            break;
+        }
+
+        for (uint32_t i = 0; i < link->uplinks; i++)
+        {
+            uint8_t payload[BENCH_UPLINK_SIZE];
+            bench_uplink_t uplink = {};
+
+            memset(payload, 0, sizeof(payload));
+            payload[0] = link->index;
+            memcpy(&payload[1], &i, sizeof(i));
+            if (MCM_STATUS::MCM_OK != link->mcm->send_uplink_async(payload, sizeof(payload), BENCH_UPLINK_PORT,
+                                                                   MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF,
+                                                                   on_uplink_complete, &uplink))
+            {
+                // an event drain is in flight
+                run_loop(link);
+                i--;
+                continue;
+            }
+            while (!uplink.is_complete)
+            {
+                run_loop(link);
+            }
+
+            uint32_t wait_ms = millis();
+            while ((MCM_CMD_STATUS::MCM_CMD_DONE == uplink.status) && link->mcm->is_last_uplink_pending() &&
+                   ((millis() - wait_ms) < BENCH_TXDONE_TIMEOUT_MS))
+            {
+                run_loop(link);
+            }
+            if ((MCM_CMD_STATUS::MCM_CMD_DONE != uplink.status) || link->mcm->is_last_uplink_pending())
+            {
+                link->failed++;
+            }
+            else
+            {
+                link->done++;
+            }
+        }
+
+        // last echoes
+        uint32_t wait_ms = millis();
+        while ((millis() - wait_ms) < (McmEmulator::get_default_config().downlink_delay_ms * 3))
+        {
+            run_loop(link);
+        }
+    } while (0);
+
+    link->is_running = false;
+}
+
+/**
+ * @brief Runs the first modems side by side, each in its own task
+ */
+static bool run_round(uint8_t modems, uint32_t uplinks)
+{
+    uint32_t start_ms = millis();
+    double start_s = wall_seconds();
+
+    for (uint8_t m = 0; m < modems; m++)
+    {
+        bench_link_t *link = &bench_links[m];
+        link->uplinks = uplinks;
+        link->done = link->failed = link->downlinks = link->leaks = 0;
+        link->is_version_ok = false;
+        link->is_running = true;
+        link->emulator->reset_stats();
+        if (pdPASS != xTaskCreate(link_task, "bench_link", BENCH_TASK_STACK_SIZE, link, 1, NULL))
+        {
+            return false;
+        }
+    }
+
+    bool is_running = true;
+    while (is_running && ((millis() - start_ms) < BENCH_ROUND_TIMEOUT_MS))
+    {
+        delay(10);
+        is_running = false;
+        for (uint8_t m = 0; m < modems; m++)
+        {
+            is_running |= bench_links[m].is_running;
+        }
+    }
+
+    double wall_s = wall_seconds() - start_s;
+    double sim_s = (millis() - start_ms) / 1000.0;
+    uint32_t done = 0;
+    bool is_isolated = !is_running;
+    for (uint8_t m = 0; m < modems; m++)
+    {
+        bench_link_t *link = &bench_links[m];
+        mcm_emulator_stats_t emu;
+        link->emulator->get_stats(&emu);
+        // every event the modem handed out was taken by its own instance, none got lost
+        bool is_events_ok = (emu.events_read == emu.events_queued) && (0 == emu.events_lost);
+        // and it sent the uplinks of its instance only
+        is_isolated &= (emu.uplinks == link->done);
+        is_isolated &= link->is_version_ok && is_events_ok && (0 == link->leaks) && (0 == link->failed);
+        done += link->done;
+        printf("  modem %u %-13s %5u %6u %4u %6u %6u %5u %7s %6s\n", m,
+               (m & 1) ? "sidewalk fsk" : "lorawan", link->done, link->failed, emu.events_read, emu.uplinks,
+               link->downlinks, link->leaks, link->is_version_ok ? "ok" : "BAD", is_events_ok ? "ok" : "BAD");
+    }
+    printf("%u modems: %u uplinks in %.1f s, %.1f up/min, %.2f s wall, %s\n\n", modems, done, sim_s,
+           (done * 60.0) / sim_s, wall_s, is_isolated ? "isolated" : "NOT ISOLATED");
+    return is_isolated;
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    uint32_t uplinks = BENCH_DEFAULT_UPLINKS;
+    uint32_t seed = 1;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (option)
+        {
+        case 'n':
+            uplinks = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n uplinks] [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host_os_set_clock(HOST_CLOCK_VIRTUAL);
+    // firmware console is the noise of the run, the results are printed on stdout
+    Serial.attach_output(NULL);
+
+    for (uint8_t m = 0; m < BENCH_MAX_MODEMS; m++)
+    {
+        bench_link_t *link = &bench_links[m];
+        link->index = m;
+        link->device_port = new HardwareSerial(BENCH_DEVICE_UART + m);
+        link->modem_port = new HardwareSerial(BENCH_MODEM_UART + m);
+        link->emulator = new McmEmulator(*link->modem_port);
+        link->mcm = new MCM(*link->device_port, 0, 0, 0);
+
+        link->modem_port->begin(MCM_EMULATOR_BAUD_RATE);
+        link->modem_port->attach_line(*link->device_port);
+        mcm_emulator_config_t config = McmEmulator::get_default_config();
+        config.seed = seed + m;
+        config.downlink_pct = BENCH_DOWNLINK_PCT;
+        config.firmware_version[2] = m + 1;
+        link->emulator->set_config(config);
+        if (!link->emulator->begin() || (MCM_STATUS::MCM_OK != link->mcm->begin()))
+        {
+            fprintf(stderr, "unable to start modem %u\n", m);
+            return 1;
+        }
+        link->mcm->set_connect_mode((m & 1) ? ConnectionMode::CONNECTION_MODE_SIDEWALK_FSK
+                                            : ConnectionMode::CONNECTION_MODE_LORAWAN);
+    }
+    // reset events of the power up
+    uint32_t start_ms = millis();
+    while ((millis() - start_ms) < 500)
+    {
+        for (uint8_t m = 0; m < BENCH_MAX_MODEMS; m++)
+        {
+            bench_links[m].mcm->handle_rx_events();
+        }
+        delay(1);
+    }
+
+    printf("%u uplinks of %u B per modem and round, %u%% echoed as downlinks, seed %u, %u baud\n\n", uplinks,
+           (unsigned)BENCH_UPLINK_SIZE, (unsigned)BENCH_DOWNLINK_PCT, seed, (unsigned)MCM_EMULATOR_BAUD_RATE);
+    printf("  %-21s %5s %6s %4s %6s %6s %5s %7s %6s\n", "", "done", "failed", "evts", "sent", "dl", "leaks",
+           "version", "events");
+
+    bool is_isolated = true;
+    for (uint8_t modems = 1; modems <= BENCH_MAX_MODEMS; modems *= 2)
+    {
+        is_isolated &= run_round(modems, uplinks);
+    }
+
+    printf("evts: events read from the modem, sent: uplinks it sent on air, dl: echoes read by its own instance\n");
+    printf("leaks: version, event or downlink of another instance, up/min: all the modems of the round\n");
+    return is_isolated ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file parse_rx_fuzz.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Fuzzing harness of the receive path, built by the native_fuzz environment
+ *        pio run -e native_fuzz && .pio/build/native_fuzz/program [seconds]
+ *        The same file is a libFuzzer target when built with -fsanitize=fuzzer -DFUZZ_LIBFUZZER
+ * @version 0.1
+ * @date 2025-01-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "api_processor.h"
+#include "frame_parse.h"
+#include "trace_buffer.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define FUZZ_MAX_INPUT              (4 * MAX_SERIAL_RECEIVE_PAYLOAD_SIZE)
+#define FUZZ_DEFAULT_SECONDS        10
+#define FUZZ_REPORT_EXECS           100000
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static mcm_module_hdl_t fuzz_module;
+static bool fuzz_is_init = false;
+static volatile uint32_t fuzz_sink;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint16_t fuzz_send(uint8_t *data, uint16_t size, void *ctx)
+{
+    return size;
+}
+
+static void fuzz_notification(void *ctx)
+{
+    fuzz_sink ^= api_processor_get_pending_events(&fuzz_module);
+}
+
+/**
+ * @brief Reads every field the application reads, so the sanitizers see a bad pointer or length
+ */
+static void fuzz_response(const api_processor_response_t *response, void *ctx)
+{
+    uint8_t payload[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+
+    if ((MROVER_RC_OK != response->return_code) || (MROVER_CC_GET_EVENT != response->cmd_code))
+    {
+        return;
+    }
+
+    if (MODEM_EVENT_DOWNDATA == mcm_helper_get_event_code(response))
+    {
+        int8_t rssi;
+        int8_t snr;
+        uint16_t port_seq;
+        uint16_t len = mcm_helper_get_downlink_len(response);
+        if (len > sizeof(payload))
+        {
+            abort();
+        }
+        mcm_helper_get_downlink_data(response, &rssi, &snr, payload, &port_seq);
+        fuzz_sink ^= payload[0] ^ (uint32_t)rssi ^ (uint32_t)snr ^ port_seq;
+    }
+}
+
+/**
+ * @brief Trace records are formatted and dropped, so every trace site runs with the sanitizers
+ */
+static void fuzz_trace_output(const char *p_line)
+{
+    fuzz_sink ^= (uint8_t)p_line[0];
+}
+
+static void fuzz_init(void)
+{
+    if (!fuzz_is_init)
+    {
+        trace_buffer_set_platform_cb(NULL, NULL, NULL, fuzz_trace_output);
+        api_processor_init(&fuzz_module, fuzz_send, fuzz_notification, fuzz_response);
+        fuzz_is_init = true;
+    }
+}
+
+/**
+ * @brief Runs one input, the first byte selects the entry point
+ *        even: serial stream through the reassembler, odd: frame from an external reassembler
+ */
+static void fuzz_one(const uint8_t *p_data, size_t len)
+{
+    if ((0 == len) || (len > FUZZ_MAX_INPUT))
+    {
+        return;
+    }
+
+    // copy so the parser can not rely on bytes past the end of the input
+    uint16_t u16_len = (uint16_t)(len - 1);
+    uint8_t *p_copy = (uint8_t *)malloc(u16_len ? u16_len : 1);
+    memcpy(p_copy, &p_data[1], u16_len);
+
+    if (p_data[0] & 0x01)
+    {
+        api_processor_parse_rx_frame(&fuzz_module, p_copy, u16_len);
+    }
+    else
+    {
+        api_processor_parse_rx_data(&fuzz_module, p_copy, u16_len);
+    }
+    free(p_copy);
+
+    trace_buffer_flush(UINT16_MAX);
+}
+
+#ifdef FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_init();
+    fuzz_one(data, size);
+    return 0;
+}
+
+#else
+
+/********************** standalone driver **********************/
+static uint32_t fuzz_rng_state = 0x12345678;
+
+static uint32_t fuzz_rand(void)
+{
+    // xorshift32
+    fuzz_rng_state ^= fuzz_rng_state << 13;
+    fuzz_rng_state ^= fuzz_rng_state >> 17;
+    fuzz_rng_state ^= fuzz_rng_state << 5;
+    return fuzz_rng_state;
+}
+
+static uint64_t fuzz_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Appends a response or notification frame, mostly well formed so the payload parsers are reached
+ */
+static uint16_t fuzz_make_frame(uint8_t *p_out, uint16_t u16_room)
+{
+    static const uint16_t cmd_codes[] = {
+        MROVER_CC_GET_EVENT, MROVER_CC_GET_EVENT, MROVER_CC_GET_EVENT, MROVER_CC_GET_VERSION,
+        MROVER_CC_GET_DEV_EUI, MROVER_CC_REQUEST_UPLINK, MROVER_CC_GET_LORAWAN_CLASS, MROVER_CC_FILE_STATUS};
+    static const uint8_t event_codes[] = {
+        MODEM_EVENT_RESET, MODEM_EVENT_TXDONE, MODEM_EVENT_DOWNDATA, MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD,
+        MODEM_EVENT_CLASS_SWITCHED, MODEM_EVENT_NONE, MODEM_EVENT_JOINED};
+    uint16_t u16_payload_len;
+    uint16_t u16_len;
+
+    if (u16_room < FP_RESPONSE_FRAME_OVERHEAD)
+    {
+        return 0;
+    }
+
+    if (0 == (fuzz_rand() % 8))
+    {
+        // notification
+        p_out[0] = MROVER_RC_NOTIFY_EVENTS;
+        p_out[1] = 0;
+        p_out[2] = 1;
+        p_out[3] = fuzz_rand() % 12;
+        u16_len = 5;
+    }
+    else
+    {
+        uint16_t u16_cmd_code = cmd_codes[fuzz_rand() % (sizeof(cmd_codes) / sizeof(cmd_codes[0]))];
+        u16_payload_len = fuzz_rand() % 12;
+        if (0 == (fuzz_rand() % 16))
+        {
+            u16_payload_len = fuzz_rand() % (MAX_SERIAL_RECEIVE_PAYLOAD_SIZE - FP_RESPONSE_FRAME_OVERHEAD + 1);
+        }
+        if (u16_payload_len > (u16_room - FP_RESPONSE_FRAME_OVERHEAD))
+        {
+            u16_payload_len = u16_room - FP_RESPONSE_FRAME_OVERHEAD;
+        }
+        p_out[0] = (0 == (fuzz_rand() % 8)) ? (fuzz_rand() & 0x0F) : MROVER_RC_OK;
+        p_out[1] = 1 + (fuzz_rand() % 3);
+        p_out[2] = u16_cmd_code >> 8;
+        p_out[3] = u16_cmd_code & 0xFF;
+        p_out[4] = u16_payload_len >> 8;
+        p_out[5] = u16_payload_len & 0xFF;
+        for (uint16_t i = 0; i < u16_payload_len; i++)
+        {
+            p_out[FP_RESPONSE_HEADER_LEN + i] = fuzz_rand();
+        }
+        if ((MROVER_CC_GET_EVENT == u16_cmd_code) && (0 != u16_payload_len))
+        {
+            p_out[FP_RESPONSE_HEADER_LEN] = event_codes[fuzz_rand() % sizeof(event_codes)];
+        }
+        u16_len = FP_RESPONSE_FRAME_OVERHEAD + u16_payload_len;
+    }
+    p_out[u16_len - 1] = fp_crc_update(0, p_out, u16_len - 1);
+
+    return u16_len;
+}
+
+/**
+ * @brief Breaks the input the way a noisy line or a buggy modem would
+ */
+static void fuzz_mutate(uint8_t *p_data, uint16_t *p_len)
+{
+    uint8_t u8_count = fuzz_rand() % 4;
+
+    for (uint8_t i = 0; (i < u8_count) && (*p_len > 1); i++)
+    {
+        uint16_t u16_pos = 1 + (fuzz_rand() % (*p_len - 1));
+        switch (fuzz_rand() % 4)
+        {
+        case 0:
+            p_data[u16_pos] ^= (uint8_t)(1 << (fuzz_rand() % 8));
+            break;
+        case 1:
+            p_data[u16_pos] = fuzz_rand();
+            break;
+        case 2:
+            *p_len = u16_pos;
+            break;
+        default:
+            // a length field which does not match the frame, with the crc fixed up
+            if (*p_len > FP_RESPONSE_HEADER_LEN)
+            {
+                p_data[1 + 5] = fuzz_rand();
+                p_data[*p_len - 1] = fp_crc_update(0, &p_data[1], *p_len - 2);
+            }
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t input[FUZZ_MAX_INPUT];
+    uint32_t u32_seconds = (argc > 1) ? (uint32_t)atoi(argv[1]) : FUZZ_DEFAULT_SECONDS;
+    uint64_t u64_start = fuzz_now_ns();
+    uint64_t u64_last = u64_start;
+    uint64_t u64_execs = 0;
+    uint64_t u64_bytes = 0;
+
+    fuzz_init();
+
+    do
+    {
+        uint16_t u16_len = 1;
+        input[0] = fuzz_rand();
+        uint8_t u8_frames = 1 + (fuzz_rand() % 4);
+        for (uint8_t i = 0; i < u8_frames; i++)
+        {
+            u16_len += fuzz_make_frame(&input[u16_len], sizeof(input) - u16_len);
+        }
+        fuzz_mutate(input, &u16_len);
+
+        fuzz_one(input, u16_len);
+        u64_execs++;
+        u64_bytes += u16_len;
+
+        if (0 == (u64_execs % FUZZ_REPORT_EXECS))
+        {
+            uint64_t u64_now = fuzz_now_ns();
+            printf("#%llu exec/s %.0f bytes/s %.0f\n", (unsigned long long)u64_execs,
+                   (FUZZ_REPORT_EXECS * 1e9) / (double)(u64_now - u64_last),
+                   ((double)u64_bytes * 1e9) / (double)(u64_now - u64_start));
+            u64_last = u64_now;
+        }
+    } while ((fuzz_now_ns() - u64_start) < ((uint64_t)u32_seconds * 1000000000ULL));
+
+    printf("done %llu execs in %u s, %.0f exec/s\n", (unsigned long long)u64_execs, u32_seconds,
+           (double)u64_execs / (double)u32_seconds);
+
+    return 0;
+}
+
+#endif // FUZZ_LIBFUZZER
@@ -0,0 +1,894 @@
+/**
+ * @file protocol_bench.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Microbenchmarks of the protocol core, built by the native environment
+ *        pio run -e native && .pio/build/native/program
+ * @version 0.1
+ * @date 2025-01-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "api_processor.h"
+#include "frame_parse.h"
+#include "host_fuota.h"
+#include "checksum.h"
+#include "fw_digest.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define BENCH_MIN_TIME_NS           (200ULL * 1000ULL * 1000ULL)   // each case runs at least this long
+#define BENCH_BATCH                 1000
+#define BENCH_STREAM_FRAMES         64
+#define BENCH_CHUNK_MAX             64      // uart reads are split at 1..64 bytes
+#define BENCH_CHUNK_SPLITS          256     // random split patterns checked against the single feed
+#define BENCH_YMODEM_BLOCK_SIZE     1024
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+/**
+ * @brief Single operation of a case, returns the number of bytes processed
+ */
+typedef uint32_t (*bench_op_t)(void);
+
+typedef struct
+{
+    const char *p_name;
+    bench_op_t op;
+} bench_case_t;
+
+typedef struct
+{
+    uint8_t u8_frame[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+    uint16_t u16_len;
+} bench_frame_t;
+
+/**
+ * @brief Frames emitted by the reassembler, compared one by one with the frames put in the stream
+ */
+typedef struct
+{
+    uint16_t u16_frames;
+    uint16_t u16_mismatches;
+} bench_frame_check_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static mcm_module_hdl_t bench_module;
+static mcm_module_hdl_t bench_copy_module;     // sends the whole frame into the uart fifo
+static mcm_module_hdl_t bench_vec_module;      // sends the frame parts into the uart fifo
+static uint8_t bench_uart_fifo[MAX_SERIAL_SEND_PAYLOAD_SIZE];
+static uint32_t bench_sent_bytes;
+static volatile uint32_t bench_sink;
+
+static uint8_t bench_eui[LORAWAN_DEV_EUI_JOIN_EUI_LEN] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77};
+static uint8_t bench_key[16] = {0};
+static uint8_t bench_payload[64] = {0};
+
+static bench_frame_t bench_event_frames[API_METRICS_EVENT_CODES];
+static uint8_t bench_event_count;
+static bench_frame_t bench_response_frame;
+static bench_frame_t bench_notify_frame;
+static bench_frame_t bench_bad_code_frame;
+static bench_frame_t bench_bad_crc_frame;
+static uint8_t bench_stream[BENCH_STREAM_FRAMES * MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+static uint16_t bench_stream_len;
+static fp_reassembler_t bench_reassembler;
+static uint8_t bench_chunks[BENCH_STREAM_FRAMES * MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+static uint16_t bench_chunk_count;
+static get_seg_file_status_t bench_seg_status;
+static uint8_t bench_block[BENCH_YMODEM_BLOCK_SIZE];
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Time stamp counter, 0 where there is none, the cycles column then reads 0
+ */
+static uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint16_t bench_send(uint8_t *data, uint16_t size, void *ctx)
+{
+    bench_sent_bytes += size;
+    bench_sink ^= data[size - 1];
+    return size;
+}
+
+/**
+ * @brief Copies the frame into the uart fifo, as HardwareSerial::write() does with the tx ring
+ */
+static uint16_t bench_send_copy(uint8_t *data, uint16_t size, void *ctx)
+{
+    memcpy(bench_uart_fifo, data, size);
+    bench_sent_bytes += size;
+    bench_sink ^= bench_uart_fifo[size - 1];
+    return size;
+}
+
+/**
+ * @brief Copies the frame parts into the uart fifo one write() per part, as MCM::on_send_vec_function() does
+ */
+static uint16_t bench_send_vec(const serial_iovec_t *p_iov, uint8_t u8_iov_count, void *ctx)
+{
+    uint16_t u16_size = 0;
+
+    for (uint8_t i = 0; i < u8_iov_count; i++)
+    {
+        memcpy(&bench_uart_fifo[u16_size], p_iov[i].p_data, p_iov[i].u16_len);
+        u16_size += p_iov[i].u16_len;
+    }
+    bench_sent_bytes += u16_size;
+    bench_sink ^= bench_uart_fifo[u16_size - 1];
+    return u16_size;
+}
+
+static void bench_notification(void *ctx)
+{
+}
+
+static void bench_response(const api_processor_response_t *response, void *ctx)
+{
+    bench_sink ^= (uint32_t)response->cmd_code;
+}
+
+static void bench_on_frame(uint8_t *p_frame, uint16_t u16_len, void *ctx)
+{
+    bench_sink ^= u16_len;
+}
+
+static void bench_check_frame(uint8_t *p_frame, uint16_t u16_len, void *ctx)
+{
+    bench_frame_check_t *p_check = (bench_frame_check_t *)ctx;
+    const bench_frame_t *p_expected = &bench_event_frames[p_check->u16_frames % bench_event_count];
+
+    if ((u16_len != p_expected->u16_len) || (0 != memcmp(p_frame, p_expected->u8_frame, u16_len)))
+    {
+        p_check->u16_mismatches++;
+    }
+    p_check->u16_frames++;
+}
+
+/**
+ * @brief Splits the stream at random points, chunks of 1..BENCH_CHUNK_MAX bytes
+ */
+static void bench_split_stream(uint32_t *p_seed)
+{
+    uint16_t u16_left = bench_stream_len;
+
+    bench_chunk_count = 0;
+    while (u16_left > 0)
+    {
+        // xorshift32, the same splits on every run
+        *p_seed ^= *p_seed << 13;
+        *p_seed ^= *p_seed >> 17;
+        *p_seed ^= *p_seed << 5;
+        uint8_t u8_chunk = 1 + (*p_seed % BENCH_CHUNK_MAX);
+        if (u8_chunk > u16_left)
+        {
+            u8_chunk = u16_left;
+        }
+        bench_chunks[bench_chunk_count++] = u8_chunk;
+        u16_left -= u8_chunk;
+    }
+}
+
+static void bench_feed_chunks(fp_reassembler_t *p_reassembler, fp_frame_cb frame_cb, void *ctx)
+{
+    uint16_t u16_offset = 0;
+
+    for (uint16_t i = 0; i < bench_chunk_count; i++)
+    {
+        fp_reassembler_feed(p_reassembler, &bench_stream[u16_offset], bench_chunks[i], frame_cb, ctx);
+        u16_offset += bench_chunks[i];
+    }
+}
+
+/**
+ * @brief Feeds the stream in one call and then at random split points, the frame sequence must be the same
+ * @return 0 if every split emitted the frames of the stream in order
+ */
+static int bench_check_chunked_feed(void)
+{
+    fp_reassembler_t h_reassembler;
+    bench_frame_check_t h_single = {0};
+    uint32_t u32_seed = 0x4F584954;
+    uint16_t u16_failed = 0;
+
+    fp_reassembler_init(&h_reassembler);
+    fp_reassembler_feed(&h_reassembler, bench_stream, bench_stream_len, bench_check_frame, &h_single);
+    if ((BENCH_STREAM_FRAMES != h_single.u16_frames) || (0 != h_single.u16_mismatches))
+    {
+        printf("single feed: %u frames, %u mismatches\n", h_single.u16_frames, h_single.u16_mismatches);
+        return 1;
+    }
+
+    for (uint16_t u16_split = 0; u16_split < BENCH_CHUNK_SPLITS; u16_split++)
+    {
+        bench_frame_check_t h_check = {0};
+
+        fp_reassembler_init(&h_reassembler);
+        bench_split_stream(&u32_seed);
+        bench_feed_chunks(&h_reassembler, bench_check_frame, &h_check);
+        if ((h_single.u16_frames != h_check.u16_frames) || (0 != h_check.u16_mismatches) ||
+            (0 != h_reassembler.u32_dropped_bytes) || fp_reassembler_has_partial_frame(&h_reassembler))
+        {
+            printf("split %u in %u chunks: %u frames, %u mismatches, %lu dropped bytes\n", u16_split, bench_chunk_count,
+                   h_check.u16_frames, h_check.u16_mismatches, (unsigned long)h_reassembler.u32_dropped_bytes);
+            u16_failed++;
+        }
+    }
+    printf("chunked feed: %u of %u random splits emitted the %u frames of the single feed\n",
+           BENCH_CHUNK_SPLITS - u16_failed, BENCH_CHUNK_SPLITS, h_single.u16_frames);
+
+    return (0 == u16_failed) ? 0 : 1;
+}
+
+/**
+ * @brief Builds a response frame [rc][type][cc][len][payload][crc]
+ */
+static void bench_build_response(bench_frame_t *p_frame, command_types_t cmd_type, mrover_cc_codes_t cmd_code,
+                                 const uint8_t *p_payload, uint16_t u16_payload_len)
+{
+    uint8_t *p = p_frame->u8_frame;
+
+    p[0] = MROVER_RC_OK;
+    p[1] = cmd_type;
+    p[2] = (cmd_code >> 8) & 0xFF;
+    p[3] = cmd_code & 0xFF;
+    p[4] = (u16_payload_len >> 8) & 0xFF;
+    p[5] = u16_payload_len & 0xFF;
+    memcpy(&p[6], p_payload, u16_payload_len);
+    p[6 + u16_payload_len] = fp_crc_update(0, p, 6 + u16_payload_len);
+    p_frame->u16_len = 7 + u16_payload_len;
+}
+
+static void bench_add_event(command_types_t cmd_type, get_event_code_t event_code, const uint8_t *p_data, uint16_t u16_data_len)
+{
+    uint8_t payload[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+
+    payload[0] = event_code;
+    payload[1] = 0;     // no more pending events
+    memcpy(&payload[2], p_data, u16_data_len);
+    bench_build_response(&bench_event_frames[bench_event_count++], cmd_type, MROVER_CC_GET_EVENT, payload, u16_data_len + 2);
+}
+
+static void bench_setup(void)
+{
+    static const uint8_t reset[] = {0x00, 0x01};
+    static const uint8_t tx_done[] = {MROVER_TX_DONE_WITH_ACK};
+    static const uint8_t class_switch[] = {MROVER_LORAWAN_CLASS_C};
+    static const uint8_t seg[sizeof(get_seg_file_status_t)] = {0x01, 1, 2, 3, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00};
+    static const get_event_code_t no_data[] = {
+        MODEM_EVENT_ALARM, MODEM_EVENT_JOINED, MODEM_EVENT_UPLOADDONE, MODEM_EVENT_SETCONF, MODEM_EVENT_MUTE,
+        MODEM_EVENT_STREAMDONE, MODEM_EVENT_JOINFAIL, MODEM_EVENT_TIME, MODEM_EVENT_TIMEOUT_ADR_CHANGED,
+        MODEM_EVENT_NEW_LINK_ADR, MODEM_EVENT_LINK_CHECK, MODEM_EVENT_ALMANAC_UPDATE, MODEM_EVENT_USER_RADIO_ACCESS,
+        MODEM_EVENT_CLASS_B_PING_SLOT_INFO, MODEM_EVENT_CLASS_B_STATUS, MODEM_EVENT_LORAWAN_MAC_TIME, MODEM_EVENT_NONE};
+    uint8_t down_data[3 + 51];
+
+    api_processor_init(&bench_module, bench_send, bench_notification, bench_response);
+    api_processor_init(&bench_copy_module, bench_send_copy, bench_notification, bench_response);
+    api_processor_init(&bench_vec_module, bench_send_copy, bench_notification, bench_response);
+    api_processor_set_send_vec_cb(&bench_vec_module, bench_send_vec);
+
+    // rssi, snr, port and the largest DR0 payload
+    memset(down_data, 0x5A, sizeof(down_data));
+    down_data[0] = (uint8_t)-80;
+    down_data[1] = 7;
+    down_data[2] = 2;
+
+    bench_add_event(COMMAND_TYPE_GENERAL, MODEM_EVENT_RESET, reset, sizeof(reset));
+    bench_add_event(COMMAND_TYPE_LORAWAN, MODEM_EVENT_TXDONE, tx_done, sizeof(tx_done));
+    bench_add_event(COMMAND_TYPE_LORAWAN, MODEM_EVENT_DOWNDATA, down_data, sizeof(down_data));
+    bench_add_event(COMMAND_TYPE_GENERAL, MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD, seg, sizeof(seg));
+    bench_add_event(COMMAND_TYPE_LORAWAN, MODEM_EVENT_CLASS_SWITCHED, class_switch, sizeof(class_switch));
+    for (uint8_t i = 0; i < sizeof(no_data) / sizeof(no_data[0]); i++)
+    {
+        bench_add_event(COMMAND_TYPE_GENERAL, no_data[i], NULL, 0);
+    }
+
+    bench_build_response(&bench_response_frame, COMMAND_TYPE_LORAWAN, MROVER_CC_GET_EVENT, bench_event_frames[2].u8_frame + 6,
+                         bench_event_frames[2].u16_len - 7);
+
+    // [0x20][len][pending][crc]
+    bench_notify_frame.u8_frame[0] = MROVER_RC_NOTIFY_EVENTS;
+    bench_notify_frame.u8_frame[1] = 0;
+    bench_notify_frame.u8_frame[2] = LENGTH_IN_NOTIFICATION_PAYLOAD;
+    bench_notify_frame.u8_frame[3] = 1;
+    bench_notify_frame.u8_frame[4] = fp_crc_update(0, bench_notify_frame.u8_frame, 4);
+    bench_notify_frame.u16_len = MIN_RX_PAYLOAD_LEN;
+
+    // the downlink frame with its first byte garbled, then with its last one
+    bench_bad_code_frame = bench_response_frame;
+    bench_bad_code_frame.u8_frame[0] = 0xFF;
+    bench_bad_crc_frame = bench_response_frame;
+    bench_bad_crc_frame.u8_frame[bench_bad_crc_frame.u16_len - 1] ^= 0x01;
+
+    // back to back frames as they come from the uart
+    bench_stream_len = 0;
+    for (uint8_t i = 0; i < BENCH_STREAM_FRAMES; i++)
+    {
+        const bench_frame_t *p_frame = &bench_event_frames[i % bench_event_count];
+        memcpy(&bench_stream[bench_stream_len], p_frame->u8_frame, p_frame->u16_len);
+        bench_stream_len += p_frame->u16_len;
+    }
+    fp_reassembler_init(&bench_reassembler);
+
+    // 16 segments of 64k, all downloaded, so the whole bitmap is scanned
+    bench_seg_status.seg_size = SEG_SIZE_64;
+    bench_seg_status.pkg_size[0] = 0x10;
+    bench_seg_status.seg_status = 0x0000;
+
+    for (uint16_t i = 0; i < sizeof(bench_block); i++)
+    {
+        bench_block[i] = (uint8_t)(i * 31 + 7);
+    }
+}
+
+static void bench_run(const char *p_group, const bench_case_t *p_case)
+{
+    uint64_t u64_ops = 0;
+    uint64_t u64_bytes = 0;
+    uint64_t u64_start = bench_now_ns();
+    uint64_t u64_start_cycles = bench_cycles();
+    uint64_t u64_elapsed;
+
+    do
+    {
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            u64_bytes += p_case->op();
+        }
+        u64_ops += BENCH_BATCH;
+        u64_elapsed = bench_now_ns() - u64_start;
+    } while (u64_elapsed < BENCH_MIN_TIME_NS);
+    uint64_t u64_cycles = bench_cycles() - u64_start_cycles;
+
+    printf("%-14s %-32s %10.1f ns/op %9.1f cycles/op %12.0f bytes/s\n", p_group, p_case->p_name,
+           (double)u64_elapsed / (double)u64_ops, (double)u64_cycles / (double)u64_ops,
+           ((double)u64_bytes * 1e9) / (double)u64_elapsed);
+}
+
+/********************** frame encode **********************/
+#define BENCH_ENCODE(name, call)                                    \
+    static uint32_t bench_encode_##name(void)                       \
+    {                                                               \
+        bench_sent_bytes = 0;                                       \
+        call;                                                       \
+        return bench_sent_bytes;                                    \
+    }
+
+BENCH_ENCODE(get_event, api_processor_cmd_get_event(&bench_module))
+BENCH_ENCODE(get_version, api_processor_cmd_get_version(&bench_module))
+BENCH_ENCODE(reset, api_processor_cmd_reset(&bench_module))
+BENCH_ENCODE(factory_reset, api_processor_cmd_factory_reset(&bench_module))
+BENCH_ENCODE(switch_network, api_processor_cmd_switch_network(&bench_module))
+BENCH_ENCODE(init_lorawan, api_processor_cmd_init_lorawan(&bench_module))
+BENCH_ENCODE(set_join_eui, api_processor_cmd_set_join_eui(&bench_module, bench_eui, sizeof(bench_eui)))
+BENCH_ENCODE(set_dev_eui, api_processor_cmd_set_dev_eui(&bench_module, bench_eui, sizeof(bench_eui)))
+BENCH_ENCODE(set_nwk_key, api_processor_cmd_set_nwk_key(&bench_module, bench_key, sizeof(bench_key)))
+BENCH_ENCODE(get_dev_eui, api_processor_cmd_get_dev_eui(&bench_module))
+BENCH_ENCODE(get_join_eui, api_processor_cmd_get_join_eui(&bench_module))
+BENCH_ENCODE(join_lorawan, api_processor_cmd_join_lorawan(&bench_module))
+BENCH_ENCODE(lorawan_uplink, api_processor_cmd_request_lorawan_uplink(&bench_module, 2, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+BENCH_ENCODE(leave_lorawan, api_processor_cmd_leave_lorawan_network(&bench_module))
+BENCH_ENCODE(stop_lorawan, api_processor_cmd_stop_lorawan_network(&bench_module))
+BENCH_ENCODE(sid_ble_link, api_processor_cmd_sid_ble_link_request(&bench_module))
+BENCH_ENCODE(sid_ble_conn, api_processor_cmd_sid_ble_conn_request(&bench_module))
+BENCH_ENCODE(sid_fsk_link, api_processor_cmd_sid_fsk_link_request(&bench_module))
+BENCH_ENCODE(sid_css_link, api_processor_cmd_sid_css_link_request(&bench_module))
+BENCH_ENCODE(sid_css_profile, api_processor_cmd_sid_set_css_profile(&bench_module, MROVER_CSS_PWR_PROFILE_A))
+BENCH_ENCODE(sid_uplink, api_processor_cmd_sid_send_uplink(&bench_module, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+BENCH_ENCODE(sid_filter, api_processor_cmd_set_sid_downlink_filter(&bench_module, MROVER_SID_ENABLE_FILTERING))
+BENCH_ENCODE(sid_stop, api_processor_cmd_sid_stop(&bench_module))
+BENCH_ENCODE(set_class, api_processor_cmd_set_lorawan_class(&bench_module, MROVER_LORAWAN_CLASS_A))
+BENCH_ENCODE(get_class, api_processor_cmd_get_lorawan_class(&bench_module))
+BENCH_ENCODE(start_file_transfer, api_processor_cmd_start_file_transfer(&bench_module, (ver_type_1_t){1, 2, 3}))
+BENCH_ENCODE(file_status, api_processor_cmd_get_seg_file_transfer_status(&bench_module))
+BENCH_ENCODE(trigger_fw_update, api_processor_cmd_trigger_fw_update(&bench_module, (ver_type_1_t){1, 2, 3}))
+
+static const bench_case_t bench_encode_cases[] = {
+    {"get_event", bench_encode_get_event},
+    {"get_version", bench_encode_get_version},
+    {"reset", bench_encode_reset},
+    {"factory_reset", bench_encode_factory_reset},
+    {"switch_network", bench_encode_switch_network},
+    {"init_lorawan", bench_encode_init_lorawan},
+    {"set_join_eui", bench_encode_set_join_eui},
+    {"set_dev_eui", bench_encode_set_dev_eui},
+    {"set_nwk_key", bench_encode_set_nwk_key},
+    {"get_dev_eui", bench_encode_get_dev_eui},
+    {"get_join_eui", bench_encode_get_join_eui},
+    {"join_lorawan", bench_encode_join_lorawan},
+    {"lorawan_uplink 64B", bench_encode_lorawan_uplink},
+    {"leave_lorawan", bench_encode_leave_lorawan},
+    {"stop_lorawan", bench_encode_stop_lorawan},
+    {"sid_ble_link", bench_encode_sid_ble_link},
+    {"sid_ble_conn", bench_encode_sid_ble_conn},
+    {"sid_fsk_link", bench_encode_sid_fsk_link},
+    {"sid_css_link", bench_encode_sid_css_link},
+    {"sid_css_profile", bench_encode_sid_css_profile},
+    {"sid_uplink 64B", bench_encode_sid_uplink},
+    {"sid_filter", bench_encode_sid_filter},
+    {"sid_stop", bench_encode_sid_stop},
+    {"set_class", bench_encode_set_class},
+    {"get_class", bench_encode_get_class},
+    {"start_file_transfer", bench_encode_start_file_transfer},
+    {"file_status", bench_encode_file_status},
+    {"trigger_fw_update", bench_encode_trigger_fw_update},
+};
+
+/********************** frame send **********************/
+BENCH_ENCODE(lorawan_uplink_contiguous, api_processor_cmd_request_lorawan_uplink(&bench_copy_module, 2, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+BENCH_ENCODE(lorawan_uplink_vec, api_processor_cmd_request_lorawan_uplink(&bench_vec_module, 2, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+BENCH_ENCODE(sid_uplink_contiguous, api_processor_cmd_sid_send_uplink(&bench_copy_module, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+BENCH_ENCODE(sid_uplink_vec, api_processor_cmd_sid_send_uplink(&bench_vec_module, bench_payload, sizeof(bench_payload), MROVER_UNCONFIRMED_UPLINK))
+
+// the frame copied once into u8_send_payload and then into the fifo, against the parts copied into the fifo
+static const bench_case_t bench_send_cases[] = {
+    {"lorawan_uplink 64B contiguous", bench_encode_lorawan_uplink_contiguous},
+    {"lorawan_uplink 64B iovec", bench_encode_lorawan_uplink_vec},
+    {"sid_uplink 64B contiguous", bench_encode_sid_uplink_contiguous},
+    {"sid_uplink 64B iovec", bench_encode_sid_uplink_vec},
+};
+
+/********************** response parse **********************/
+static uint8_t bench_event_index;
+
+static uint32_t bench_parse_event(void)
+{
+    bench_frame_t *p_frame = &bench_event_frames[bench_event_index];
+    api_processor_parse_rx_frame(&bench_module, p_frame->u8_frame, p_frame->u16_len);
+    return p_frame->u16_len;
+}
+
+static uint32_t bench_parse_frame(const bench_frame_t *p_frame)
+{
+    bench_sink ^= api_processor_parse_rx_frame(&bench_module, (uint8_t *)p_frame->u8_frame, p_frame->u16_len);
+    return p_frame->u16_len;
+}
+
+static uint32_t bench_parse_notify(void)
+{
+    return bench_parse_frame(&bench_notify_frame);
+}
+
+/**
+ * @brief Frame rejected at its first byte, nothing else is read
+ */
+static uint32_t bench_parse_bad_code(void)
+{
+    return bench_parse_frame(&bench_bad_code_frame);
+}
+
+/**
+ * @brief Frame rejected by the crc check before the payload parser runs
+ */
+static uint32_t bench_parse_bad_crc(void)
+{
+    return bench_parse_frame(&bench_bad_crc_frame);
+}
+
+static const bench_case_t bench_parse_cases[] = {
+    {"notify", bench_parse_notify},
+    {"downlink 63B, bad return code", bench_parse_bad_code},
+    {"downlink 63B, bad crc", bench_parse_bad_crc},
+};
+
+/********************** validation **********************/
+static uint32_t bench_decode_header(void)
+{
+    fp_frame_header_t h_header;
+    bench_sink ^= fp_decode_frame_header(bench_response_frame.u8_frame, bench_response_frame.u16_len, &h_header);
+    bench_sink ^= h_header.u8_crc;
+    return FP_RESPONSE_HEADER_LEN;
+}
+
+static uint32_t bench_reassemble_stream(void)
+{
+    fp_reassembler_feed(&bench_reassembler, bench_stream, bench_stream_len, bench_on_frame, NULL);
+    return bench_stream_len;
+}
+
+static uint32_t bench_reassemble_chunks(void)
+{
+    bench_feed_chunks(&bench_reassembler, bench_on_frame, NULL);
+    return bench_stream_len;
+}
+
+static uint32_t bench_parse_stream(void)
+{
+    api_processor_parse_rx_data(&bench_module, bench_stream, bench_stream_len);
+    return bench_stream_len;
+}
+
+/********************** old multi pass validation **********************/
+// the validation of api_processor_parse_rx_frame() before fp_decode_frame_header(), kept to compare
+// the two paths: fp_is_frame_notification(), then fp_is_valid_notify_frame() and
+// fp_get_pending_event_count(), or fp_is_valid_response_frame() and the header decoded again
+// by api_processor_parse_response_frame(). The payload parser is the same on both paths.
+// The checks are kept out of line, as they were in frame_parser.c, so the compiler does not fold them
+// into the bench loop.
+#define BENCH_LEGACY_SLOT_ENTRY(cc, type, rsp_len_policy, rsp_len, parser, name)    [MROVER_CC_TABLE_SLOT(cc)] = {(cc), (type)},
+
+typedef struct
+{
+    uint16_t u16_cmd_code;
+    uint8_t u8_cmd_type;
+} bench_legacy_slot_t;
+
+static const bench_legacy_slot_t bench_legacy_slots[MROVER_CC_TABLE_SIZE] = {
+    MROVER_COMMAND_LIST(BENCH_LEGACY_SLOT_ENTRY)
+};
+
+static bool bench_legacy_is_valid_response_code(uint8_t u8_response_code)
+{
+    switch (u8_response_code)
+    {
+        case MROVER_RC_OK:
+        case MROVER_RC_UNKNOWN:
+        case MROVER_RC_NOT_IMPLEMENTED:
+        case MROVER_RC_FAIL:
+        case MROVER_RC_BAD_CRC:
+        case MROVER_RC_BAD_SIZE:
+        case MROVER_RC_NOTIFY_EVENTS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool bench_legacy_is_valid_command_type(uint8_t u8_command_type)
+{
+    return ((COMMAND_TYPE_GENERAL == u8_command_type) || (COMMAND_TYPE_LORAWAN == u8_command_type) ||
+            (COMMAND_TYPE_SIDEWALK == u8_command_type)) ? true : false;
+}
+
+static __attribute__((noinline)) fp_api_status_t bench_legacy_is_valid_response_frame(const uint8_t *data, uint16_t len)
+{
+    if ((FP_RESPONSE_FRAME_OVERHEAD > len) || (MAX_SERIAL_RECEIVE_PAYLOAD_SIZE < len) ||
+        ((FP_RESPONSE_FRAME_OVERHEAD + ((data[4] << 8) | data[5])) != len))
+    {
+        return FP_INVALID_PARAMETERS;
+    }
+    if (false == bench_legacy_is_valid_response_code(data[0]))
+    {
+        return FP_INVALID_RETURN_CODE;
+    }
+    if (false == bench_legacy_is_valid_command_type(data[1]))
+    {
+        return FP_INVALID_COMMAND_TYPE;
+    }
+
+    uint16_t u16_command_code = (data[2] << 8) | data[3];
+    const bench_legacy_slot_t *p_slot = &bench_legacy_slots[MROVER_CC_TABLE_SLOT(u16_command_code)];
+    if ((0 == p_slot->u8_cmd_type) || (u16_command_code != p_slot->u16_cmd_code))
+    {
+        return FP_INVALID_COMMAND_TYPE;
+    }
+
+    // the whole frame is XORed again, header included
+    if (checksum_xor8_update(CHECKSUM_XOR8_INIT, data, len - 1) != data[len - 1])
+    {
+        return FP_INVALID_CRC;
+    }
+    return FP_SUCCESS;
+}
+
+static __attribute__((noinline)) fp_api_status_t bench_legacy_is_valid_notify_frame(const uint8_t *data, uint16_t len)
+{
+    if ((MIN_RX_PAYLOAD_LEN > len) || (checksum_xor8_update(CHECKSUM_XOR8_INIT, data, len - 1) != data[len - 1]) ||
+        (LENGTH_IN_NOTIFICATION_PAYLOAD != ((data[1] << 8) | data[2])) || (MAX_PENDING_MESSAGES < data[3]))
+    {
+        return FP_ERROR;
+    }
+    return FP_SUCCESS;
+}
+
+/**
+ * @brief Old path up to the payload parser, the header of a response frame is decoded after the validation
+ */
+static uint32_t bench_legacy_validate(const bench_frame_t *p_frame)
+{
+    const uint8_t *data = p_frame->u8_frame;
+
+    if (MROVER_RC_NOTIFY_EVENTS == data[0])
+    {
+        if (FP_SUCCESS == bench_legacy_is_valid_notify_frame(data, p_frame->u16_len))
+        {
+            bench_sink ^= data[3];
+        }
+    }
+    else if (FP_SUCCESS == bench_legacy_is_valid_response_frame(data, p_frame->u16_len))
+    {
+        fp_frame_header_t h_header;
+        bench_sink ^= fp_decode_frame_header(data, p_frame->u16_len, &h_header);
+    }
+    return p_frame->u16_len;
+}
+
+/**
+ * @brief Single pass up to the payload parser, the payload and the crc byte are XORed once onto the header crc
+ */
+static uint32_t bench_single_pass_validate(const bench_frame_t *p_frame)
+{
+    fp_frame_header_t h_header;
+
+    if ((FP_SUCCESS == fp_decode_frame_header(p_frame->u8_frame, p_frame->u16_len, &h_header)) &&
+        (MROVER_RC_NOTIFY_EVENTS != h_header.u8_return_code))
+    {
+        bench_sink ^= fp_crc_update(h_header.u8_crc, &p_frame->u8_frame[FP_RESPONSE_HEADER_LEN], h_header.u16_payload_len + 1);
+    }
+    return p_frame->u16_len;
+}
+
+#define BENCH_VALIDATE(name, frame)                                 \
+    static uint32_t bench_legacy_##name(void)                       \
+    {                                                               \
+        return bench_legacy_validate(&(frame));                     \
+    }                                                               \
+    static uint32_t bench_single_pass_##name(void)                  \
+    {                                                               \
+        return bench_single_pass_validate(&(frame));                \
+    }
+
+BENCH_VALIDATE(notify, bench_notify_frame)
+BENCH_VALIDATE(bad_code, bench_bad_code_frame)
+BENCH_VALIDATE(response, bench_response_frame)
+BENCH_VALIDATE(bad_crc, bench_bad_crc_frame)
+
+// every pair is the old path, then the single pass
+static const bench_case_t bench_legacy_cases[] = {
+    {"notify, old path", bench_legacy_notify},
+    {"notify, single pass", bench_single_pass_notify},
+    {"63B bad return code, old path", bench_legacy_bad_code},
+    {"63B bad return code, single pass", bench_single_pass_bad_code},
+    {"63B response, old path", bench_legacy_response},
+    {"63B response, single pass", bench_single_pass_response},
+    {"63B bad crc, old path", bench_legacy_bad_crc},
+    {"63B bad crc, single pass", bench_single_pass_bad_crc},
+};
+
+static const bench_case_t bench_validate_cases[] = {
+    {"fp_decode_frame_header", bench_decode_header},
+    {"fp_reassembler_feed stream", bench_reassemble_stream},
+    {"fp_reassembler_feed 1..64B chunks", bench_reassemble_chunks},
+    {"parse_rx_data stream", bench_parse_stream},
+};
+
+/********************** checksum **********************/
+/**
+ * @brief Bit by bit CRC-16/XMODEM, as ymodem calculated it before the tables
+ */
+static uint16_t bench_crc16_bitwise(const uint8_t *p_data, uint32_t u32_len)
+{
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < u32_len; i++)
+    {
+        crc ^= p_data[i] << 8;
+        for (uint8_t j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint8_t bench_xor8_bytewise(const uint8_t *p_data, uint32_t u32_len)
+{
+    uint8_t crc = 0;
+    for (uint32_t i = 0; i < u32_len; i++)
+    {
+        crc ^= p_data[i];
+    }
+    return crc;
+}
+
+static uint32_t bench_crc16_bitwise_block(void)
+{
+    bench_sink ^= bench_crc16_bitwise(bench_block, sizeof(bench_block));
+    return sizeof(bench_block);
+}
+
+static uint32_t bench_crc16_table_block(void)
+{
+    bench_sink ^= checksum_crc16_update(CHECKSUM_CRC16_INIT, bench_block, sizeof(bench_block));
+    return sizeof(bench_block);
+}
+
+static uint32_t bench_xor8_bytewise_frame(void)
+{
+    bench_sink ^= bench_xor8_bytewise(bench_block, MAX_SERIAL_RECEIVE_PAYLOAD_SIZE);
+    return MAX_SERIAL_RECEIVE_PAYLOAD_SIZE;
+}
+
+static uint32_t bench_xor8_word_frame(void)
+{
+    bench_sink ^= checksum_xor8_update(CHECKSUM_XOR8_INIT, bench_block, MAX_SERIAL_RECEIVE_PAYLOAD_SIZE);
+    return MAX_SERIAL_RECEIVE_PAYLOAD_SIZE;
+}
+
+/**
+ * @brief Digest of one ymodem block, what each written block adds to the transfer
+ */
+static uint32_t bench_sha256_block(void)
+{
+    static fw_digest_t digest;
+
+    if (digest.u32_offset >= digest.u32_image_size)
+    {
+        fw_digest_begin(&digest, UINT32_MAX, NULL);
+    }
+    fw_digest_update(&digest, bench_block, sizeof(bench_block));
+    bench_sink ^= digest.h_sha.u32_state[0];
+    return sizeof(bench_block);
+}
+
+static const bench_case_t bench_checksum_cases[] = {
+    {"crc16 bitwise 1k block", bench_crc16_bitwise_block},
+    {"crc16 slice-by-4 1k block", bench_crc16_table_block},
+    {"xor8 bytewise 307B frame", bench_xor8_bytewise_frame},
+    {"xor8 word 307B frame", bench_xor8_word_frame},
+    {"sha256 1k block", bench_sha256_block},
+};
+
+/********************** fuota **********************/
+static uint32_t bench_all_segments(void)
+{
+    bench_sink ^= is_all_segments_downloaded(bench_seg_status);
+    return sizeof(bench_seg_status);
+}
+
+// bitmap operations on 1 MB at 64 B segments, the statuses of the modem only ever fill 16 of them
+#define BENCH_SEGMENTS              ((1024 * 1024) / 64)
+#define BENCH_SEGMENT_WORDS         FUOTA_SEG_TRACKER_WORDS(BENCH_SEGMENTS)
+
+static fuota_seg_tracker_t bench_tracker;
+static uint32_t bench_tracker_words[BENCH_SEGMENT_WORDS];
+static fuota_seg_tracker_t bench_large_tracker;
+static uint32_t bench_large_words[FUOTA_SEG_TRACKER_MAX_WORDS];
+static get_seg_file_status_t bench_large_status;
+static uint32_t bench_pending[16];
+
+static void bench_fuota_setup(void)
+{
+    fuota_seg_tracker_init(&bench_tracker, bench_tracker_words, BENCH_SEGMENT_WORDS, 1024 * 1024, 64);
+    // about one segment in a hundred still pending, spread over the image
+    for (uint32_t u32_first = 0; u32_first < BENCH_SEGMENTS; u32_first += FUOTA_SEG_STATUS_WINDOW)
+    {
+        uint32_t u32_status = (0 == (u32_first % 1600)) ? 0x0100 : 0x0000;
+        fuota_seg_tracker_update(&bench_tracker, u32_first, u32_status, FUOTA_SEG_STATUS_WINDOW);
+    }
+
+    // largest package a status reports, 16 segments of 64k
+    bench_large_status.seg_size = SEG_SIZE_64;
+    bench_large_status.pkg_size[0] = 0x10;
+    bench_large_status.pkg_size[1] = 0x00;
+    bench_large_status.pkg_size[2] = 0x00;
+}
+
+static uint32_t bench_tracker_apply_status(void)
+{
+    bench_large_status.seg_status ^= 0x0101;
+    bench_sink ^= fuota_seg_tracker_apply_status(&bench_large_tracker, bench_large_words, FUOTA_SEG_TRACKER_MAX_WORDS,
+                                                 &bench_large_status);
+    return sizeof(bench_large_status);
+}
+
+static uint32_t bench_tracker_percent(void)
+{
+    bench_sink ^= fuota_seg_tracker_get_percent(&bench_tracker);
+    return 0;
+}
+
+/**
+ * @brief What a per segment loop costs, as is_all_segments_downloaded() did on one window
+ */
+static uint32_t bench_scan_percent(void)
+{
+    uint32_t u32_done = 0;
+    for (uint32_t i = 0; i < BENCH_SEGMENTS; i++)
+    {
+        u32_done += (0 == (bench_tracker_words[i / 32] & (1UL << (i % 32))));
+    }
+    bench_sink ^= (u32_done * 100) / BENCH_SEGMENTS;
+    return 0;
+}
+
+static uint32_t bench_tracker_pending(void)
+{
+    bench_sink ^= fuota_seg_tracker_get_pending(&bench_tracker, 0, bench_pending, 16);
+    return 0;
+}
+
+static const bench_case_t bench_fuota_cases[] = {
+    {"is_all_segments_downloaded", bench_all_segments},
+    {"tracker status 16 segments", bench_tracker_apply_status},
+    {"tracker percent 16384 segments", bench_tracker_percent},
+    {"scan percent 16384 segments", bench_scan_percent},
+    {"tracker 16 pending of 16384", bench_tracker_pending},
+};
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(void)
+{
+    char name[48];
+
+    bench_setup();
+    if (0 != bench_check_chunked_feed())
+    {
+        return 1;
+    }
+
+    for (uint8_t i = 0; i < sizeof(bench_encode_cases) / sizeof(bench_encode_cases[0]); i++)
+    {
+        bench_run("encode", &bench_encode_cases[i]);
+    }
+
+    for (uint8_t i = 0; i < sizeof(bench_send_cases) / sizeof(bench_send_cases[0]); i++)
+    {
+        bench_run("send", &bench_send_cases[i]);
+    }
+
+    for (bench_event_index = 0; bench_event_index < bench_event_count; bench_event_index++)
+    {
+        const uint8_t *p_frame = bench_event_frames[bench_event_index].u8_frame;
+        bench_case_t h_case = {name, bench_parse_event};
+        snprintf(name, sizeof(name), "event 0x%02X type %u", p_frame[6], p_frame[1]);
+        bench_run("parse", &h_case);
+    }
+    for (uint8_t i = 0; i < sizeof(bench_parse_cases) / sizeof(bench_parse_cases[0]); i++)
+    {
+        bench_run("parse", &bench_parse_cases[i]);
+    }
+
+    for (uint8_t i = 0; i < sizeof(bench_legacy_cases) / sizeof(bench_legacy_cases[0]); i++)
+    {
+        bench_run("validate", &bench_legacy_cases[i]);
+    }
+    for (uint8_t i = 0; i < sizeof(bench_validate_cases) / sizeof(bench_validate_cases[0]); i++)
+    {
+        bench_run("validate", &bench_validate_cases[i]);
+    }
+
+    for (uint8_t i = 0; i < sizeof(bench_checksum_cases) / sizeof(bench_checksum_cases[0]); i++)
+    {
+        bench_run("checksum", &bench_checksum_cases[i]);
+    }
+
+    bench_fuota_setup();
+    for (uint8_t i = 0; i < sizeof(bench_fuota_cases) / sizeof(bench_fuota_cases[0]); i++)
+    {
+        bench_run("fuota", &bench_fuota_cases[i]);
+    }
+
+    return 0;
+}
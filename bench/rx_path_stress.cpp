@@ -0,0 +1,610 @@
+/**
+ * @file rx_path_stress.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Rx path of src/mcm_rx_path.cpp under real threads, built by the native_rx_stress environment
+ *        pio run -e native_rx_stress && .pio/build/native_rx_stress/program [-d seconds] [-s seed]
+ *        -d  duration of the run, 5 s by default
+ *        -s  seed of the chunk sizes and the frame lengths
+ *        One pthread stands in for the uart callback, one for the rx task and the main
+ *        thread for the loop, over a FreeRTOS queue and stream buffer made of a mutex and a
+ *        condition variable. The phases alternate: response frames in bursts, which fill the
+ *        stream buffer and the rx queue, then raw ymodem packets sent one at a time once the
+ *        previous one is acked, the way the modem sends them. The loop switches the state the
+ *        rx task reads between the phases, like the ymodem state of the mcm. Every item is
+ *        checked against what was sent: a frame may only be lost to a full rx queue, and then
+ *        counted as dropped, never damaged or reordered. The loop also reads and resets the
+ *        link metrics and the rx stats while the uart and the rx task count, the sum of its
+ *        metrics reads must be every frame byte sent. The environment builds with the thread
+ *        sanitizer.
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include "mcm_rx_path.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define STRESS_DEFAULT_SECONDS 5
+#define STRESS_FRAMES_PER_PHASE 200
+#define STRESS_RAW_PER_PHASE 10
+#define STRESS_FRAME_HEADER_LEN 6           // return code, command type, command code and length
+#define STRESS_FRAME_MIN_PAYLOAD (GET_EVENT_HEADER_LEN + 4)
+#define STRESS_FRAME_MAX_PAYLOAD (MAX_SERIAL_RECEIVE_PAYLOAD_SIZE - STRESS_FRAME_HEADER_LEN - 1)
+#define STRESS_RAW_SMALL 133                // ymodem packets of 128 and 1024 bytes
+#define STRESS_RAW_LARGE 1029
+#define STRESS_RAW_HEADER_LEN 6             // sequence and length of the packet
+#define STRESS_ACK_TIMEOUT_MS 1000
+#define STRESS_QUIET_MS (3 * MCM_RX_IDLE_TIMEOUT_MS)
+#define STRESS_LOOP_SLOW_PCT 2              // loop iterations which take a while, the rx queue fills up
+#define STRESS_METRICS_ITEMS 50             // items between two reads of the link metrics, each one resets them
+
+#define STRESS_PHASE_FRAMES 0
+#define STRESS_PHASE_RAW 1
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+struct host_queue_t
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct host_stream_buffer_t
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t *data;
+    size_t size;
+    size_t trigger_level;
+    size_t head;
+    size_t count;
+};
+
+typedef struct
+{
+    uint32_t frames_sent;
+    uint32_t frame_bytes;       // bytes of the frames sent, all go through the reassembler
+    uint32_t frames_received;
+    uint32_t frames_lost;       // sequence numbers skipped, rx queue was full
+    uint32_t raw_sent;
+    uint32_t raw_received;
+    uint32_t raw_split;         // rest of a packet handed over as a second item, the uart thread was late
+    uint32_t raw_lost;          // no ack within STRESS_ACK_TIMEOUT_MS
+    uint32_t stream_full;       // writes the stream buffer could not take at once
+    uint32_t overflow_bytes;    // bytes of those writes the stream buffer refused, written again
+    uint32_t damaged;           // bytes, length or type not the ones sent
+    uint32_t reordered;
+    uint32_t phases;
+} stress_counts_t;
+
+/******************************************************************************
+ * PRIVATE VARIABLES
+ ******************************************************************************/
+static McmRxPath rx_path;
+static std::atomic<int> stress_ymodem_state{0};     // read by the rx task, written by the loop
+static std::atomic<int> stress_phase{STRESS_PHASE_FRAMES};
+static std::atomic<bool> is_phase_sent{false};
+static std::atomic<uint32_t> raw_acked{0};          // sequence of the last raw packet the loop got
+static std::atomic<bool> is_stopping{false};
+static stress_counts_t counts = {};                 // sent ones and stream_full written by the uart, the others by the loop
+static uint32_t uart_seed = 1;
+static api_metrics_t metrics = {};                  // link counters summed over the reads of the loop
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static struct timespec deadline_after(TickType_t ticks)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    uint64_t ns = deadline.tv_nsec + (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ);
+    deadline.tv_sec += ns / 1000000000ULL;
+    deadline.tv_nsec = ns % 1000000000ULL;
+    return deadline;
+}
+
+static uint64_t now_ms()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static uint32_t next_rand(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static uint8_t pattern_byte(uint32_t seq, uint16_t i)
+{
+    return (uint8_t)((seq * 31) + (i * 7) + (seq >> 8));
+}
+
+static bool is_raw_mode(void *user_ctx)
+{
+    return (0 != stress_ymodem_state.load());
+}
+
+/**
+ * @brief Bytes in uart callback sized chunks, the rx task reads while they are written
+ *
+ * A full stream buffer is waited for, like a line with flow control. A byte lost there
+ * could splice two frames into one which passes the crc, the check would count it as
+ * damaged although the handoff did nothing wrong.
+ */
+static void uart_write(const uint8_t *data, uint16_t len)
+{
+    uint16_t sent = 0;
+    while (sent < len)
+    {
+        uint16_t chunk = 1 + (next_rand(&uart_seed) % MCM_RX_CHUNK_SIZE);
+        if (chunk > (len - sent))
+        {
+            chunk = len - sent;
+        }
+        size_t written = rx_path.write(&data[sent], chunk);
+        sent += written;
+        if (written < chunk)
+        {
+            counts.stream_full++;
+            counts.overflow_bytes += chunk - written;
+            usleep(50);
+        }
+    }
+}
+
+/**
+ * @brief GET_EVENT response [rc][type][cc][len][event][pending][seq][pattern][crc]
+ */
+static uint16_t build_frame(uint8_t *frame, uint32_t seq, uint16_t payload_len)
+{
+    frame[0] = MROVER_RC_OK;
+    frame[1] = COMMAND_TYPE_LORAWAN;
+    frame[2] = (MROVER_CC_GET_EVENT >> 8) & 0xFF;
+    frame[3] = MROVER_CC_GET_EVENT & 0xFF;
+    frame[4] = (payload_len >> 8) & 0xFF;
+    frame[5] = payload_len & 0xFF;
+    frame[6] = MODEM_EVENT_DOWNDATA;
+    frame[7] = 0;
+    memcpy(&frame[8], &seq, sizeof(seq));
+    for (uint16_t i = STRESS_FRAME_MIN_PAYLOAD; i < payload_len; i++)
+    {
+        frame[STRESS_FRAME_HEADER_LEN + i] = pattern_byte(seq, i);
+    }
+    frame[STRESS_FRAME_HEADER_LEN + payload_len] = fp_crc_update(0, frame, STRESS_FRAME_HEADER_LEN + payload_len);
+    return STRESS_FRAME_HEADER_LEN + payload_len + 1;
+}
+
+static void *uart_thread(void *arg)
+{
+    uint8_t data[MCM_RX_SLOT_SIZE];
+    uint32_t frame_seq = 0;
+    uint32_t raw_seq = 0;
+
+    while (!is_stopping.load())
+    {
+        // loop switches the rx task for the next phase once this one went through
+        if (is_phase_sent.load())
+        {
+            usleep(100);
+            continue;
+        }
+
+        if (STRESS_PHASE_FRAMES == stress_phase.load())
+        {
+            // as fast as it goes, the slow loop iterations fill the rx queue
+            for (uint32_t i = 0; i < STRESS_FRAMES_PER_PHASE; i++)
+            {
+                uint16_t payload_len = STRESS_FRAME_MIN_PAYLOAD +
+                                       (next_rand(&uart_seed) % (STRESS_FRAME_MAX_PAYLOAD - STRESS_FRAME_MIN_PAYLOAD + 1));
+                uint16_t len = build_frame(data, ++frame_seq, payload_len);
+                uart_write(data, len);
+                counts.frames_sent++;
+                counts.frame_bytes += len;
+            }
+        }
+        else
+        {
+            // one packet in flight, the next one goes once it is acked
+            for (uint32_t i = 0; (i < STRESS_RAW_PER_PHASE) && !is_stopping.load(); i++)
+            {
+                uint16_t len = (next_rand(&uart_seed) & 1) ? STRESS_RAW_LARGE : STRESS_RAW_SMALL;
+                raw_seq++;
+                memcpy(&data[0], &raw_seq, sizeof(raw_seq));
+                memcpy(&data[4], &len, sizeof(len));
+                for (uint16_t j = STRESS_RAW_HEADER_LEN; j < len; j++)
+                {
+                    data[j] = pattern_byte(raw_seq, j);
+                }
+                uart_write(data, len);
+                counts.raw_sent++;
+
+                uint64_t start_ms = now_ms();
+                while ((raw_acked.load() != raw_seq) && ((now_ms() - start_ms) < STRESS_ACK_TIMEOUT_MS))
+                {
+                    usleep(100);
+                }
+            }
+        }
+        is_phase_sent.store(true);
+    }
+    return NULL;
+}
+
+static void *rx_task_thread(void *arg)
+{
+    while (!is_stopping.load())
+    {
+        rx_path.run_once();
+    }
+    return NULL;
+}
+
+static void check_frame(const uint8_t *data, uint16_t len, uint32_t *last_seq)
+{
+    uint32_t seq;
+    uint16_t payload_len = ((uint16_t)data[4] << 8) | data[5];
+
+    memcpy(&seq, &data[8], sizeof(seq));
+    if ((len != (STRESS_FRAME_HEADER_LEN + payload_len + 1)) || (payload_len < STRESS_FRAME_MIN_PAYLOAD))
+    {
+        counts.damaged++;
+        return;
+    }
+    for (uint16_t i = STRESS_FRAME_MIN_PAYLOAD; i < payload_len; i++)
+    {
+        if (data[STRESS_FRAME_HEADER_LEN + i] != pattern_byte(seq, i))
+        {
+            counts.damaged++;
+            return;
+        }
+    }
+    if (seq <= *last_seq)
+    {
+        counts.reordered++;
+        return;
+    }
+    counts.frames_lost += seq - *last_seq - 1;
+    counts.frames_received++;
+    *last_seq = seq;
+}
+
+static void check_raw(const uint8_t *data, uint16_t len, uint32_t *last_seq)
+{
+    uint32_t seq;
+    uint16_t sent_len;
+
+    memcpy(&seq, &data[0], sizeof(seq));
+    memcpy(&sent_len, &data[4], sizeof(sent_len));
+    if ((len < STRESS_RAW_HEADER_LEN) || (seq != (*last_seq + 1)) || (len > sent_len))
+    {
+        // rest of a packet cut by the idle timeout, its start was counted
+        counts.raw_split++;
+        return;
+    }
+    for (uint16_t j = STRESS_RAW_HEADER_LEN; j < len; j++)
+    {
+        if (data[j] != pattern_byte(seq, j))
+        {
+            counts.damaged++;
+            return;
+        }
+    }
+    counts.raw_received++;
+    *last_seq = seq;
+    raw_acked.store(seq);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = (QueueHandle_t)calloc(1, sizeof(struct host_queue_t));
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    queue->items = (uint8_t *)malloc((size_t)length * item_size);
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    struct timespec deadline = deadline_after(ticks);
+    BaseType_t result = errQUEUE_FULL;
+
+    pthread_mutex_lock(&queue->mutex);
+    while ((queue->count == queue->length) && (0 != ticks) &&
+           (ETIMEDOUT != pthread_cond_timedwait(&queue->cond, &queue->mutex, &deadline)))
+    {
+    }
+    if (queue->count < queue->length)
+    {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(&queue->items[(size_t)tail * queue->item_size], item, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+        result = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return result;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    struct timespec deadline = deadline_after(ticks);
+    BaseType_t result = pdFALSE;
+
+    pthread_mutex_lock(&queue->mutex);
+    while ((0 == queue->count) && (0 != ticks) &&
+           (ETIMEDOUT != pthread_cond_timedwait(&queue->cond, &queue->mutex, &deadline)))
+    {
+    }
+    if (queue->count > 0)
+    {
+        memcpy(item, &queue->items[(size_t)queue->head * queue->item_size], queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+        result = pdTRUE;
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return result;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level)
+{
+    StreamBufferHandle_t stream = (StreamBufferHandle_t)calloc(1, sizeof(struct host_stream_buffer_t));
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    stream->data = (uint8_t *)malloc(size);
+    stream->size = size;
+    stream->trigger_level = (0 == trigger_level) ? 1 : trigger_level;
+    return stream;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks)
+{
+    struct timespec deadline = deadline_after(ticks);
+    size_t sent = 0;
+
+    pthread_mutex_lock(&stream->mutex);
+    while ((stream->count == stream->size) && (0 != ticks) &&
+           (ETIMEDOUT != pthread_cond_timedwait(&stream->cond, &stream->mutex, &deadline)))
+    {
+    }
+    while ((sent < len) && (stream->count < stream->size))
+    {
+        size_t tail = (stream->head + stream->count) % stream->size;
+        size_t part = stream->size - tail;
+        if (part > (stream->size - stream->count))
+        {
+            part = stream->size - stream->count;
+        }
+        if (part > (len - sent))
+        {
+            part = len - sent;
+        }
+        memcpy(&stream->data[tail], &((const uint8_t *)data)[sent], part);
+        stream->count += part;
+        sent += part;
+    }
+    if (sent > 0)
+    {
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->mutex);
+    return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks)
+{
+    struct timespec deadline = deadline_after(ticks);
+    size_t received = 0;
+
+    pthread_mutex_lock(&stream->mutex);
+    while ((stream->count < stream->trigger_level) && (0 != ticks) &&
+           (ETIMEDOUT != pthread_cond_timedwait(&stream->cond, &stream->mutex, &deadline)))
+    {
+    }
+    while ((received < len) && (stream->count > 0))
+    {
+        size_t part = stream->size - stream->head;
+        if (part > stream->count)
+        {
+            part = stream->count;
+        }
+        if (part > (len - received))
+        {
+            part = len - received;
+        }
+        memcpy(&((uint8_t *)data)[received], &stream->data[stream->head], part);
+        stream->head = (stream->head + part) % stream->size;
+        stream->count -= part;
+        received += part;
+    }
+    if (received > 0)
+    {
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->mutex);
+    return received;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    size_t count = stream->count;
+    pthread_mutex_unlock(&stream->mutex);
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = STRESS_DEFAULT_SECONDS;
+    uint32_t loop_seed = 1;
+    int option;
+
+    while ((option = getopt(argc, argv, "d:s:")) != -1)
+    {
+        switch (option)
+        {
+        case 'd':
+            seconds = (uint32_t)atoi(optarg);
+            break;
+        case 's':
+            uart_seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-d seconds] [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    uart_seed = (0 != uart_seed) ? uart_seed : 1;
+    uint32_t seed = uart_seed;
+    loop_seed = uart_seed * 2654435761u;
+
+    if (!rx_path.begin(is_raw_mode, NULL))
+    {
+        fprintf(stderr, "unable to create the rx path\n");
+        return 1;
+    }
+    pthread_t uart, rx_task;
+    pthread_create(&rx_task, NULL, rx_task_thread, NULL);
+    pthread_create(&uart, NULL, uart_thread, NULL);
+
+    uint32_t last_frame_seq = 0;
+    uint32_t last_raw_seq = 0;
+    uint32_t items = 0;
+    mcm_rx_stats_t last_stats = {};
+    uint64_t start_ms = now_ms();
+    uint64_t quiet_ms = now_ms();
+    for (;;)
+    {
+        mcm_rx_item_t item;
+        if (rx_path.receive(&item))
+        {
+            const uint8_t *data = rx_path.get_data(&item);
+            bool is_raw = (MCM_RX_ITEM_TYPE::MCM_RX_ITEM_RAW == item.type);
+            if (is_raw != (STRESS_PHASE_RAW == stress_phase.load()))
+            {
+                counts.damaged++;
+            }
+            else if (is_raw)
+            {
+                check_raw(data, item.len, &last_raw_seq);
+            }
+            else
+            {
+                check_frame(data, item.len, &last_frame_seq);
+            }
+            rx_path.release(&item);
+            quiet_ms = now_ms();
+
+            // metrics read like the cli does, while the uart and the rx task keep counting
+            if (0 == (++items % STRESS_METRICS_ITEMS))
+            {
+                mcm_rx_stats_t running;
+                rx_path.add_link_metrics(&metrics, true);
+                rx_path.get_stats(&running);
+                // counters only grow, a torn or lost update shows up as one going back
+                if ((running.items_count < last_stats.items_count) ||
+                    (running.stream_overflow_bytes < last_stats.stream_overflow_bytes))
+                {
+                    counts.damaged++;
+                }
+                last_stats = running;
+            }
+
+            // the loop is busy elsewhere, the rx task keeps on queueing
+            if ((next_rand(&loop_seed) % 100) < STRESS_LOOP_SLOW_PCT)
+            {
+                usleep(1000 + (next_rand(&loop_seed) % 2000));
+            }
+            continue;
+        }
+
+        // phase is over once everything sent went through, the state changes on a quiet line
+        if (is_phase_sent.load() && ((now_ms() - quiet_ms) > STRESS_QUIET_MS))
+        {
+            if ((now_ms() - start_ms) >= (seconds * 1000ULL))
+            {
+                break;
+            }
+            int phase = (STRESS_PHASE_FRAMES == stress_phase.load()) ? STRESS_PHASE_RAW : STRESS_PHASE_FRAMES;
+            stress_ymodem_state.store((STRESS_PHASE_RAW == phase) ? 1 : 0);
+            stress_phase.store(phase);
+            is_phase_sent.store(false);
+            counts.phases++;
+            continue;
+        }
+        usleep(50);
+    }
+    is_stopping.store(true);
+    pthread_join(uart, NULL);
+    pthread_join(rx_task, NULL);
+
+    mcm_rx_stats_t stats;
+    rx_path.get_stats(&stats);
+    rx_path.add_link_metrics(&metrics, true);
+    counts.raw_lost = counts.raw_sent - counts.raw_received;
+    // frames dropped after the last one handed over left no gap to count them by
+    counts.frames_lost += counts.frames_sent - last_frame_seq;
+    // run ends on a quiet line, every frame sent was either handed over or dropped on a full queue
+    bool is_ok = (0 == counts.damaged) && (0 == counts.reordered) && (0 == counts.raw_lost) &&
+                 (counts.frames_sent == (counts.frames_received + counts.frames_lost)) &&
+                 (counts.frames_lost == stats.items_dropped) && (stats.items_count == (counts.frames_received + counts.raw_received + counts.raw_split)) &&
+                 (counts.frame_bytes == metrics.h_link.u32_bytes_in) && (0 == metrics.h_link.u32_crc_errors) &&
+                 (counts.overflow_bytes == stats.stream_overflow_bytes);
+    double items_per_s = (counts.frames_received + counts.raw_received) / (double)seconds;
+
+    printf("%u s, %u phases, seed %u, %u items per second\n", seconds, counts.phases, seed, (unsigned)items_per_s);
+    printf("frames: %u sent, %u received, %u lost\n", counts.frames_sent, counts.frames_received, counts.frames_lost);
+    printf("raw packets: %u sent, %u received, %u split, %u lost\n", counts.raw_sent, counts.raw_received,
+           counts.raw_split, counts.raw_lost);
+    printf("rx path: %u items queued, %u dropped, stream buffer full %u times (%u of %u B counted), %u B garbage, "
+           "queue high water %u of %u\n",
+           stats.items_count, stats.items_dropped, counts.stream_full, stats.stream_overflow_bytes, counts.overflow_bytes,
+           stats.garbage_bytes, stats.queue_high_water, (unsigned)MCM_RX_QUEUE_DEPTH);
+    printf("link metrics: %u of %u B, %u crc errors, %u B dropped\n", metrics.h_link.u32_bytes_in,
+           counts.frame_bytes, metrics.h_link.u32_crc_errors, metrics.h_link.u32_dropped_bytes);
+    printf("damaged %u, reordered %u: %s\n", counts.damaged, counts.reordered, is_ok ? "ok" : "FAILED");
+    return is_ok ? 0 : 1;
+}
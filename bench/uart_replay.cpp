@@ -0,0 +1,412 @@
+/**
+ * @file uart_replay.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Replays a capture of the MCM and GNSS traffic of uart_capture.c through the parsers of the
+ *        firmware, built by the native_replay environment
+ *        pio run -e native_replay && .pio/build/native_replay/program -i console.log -o capture.bin
+ *        pio run -e native_replay && .pio/build/native_replay/program [-r] [-v] [-n loops] [-p port] capture.bin
+ *        -i  console log holding the output of "capture dump", turned into the capture file -o
+ *        -r  records replayed at the pace they were captured, on the real clock, instead of at once
+ *        -v  one line per record on stdout
+ *        -n  replays of the whole capture, 1 by default, for perf record
+ *        -p  mcm port replayed, 0 by default, the records of the other modems are only counted
+ *        The received mcm bytes go to api_processor_parse_rx_data() in the chunks the uart driver
+ *        delivered them, so a field issue with split or garbled frames comes back on the host. The
+ *        received gnss bytes go through GPS_Serial to gnssCheckin(). The run prints the frames and
+ *        fixes parsed, then the parsing speed against the time the capture covers.
+ * @version 0.1
+ * @date 2025-02-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "api_processor.h"
+#include "checksum.h"
+#include "gnss.h"
+#include "uart_capture.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+extern HardwareSerial GPS_Serial;
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define REPLAY_GNSS_BAUD_RATE 115200
+#define REPLAY_LINE_SIZE 512
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t records[UART_CAPTURE_STREAM_COUNT];
+    uint64_t bytes[UART_CAPTURE_STREAM_COUNT];
+    uint32_t responses;
+    uint32_t error_responses;     // return code other than MROVER_RC_OK
+    uint32_t notifications;
+    uint32_t parse_errors;        // api_processor_parse_rx_data() failed
+    uint32_t fixes;
+    uint32_t other_port_records;  // mcm records of the modems not replayed
+} replay_stats_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static const char *stream_names[UART_CAPTURE_STREAM_COUNT] = {"mcm rx", "mcm tx", "gnss rx", "gnss tx"};
+
+static HardwareSerial gnss_feeder(4);
+static mcm_module_hdl_t module;
+static replay_stats_t stats;
+static bool is_verbose = false;
+static uint8_t mcm_port = 0;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint16_t on_send(uint8_t *data, uint16_t size, void *user_context)
+{
+    // the commands of the capture are only counted, nothing is sent
+    return size;
+}
+
+static void on_notification(void *user_context)
+{
+    stats.notifications++;
+}
+
+static void on_response(const api_processor_response_t *response, void *user_context)
+{
+    stats.responses++;
+    if (MROVER_RC_OK != response->return_code)
+    {
+        stats.error_responses++;
+    }
+    if (is_verbose)
+    {
+        printf("    response cc 0x%04x rc %u\n", response->cmd_code, response->return_code);
+    }
+}
+
+static uint32_t on_tick()
+{
+    return millis();
+}
+
+static double wall_seconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec / 1e9);
+}
+
+static int hex_value(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Turns the "capture dump" lines of a console log into a capture file
+ *
+ * The lines can have a prefix, e.g. the timestamps of a terminal program. The last dump
+ * of the log is kept, its size and crc are checked.
+ */
+static int import_dump(const char *p_log_path, const char *p_out_path)
+{
+    FILE *log = fopen(p_log_path, "r");
+    if (NULL == log)
+    {
+        fprintf(stderr, "unable to open %s\n", p_log_path);
+        return 1;
+    }
+
+    std::vector<uint8_t> file;
+    char line[REPLAY_LINE_SIZE];
+    unsigned long expected_size = 0;
+    unsigned int expected_crc = 0;
+    bool is_in_dump = false;
+    bool is_done = false;
+
+    while (NULL != fgets(line, sizeof(line), log))
+    {
+        char *p_begin = strstr(line, UART_CAPTURE_DUMP_BEGIN);
+        char *p_end = strstr(line, UART_CAPTURE_DUMP_END);
+        char *p_data = strstr(line, UART_CAPTURE_DUMP_LINE);
+
+        if (NULL != p_begin)
+        {
+            expected_size = strtoul(p_begin + strlen(UART_CAPTURE_DUMP_BEGIN), NULL, 10);
+            file.clear();
+            is_in_dump = true;
+            is_done = false;
+        }
+        else if (is_in_dump && (NULL != p_end))
+        {
+            expected_crc = (unsigned int)strtoul(p_end + strlen(UART_CAPTURE_DUMP_END), NULL, 16);
+            is_in_dump = false;
+            is_done = true;
+        }
+        else if (is_in_dump && (NULL != p_data))
+        {
+            for (char *p = p_data + strlen(UART_CAPTURE_DUMP_LINE); (hex_value(p[0]) >= 0) && (hex_value(p[1]) >= 0); p += 2)
+            {
+                file.push_back((uint8_t)((hex_value(p[0]) << 4) | hex_value(p[1])));
+            }
+        }
+    }
+    fclose(log);
+
+    if (!is_done)
+    {
+        fprintf(stderr, "no complete dump in %s\n", p_log_path);
+        return 1;
+    }
+    uint16_t crc = checksum_crc16_update(CHECKSUM_CRC16_INIT, file.data(), (uint32_t)file.size());
+    if ((file.size() != expected_size) || (crc != expected_crc))
+    {
+        fprintf(stderr, "dump damaged: %zu of %lu B, crc %04x instead of %04x\n", file.size(), expected_size, crc,
+                expected_crc);
+        return 1;
+    }
+
+    FILE *out = fopen(p_out_path, "wb");
+    if ((NULL == out) || (file.size() != fwrite(file.data(), 1, file.size(), out)) || (0 != fclose(out)))
+    {
+        fprintf(stderr, "unable to write %s\n", p_out_path);
+        return 1;
+    }
+    printf("%zu B written to %s\n", file.size(), p_out_path);
+    return 0;
+}
+
+static void replay_record(const uart_capture_record_t *p_record, uint64_t time_us)
+{
+    uint8_t data[UART_CAPTURE_MAX_RECORD_DATA];
+    bool is_gnss = (UART_CAPTURE_GNSS_RX == p_record->u8_stream) || (UART_CAPTURE_GNSS_TX == p_record->u8_stream);
+
+    // one parser state per modem, the frames of two modems would garble each other
+    if (!is_gnss && (mcm_port != p_record->u8_port))
+    {
+        stats.other_port_records++;
+        return;
+    }
+    stats.records[p_record->u8_stream]++;
+    stats.bytes[p_record->u8_stream] += p_record->u16_len;
+    if (is_verbose)
+    {
+        printf("%12.6f %-7s %2u %3u B ", time_us / 1e6, stream_names[p_record->u8_stream], p_record->u8_port,
+               p_record->u16_len);
+        for (uint16_t i = 0; i < p_record->u16_len; i++)
+        {
+            uint8_t c = p_record->p_data[i];
+            if (is_gnss)
+            {
+                putchar(((c >= ' ') && (c < 0x7F)) ? c : '.');
+            }
+            else
+            {
+                printf("%02x", c);
+            }
+        }
+        putchar('\n');
+    }
+
+    switch (p_record->u8_stream)
+    {
+    case UART_CAPTURE_MCM_RX:
+        // the parser takes a writable buffer
+        memcpy(data, p_record->p_data, p_record->u16_len);
+        if (API_PROCESSOR_SUCCESS != api_processor_parse_rx_data(&module, data, p_record->u16_len))
+        {
+            stats.parse_errors++;
+        }
+        break;
+    case UART_CAPTURE_GNSS_RX:
+    {
+        gnss_data_t fix;
+        gnss_feeder.write(p_record->p_data, p_record->u16_len);
+        if (gnssCheckin(&fix))
+        {
+            stats.fixes++;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Runs the records of the capture once
+ * @return false on a record of an unknown stream or a truncated one
+ */
+static bool replay(const uint8_t *p_records, uint32_t size, bool is_paced)
+{
+    uart_capture_record_t record;
+    uint32_t offset = 0;
+    uint64_t time_us = 0;
+    uint64_t start_us = host_os_micros();
+
+    while (uart_capture_next_record(p_records, size, &offset, &record))
+    {
+        if (record.u8_stream >= UART_CAPTURE_STREAM_COUNT)
+        {
+            return false;
+        }
+        time_us += record.u32_delta_us;
+        if (is_paced && (host_os_micros() < (start_us + time_us)))
+        {
+            host_os_sleep_us(start_us + time_us - host_os_micros());
+        }
+        replay_record(&record, time_us);
+    }
+    return (offset == size);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    const char *p_log_path = NULL;
+    const char *p_out_path = NULL;
+    bool is_paced = false;
+    uint32_t loops = 1;
+    int option;
+
+    while ((option = getopt(argc, argv, "i:o:rvn:p:")) != -1)
+    {
+        switch (option)
+        {
+        case 'i':
+            p_log_path = optarg;
+            break;
+        case 'o':
+            p_out_path = optarg;
+            break;
+        case 'r':
+            is_paced = true;
+            break;
+        case 'v':
+            is_verbose = true;
+            break;
+        case 'n':
+            loops = (uint32_t)atoi(optarg);
+            break;
+        case 'p':
+            mcm_port = (uint8_t)atoi(optarg);
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+    if ((NULL != p_log_path) && (NULL != p_out_path))
+    {
+        return import_dump(p_log_path, p_out_path);
+    }
+    if ((optind != (argc - 1)) || (0 == loops))
+    {
+        fprintf(stderr, "usage: %s -i console.log -o capture.bin\n", argv[0]);
+        fprintf(stderr, "       %s [-r] [-v] [-n loops] [-p port] capture.bin\n", argv[0]);
+        return 1;
+    }
+
+    const char *p_path = argv[optind];
+    int fd = open(p_path, O_RDONLY);
+    struct stat file_stat;
+    if ((fd < 0) || (0 != fstat(fd, &file_stat)) || (0 == file_stat.st_size))
+    {
+        fprintf(stderr, "unable to open %s\n", p_path);
+        return 1;
+    }
+    const uint8_t *p_file = (const uint8_t *)mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    uart_capture_header_t header;
+    if ((MAP_FAILED == p_file) || !uart_capture_parse_header(p_file, (uint32_t)file_stat.st_size, &header))
+    {
+        fprintf(stderr, "%s is not a capture file\n", p_path);
+        return 1;
+    }
+
+    // the virtual clock keeps the time of the records for the timeouts of the parsers at no cost
+    host_os_set_clock(is_paced ? HOST_CLOCK_REAL : HOST_CLOCK_VIRTUAL);
+    Serial.attach_output(is_verbose ? stdout : NULL);
+    if (API_PROCESSOR_SUCCESS != api_processor_init(&module, on_send, on_notification, on_response))
+    {
+        fprintf(stderr, "api processor init failed\n");
+        return 1;
+    }
+    api_processor_set_tick_cb(&module, on_tick);
+    GPS_Serial.begin(REPLAY_GNSS_BAUD_RATE);
+    gnss_feeder.begin(REPLAY_GNSS_BAUD_RATE);
+    gnss_feeder.attach_line(GPS_Serial, false);
+
+    const uint8_t *p_records = p_file + header.u16_header_size;
+    uint64_t captured_us = 0;
+    double start_s = wall_seconds();
+    for (uint32_t i = 0; i < loops; i++)
+    {
+        if (!replay(p_records, header.u32_data_size, is_paced))
+        {
+            fprintf(stderr, "damaged record in %s\n", p_path);
+            return 1;
+        }
+    }
+    double wall_s = wall_seconds() - start_s;
+
+    uart_capture_record_t record;
+    uint32_t offset = 0;
+    while (uart_capture_next_record(p_records, header.u32_data_size, &offset, &record))
+    {
+        captured_us += record.u32_delta_us;
+    }
+
+    uint64_t total_bytes = 0;
+    printf("%s: version %u, %u B of records, %u records overwritten before the dump, %.3f s of traffic\n", p_path,
+           header.u8_version, header.u32_data_size, header.u32_overwritten, captured_us / 1e6);
+    for (uint8_t i = 0; i < UART_CAPTURE_STREAM_COUNT; i++)
+    {
+        printf("%-8s %8u records %10llu B\n", stream_names[i], stats.records[i] / loops,
+               (unsigned long long)(stats.bytes[i] / loops));
+        total_bytes += stats.bytes[i];
+    }
+    printf("responses %u, error responses %u, notifications %u, parse errors %u, gnss fixes %u\n",
+           stats.responses / loops, stats.error_responses / loops, stats.notifications / loops,
+           stats.parse_errors / loops, stats.fixes / loops);
+    if (stats.other_port_records > 0)
+    {
+        printf("%u records of the other mcm ports not replayed, see -p\n", stats.other_port_records / loops);
+    }
+    printf("%u replays in %.4f s, %.2f MB/s, %.1f ns/B, %.0fx the captured time\n", loops, wall_s,
+           total_bytes / wall_s / 1e6, (wall_s * 1e9) / (total_bytes ? total_bytes : 1),
+           (captured_us / 1e6) * loops / wall_s);
+
+    return 0;
+}
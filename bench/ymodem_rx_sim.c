@@ -0,0 +1,415 @@
+/**
+ * @file ymodem_rx_sim.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Transfer simulation of the ymodem receiver, built by the native_ymodem environment
+ *        pio run -e native_ymodem && .pio/build/native_ymodem/program
+ *        A sender sends an image over a simulated 9600 baud line, the uart reads split
+ *        the packets at random places. The old packet-per-read receiver is simulated
+ *        next to the incremental one and the effective throughput of both is printed.
+ * @version 0.1
+ * @date 2025-01-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ymodem_rx.h"
+#include "checksum.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define SIM_BAUD_RATE               9600
+#define SIM_BYTE_US                 ((10 * 1000000) / SIM_BAUD_RATE)   // start, 8 data and stop bit
+#define SIM_READ_LATENCY_US         2000        // uart event and rx task delay of a read
+#define SIM_POLL_STEP_US            10000       // loop period calling ymodem_rx_poll()
+#define SIM_SENDER_TIMEOUT_US       (10 * 1000000)
+#define SIM_MAX_RETRIES             10
+#define SIM_IMAGE_SIZE              (32 * 1024 + 100)
+#define SIM_READ_MAX                1036        // MCM rx item size
+#define SIM_PARSE_MIN_TIME_NS       (300ULL * 1000ULL * 1000ULL)
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    SIM_RX_LEGACY,          // one whole packet per read, as the receiver was before
+    SIM_RX_INCREMENTAL      // ymodem_rx
+} sim_rx_mode_t;
+
+typedef struct
+{
+    const char *p_name;
+    uint8_t u8_split_pct;   // packets whose read is split at random places
+    uint8_t u8_corrupt_pct; // packets with one byte changed on the line
+    uint8_t u8_ack_loss_pct;// ACKs lost on the way back
+} sim_scenario_t;
+
+typedef struct
+{
+    sim_rx_mode_t mode;
+    ymodem_rx_t h_rx;
+    uint8_t u8_reply;       // byte sent back for the last read, 0 if none
+    bool b_header_done;
+    uint8_t u8_legacy_next;
+    uint32_t u32_written;
+    uint32_t u32_rewrites;  // blocks written more than once
+    uint8_t u8_image[SIM_IMAGE_SIZE];
+} sim_receiver_t;
+
+typedef struct
+{
+    uint64_t u64_time_us;
+    uint32_t u32_packets;
+    uint32_t u32_resends;
+    bool b_complete;
+    bool b_image_ok;
+} sim_result_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static uint32_t sim_rng_state = 0x2545F491;
+static uint8_t sim_image[SIM_IMAGE_SIZE];
+static sim_receiver_t sim_rx;
+static volatile uint32_t sim_sink;
+
+static const sim_scenario_t sim_scenarios[] = {
+    {"clean line, one read per packet", 0, 0, 0},
+    {"5% reads split", 5, 0, 0},
+    {"25% reads split", 25, 0, 0},
+    {"every read split", 100, 0, 0},
+    {"25% split, 10% corrupted", 25, 10, 0},
+    {"25% split, 10% acks lost", 25, 0, 10},
+};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint32_t sim_rand(void)
+{
+    // xorshift32
+    sim_rng_state ^= sim_rng_state << 13;
+    sim_rng_state ^= sim_rng_state >> 17;
+    sim_rng_state ^= sim_rng_state << 5;
+    return sim_rng_state;
+}
+
+static uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Builds the packet of a block, block 0 is the ymodem header
+ */
+static uint16_t sim_build_packet(uint8_t *p_out, uint32_t u32_block)
+{
+    uint16_t u16_data_len = (0 == u32_block) ? YMODEM_BLOCK_SIZE_SOH : YMODEM_BLOCK_SIZE_STX;
+    uint8_t *p_data = &p_out[3];
+
+    p_out[0] = (0 == u32_block) ? SOH : STX;
+    p_out[1] = (uint8_t)u32_block;
+    p_out[2] = (uint8_t)(0xFF - (uint8_t)u32_block);
+    memset(p_data, 0x1A, u16_data_len);
+    if (0 == u32_block)
+    {
+        int len = snprintf((char *)p_data, u16_data_len, "fota.bin");
+        snprintf((char *)&p_data[len + 1], u16_data_len - len - 1, "%u", (unsigned)SIM_IMAGE_SIZE);
+    }
+    else
+    {
+        uint32_t u32_offset = (u32_block - 1) * YMODEM_BLOCK_SIZE_STX;
+        uint32_t u32_len = SIM_IMAGE_SIZE - u32_offset;
+        memcpy(p_data, &sim_image[u32_offset], (u32_len > u16_data_len) ? u16_data_len : u32_len);
+    }
+    uint16_t u16_crc = checksum_crc16_update(CHECKSUM_CRC16_INIT, p_data, u16_data_len);
+    p_out[3 + u16_data_len] = u16_crc >> 8;
+    p_out[4 + u16_data_len] = u16_crc & 0xFF;
+
+    return u16_data_len + YMODEM_PACKET_OVERHEAD;
+}
+
+/**
+ * @brief The sender acts on the first byte it gets back for a packet
+ */
+static void sim_reply(uint8_t u8_reply)
+{
+    if (0 == sim_rx.u8_reply)
+    {
+        sim_rx.u8_reply = u8_reply;
+    }
+}
+
+static void sim_write_block(uint8_t u8_block, const uint8_t *p_data, uint16_t u16_len)
+{
+    uint32_t u32_offset = (uint32_t)(u8_block - 1) * YMODEM_BLOCK_SIZE_STX;
+    if (u32_offset >= SIM_IMAGE_SIZE)
+    {
+        return;
+    }
+    uint32_t u32_len = SIM_IMAGE_SIZE - u32_offset;
+    if (u32_len > u16_len)
+    {
+        u32_len = u16_len;
+    }
+    if (u32_offset < sim_rx.u32_written)
+    {
+        sim_rx.u32_rewrites++;
+    }
+    memcpy(&sim_rx.u8_image[u32_offset], p_data, u32_len);
+    sim_rx.u32_written = u32_offset + u32_len;
+}
+
+/**
+ * @brief Same answers as YModem::handleRxEvent()
+ */
+static void sim_on_rx_event(ymodem_rx_event_t event, uint8_t u8_block, const uint8_t *p_data, uint16_t u16_len, void *ctx)
+{
+    (void)ctx;
+    switch (event)
+    {
+    case YMODEM_RX_EVT_BLOCK:
+        if (0 != u8_block)
+        {
+            sim_write_block(u8_block, p_data, u16_len);
+        }
+        sim_reply(ACK);
+        break;
+    case YMODEM_RX_EVT_DUPLICATE:
+    case YMODEM_RX_EVT_EOT:
+        sim_reply(ACK);
+        break;
+    case YMODEM_RX_EVT_RETRY:
+        sim_reply(NAK);
+        break;
+    default:
+        sim_reply(CAN);
+        break;
+    }
+}
+
+/**
+ * @brief The receiver as it was: a read has to start with the packet start byte
+ *        and the crc is taken from the last two bytes of the read
+ */
+static void sim_legacy_feed(const uint8_t *p_data, uint16_t u16_len)
+{
+    if (EOT == p_data[0])
+    {
+        sim_reply(ACK);
+    }
+    else if ((SOH == p_data[0]) || (STX == p_data[0]))
+    {
+        if (!sim_rx.b_header_done)
+        {
+            sim_rx.b_header_done = true;
+            sim_rx.u8_legacy_next = 1;
+            sim_reply(ACK);
+            return;
+        }
+        uint16_t u16_received_crc = (p_data[u16_len - 2] << 8) | p_data[u16_len - 1];
+        // bytes past a short read are whatever the buffer held before
+        static uint8_t legacy_buffer[SIM_READ_MAX];
+        memcpy(legacy_buffer, p_data, u16_len);
+        if ((u16_len >= 3 + YMODEM_BLOCK_SIZE_STX) &&
+            (u16_received_crc == checksum_crc16_update(CHECKSUM_CRC16_INIT, &legacy_buffer[3], YMODEM_BLOCK_SIZE_STX)))
+        {
+            // block number was not checked, every good packet was written at the next place
+            sim_write_block(sim_rx.u8_legacy_next++, &legacy_buffer[3], YMODEM_BLOCK_SIZE_STX);
+            sim_reply(ACK);
+        }
+        else
+        {
+            sim_reply(NAK);
+        }
+    }
+}
+
+static void sim_feed(const uint8_t *p_data, uint16_t u16_len, uint64_t u64_now_us)
+{
+    if (SIM_RX_LEGACY == sim_rx.mode)
+    {
+        sim_legacy_feed(p_data, u16_len);
+    }
+    else
+    {
+        ymodem_rx_feed(&sim_rx.h_rx, p_data, u16_len, (uint32_t)(u64_now_us / 1000), sim_on_rx_event, NULL);
+    }
+}
+
+/**
+ * @brief Sends one packet over the line in reads of random size, returns the time of the last read
+ */
+static uint64_t sim_send_packet(const uint8_t *p_packet, uint16_t u16_len, uint64_t u64_now_us, const sim_scenario_t *p_scenario)
+{
+    uint16_t u16_sent = 0;
+
+    while (u16_sent < u16_len)
+    {
+        uint16_t u16_read = u16_len - u16_sent;
+        if ((u16_len > 1) && ((sim_rand() % 100) < p_scenario->u8_split_pct))
+        {
+            // the line went idle long enough inside the packet to close the read
+            u16_read = 1 + (sim_rand() % u16_read);
+        }
+        u64_now_us += (uint64_t)u16_read * SIM_BYTE_US;
+        sim_feed(&p_packet[u16_sent], u16_read, u64_now_us + SIM_READ_LATENCY_US);
+        u16_sent += u16_read;
+    }
+
+    return u64_now_us + SIM_READ_LATENCY_US;
+}
+
+static sim_result_t sim_transfer(sim_rx_mode_t mode, const sim_scenario_t *p_scenario)
+{
+    static uint8_t packet[YMODEM_PACKET_MAX_SIZE];
+    uint32_t u32_blocks = (SIM_IMAGE_SIZE + YMODEM_BLOCK_SIZE_STX - 1) / YMODEM_BLOCK_SIZE_STX;
+    uint32_t u32_block = 0;
+    uint8_t u8_retries = 0;
+    sim_result_t h_result = {0};
+
+    memset(&sim_rx, 0, sizeof(sim_rx));
+    sim_rx.mode = mode;
+    ymodem_rx_init(&sim_rx.h_rx, 0);
+
+    while ((u32_block <= (u32_blocks + 1)) && (u8_retries <= SIM_MAX_RETRIES))
+    {
+        uint16_t u16_len;
+        if (u32_block <= u32_blocks)
+        {
+            u16_len = sim_build_packet(packet, u32_block);
+        }
+        else
+        {
+            packet[0] = EOT;
+            u16_len = 1;
+        }
+        if ((u16_len > 1) && ((sim_rand() % 100) < p_scenario->u8_corrupt_pct))
+        {
+            packet[1 + (sim_rand() % (u16_len - 1))] ^= 0x10;
+        }
+
+        sim_rx.u8_reply = 0;
+        h_result.u32_packets++;
+        h_result.u64_time_us = sim_send_packet(packet, u16_len, h_result.u64_time_us, p_scenario);
+
+        // receiver may answer later, after the purge or the packet timeout
+        uint64_t u64_deadline = h_result.u64_time_us + SIM_SENDER_TIMEOUT_US;
+        while ((0 == sim_rx.u8_reply) && (h_result.u64_time_us < u64_deadline))
+        {
+            h_result.u64_time_us += SIM_POLL_STEP_US;
+            if (SIM_RX_INCREMENTAL == mode)
+            {
+                ymodem_rx_poll(&sim_rx.h_rx, (uint32_t)(h_result.u64_time_us / 1000), sim_on_rx_event, NULL);
+            }
+        }
+        h_result.u64_time_us += SIM_BYTE_US;
+
+        if ((ACK == sim_rx.u8_reply) && ((sim_rand() % 100) >= p_scenario->u8_ack_loss_pct))
+        {
+            u32_block++;
+            u8_retries = 0;
+            continue;
+        }
+        if (CAN == sim_rx.u8_reply)
+        {
+            break;
+        }
+        // NAK, no answer or ACK lost, the packet goes again
+        h_result.u32_resends++;
+        u8_retries++;
+    }
+
+    h_result.b_complete = (u32_block > (u32_blocks + 1));
+    h_result.b_image_ok = h_result.b_complete && (0 == memcmp(sim_rx.u8_image, sim_image, SIM_IMAGE_SIZE));
+    return h_result;
+}
+
+/**
+ * @brief CPU cost of the receiver for a stream of good packets in random reads
+ */
+static void sim_parse_speed(void)
+{
+    static uint8_t stream[8 * YMODEM_PACKET_MAX_SIZE];
+    uint16_t u16_stream_len = 0;
+    uint64_t u64_bytes = 0;
+    uint64_t u64_start = sim_now_ns();
+    uint64_t u64_elapsed;
+
+    for (uint32_t i = 1; i <= 8; i++)
+    {
+        u16_stream_len += sim_build_packet(&stream[u16_stream_len], i);
+    }
+
+    memset(&sim_rx, 0, sizeof(sim_rx));
+    do
+    {
+        ymodem_rx_init(&sim_rx.h_rx, 1);
+        uint16_t u16_pos = 0;
+        while (u16_pos < u16_stream_len)
+        {
+            uint16_t u16_read = 1 + (sim_rand() % 64);
+            if (u16_read > (u16_stream_len - u16_pos))
+            {
+                u16_read = u16_stream_len - u16_pos;
+            }
+            ymodem_rx_feed(&sim_rx.h_rx, &stream[u16_pos], u16_read, 0, sim_on_rx_event, NULL);
+            u16_pos += u16_read;
+        }
+        sim_sink ^= sim_rx.h_rx.u32_blocks;
+        u64_bytes += u16_stream_len;
+        u64_elapsed = sim_now_ns() - u64_start;
+    } while (u64_elapsed < SIM_PARSE_MIN_TIME_NS);
+
+    printf("\nymodem_rx_feed, good packets in reads of 1..64 bytes: %.2f ns/byte, %.0f bytes/s\n",
+           (double)u64_elapsed / (double)u64_bytes, ((double)u64_bytes * 1e9) / (double)u64_elapsed);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+int main(void)
+{
+    static const char *const mode_names[] = {"legacy", "incremental"};
+
+    for (uint32_t i = 0; i < SIM_IMAGE_SIZE; i++)
+    {
+        sim_image[i] = (uint8_t)sim_rand();
+    }
+
+    printf("%u byte image at %u baud, line limit %.0f bytes/s\n\n", (unsigned)SIM_IMAGE_SIZE, (unsigned)SIM_BAUD_RATE,
+           1e6 / SIM_BYTE_US);
+    printf("%-32s %-12s %9s %10s %8s %8s %8s %s\n", "scenario", "receiver", "time s", "bytes/s", "packets", "resends",
+           "rewrites", "image");
+
+    for (uint8_t i = 0; i < sizeof(sim_scenarios) / sizeof(sim_scenarios[0]); i++)
+    {
+        for (uint8_t mode = SIM_RX_LEGACY; mode <= SIM_RX_INCREMENTAL; mode++)
+        {
+            // same line for both receivers
+            sim_rng_state = 0x9E3779B9 + i;
+            sim_result_t h_result = sim_transfer((sim_rx_mode_t)mode, &sim_scenarios[i]);
+            printf("%-32s %-12s %9.1f %10.0f %8lu %8lu %8lu %s\n", sim_scenarios[i].p_name, mode_names[mode],
+                   (double)h_result.u64_time_us / 1e6,
+                   h_result.b_complete ? ((double)SIM_IMAGE_SIZE * 1e6) / (double)h_result.u64_time_us : 0.0,
+                   (unsigned long)h_result.u32_packets, (unsigned long)h_result.u32_resends,
+                   (unsigned long)sim_rx.u32_rewrites,
+                   !h_result.b_complete ? "failed" : (h_result.b_image_ok ? "ok" : "corrupt"));
+        }
+    }
+
+    sim_parse_speed();
+
+    return 0;
+}
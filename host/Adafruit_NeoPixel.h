@@ -0,0 +1,69 @@
+/**
+ * @file Adafruit_NeoPixel.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief NeoPixel library of the host builds, the colors are kept for the simulation
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_ADAFRUIT_NEOPIXEL_H__
+#define __HOST_ADAFRUIT_NEOPIXEL_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class Adafruit_NeoPixel
+{
+public:
+    Adafruit_NeoPixel(uint16_t count, int16_t pin, uint16_t type) : _pixels(count, 0), _shown(count, 0) {}
+
+    void begin() {}
+    void clear() { std::fill(_pixels.begin(), _pixels.end(), 0); }
+    void setBrightness(uint8_t brightness) { _brightness = brightness; }
+    void setPixelColor(uint16_t index, uint32_t color)
+    {
+        if (index < _pixels.size())
+        {
+            _pixels[index] = color;
+        }
+    }
+    void show()
+    {
+        _shown = _pixels;
+        _show_count++;
+    }
+    uint32_t getPixelColor(uint16_t index) { return (index < _shown.size()) ? _shown[index] : 0; }
+    uint16_t numPixels() { return (uint16_t)_pixels.size(); }
+    static uint32_t Color(uint8_t red, uint8_t green, uint8_t blue)
+    {
+        return ((uint32_t)red << 16) | ((uint32_t)green << 8) | blue;
+    }
+
+    /**
+     * @brief Updates of the strip since the start, each one costs a refresh on the board
+     */
+    uint32_t get_show_count() { return _show_count; }
+
+private:
+    std::vector<uint32_t> _pixels;
+    std::vector<uint32_t> _shown;   // colors of the last show()
+    uint8_t _brightness = 255;
+    uint32_t _show_count = 0;
+};
+
+#endif // __HOST_ADAFRUIT_NEOPIXEL_H__
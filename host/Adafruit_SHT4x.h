@@ -0,0 +1,57 @@
+/**
+ * @file Adafruit_SHT4x.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief SHT4x library of the host builds, the sensor is never found like on a board without it
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_ADAFRUIT_SHT4X_H__
+#define __HOST_ADAFRUIT_SHT4X_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include "Wire.h"
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef enum
+{
+    SHT4X_HIGH_PRECISION,
+    SHT4X_MED_PRECISION,
+    SHT4X_LOW_PRECISION
+} sht4x_precision_t;
+
+typedef enum
+{
+    SHT4X_NO_HEATER,
+    SHT4X_HIGH_HEATER_1S,
+    SHT4X_HIGH_HEATER_100MS,
+    SHT4X_MED_HEATER_1S,
+    SHT4X_MED_HEATER_100MS,
+    SHT4X_LOW_HEATER_1S,
+    SHT4X_LOW_HEATER_100MS
+} sht4x_heater_t;
+
+typedef struct
+{
+    float temperature;
+    float relative_humidity;
+} sensors_event_t;
+
+class Adafruit_SHT4x
+{
+public:
+    bool begin(TwoWire *wire = &Wire) { return false; }
+    uint32_t readSerial() { return 0; }
+    void setPrecision(sht4x_precision_t precision) {}
+    void setHeater(sht4x_heater_t heater) {}
+    bool getEvent(sensors_event_t *humidity, sensors_event_t *temperature) { return false; }
+};
+
+#endif // __HOST_ADAFRUIT_SHT4X_H__
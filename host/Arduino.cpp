@@ -0,0 +1,143 @@
+/**
+ * @file Arduino.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino core of the host builds, time and pins
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Arduino.h"
+#include "Wire.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static uint8_t gpio_levels[HOST_GPIO_COUNT];
+static host_gpio_write_cb gpio_write_cb = NULL;
+static void (*gpio_isr[HOST_GPIO_COUNT])(void);
+static int gpio_isr_mode[HOST_GPIO_COUNT];
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+EspClass ESP;
+TwoWire Wire;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+unsigned long millis()
+{
+    return (unsigned long)(host_os_micros() / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)host_os_micros();
+}
+
+void delay(uint32_t ms)
+{
+    host_os_sleep_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    host_os_sleep_us(us);
+}
+
+void yield()
+{
+    host_os_yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    // nothing drives the pin yet, the pull up does
+    if ((pin < HOST_GPIO_COUNT) && (INPUT_PULLUP == mode))
+    {
+        gpio_levels[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    if (pin < HOST_GPIO_COUNT)
+    {
+        gpio_levels[pin] = level;
+        if (NULL != gpio_write_cb)
+        {
+            gpio_write_cb(pin, level);
+        }
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin < HOST_GPIO_COUNT) ? gpio_levels[pin] : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+    if (pin < HOST_GPIO_COUNT)
+    {
+        gpio_isr[pin] = isr;
+        gpio_isr_mode[pin] = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < HOST_GPIO_COUNT)
+    {
+        gpio_isr[pin] = NULL;
+    }
+}
+
+void host_gpio_set_write_cb(host_gpio_write_cb write_cb)
+{
+    gpio_write_cb = write_cb;
+}
+
+void host_gpio_set_input(uint8_t pin, uint8_t level)
+{
+    if (pin >= HOST_GPIO_COUNT)
+    {
+        return;
+    }
+
+    uint8_t prev_level = gpio_levels[pin];
+    gpio_levels[pin] = level;
+    if ((NULL == gpio_isr[pin]) || (prev_level == level))
+    {
+        return;
+    }
+    if ((CHANGE == gpio_isr_mode[pin]) || ((RISING == gpio_isr_mode[pin]) && (HIGH == level)) ||
+        ((FALLING == gpio_isr_mode[pin]) && (LOW == level)))
+    {
+        // the isr runs in the task driving the pin, no other task runs meanwhile
+        gpio_isr[pin]();
+    }
+}
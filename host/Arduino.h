@@ -0,0 +1,121 @@
+/**
+ * @file Arduino.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino core of the host builds, the firmware sources build unchanged for Linux
+ *        Time comes from host_os, see host_os_set_clock() for the real and the virtual clock.
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <memory> // the firmware includes some headers inside extern "C", the templates have to come first
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "host_os.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define HOST_GPIO_COUNT 49 // pins of the esp32-s3
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define IRAM_ATTR
+
+#define digitalPinToInterrupt(pin) (((pin) < HOST_GPIO_COUNT) ? (pin) : -1)
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+// same as the esp32 core, both arguments have the same type
+using std::max;
+using std::min;
+
+/**
+ * @brief Called on every digitalWrite(), a simulated device can follow its reset line with it
+ */
+typedef void (*host_gpio_write_cb)(uint8_t pin, uint8_t level);
+
+class EspClass
+{
+public:
+    void restart() { host_os_restart(); }
+    uint32_t getFreeHeap() { return 0; }
+};
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+extern EspClass ESP;
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+void host_gpio_set_write_cb(host_gpio_write_cb write_cb);
+
+// sketch entry points, a host program which runs the sketch calls them
+void setup();
+void loop();
+
+/**
+ * @brief Level of an input pin, as a simulated device drives it, an edge runs the interrupt of the pin
+ */
+void host_gpio_set_input(uint8_t pin, uint8_t level);
+
+#endif // __HOST_ARDUINO_H__
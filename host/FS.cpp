@@ -0,0 +1,173 @@
+/**
+ * @file FS.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino file system and SPIFFS of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "FS.h"
+#include "SPIFFS.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+SPIFFSFS SPIFFS;
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+File::File(FILE *file, const char *path) : _file(file, fclose), _path(path)
+{
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    return _file ? fwrite(buffer, 1, size, _file.get()) : 0;
+}
+
+int File::available()
+{
+    return _file ? (int)(size() - position()) : 0;
+}
+
+int File::read()
+{
+    return _file ? fgetc(_file.get()) : -1;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    return _file ? fread(buffer, 1, size, _file.get()) : 0;
+}
+
+int File::peek()
+{
+    if (!_file)
+    {
+        return -1;
+    }
+    int data = fgetc(_file.get());
+    if (EOF != data)
+    {
+        ungetc(data, _file.get());
+    }
+    return data;
+}
+
+void File::flush()
+{
+    if (_file)
+    {
+        fflush(_file.get());
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return _file && (0 == fseek(_file.get(), pos, whence[mode]));
+}
+
+size_t File::position() const
+{
+    long pos = _file ? ftell(_file.get()) : -1;
+    return (pos < 0) ? 0 : (size_t)pos;
+}
+
+size_t File::size() const
+{
+    struct stat info;
+    if (!_file)
+    {
+        return 0;
+    }
+    // buffered writes count as well
+    fflush(_file.get());
+    return (0 == fstat(fileno(_file.get()), &info)) ? (size_t)info.st_size : 0;
+}
+
+const char *File::name() const
+{
+    const char *p_name = strrchr(_path.c_str(), '/');
+    return (NULL != p_name) ? (p_name + 1) : _path.c_str();
+}
+
+File FS::open(const char *path, const char *mode, bool create)
+{
+    std::string host_mode(mode);
+    host_mode += "b";
+
+    FILE *file = fopen(host_path(path).c_str(), host_mode.c_str());
+    if (NULL == file)
+    {
+        return File();
+    }
+    return File(file, path);
+}
+
+bool FS::exists(const char *path)
+{
+    return 0 == access(host_path(path).c_str(), F_OK);
+}
+
+bool FS::remove(const char *path)
+{
+    return 0 == ::remove(host_path(path).c_str());
+}
+
+bool FS::rename(const char *path_from, const char *path_to)
+{
+    return 0 == ::rename(host_path(path_from).c_str(), host_path(path_to).c_str());
+}
+
+std::string FS::host_path(const char *path)
+{
+    std::string full_path(_root);
+    if ('/' != path[0])
+    {
+        full_path += "/";
+    }
+    return full_path + path;
+}
+
+bool SPIFFSFS::begin(bool format_on_fail, const char *base_path, uint8_t max_open_files, const char *partition_label)
+{
+    struct stat info;
+    if ((0 == stat(_root.c_str(), &info)) && S_ISDIR(info.st_mode))
+    {
+        return true;
+    }
+    return 0 == mkdir(_root.c_str(), 0755);
+}
+
+bool SPIFFSFS::format()
+{
+    DIR *dir = opendir(_root.c_str());
+    if (NULL == dir)
+    {
+        return false;
+    }
+
+    // spiffs has no directories, the files are all at the root
+    struct dirent *entry;
+    while (NULL != (entry = readdir(dir)))
+    {
+        if ('.' != entry->d_name[0])
+        {
+            remove(entry->d_name);
+        }
+    }
+    closedir(dir);
+    return true;
+}
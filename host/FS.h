@@ -0,0 +1,110 @@
+/**
+ * @file FS.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino file system of the host builds, the files are in a directory of the machine
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_FS_H__
+#define __HOST_FS_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include "Stream.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+#define HOST_FS_DEFAULT_ROOT "host_fs" // directory of the files, relative to the working directory
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+/**
+ * @brief Open file, copies share it like on the esp32
+ */
+class File : public Stream
+{
+public:
+    File() {}
+    File(FILE *file, const char *path);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    size_t read(uint8_t *buffer, size_t size);
+    int peek() override;
+    void flush() override;
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close() { _file.reset(); }
+    const char *path() const { return _path.c_str(); }
+    const char *name() const;
+    operator bool() const { return (bool)_file; }
+
+private:
+    std::shared_ptr<FILE> _file;
+    std::string _path;
+};
+
+/**
+ * @brief File system rooted in a directory of the machine, the path "/a.bin" is "<root>/a.bin"
+ */
+class FS
+{
+public:
+    explicit FS(const char *root) : _root(root) {}
+
+    /**
+     * @brief Opens a file, the modes of fopen()
+     * @param create ignored, the write modes always create the file
+     */
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false) { return open(path.c_str(), mode, create); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *path_from, const char *path_to);
+
+    /**
+     * @brief Directory of the files, before begin()
+     */
+    void set_root(const char *root) { _root = root; }
+    const char *get_root() { return _root.c_str(); }
+
+protected:
+    std::string _root;
+
+    std::string host_path(const char *path);
+};
+
+namespace fs
+{
+typedef ::File File;
+typedef ::FS FS;
+}
+
+#endif // __HOST_FS_H__
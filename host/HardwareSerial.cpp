@@ -0,0 +1,365 @@
+/**
+ * @file HardwareSerial.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino HardwareSerial of the host builds, over an in-memory line or a pty
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "HardwareSerial.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define HOST_SERIAL_PTY_READ_SIZE 256
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static speed_t host_serial_get_speed(unsigned long baud)
+{
+    switch (baud)
+    {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+    default:
+        return B115200;
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+HardwareSerial::~HardwareSerial()
+{
+    if (_pty_fd >= 0)
+    {
+        close(_pty_fd);
+    }
+    if (_pty_peer_fd >= 0)
+    {
+        close(_pty_peer_fd);
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rx_pin, int8_t tx_pin,
+                           bool invert, unsigned long timeout_ms, uint8_t rxfifo_full_thrhd)
+{
+    _baud = baud;
+    add_source();
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size)
+{
+    _rx_buffer_size = size;
+    return size;
+}
+
+bool HardwareSerial::setRxTimeout(uint8_t symbols)
+{
+    _rx_timeout = symbols;
+    return true;
+}
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool only_on_timeout)
+{
+    _on_receive = function;
+    add_source();
+}
+
+int HardwareSerial::available()
+{
+    receive_arrived(host_os_micros());
+    if (_rx.empty())
+    {
+        // firmware polls the port in a loop, whatever sends the bytes needs to run
+        host_os_yield();
+        receive_arrived(host_os_micros());
+    }
+    return (int)_rx.size();
+}
+
+int HardwareSerial::read()
+{
+    uint8_t data;
+    return (1 == read(&data, 1)) ? data : -1;
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size)
+{
+    receive_arrived(host_os_micros());
+
+    size_t count = 0;
+    while ((count < size) && !_rx.empty())
+    {
+        buffer[count++] = _rx.front();
+        _rx.pop_front();
+    }
+    return count;
+}
+
+int HardwareSerial::peek()
+{
+    receive_arrived(host_os_micros());
+    return _rx.empty() ? -1 : _rx.front();
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (NULL != _peer)
+    {
+        send_to(*_peer, buffer, size);
+    }
+    else if (_pty_fd >= 0)
+    {
+        size_t written = 0;
+        while (written < size)
+        {
+            ssize_t result = ::write(_pty_fd, &buffer[written], size - written);
+            if (result > 0)
+            {
+                written += result;
+            }
+            else if ((result < 0) && (EAGAIN != errno) && (EINTR != errno))
+            {
+                break;
+            }
+        }
+    }
+    else if (NULL != _output)
+    {
+        fwrite(buffer, 1, size, _output);
+    }
+    return size;
+}
+
+void HardwareSerial::flush()
+{
+    // returns once the last byte is out on the line
+    while (_tx_free_us > host_os_micros())
+    {
+        host_os_sleep_us(_tx_free_us - host_os_micros());
+    }
+    if ((NULL == _peer) && (_pty_fd < 0) && (NULL != _output))
+    {
+        fflush(_output);
+    }
+}
+
+void HardwareSerial::attach_line(HardwareSerial &peer, bool is_timed)
+{
+    _peer = &peer;
+    _is_timed = is_timed;
+    peer._peer = this;
+    peer._is_timed = is_timed;
+    add_source();
+    peer.add_source();
+}
+
+const char *HardwareSerial::attach_pty()
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((fd < 0) || (0 != grantpt(fd)) || (0 != unlockpt(fd)) || (NULL == ptsname(fd)))
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return NULL;
+    }
+    strncpy(_pty_path, ptsname(fd), sizeof(_pty_path) - 1);
+    _pty_path[sizeof(_pty_path) - 1] = '\0';
+
+    // the other end is kept open, the pty stays usable while the other process reopens it
+    _pty_peer_fd = open(_pty_path, O_RDWR | O_NOCTTY);
+    struct termios settings;
+    if ((_pty_peer_fd >= 0) && (0 == tcgetattr(_pty_peer_fd, &settings)))
+    {
+        cfmakeraw(&settings);
+        tcsetattr(_pty_peer_fd, TCSANOW, &settings);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    _pty_fd = fd;
+    add_source();
+
+    return _pty_path;
+}
+
+bool HardwareSerial::attach_device(const char *path)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // raw bytes at the baud rate of begin(), a pty ignores the speed
+    struct termios settings;
+    if (0 == tcgetattr(fd, &settings))
+    {
+        cfmakeraw(&settings);
+        cfsetspeed(&settings, host_serial_get_speed(_baud));
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+    strncpy(_pty_path, path, sizeof(_pty_path) - 1);
+    _pty_path[sizeof(_pty_path) - 1] = '\0';
+    _pty_fd = fd;
+    add_source();
+
+    return true;
+}
+
+bool HardwareSerial::dispatch(uint64_t now_us)
+{
+    if (receive_arrived(now_us))
+    {
+        host_os_notify();
+    }
+
+    if (_on_receive && (_rx_since_callback > 0) && !_rx.empty() &&
+        ((_rx_since_callback >= HOST_SERIAL_RX_FIFO_FULL) ||
+         (now_us >= (_last_arrival_us + (_rx_timeout * get_byte_us())))))
+    {
+        _rx_since_callback = 0;
+        _on_receive();
+        return true;
+    }
+    return false;
+}
+
+uint64_t HardwareSerial::next_event_us()
+{
+    uint64_t next_us = HOST_OS_FOREVER;
+
+    if (!_in_flight.empty())
+    {
+        next_us = _in_flight.front().arrival_us;
+    }
+    if (_on_receive && (_rx_since_callback > 0) && !_rx.empty())
+    {
+        uint64_t callback_us = _last_arrival_us + (_rx_timeout * get_byte_us());
+        if (callback_us < next_us)
+        {
+            next_us = callback_us;
+        }
+    }
+    return next_us;
+}
+
+void HardwareSerial::add_source()
+{
+    if (!_is_source)
+    {
+        _is_source = true;
+        host_os_add_source(this);
+    }
+}
+
+void HardwareSerial::send_to(HardwareSerial &peer, const uint8_t *buffer, size_t size)
+{
+    uint64_t now_us = host_os_micros();
+    uint64_t byte_us = get_byte_us();
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint64_t arrival_us = now_us;
+        if (_is_timed)
+        {
+            _tx_free_us = ((_tx_free_us > now_us) ? _tx_free_us : now_us) + byte_us;
+            arrival_us = _tx_free_us;
+        }
+        peer._in_flight.push_back({arrival_us, buffer[i]});
+    }
+}
+
+/**
+ * @brief Moves the bytes which reached the port into the receive buffer
+ * @return true if any byte was received
+ */
+bool HardwareSerial::receive_arrived(uint64_t now_us)
+{
+    size_t received = 0;
+
+    while (!_in_flight.empty() && (_in_flight.front().arrival_us <= now_us))
+    {
+        if (_rx.size() < _rx_buffer_size)
+        {
+            _rx.push_back(_in_flight.front().data);
+        }
+        else
+        {
+            _rx_overflow_count++;
+        }
+        _last_arrival_us = _in_flight.front().arrival_us;
+        _in_flight.pop_front();
+        received++;
+    }
+
+    if (_pty_fd >= 0)
+    {
+        uint8_t chunk[HOST_SERIAL_PTY_READ_SIZE];
+        ssize_t size;
+        while ((size = ::read(_pty_fd, chunk, sizeof(chunk))) > 0)
+        {
+            for (ssize_t i = 0; i < size; i++)
+            {
+                if (_rx.size() < _rx_buffer_size)
+                {
+                    _rx.push_back(chunk[i]);
+                }
+                else
+                {
+                    _rx_overflow_count++;
+                }
+            }
+            _last_arrival_us = now_us;
+            received += size;
+        }
+    }
+
+    _rx_since_callback += received;
+    return received > 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file HardwareSerial.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino HardwareSerial of the host builds, over an in-memory line or a pty
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_HARDWARE_SERIAL_H__
+#define __HOST_HARDWARE_SERIAL_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <deque>
+#include <functional>
+#include "Stream.h"
+#include "host_os.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define SERIAL_8N1 0x800001c
+
+#define HOST_SERIAL_RX_BUFFER_SIZE 256  // default of the esp32 core
+#define HOST_SERIAL_RX_TIMEOUT 2        // idle symbols before the receive callback, default of the esp32 core
+#define HOST_SERIAL_RX_FIFO_FULL 120    // bytes received before the callback runs without the line going idle
+#define HOST_SERIAL_BITS_PER_BYTE 10    // 8N1
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef std::function<void(void)> OnReceiveCb;
+
+/**
+ * @brief Serial port of the host builds
+ *
+ * A port is one of
+ * - a console, written to a FILE, the default one is stdout
+ * - one end of an in-memory line, see attach_line(). The bytes take the time of the baud rate
+ *   to go through, so the receive callbacks and the idle timeouts see what a uart would
+ * - a pty, see attach_pty(), another process opens its other end
+ *
+ * The receive callback runs from the scheduler, the way the uart driver task runs it on the
+ * esp32: after the line is idle for HOST_SERIAL_RX_TIMEOUT symbols, or every
+ * HOST_SERIAL_RX_FIFO_FULL bytes while it is busy.
+ */
+class HardwareSerial : public Stream, public HostEventSource
+{
+public:
+    explicit HardwareSerial(int uart_nr) : _uart_nr(uart_nr) {}
+    ~HardwareSerial();
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rx_pin = -1, int8_t tx_pin = -1,
+               bool invert = false, unsigned long timeout_ms = 20000UL, uint8_t rxfifo_full_thrhd = 112);
+    void end() {}
+    size_t setRxBufferSize(size_t size);
+    size_t setTxBufferSize(size_t size) { return size; }
+    bool setRxTimeout(uint8_t symbols);
+    void onReceive(OnReceiveCb function, bool only_on_timeout = false);
+    void updateBaudRate(unsigned long baud) { _baud = baud; }
+    unsigned long baudRate() { return _baud; }
+
+    /**
+     * @brief Bytes received, an empty port lets the other tasks run before it answers
+     */
+    int available() override;
+    int availableForWrite() { return HOST_SERIAL_RX_BUFFER_SIZE; }
+    int read() override;
+    size_t read(uint8_t *buffer, size_t size);
+    size_t read(char *buffer, size_t size) { return read((uint8_t *)buffer, size); }
+    int peek() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    operator bool() const { return true; }
+
+    /**
+     * @brief Connects the port to another one, what one writes the other receives
+     * @param is_timed false: the bytes arrive at once, whatever the baud rate
+     */
+    void attach_line(HardwareSerial &peer, bool is_timed = true);
+
+    /**
+     * @brief Connects the port to a new pty, for the real clock only
+     * @return path of the other end, NULL if the pty can not be opened
+     */
+    const char *attach_pty();
+
+    /**
+     * @brief Connects the port to a tty, the pty of another process or a serial adapter, for the real clock only
+     * @return false if the device can not be opened
+     */
+    bool attach_device(const char *path);
+
+    /**
+     * @brief Output of a console port, NULL drops it
+     */
+    void attach_output(FILE *output) { _output = output; }
+
+    /**
+     * @brief Bytes lost since the start, the receive buffer was full
+     */
+    uint32_t get_rx_overflow_count() { return _rx_overflow_count; }
+
+    bool dispatch(uint64_t now_us) override;
+    uint64_t next_event_us() override;
+    int get_fd() override { return _pty_fd; }
+
+private:
+    typedef struct
+    {
+        uint64_t arrival_us;
+        uint8_t data;
+    } in_flight_t;
+
+    int _uart_nr;
+    unsigned long _baud = 115200;
+    FILE *_output = stdout;
+    HardwareSerial *_peer = NULL;
+    bool _is_timed = true;
+    int _pty_fd = -1;
+    int _pty_peer_fd = -1;
+    char _pty_path[64];
+    bool _is_source = false;
+
+    std::deque<in_flight_t> _in_flight;  // written by the other end, not received yet
+    std::deque<uint8_t> _rx;
+    size_t _rx_buffer_size = HOST_SERIAL_RX_BUFFER_SIZE;
+    uint32_t _rx_overflow_count = 0;
+    uint64_t _tx_free_us = 0;            // end of the last byte written on the line
+    uint64_t _last_arrival_us = 0;
+    uint8_t _rx_timeout = HOST_SERIAL_RX_TIMEOUT;
+    size_t _rx_since_callback = 0;
+    OnReceiveCb _on_receive;
+
+    void add_source();
+    uint64_t get_byte_us() { return (HOST_SERIAL_BITS_PER_BYTE * 1000000ULL) / _baud; }
+    void send_to(HardwareSerial &peer, const uint8_t *buffer, size_t size);
+    bool receive_arrived(uint64_t now_us);
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // __HOST_HARDWARE_SERIAL_H__
@@ -0,0 +1,122 @@
+/**
+ * @file Print.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino Print and Stream of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Print.h"
+#include "Stream.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define PRINT_FORMAT_BUFFER_SIZE 256 // longer lines are formatted into the heap
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while ((written < size) && (1 == write(buffer[written])))
+    {
+        written++;
+    }
+    return written;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buffer[PRINT_FORMAT_BUFFER_SIZE];
+    char *p_line = buffer;
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (len < 0)
+    {
+        return 0;
+    }
+
+    if ((size_t)len >= sizeof(buffer))
+    {
+        p_line = (char *)malloc(len + 1);
+        if (NULL == p_line)
+        {
+            return 0;
+        }
+        va_start(args, format);
+        vsnprintf(p_line, len + 1, format, args);
+        va_end(args);
+    }
+
+    size_t written = write((const uint8_t *)p_line, len);
+    if (p_line != buffer)
+    {
+        free(p_line);
+    }
+    return written;
+}
+
+size_t Print::print(long value, int base)
+{
+    if ((DEC == base) && (value < 0))
+    {
+        return print('-') + print((unsigned long)-value, base);
+    }
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char buffer[8 * sizeof(unsigned long) + 1];
+    char *p_digit = &buffer[sizeof(buffer) - 1];
+
+    if (base < 2)
+    {
+        base = DEC;
+    }
+    *p_digit = '\0';
+    do
+    {
+        unsigned long digit = value % base;
+        *--p_digit = (char)((digit < 10) ? ('0' + digit) : ('A' + digit - 10));
+        value /= base;
+    } while (0 != value);
+
+    return write(p_digit);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char buffer[64];
+    int len = snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return (len > 0) ? write((const uint8_t *)buffer, (size_t)len) : 0;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t count = 0;
+    int data;
+    while ((count < length) && (available() > 0) && ((data = read()) >= 0))
+    {
+        buffer[count++] = (uint8_t)data;
+    }
+    return count;
+}
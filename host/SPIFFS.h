@@ -0,0 +1,45 @@
+/**
+ * @file SPIFFS.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief SPIFFS of the host builds, see FS.h
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_SPIFFS_H__
+#define __HOST_SPIFFS_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "FS.h"
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class SPIFFSFS : public FS
+{
+public:
+    SPIFFSFS() : FS(HOST_FS_DEFAULT_ROOT) {}
+
+    /**
+     * @brief Creates the directory of the files if needed
+     */
+    bool begin(bool format_on_fail = false, const char *base_path = "/spiffs", uint8_t max_open_files = 10,
+               const char *partition_label = NULL);
+    void end() {}
+
+    /**
+     * @brief Removes every file
+     */
+    bool format();
+};
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+extern SPIFFSFS SPIFFS;
+
+#endif // __HOST_SPIFFS_H__
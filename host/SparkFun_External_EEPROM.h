@@ -0,0 +1,70 @@
+/**
+ * @file SparkFun_External_EEPROM.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief External EEPROM library of the host builds, the memory is an erased array
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_SPARKFUN_EXTERNAL_EEPROM_H__
+#define __HOST_SPARKFUN_EXTERNAL_EEPROM_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class ExternalEEPROM
+{
+public:
+    /**
+     * @brief Size of the memory in kbit, like the 24xx part numbers
+     */
+    void setMemoryType(uint16_t type) { _memory.assign((size_t)type * 1024 / 8, 0xFF); }
+    bool begin() { return !_memory.empty(); }
+    uint32_t length() { return (uint32_t)_memory.size(); }
+
+    int read(uint32_t address, uint8_t *buffer, uint16_t size)
+    {
+        if ((address + size) > _memory.size())
+        {
+            return -1;
+        }
+        memcpy(buffer, &_memory[address], size);
+        return 0;
+    }
+    int write(uint32_t address, const uint8_t *buffer, uint16_t size)
+    {
+        if ((address + size) > _memory.size())
+        {
+            return -1;
+        }
+        memcpy(&_memory[address], buffer, size);
+        return 0;
+    }
+    void erase(uint8_t value = 0x00) { std::fill(_memory.begin(), _memory.end(), value); }
+
+    template <typename T> T &get(uint32_t address, T &value)
+    {
+        read(address, (uint8_t *)&value, sizeof(T));
+        return value;
+    }
+    template <typename T> const T &put(uint32_t address, const T &value)
+    {
+        write(address, (const uint8_t *)&value, sizeof(T));
+        return value;
+    }
+
+private:
+    std::vector<uint8_t> _memory;
+};
+
+#endif // __HOST_SPARKFUN_EXTERNAL_EEPROM_H__
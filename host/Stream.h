@@ -0,0 +1,40 @@
+/**
+ * @file Stream.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino Stream of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_STREAM_H__
+#define __HOST_STREAM_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "Print.h"
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    /**
+     * @brief Reads what is available, the host ports do not wait for the rest
+     */
+    virtual size_t readBytes(uint8_t *buffer, size_t length);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    void setTimeout(unsigned long timeout_ms) { _timeout_ms = timeout_ms; }
+
+protected:
+    unsigned long _timeout_ms = 1000;
+};
+
+#endif // __HOST_STREAM_H__
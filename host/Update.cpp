@@ -0,0 +1,154 @@
+/**
+ * @file Update.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino Update of the host builds, the new firmware is written into a file
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Update.h"
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define UPDATE_IMAGE_MAGIC 0xE9 // first byte of an esp32 application image
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+UpdateClass Update;
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+bool UpdateClass::begin(size_t size, int command, int led_pin, uint8_t led_on, const char *label)
+{
+    if (NULL != _file)
+    {
+        fail(UPDATE_ERROR_BAD_ARGUMENT);
+        return false;
+    }
+
+    _error = UPDATE_ERROR_OK;
+    _progress = 0;
+    _size = (UPDATE_SIZE_UNKNOWN == size) ? _capacity : size;
+    if ((0 == size) || (U_FLASH != command))
+    {
+        fail(UPDATE_ERROR_BAD_ARGUMENT);
+        return false;
+    }
+    if (_size > _capacity)
+    {
+        fail(UPDATE_ERROR_SIZE);
+        return false;
+    }
+
+    _file = fopen(_path.c_str(), "wb");
+    if (NULL == _file)
+    {
+        fail(UPDATE_ERROR_NO_PARTITION);
+        return false;
+    }
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t *data, size_t len)
+{
+    if ((NULL == _file) || hasError())
+    {
+        return 0;
+    }
+    if (len > remaining())
+    {
+        fail(UPDATE_ERROR_SPACE);
+        return 0;
+    }
+    if ((0 == _progress) && (len > 0) && (UPDATE_IMAGE_MAGIC != data[0]))
+    {
+        fail(UPDATE_ERROR_MAGIC_BYTE);
+        return 0;
+    }
+    if (fwrite(data, 1, len, _file) != len)
+    {
+        fail(UPDATE_ERROR_WRITE);
+        return 0;
+    }
+    _progress += len;
+    return len;
+}
+
+size_t UpdateClass::writeStream(Stream &data)
+{
+    uint8_t chunk[HOST_UPDATE_STREAM_CHUNK];
+    size_t written = 0;
+
+    while (!hasError() && (remaining() > 0))
+    {
+        size_t len = data.readBytes(chunk, (remaining() < sizeof(chunk)) ? remaining() : sizeof(chunk));
+        if (0 == len)
+        {
+            fail(UPDATE_ERROR_STREAM);
+            break;
+        }
+        if (write(chunk, len) != len)
+        {
+            break;
+        }
+        written += len;
+    }
+    return written;
+}
+
+bool UpdateClass::end(bool even_if_remaining)
+{
+    if ((NULL == _file) || hasError())
+    {
+        return false;
+    }
+    if (!isFinished() && !even_if_remaining)
+    {
+        fail(UPDATE_ERROR_ABORT);
+        return false;
+    }
+
+    fclose(_file);
+    _file = NULL;
+    _update_count++;
+    return true;
+}
+
+void UpdateClass::abort()
+{
+    fail(UPDATE_ERROR_ABORT);
+}
+
+const char *UpdateClass::errorString()
+{
+    static const char *const error_strings[] = {
+        "No Error", "Flash Write Failed", "Flash Erase Failed", "Flash Read Failed", "Not Enough Space",
+        "Bad Size Given", "Stream Read Timeout", "MD5 Check Failed", "Wrong Magic Byte",
+        "Could Not Activate The Firmware", "Partition Could Not be Found", "Bad Argument", "Aborted"};
+    return (_error < (sizeof(error_strings) / sizeof(error_strings[0]))) ? error_strings[_error] : "UNKNOWN";
+}
+
+void UpdateClass::set_image_path(const char *path, size_t capacity)
+{
+    _path = path;
+    _capacity = capacity;
+}
+
+void UpdateClass::fail(uint8_t error)
+{
+    _error = error;
+    if (NULL != _file)
+    {
+        fclose(_file);
+        _file = NULL;
+    }
+}
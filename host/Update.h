@@ -0,0 +1,105 @@
+/**
+ * @file Update.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino Update of the host builds, the new firmware is written into a file
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_UPDATE_H__
+#define __HOST_UPDATE_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "Stream.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define UPDATE_ERROR_OK (0)
+#define UPDATE_ERROR_WRITE (1)
+#define UPDATE_ERROR_ERASE (2)
+#define UPDATE_ERROR_READ (3)
+#define UPDATE_ERROR_SPACE (4)
+#define UPDATE_ERROR_SIZE (5)
+#define UPDATE_ERROR_STREAM (6)
+#define UPDATE_ERROR_MD5 (7)
+#define UPDATE_ERROR_MAGIC_BYTE (8)
+#define UPDATE_ERROR_ACTIVATE (9)
+#define UPDATE_ERROR_NO_PARTITION (10)
+#define UPDATE_ERROR_BAD_ARGUMENT (11)
+#define UPDATE_ERROR_ABORT (12)
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+#define U_FLASH 0
+#define U_SPIFFS 100
+
+#define HOST_UPDATE_DEFAULT_PATH "host_update.bin"
+#define HOST_UPDATE_DEFAULT_CAPACITY 0x140000 // app partition of the default 4 MB table
+#define HOST_UPDATE_STREAM_CHUNK 1024
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**
+ * @brief Update of the running firmware, the image goes into a file
+ *
+ * The image is checked like the esp32 core checks it, the first byte has to be the
+ * magic byte and every byte announced to begin() has to be written before end().
+ */
+class UpdateClass
+{
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH, int led_pin = -1, uint8_t led_on = 0,
+               const char *label = NULL);
+    size_t write(uint8_t *data, size_t len);
+    size_t writeStream(Stream &data);
+    bool end(bool even_if_remaining = false);
+    void abort();
+
+    bool hasError() { return UPDATE_ERROR_OK != _error; }
+    uint8_t getError() { return _error; }
+    const char *errorString();
+    void printError(Print &out) { out.println(errorString()); }
+    bool isRunning() { return NULL != _file; }
+    bool isFinished() { return _progress == _size; }
+    size_t size() { return _size; }
+    size_t progress() { return _progress; }
+    size_t remaining() { return _size - _progress; }
+
+    /**
+     * @brief File the image is written into, and the space it can take
+     */
+    void set_image_path(const char *path, size_t capacity = HOST_UPDATE_DEFAULT_CAPACITY);
+
+    /**
+     * @brief Number of images completed with end() since the start
+     */
+    uint32_t get_update_count() { return _update_count; }
+
+private:
+    std::string _path = HOST_UPDATE_DEFAULT_PATH;
+    size_t _capacity = HOST_UPDATE_DEFAULT_CAPACITY;
+    FILE *_file = NULL;
+    size_t _size = 0;
+    size_t _progress = 0;
+    uint8_t _error = UPDATE_ERROR_OK;
+    uint32_t _update_count = 0;
+
+    void fail(uint8_t error);
+};
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+extern UpdateClass Update;
+
+#endif // __HOST_UPDATE_H__
@@ -0,0 +1,16 @@
+/**
+ * @file WProgram.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Pre 1.0 name of Arduino.h, included by the libraries when ARDUINO is not defined
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_WPROGRAM_H__
+#define __HOST_WPROGRAM_H__
+
+#include "Arduino.h"
+
+#endif // __HOST_WPROGRAM_H__
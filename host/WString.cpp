@@ -0,0 +1,115 @@
+/**
+ * @file WString.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino String of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <ctype.h>
+#include <stdio.h>
+#include "WString.h"
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+String::String(long value, unsigned char base)
+{
+    if ((10 == base) && (value < 0))
+    {
+        _str = "-" + String((unsigned long)-value, base)._str;
+    }
+    else
+    {
+        _str = String((unsigned long)value, base)._str;
+    }
+}
+
+String::String(unsigned long value, unsigned char base)
+{
+    if (base < 2)
+    {
+        base = 10;
+    }
+    do
+    {
+        unsigned long digit = value % base;
+        _str.insert(_str.begin(), (char)((digit < 10) ? ('0' + digit) : ('a' + digit - 10)));
+        value /= base;
+    } while (0 != value);
+}
+
+String::String(double value, unsigned int decimals)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    _str = buffer;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return (suffix._str.length() <= _str.length()) &&
+           (0 == _str.compare(_str.length() - suffix._str.length(), suffix._str.length(), suffix._str));
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    size_t index = _str.find(c, from);
+    return (std::string::npos == index) ? -1 : (int)index;
+}
+
+int String::indexOf(const String &str, unsigned int from) const
+{
+    size_t index = _str.find(str._str, from);
+    return (std::string::npos == index) ? -1 : (int)index;
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    if (from >= _str.length())
+    {
+        return String();
+    }
+    return String(_str.substr(from, to - from));
+}
+
+void String::trim()
+{
+    size_t start = 0;
+    size_t end = _str.length();
+    while ((start < end) && isspace((unsigned char)_str[start]))
+    {
+        start++;
+    }
+    while ((end > start) && isspace((unsigned char)_str[end - 1]))
+    {
+        end--;
+    }
+    _str = _str.substr(start, end - start);
+}
+
+void String::toUpperCase()
+{
+    for (char &c : _str)
+    {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : _str)
+    {
+        c = (char)tolower((unsigned char)c);
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file WString.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Arduino String of the host builds, over std::string
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_WSTRING_H__
+#define __HOST_WSTRING_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define PSTR(string_literal) (string_literal)
+
+class String
+{
+public:
+    String() {}
+    String(const char *cstr) : _str((NULL != cstr) ? cstr : "") {}
+    String(const __FlashStringHelper *fstr) : String(reinterpret_cast<const char *>(fstr)) {}
+    String(const std::string &str) : _str(str) {}
+    explicit String(char c) : _str(1, c) {}
+    explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+    explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(double value, unsigned int decimals = 2);
+    explicit String(float value, unsigned int decimals = 2) : String((double)value, decimals) {}
+
+    const char *c_str() const { return _str.c_str(); }
+    unsigned int length() const { return (unsigned int)_str.length(); }
+    bool isEmpty() const { return _str.empty(); }
+    char charAt(unsigned int index) const { return (index < _str.length()) ? _str[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    bool concat(const String &str) { _str += str._str; return true; }
+    bool concat(const char *cstr) { _str += (NULL != cstr) ? cstr : ""; return true; }
+    bool concat(char c) { _str += c; return true; }
+    template <typename T> bool concat(T value) { return concat(String(value)); }
+    template <typename T> String &operator+=(const T &value) { concat(value); return *this; }
+
+    bool equals(const String &str) const { return _str == str._str; }
+    bool equals(const char *cstr) const { return _str == ((NULL != cstr) ? cstr : ""); }
+    bool operator==(const String &str) const { return equals(str); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &str) const { return !equals(str); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool startsWith(const String &prefix) const { return 0 == _str.compare(0, prefix._str.length(), prefix._str); }
+    bool endsWith(const String &suffix) const;
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &str, unsigned int from = 0) const;
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const;
+    void trim();
+    void toUpperCase();
+    void toLowerCase();
+    long toInt() const { return strtol(_str.c_str(), NULL, 10); }
+    double toDouble() const { return strtod(_str.c_str(), NULL); }
+    float toFloat() const { return (float)toDouble(); }
+
+private:
+    std::string _str;
+};
+
+template <typename T> String operator+(const String &lhs, const T &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+#endif // __HOST_WSTRING_H__
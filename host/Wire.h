@@ -0,0 +1,35 @@
+/**
+ * @file Wire.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief I2C bus of the host builds, no device answers on it
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_WIRE_H__
+#define __HOST_WIRE_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+class TwoWire
+{
+public:
+    bool setPins(int sda, int scl) { return true; }
+    bool begin() { return true; }
+    void end() {}
+};
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+extern TwoWire Wire;
+
+#endif // __HOST_WIRE_H__
@@ -0,0 +1,28 @@
+/**
+ * @file esp_system.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief ESP-IDF system calls of the host builds
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_ESP_SYSTEM_H__
+#define __HOST_ESP_SYSTEM_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "esp_err.h"
+#include "host_os.h"
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+static inline void esp_restart(void)
+{
+    host_os_restart();
+}
+
+#endif // __HOST_ESP_SYSTEM_H__
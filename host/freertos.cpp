@@ -0,0 +1,248 @@
+/**
+ * @file freertos.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief FreeRTOS tasks, queues and stream buffers of the host builds, on top of host_os
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_os.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/task.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+struct host_queue_t
+{
+    uint8_t *items;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct host_stream_buffer_t
+{
+    uint8_t *data;
+    size_t size;
+    size_t trigger_level;
+    size_t head;
+    size_t count;
+};
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint64_t ticks_to_deadline(TickType_t ticks)
+{
+    if (portMAX_DELAY == ticks)
+    {
+        return HOST_OS_FOREVER;
+    }
+    return host_os_micros() + ((uint64_t)ticks * (1000000ULL / configTICK_RATE_HZ));
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+BaseType_t xTaskCreate(TaskFunction_t task_fn, const char *name, uint32_t stack_size, void *arg,
+                       UBaseType_t priority, TaskHandle_t *p_handle)
+{
+    void *task = host_os_task_create(task_fn, arg, name, stack_size);
+    if (NULL != p_handle)
+    {
+        *p_handle = task;
+    }
+    return (NULL != task) ? pdPASS : pdFAIL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *p_handle, BaseType_t core_id)
+{
+    return xTaskCreate(task_fn, name, stack_size, arg, priority, p_handle);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_os_sleep_us((uint64_t)ticks * (1000000ULL / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)(host_os_micros() / (1000000ULL / configTICK_RATE_HZ));
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = (QueueHandle_t)calloc(1, sizeof(struct host_queue_t));
+    if (NULL != queue)
+    {
+        queue->items = (uint8_t *)malloc((size_t)length * item_size);
+        if (NULL == queue->items)
+        {
+            free(queue);
+            return NULL;
+        }
+        queue->length = length;
+        queue->item_size = item_size;
+    }
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    uint64_t deadline_us = ticks_to_deadline(ticks);
+
+    while (queue->count == queue->length)
+    {
+        if ((0 == ticks) || (host_os_micros() >= deadline_us))
+        {
+            return errQUEUE_FULL;
+        }
+        host_os_wait(deadline_us);
+    }
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->items[(size_t)tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    host_os_notify();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    uint64_t deadline_us = ticks_to_deadline(ticks);
+
+    while (0 == queue->count)
+    {
+        if ((0 == ticks) || (host_os_micros() >= deadline_us))
+        {
+            return pdFALSE;
+        }
+        host_os_wait(deadline_us);
+    }
+
+    memcpy(item, &queue->items[(size_t)queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    host_os_notify();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue->count;
+}
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level)
+{
+    StreamBufferHandle_t stream = (StreamBufferHandle_t)calloc(1, sizeof(struct host_stream_buffer_t));
+    if (NULL != stream)
+    {
+        stream->data = (uint8_t *)malloc(size);
+        if (NULL == stream->data)
+        {
+            free(stream);
+            return NULL;
+        }
+        stream->size = size;
+        stream->trigger_level = (0 == trigger_level) ? 1 : trigger_level;
+    }
+    return stream;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks)
+{
+    uint64_t deadline_us = ticks_to_deadline(ticks);
+
+    while ((stream->count == stream->size) && (0 != ticks) && (host_os_micros() < deadline_us))
+    {
+        host_os_wait(deadline_us);
+    }
+
+    size_t sent = 0;
+    while ((sent < len) && (stream->count < stream->size))
+    {
+        size_t tail = (stream->head + stream->count) % stream->size;
+        size_t part = stream->size - tail;
+        if (part > (stream->size - stream->count))
+        {
+            part = stream->size - stream->count;
+        }
+        if (part > (len - sent))
+        {
+            part = len - sent;
+        }
+        memcpy(&stream->data[tail], &((const uint8_t *)data)[sent], part);
+        stream->count += part;
+        sent += part;
+    }
+
+    if (sent > 0)
+    {
+        host_os_notify();
+    }
+    return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks)
+{
+    uint64_t deadline_us = ticks_to_deadline(ticks);
+
+    while ((stream->count < stream->trigger_level) && (0 != ticks) && (host_os_micros() < deadline_us))
+    {
+        host_os_wait(deadline_us);
+    }
+
+    size_t received = 0;
+    while ((received < len) && (stream->count > 0))
+    {
+        size_t part = stream->size - stream->head;
+        if (part > stream->count)
+        {
+            part = stream->count;
+        }
+        if (part > (len - received))
+        {
+            part = len - received;
+        }
+        memcpy(&((uint8_t *)data)[received], &stream->data[stream->head], part);
+        stream->head = (stream->head + part) % stream->size;
+        stream->count -= part;
+        received += part;
+    }
+
+    if (received > 0)
+    {
+        host_os_notify();
+    }
+    return received;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream)
+{
+    return stream->count;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file queue.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief FreeRTOS queues of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_FREERTOS_QUEUE_H__
+#define __HOST_FREERTOS_QUEUE_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef struct host_queue_t *QueueHandle_t;
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+
+/**
+ * @brief Copies the item to the back of the queue, waits up to ticks for a free place
+ * @return pdTRUE if the item is queued, errQUEUE_FULL otherwise
+ */
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+
+/**
+ * @brief Copies the item at the front of the queue out of it, waits up to ticks for one
+ * @return pdTRUE if an item is received
+ */
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#define xQueueSendToBack(queue, item, ticks) xQueueSend(queue, item, ticks)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_QUEUE_H__
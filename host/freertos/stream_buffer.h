@@ -0,0 +1,51 @@
+/**
+ * @file stream_buffer.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief FreeRTOS stream buffers of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_FREERTOS_STREAM_BUFFER_H__
+#define __HOST_FREERTOS_STREAM_BUFFER_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef struct host_stream_buffer_t *StreamBufferHandle_t;
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level);
+
+/**
+ * @brief Copies as many bytes as fit, waits up to ticks for space when none is free
+ * @return number of bytes copied
+ */
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks);
+
+/**
+ * @brief Copies up to len bytes out, waits up to ticks for the trigger level to be reached
+ * @return number of bytes copied, 0 on timeout
+ */
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks);
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_STREAM_BUFFER_H__
@@ -0,0 +1,50 @@
+/**
+ * @file task.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief FreeRTOS tasks of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_FREERTOS_TASK_H__
+#define __HOST_FREERTOS_TASK_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+
+/**
+ * @brief Starts a task, the priority is ignored, host tasks run in turn
+ */
+BaseType_t xTaskCreate(TaskFunction_t task_fn, const char *name, uint32_t stack_size, void *arg,
+                       UBaseType_t priority, TaskHandle_t *p_handle);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *p_handle, BaseType_t core_id);
+
+void vTaskDelay(TickType_t ticks);
+
+TickType_t xTaskGetTickCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOST_FREERTOS_TASK_H__
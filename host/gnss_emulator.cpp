@@ -0,0 +1,185 @@
+/**
+ * @file gnss_emulator.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Quectel GNSS module of the host builds, answers the PAIR commands and sends NMEA fixes
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "gnss_emulator.h"
+#include "host_os.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define GNSS_EMULATOR_TASK_STACK_SIZE (8 * 1024)
+#define GNSS_EMULATOR_WALK_STEPS 1000 // fixes of the walk before it starts over
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+gnss_emulator_config_t GnssEmulator::get_default_config()
+{
+    gnss_emulator_config_t config = {};
+
+    config.seed = 1;
+    return config;
+}
+
+bool GnssEmulator::begin()
+{
+    _rng_state = (0 != _config.seed) ? _config.seed : 1;
+    _next_fix_us = host_os_micros();
+    _first_fix_us = _next_fix_us + (_config.first_fix_ms * 1000ULL);
+
+    return NULL != host_os_task_create(task_entry, this, "gnss_emulator", GNSS_EMULATOR_TASK_STACK_SIZE);
+}
+
+void GnssEmulator::set_config(const gnss_emulator_config_t &config)
+{
+    _config = config;
+    _rng_state = (0 != config.seed) ? config.seed : 1;
+}
+
+void GnssEmulator::set_reset_line(uint8_t level)
+{
+    if ((0 == level) && !_is_held_in_reset)
+    {
+        _is_held_in_reset = true;
+        _line_len = 0;
+    }
+    else if ((0 != level) && _is_held_in_reset)
+    {
+        // the module boots and looks for the satellites again
+        _is_held_in_reset = false;
+        _stats.resets++;
+        _next_fix_us = host_os_micros() + (GNSS_EMULATOR_FIX_PERIOD_MS * 1000ULL);
+        _first_fix_us = host_os_micros() + (_config.first_fix_ms * 1000ULL);
+        host_os_notify();
+    }
+}
+
+void GnssEmulator::task_entry(void *arg)
+{
+    ((GnssEmulator *)arg)->run();
+}
+
+void GnssEmulator::run()
+{
+    for (;;)
+    {
+        uint8_t data;
+
+        // read() does not yield, the module only waits below
+        while (1 == _port.read(&data, 1))
+        {
+            if (!_is_held_in_reset)
+            {
+                receive_byte(data);
+            }
+        }
+
+        if (!_is_held_in_reset && (host_os_micros() >= _next_fix_us))
+        {
+            bool has_position = (host_os_micros() >= _first_fix_us) && ((rand() % 100) >= _config.no_fix_pct);
+            send_fix(has_position);
+            _next_fix_us += GNSS_EMULATOR_FIX_PERIOD_MS * 1000ULL;
+        }
+        host_os_wait(_is_held_in_reset ? HOST_OS_FOREVER : _next_fix_us);
+    }
+}
+
+uint32_t GnssEmulator::rand()
+{
+    // xorshift32
+    _rng_state ^= _rng_state << 13;
+    _rng_state ^= _rng_state >> 17;
+    _rng_state ^= _rng_state << 5;
+    return _rng_state;
+}
+
+void GnssEmulator::receive_byte(uint8_t data)
+{
+    if ('\n' != data)
+    {
+        if (_line_len < (sizeof(_line) - 1))
+        {
+            _line[_line_len++] = (char)data;
+        }
+        return;
+    }
+
+    _line[_line_len] = '\0';
+    if ((_line_len > 8) && (0 == strncmp(_line, "$PAIR", 5)))
+    {
+        char body[GNSS_EMULATOR_LINE_SIZE];
+        snprintf(body, sizeof(body), "PAIR001,%.3s,0", &_line[5]);
+        send_sentence(body);
+        _stats.commands++;
+    }
+    _line_len = 0;
+}
+
+void GnssEmulator::send_sentence(const char *body)
+{
+    uint8_t checksum = 0;
+    for (const char *p = body; *p; p++)
+    {
+        checksum ^= (uint8_t)*p;
+    }
+    _port.printf("$%s*%02X\r\n", body, checksum);
+}
+
+void GnssEmulator::send_fix(bool has_position)
+{
+    char body[GNSS_EMULATOR_LINE_SIZE];
+    uint32_t seconds = _fix_count % 86400;
+    // slow walk to the north east, every fix is a new position
+    double lat_min = 30.0 + (_fix_count % GNSS_EMULATOR_WALK_STEPS) * 0.001;
+    double lon_min = 10.0 + (_fix_count % GNSS_EMULATOR_WALK_STEPS) * 0.001;
+    _fix_count++;
+
+    if (!has_position)
+    {
+        _stats.no_fixes++;
+        snprintf(body, sizeof(body), "GNGGA,%02u%02u%02u.00,,,,,0,00,99.9,,,,,,", seconds / 3600, (seconds / 60) % 60,
+                 seconds % 60);
+        send_sentence(body);
+        snprintf(body, sizeof(body), "GNRMC,%02u%02u%02u.00,V,,,,,,,150225,,,N", seconds / 3600, (seconds / 60) % 60,
+                 seconds % 60);
+        send_sentence(body);
+        return;
+    }
+
+    _stats.fixes++;
+    snprintf(body, sizeof(body), "GNGGA,%02u%02u%02u.00,48%06.3f,N,011%06.3f,E,1,12,0.8,545.4,M,46.9,M,,",
+             seconds / 3600, (seconds / 60) % 60, seconds % 60, lat_min, lon_min);
+    send_sentence(body);
+    snprintf(body, sizeof(body), "GNRMC,%02u%02u%02u.00,A,48%06.3f,N,011%06.3f,E,0.5,54.7,150225,,,A",
+             seconds / 3600, (seconds / 60) % 60, seconds % 60, lat_min, lon_min);
+    send_sentence(body);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file gnss_emulator.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Quectel GNSS module of the host builds, answers the PAIR commands and sends NMEA fixes
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __GNSS_EMULATOR_H__
+#define __GNSS_EMULATOR_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include "HardwareSerial.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define GNSS_EMULATOR_BAUD_RATE 115200
+#define GNSS_EMULATOR_LINE_SIZE 128
+#define GNSS_EMULATOR_FIX_PERIOD_MS 1000
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**
+ * @brief Behaviour of the module, see GnssEmulator::set_config()
+ */
+typedef struct
+{
+    uint32_t seed;
+    uint32_t first_fix_ms;  // power up or reset to the first fix, the sentences carry no position before
+    uint8_t no_fix_pct;     // seconds without a fix once the first one is there, tunnels and buildings
+} gnss_emulator_config_t;
+
+/**
+ * @brief Counters of the module since the start
+ */
+typedef struct
+{
+    uint32_t commands;      // PAIR commands answered
+    uint32_t fixes;         // seconds with a position
+    uint32_t no_fixes;      // seconds without
+    uint32_t resets;
+} gnss_emulator_stats_t;
+
+/**
+ * @brief Emulated GNSS module on a serial port of the host builds
+ *
+ * The module runs as a task of host_os. It sends a GGA and an RMC sentence every second,
+ * each fix is a step of a slow walk to the north east, and answers every PAIR command
+ * with PAIR001 and a success result.
+ */
+class GnssEmulator
+{
+public:
+    explicit GnssEmulator(HardwareSerial &port) : _port(port) {}
+
+    /**
+     * @brief Starts the module task, the first fix comes after first_fix_ms
+     */
+    bool begin();
+
+    void set_config(const gnss_emulator_config_t &config);
+    static gnss_emulator_config_t get_default_config();
+
+    /**
+     * @brief Level of the reset line of the module, low keeps it silent, the rising edge restarts it
+     */
+    void set_reset_line(uint8_t level);
+
+    void get_stats(gnss_emulator_stats_t *stats) { *stats = _stats; }
+
+private:
+    HardwareSerial &_port;
+    gnss_emulator_config_t _config = get_default_config();
+    gnss_emulator_stats_t _stats = {};
+    uint32_t _rng_state = 1;
+
+    char _line[GNSS_EMULATOR_LINE_SIZE];
+    size_t _line_len = 0;
+    uint32_t _fix_count = 0;          // seconds since the power up, the time of the sentences
+    uint64_t _next_fix_us = 0;
+    uint64_t _first_fix_us = 0;
+    bool _is_held_in_reset = false;
+
+    static void task_entry(void *arg);
+    void run();
+    uint32_t rand();
+    void receive_byte(uint8_t data);
+    void send_sentence(const char *body);
+    void send_fix(bool has_position);
+};
+
+#endif // __GNSS_EMULATOR_H__
@@ -0,0 +1,31 @@
+/**
+ * @file uart_types.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief ESP-IDF uart types of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_HAL_UART_TYPES_H__
+#define __HOST_HAL_UART_TYPES_H__
+
+typedef enum
+{
+    UART_NUM_0,
+    UART_NUM_1,
+    UART_NUM_2,
+    UART_NUM_MAX
+} uart_port_t;
+
+typedef enum
+{
+    UART_BREAK_ERROR,
+    UART_BUFFER_FULL_ERROR,
+    UART_FIFO_OVF_ERROR,
+    UART_FRAME_ERROR,
+    UART_PARITY_ERROR
+} hardwareSerial_error_t;
+
+#endif // __HOST_HAL_UART_TYPES_H__
@@ -0,0 +1,339 @@
+/**
+ * @file host_os.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Clock and task scheduler under the Arduino and FreeRTOS calls of the host builds
+ *        Tasks are coroutines run by one thread. A task runs until it waits, a delay(),
+ *        a blocking queue call or a poll of an empty serial port, so the firmware needs no
+ *        locks on the host and a run with the virtual clock is repeatable.
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "host_os.h"
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+#include <vector>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef struct
+{
+    ucontext_t context;
+    uint8_t *stack;      // NULL for the main task, it runs on the stack of the process
+    size_t stack_size;
+    host_task_fn fn;
+    void *arg;
+    const char *name;
+    uint64_t wake_us;    // deadline of the wait
+    bool is_waiting;
+    bool is_notified;    // data came in while waiting
+    bool is_done;
+} host_task_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static host_clock_t clock_mode = HOST_CLOCK_REAL;
+static bool is_clock_started = false;
+static struct timespec real_start;
+static uint64_t virtual_now_us = 0;
+
+static std::vector<host_task_t *> tasks;
+static size_t current_task = 0;
+static std::vector<HostEventSource *> sources;
+// receive callbacks can not wait, like on the esp32 where they run in the uart driver
+static bool is_dispatching = false;
+
+static void (*restart_handler)() = NULL;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void host_os_init_tasks()
+{
+    if (tasks.empty())
+    {
+        host_task_t *main_task = new host_task_t();
+        main_task->name = "main";
+        tasks.push_back(main_task);
+        current_task = 0;
+    }
+}
+
+static void host_os_task_entry()
+{
+    host_task_t *task = tasks[current_task];
+    task->fn(task->arg);
+
+    // a freertos task must not return, the host one is simply never run again
+    task->is_done = true;
+    host_os_wait(HOST_OS_FOREVER);
+}
+
+/**
+ * @brief Makes the context which starts the task on its own stack
+ */
+static bool host_os_make_context(host_task_t *task)
+{
+    if (0 != getcontext(&task->context))
+    {
+        return false;
+    }
+    task->context.uc_stack.ss_sp = task->stack;
+    task->context.uc_stack.ss_size = task->stack_size;
+    task->context.uc_link = NULL;
+    makecontext(&task->context, host_os_task_entry, 0);
+    return true;
+}
+
+static void host_os_switch_to(size_t next_task)
+{
+    host_task_t *task = tasks[next_task];
+    task->is_waiting = false;
+    task->is_notified = false;
+
+    if (next_task != current_task)
+    {
+        host_task_t *prev = tasks[current_task];
+        current_task = next_task;
+        swapcontext(&prev->context, &task->context);
+    }
+}
+
+/**
+ * @brief Nothing can run, waits for the next event
+ */
+static void host_os_idle(uint64_t next_event_us)
+{
+    std::vector<struct pollfd> fds;
+    for (HostEventSource *source : sources)
+    {
+        int fd = source->get_fd();
+        if (fd >= 0)
+        {
+            fds.push_back({fd, POLLIN, 0});
+        }
+    }
+
+    if (HOST_CLOCK_VIRTUAL == clock_mode)
+    {
+        if (HOST_OS_FOREVER != next_event_us)
+        {
+            virtual_now_us = next_event_us;
+        }
+        else if (!fds.empty())
+        {
+            // only another process can wake the tasks, time stands still meanwhile
+            poll(fds.data(), fds.size(), -1);
+        }
+        else
+        {
+            fprintf(stderr, "host_os: every task waits forever, nothing left to run\n");
+            exit(1);
+        }
+        return;
+    }
+
+    struct timespec timeout;
+    struct timespec *p_timeout = NULL;
+    if (HOST_OS_FOREVER != next_event_us)
+    {
+        uint64_t now_us = host_os_micros();
+        uint64_t wait_us = (next_event_us > now_us) ? (next_event_us - now_us) : 0;
+        timeout.tv_sec = wait_us / 1000000;
+        timeout.tv_nsec = (wait_us % 1000000) * 1000;
+        p_timeout = &timeout;
+    }
+    else if (fds.empty())
+    {
+        fprintf(stderr, "host_os: every task waits forever, nothing left to run\n");
+        exit(1);
+    }
+    ppoll(fds.data(), fds.size(), p_timeout, NULL);
+}
+
+/**
+ * @brief Runs the sources, then the next task able to run, the calling one last
+ */
+static void host_os_schedule()
+{
+    for (;;)
+    {
+        uint64_t now_us = host_os_micros();
+
+        is_dispatching = true;
+        for (HostEventSource *source : sources)
+        {
+            source->dispatch(now_us);
+        }
+        is_dispatching = false;
+
+        size_t count = tasks.size();
+        for (size_t i = 1; i <= count; i++)
+        {
+            size_t index = (current_task + i) % count;
+            host_task_t *task = tasks[index];
+            if (!task->is_done && (!task->is_waiting || task->is_notified || (task->wake_us <= now_us)))
+            {
+                host_os_switch_to(index);
+                return;
+            }
+        }
+
+        uint64_t next_event_us = HOST_OS_FOREVER;
+        for (host_task_t *task : tasks)
+        {
+            if (!task->is_done && (task->wake_us < next_event_us))
+            {
+                next_event_us = task->wake_us;
+            }
+        }
+        for (HostEventSource *source : sources)
+        {
+            uint64_t source_event_us = source->next_event_us();
+            if (source_event_us < next_event_us)
+            {
+                next_event_us = source_event_us;
+            }
+        }
+        host_os_idle(next_event_us);
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+void host_os_set_clock(host_clock_t clock)
+{
+    clock_mode = clock;
+}
+
+host_clock_t host_os_get_clock()
+{
+    return clock_mode;
+}
+
+uint64_t host_os_micros()
+{
+    if (HOST_CLOCK_VIRTUAL == clock_mode)
+    {
+        return virtual_now_us;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!is_clock_started)
+    {
+        real_start = now;
+        is_clock_started = true;
+    }
+    return ((uint64_t)(now.tv_sec - real_start.tv_sec) * 1000000ULL) + (now.tv_nsec / 1000) - (real_start.tv_nsec / 1000);
+}
+
+void *host_os_task_create(host_task_fn fn, void *arg, const char *name, size_t stack_size)
+{
+    host_os_init_tasks();
+
+    if (stack_size < HOST_OS_TASK_MIN_STACK_SIZE)
+    {
+        stack_size = HOST_OS_TASK_MIN_STACK_SIZE;
+    }
+
+    host_task_t *task = new host_task_t();
+    task->stack = (uint8_t *)malloc(stack_size);
+    task->stack_size = stack_size;
+    if ((NULL == task->stack) || !host_os_make_context(task))
+    {
+        free(task->stack);
+        delete task;
+        return NULL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->name = name;
+    tasks.push_back(task);
+
+    return task;
+}
+
+void host_os_wait(uint64_t deadline_us)
+{
+    if (is_dispatching)
+    {
+        return;
+    }
+    host_os_init_tasks();
+
+    host_task_t *task = tasks[current_task];
+    task->wake_us = deadline_us;
+    task->is_waiting = true;
+    task->is_notified = false;
+    host_os_schedule();
+}
+
+void host_os_sleep_us(uint64_t duration_us)
+{
+    uint64_t deadline_us = host_os_micros() + duration_us;
+
+    // notifications of the other tasks do not end a delay
+    do
+    {
+        host_os_wait(deadline_us);
+    } while (!is_dispatching && (host_os_micros() < deadline_us));
+}
+
+void host_os_yield()
+{
+    host_os_wait(host_os_micros() + ((HOST_CLOCK_VIRTUAL == clock_mode) ? HOST_OS_SPIN_US : 0));
+}
+
+void host_os_notify()
+{
+    for (host_task_t *task : tasks)
+    {
+        if (task->is_waiting)
+        {
+            task->is_notified = true;
+        }
+    }
+}
+
+void host_os_add_source(HostEventSource *source)
+{
+    sources.push_back(source);
+}
+
+void host_os_set_restart_handler(void (*handler)())
+{
+    restart_handler = handler;
+}
+
+void host_os_restart()
+{
+    if (NULL != restart_handler)
+    {
+        restart_handler();
+        return;
+    }
+    printf("host_os: ESP.restart(), end of the run\n");
+    fflush(stdout);
+    exit(0);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file host_os.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Clock and task scheduler under the Arduino and FreeRTOS calls of the host builds
+ * @version 0.1
+ * @date 2025-02-03
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __HOST_OS_H__
+#define __HOST_OS_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define HOST_OS_FOREVER UINT64_MAX // deadline of a wait without timeout
+
+#define HOST_OS_TASK_MIN_STACK_SIZE (64 * 1024) // host printf and the sanitizers need more than the esp32 stacks
+#define HOST_OS_SPIN_US 100                     // virtual time a poll of an empty serial port costs
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**
+ * @brief Time base of millis(), micros() and every timeout
+ *
+ * HOST_CLOCK_REAL follows the monotonic clock of the machine, the firmware can talk to
+ * another process over a pty. HOST_CLOCK_VIRTUAL only moves when every task waits, it
+ * jumps to the next timeout or byte arrival, so runs are faster than real time and the
+ * same inputs always give the same run.
+ */
+typedef enum
+{
+    HOST_CLOCK_REAL,
+    HOST_CLOCK_VIRTUAL
+} host_clock_t;
+
+/**
+ * @brief Source of events the scheduler checks while looking for work
+ *
+ * Serial ports register one so their bytes arrive and their receive callbacks run.
+ */
+class HostEventSource
+{
+public:
+    virtual ~HostEventSource() {}
+
+    /**
+     * @brief Runs the work due at the current time
+     * @return true if anything was done, a waiting task may be able to continue
+     */
+    virtual bool dispatch(uint64_t now_us) = 0;
+
+    /**
+     * @brief Time of the next work of the source, HOST_OS_FOREVER if none
+     */
+    virtual uint64_t next_event_us() = 0;
+
+    /**
+     * @brief File descriptor the real clock mode waits on, -1 if none
+     */
+    virtual int get_fd() { return -1; }
+};
+
+typedef void (*host_task_fn)(void *arg);
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+
+/**
+ * @brief Selects the clock, before anything reads the time
+ */
+void host_os_set_clock(host_clock_t clock);
+
+host_clock_t host_os_get_clock();
+
+/**
+ * @brief Microseconds since the start of the run
+ */
+uint64_t host_os_micros();
+
+/**
+ * @brief Starts a task, it first runs when the caller waits or yields
+ * @param stack_size stack of the esp32 task, raised to HOST_OS_TASK_MIN_STACK_SIZE
+ * @return NULL if the task can not be created
+ */
+void *host_os_task_create(host_task_fn fn, void *arg, const char *name, size_t stack_size);
+
+/**
+ * @brief Lets the other tasks run until the deadline, or until host_os_notify() if it comes first
+ *
+ * The callers check their condition again on return, a wake up does not mean it is met.
+ */
+void host_os_wait(uint64_t deadline_us);
+
+/**
+ * @brief Lets the other tasks run for the given time, the delay() of the tasks
+ */
+void host_os_sleep_us(uint64_t duration_us);
+
+/**
+ * @brief Lets the other tasks run, used by the calls the firmware polls in a loop
+ *
+ * Costs HOST_OS_SPIN_US of virtual time, so a loop waiting for a byte with millis()
+ * still reaches its timeout.
+ */
+void host_os_yield();
+
+/**
+ * @brief Wakes the waiting tasks, called when a queue, a stream buffer or a port gets data or space
+ */
+void host_os_notify();
+
+/**
+ * @brief Adds a source of events, it stays registered for the whole run
+ */
+void host_os_add_source(HostEventSource *source);
+
+/**
+ * @brief Called by ESP.restart(), the run ends with the given handler unless it is replaced
+ */
+void host_os_set_restart_handler(void (*handler)());
+
+void host_os_restart();
+
+#endif // __HOST_OS_H__
@@ -0,0 +1,963 @@
+/**
+ * @file mcm_emulator.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief MCM modem of the host builds, answers the OxTech serial protocol of commands_defs.h
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "mcm_emulator.h"
+#include "checksum.h"
+#include "frame_parse.h"
+#include "host_fuota.h"
+#include "sha256.h"
+#include "ymodem_rx.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define MCM_EMULATOR_CMD_TIMEOUT_US (100 * 1000ULL) // partial command dropped after this idle time
+#define MCM_EMULATOR_TASK_STACK_SIZE (8 * 1024)
+
+#define MCM_EMULATOR_NAME_CASE(cc, type, rsp_len_policy, rsp_len, parser, name) \
+    case (cc):                                                                  \
+        return (name);
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+// bootloader 1.2.3, modem firmware 2.1.4, hardware 1.0.0, sidewalk 1.16.1, lorawan 1.0.4
+static const uint8_t mcm_emulator_version[GET_VERSION_RESPONSE_PAYLOAD_LEN] = {
+    1, 2, 0, 3, 2, 1, 0, 4, 1, 0, 0, 1, 16, 1, 1, 0, 4};
+
+static const uint8_t mcm_emulator_default_eui[LORAWAN_DEV_EUI_JOIN_EUI_LEN] = {
+    0x70, 0xB3, 0xD5, 0x7E, 0xD0, 0x00, 0x00, 0x01};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static const char *mcm_emulator_get_name(uint16_t cmd_code)
+{
+    switch (cmd_code)
+    {
+        MROVER_COMMAND_LIST(MCM_EMULATOR_NAME_CASE)
+    default:
+        return "Unknown";
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+mcm_emulator_config_t McmEmulator::get_default_config()
+{
+    mcm_emulator_config_t config = {};
+
+    config.seed = 1;
+    config.response_delay_us = 2000;
+    config.join_delay_ms = 6000;
+    config.tx_delay_ms = 1500;
+    config.tx_status = MROVER_TX_DONE_WITHOUT_ACK;
+    config.downlink_delay_ms = 1000;
+    config.segment_period_ms = 2000;
+    config.lora_sf = 9;
+    config.firmware_version[0] = 2;
+    config.firmware_version[1] = 1;
+    config.firmware_version[2] = 4;
+    return config;
+}
+
+bool McmEmulator::begin()
+{
+    memcpy(_dev_eui, mcm_emulator_default_eui, sizeof(_dev_eui));
+    memcpy(_join_eui, mcm_emulator_default_eui, sizeof(_join_eui));
+    _rng_state = (0 != _config.seed) ? _config.seed : 1;
+
+    if (NULL == host_os_task_create(task_entry, this, "mcm_emulator", MCM_EMULATOR_TASK_STACK_SIZE))
+    {
+        return false;
+    }
+    // a powered up modem reports its reset first
+    schedule_event(0, MODEM_EVENT_RESET, COMMAND_TYPE_GENERAL, NULL, 0);
+    return true;
+}
+
+void McmEmulator::set_config(const mcm_emulator_config_t &config)
+{
+    _config = config;
+    _rng_state = (0 != config.seed) ? config.seed : 1;
+}
+
+bool McmEmulator::queue_event(uint8_t code, uint8_t cmd_type, const uint8_t *data, uint16_t len)
+{
+    if (_events.size() >= MAX_PENDING_MESSAGES)
+    {
+        _stats.events_lost++;
+        return false;
+    }
+
+    mcm_emulator_event_t event;
+    event.code = code;
+    event.cmd_type = cmd_type;
+    event.data.assign(data, data + len);
+    _events.push_back(event);
+    _stats.events_queued++;
+    host_os_notify();
+    return true;
+}
+
+void McmEmulator::notify()
+{
+    // the receiver would take the notification for a ymodem byte, it comes after the transfer
+    if (_events.empty() || is_file_transfer_active())
+    {
+        return;
+    }
+
+    std::vector<uint8_t> frame = {MROVER_RC_NOTIFY_EVENTS, (LENGTH_IN_NOTIFICATION_PAYLOAD >> 8),
+                                  (LENGTH_IN_NOTIFICATION_PAYLOAD & 0xFF), (uint8_t)_events.size(), 0};
+    frame[MCM_EMULATOR_NOTIFY_FRAME_LEN - 1] = fp_crc_update(0, frame.data(), MCM_EMULATOR_NOTIFY_FRAME_LEN - 1);
+    _stats.notifications++;
+    send_frame(frame, host_os_micros());
+}
+
+bool McmEmulator::queue_downlink(const uint8_t *payload, uint16_t len, uint8_t port)
+{
+    uint8_t data[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+    uint16_t header_len = (COMMAND_TYPE_LORAWAN == _protocol) ? 3 : 4;
+    int8_t rssi = -(int8_t)(60 + (rand() % 60));
+    int8_t snr = (int8_t)(rand() % 20) - 5;
+
+    if ((size_t)(len + header_len + GET_EVENT_HEADER_LEN) > sizeof(data))
+    {
+        return false;
+    }
+    if (COMMAND_TYPE_LORAWAN == _protocol)
+    {
+        data[0] = (uint8_t)rssi;
+        data[1] = (uint8_t)snr;
+        data[2] = port;
+    }
+    else
+    {
+        data[0] = _sid_sequence >> 8;
+        data[1] = _sid_sequence & 0xFF;
+        data[2] = (uint8_t)rssi;
+        data[3] = (uint8_t)snr;
+        _sid_sequence++;
+    }
+    memcpy(&data[header_len], payload, len);
+    return queue_event(MODEM_EVENT_DOWNDATA, _protocol, data, header_len + len);
+}
+
+void McmEmulator::set_file_image(const std::vector<uint8_t> &image, ver_type_1_t version)
+{
+    _image = image;
+    _image_version = version;
+}
+
+bool McmEmulator::queue_file_download(uint8_t bin_type, uint8_t seg_size)
+{
+    uint32_t seg_bytes = get_seg_size_bytes(seg_size);
+    if (_image.empty() || (0 == seg_bytes) || (_image.size() > 0xFFFFFF))
+    {
+        return false;
+    }
+
+    _segments = (_image.size() + seg_bytes - 1) / seg_bytes;
+    if (_segments > FUOTA_SEG_TRACKER_MAX_SEGMENTS)
+    {
+        // status reports the first 16 segments only
+        return false;
+    }
+    _file_bin_type = bin_type;
+    _file_seg_size = seg_size;
+    _segments_done = 0;
+    _has_file = true;
+    _next_segment_us = host_os_micros() + (_config.segment_period_ms * 1000ULL);
+    host_os_notify();
+    return true;
+}
+
+void McmEmulator::task_entry(void *arg)
+{
+    ((McmEmulator *)arg)->run();
+}
+
+void McmEmulator::run()
+{
+    for (;;)
+    {
+        uint64_t now_us = host_os_micros();
+        uint8_t data;
+
+        if ((_cmd_len > 0) && ((now_us - _cmd_last_us) > MCM_EMULATOR_CMD_TIMEOUT_US))
+        {
+            _cmd_len = 0;
+        }
+        // read() does not yield, the modem only waits below
+        while (1 == _port.read(&data, 1))
+        {
+            if (_is_held_in_reset)
+            {
+                continue;
+            }
+            if (is_file_transfer_active())
+            {
+                ymodem_receive(data);
+            }
+            else
+            {
+                receive_command_byte(data);
+            }
+            _cmd_last_us = now_us;
+        }
+
+        queue_due_events(now_us);
+        download_segments(now_us);
+        ymodem_check_timeout(now_us);
+        send_due_frames(now_us);
+        host_os_wait(get_next_wake_us());
+    }
+}
+
+uint32_t McmEmulator::rand()
+{
+    // xorshift32
+    _rng_state ^= _rng_state << 13;
+    _rng_state ^= _rng_state >> 17;
+    _rng_state ^= _rng_state << 5;
+    return _rng_state;
+}
+
+void McmEmulator::receive_command_byte(uint8_t data)
+{
+    _cmd[_cmd_len++] = data;
+    if (_cmd_len < MCM_EMULATOR_CMD_HEADER_LEN)
+    {
+        return;
+    }
+
+    uint16_t frame_len = MCM_EMULATOR_CMD_HEADER_LEN + ((_cmd[3] << 8) | _cmd[4]) + 1;
+    if (frame_len > sizeof(_cmd))
+    {
+        // no command is that long, the header was corrupted
+        _cmd_len = 0;
+        return;
+    }
+    if (_cmd_len < frame_len)
+    {
+        return;
+    }
+    _cmd_len = 0;
+
+    if (chance(_config.loss_pct))
+    {
+        _stats.lost_commands++;
+        if (NULL != _log)
+        {
+            fprintf(_log, "[MCM EMU] %s lost\n", mcm_emulator_get_name((_cmd[1] << 8) | _cmd[2]));
+        }
+        return;
+    }
+    if (0 != fp_crc_update(0, _cmd, frame_len))
+    {
+        _stats.bad_crc_commands++;
+        respond(MROVER_RC_BAD_CRC, _cmd[0], (_cmd[1] << 8) | _cmd[2], NULL, 0);
+        return;
+    }
+    _stats.commands++;
+    handle_command(_cmd, frame_len);
+}
+
+void McmEmulator::handle_command(const uint8_t *cmd, uint16_t len)
+{
+    uint8_t cmd_type = cmd[0];
+    uint16_t cmd_code = (cmd[1] << 8) | cmd[2];
+    const uint8_t *params = &cmd[MCM_EMULATOR_CMD_HEADER_LEN];
+    uint16_t params_len = len - MCM_EMULATOR_CMD_HEADER_LEN - 1;
+    uint8_t payload[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+    uint16_t payload_len = 0;
+    uint8_t rc = MROVER_RC_OK;
+
+    if (NULL != _log)
+    {
+        fprintf(_log, "[MCM EMU] %s (%u B)\n", mcm_emulator_get_name(cmd_code), params_len);
+    }
+
+    switch (cmd_code)
+    {
+    case MROVER_CC_GET_EVENT:
+        if (_events.empty())
+        {
+            payload[0] = MODEM_EVENT_NONE;
+            payload[1] = 0;
+            payload_len = GET_EVENT_HEADER_LEN;
+            break;
+        }
+        // the response carries the protocol of the event
+        cmd_type = _events.front().cmd_type;
+        payload[0] = _events.front().code;
+        payload[1] = (uint8_t)(_events.size() - 1);
+        memcpy(&payload[GET_EVENT_HEADER_LEN], _events.front().data.data(), _events.front().data.size());
+        payload_len = GET_EVENT_HEADER_LEN + _events.front().data.size();
+        _events.pop_front();
+        _stats.events_read++;
+        break;
+
+    case MROVER_CC_GET_VERSION:
+        memcpy(payload, mcm_emulator_version, sizeof(mcm_emulator_version));
+        // modem firmware follows the bootloader, the patch takes two bytes
+        payload[4] = _config.firmware_version[0];
+        payload[5] = _config.firmware_version[1];
+        payload[7] = _config.firmware_version[2];
+        payload_len = sizeof(mcm_emulator_version);
+        break;
+
+    case MROVER_CC_FACTORY_RESET:
+        memcpy(_dev_eui, mcm_emulator_default_eui, sizeof(_dev_eui));
+        memcpy(_join_eui, mcm_emulator_default_eui, sizeof(_join_eui));
+        schedule_event(MCM_EMULATOR_RESET_MS, MODEM_EVENT_RESET, COMMAND_TYPE_GENERAL, NULL, 0);
+        break;
+
+    case MROVER_CC_RESET:
+    case MROVER_CC_TRIGGER_FW_UPDATE:
+        // the modem comes back with its reset event
+        schedule_event(MCM_EMULATOR_RESET_MS, MODEM_EVENT_RESET, COMMAND_TYPE_GENERAL, NULL, 0);
+        break;
+
+    case MROVER_CC_SWITCH_NETWORK:
+    case MROVER_CC_LEAVE_LORAWAN_NETWORK:
+    case MROVER_CC_STOP_SID_LORAWAN_NETWORK:
+        _is_joined = false;
+        break;
+
+    case MROVER_CC_SET_JOIN_EUI:
+    case MROVER_CC_SET_DEV_EUI:
+        if (LORAWAN_DEV_EUI_JOIN_EUI_LEN != params_len)
+        {
+            rc = MROVER_RC_BAD_SIZE;
+            break;
+        }
+        memcpy((MROVER_CC_SET_DEV_EUI == cmd_code) ? _dev_eui : _join_eui, params, params_len);
+        break;
+
+    case MROVER_CC_SET_NW_KEY:
+        rc = (LORAWAN_NETWORK_KEY_LEN == params_len) ? MROVER_RC_OK : MROVER_RC_BAD_SIZE;
+        break;
+
+    case MROVER_CC_GET_DEV_EUI:
+    case MROVER_CC_GET_JOIN_EUI:
+        memcpy(payload, (MROVER_CC_GET_DEV_EUI == cmd_code) ? _dev_eui : _join_eui, LORAWAN_DEV_EUI_JOIN_EUI_LEN);
+        payload_len = LORAWAN_DEV_EUI_JOIN_EUI_LEN;
+        break;
+
+    case MROVER_CC_JOIN_LORAWAN:
+    case MROVER_CC_BLE_LINK_REQUEST:
+    case MROVER_CC_FSK_LINK_REQUEST:
+    case MROVER_CC_CSS_LINK_REQUEST:
+        _protocol = (MROVER_CC_JOIN_LORAWAN == cmd_code) ? COMMAND_TYPE_LORAWAN : COMMAND_TYPE_SIDEWALK;
+        _link_code = cmd_code;
+        _is_joined = false;
+        schedule_event(_config.join_delay_ms, _config.is_join_fail ? MODEM_EVENT_JOINFAIL : MODEM_EVENT_JOINED,
+                       _protocol, NULL, 0);
+        break;
+
+    case MROVER_CC_REQUEST_UPLINK:
+    {
+        // lorawan: port, type and payload, sidewalk: type and payload
+        uint16_t header_len = (COMMAND_TYPE_LORAWAN == cmd_type) ? 2 : 1;
+        if (params_len < header_len)
+        {
+            rc = MROVER_RC_BAD_SIZE;
+            break;
+        }
+        if (!_is_joined)
+        {
+            rc = MROVER_RC_FAIL;
+            break;
+        }
+        _stats.uplinks++;
+        _stats.airtime_us += get_airtime_us(params_len - header_len);
+        uint8_t uplink_type = params[header_len - 1];
+        uint8_t tx_status = (MROVER_CONFIRMED_UPLINK == uplink_type) ? MROVER_TX_DONE_WITH_ACK : _config.tx_status;
+        schedule_event(_config.tx_delay_ms, MODEM_EVENT_TXDONE, cmd_type, &tx_status, 1);
+        if (chance(_config.downlink_pct))
+        {
+            // echo of the uplink in the receive window after it
+            uint8_t data[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+            uint16_t data_len = 0;
+            int8_t rssi = -(int8_t)(60 + (rand() % 60));
+            int8_t snr = (int8_t)(rand() % 20) - 5;
+            if (COMMAND_TYPE_LORAWAN == cmd_type)
+            {
+                data[data_len++] = (uint8_t)rssi;
+                data[data_len++] = (uint8_t)snr;
+                data[data_len++] = params[0];
+            }
+            else
+            {
+                data[data_len++] = _sid_sequence >> 8;
+                data[data_len++] = _sid_sequence & 0xFF;
+                data[data_len++] = (uint8_t)rssi;
+                data[data_len++] = (uint8_t)snr;
+                _sid_sequence++;
+            }
+            uint16_t echo_len = params_len - header_len;
+            if ((size_t)(data_len + echo_len + GET_EVENT_HEADER_LEN) > sizeof(data))
+            {
+                echo_len = sizeof(data) - data_len - GET_EVENT_HEADER_LEN;
+            }
+            memcpy(&data[data_len], &params[header_len], echo_len);
+            schedule_event(_config.tx_delay_ms + _config.downlink_delay_ms, MODEM_EVENT_DOWNDATA, cmd_type, data,
+                           data_len + echo_len);
+        }
+        payload[0] = 0;
+        payload_len = 1;
+    }
+    break;
+
+    case MROVER_CC_GET_LORAWAN_CLASS:
+        payload[0] = _class;
+        payload_len = 1;
+        break;
+
+    case MROVER_CC_SET_LORAWAN_CLASS:
+        if ((1 != params_len) || (MROVER_LORAWAN_CLASS_C < params[0]))
+        {
+            rc = MROVER_RC_BAD_SIZE;
+            break;
+        }
+        _class = params[0];
+        schedule_event(MCM_EMULATOR_CLASS_SWITCH_MS, MODEM_EVENT_CLASS_SWITCHED, COMMAND_TYPE_LORAWAN, &_class, 1);
+        break;
+
+    case MROVER_CC_START_FILE_TRANSFER:
+        // only the image announced by the file download is sent
+        if (_image.empty() || (3 != params_len) || (params[0] != _image_version.major) ||
+            (params[1] != _image_version.minor) || (params[2] != _image_version.patch))
+        {
+            rc = MROVER_RC_FAIL;
+            break;
+        }
+        respond(rc, cmd_type, cmd_code, NULL, 0);
+        ymodem_start();
+        return;
+
+    case MROVER_CC_FILE_STATUS:
+        if (!_has_file)
+        {
+            rc = MROVER_RC_FAIL;
+            break;
+        }
+        get_file_status(payload);
+        payload_len = sizeof(get_seg_file_status_t);
+        break;
+
+    case MROVER_CC_INIT_LORAWAN:
+    case MROVER_CC_BLE_CONNECTION_REQUEST:
+    case MROVER_CC_SET_CSS_PWR_PROFILE:
+    case MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK:
+        break;
+
+    default:
+        _stats.unknown_commands++;
+        rc = MROVER_RC_UNKNOWN;
+        break;
+    }
+
+    respond(rc, cmd_type, cmd_code, payload, payload_len);
+}
+
+void McmEmulator::respond(uint8_t rc, uint8_t cmd_type, uint16_t cmd_code, const uint8_t *payload, uint16_t len)
+{
+    std::vector<uint8_t> frame(FP_RESPONSE_FRAME_OVERHEAD + len);
+
+    frame[0] = rc;
+    frame[1] = cmd_type;
+    frame[2] = cmd_code >> 8;
+    frame[3] = cmd_code & 0xFF;
+    frame[4] = len >> 8;
+    frame[5] = len & 0xFF;
+    if (len > 0)
+    {
+        memcpy(&frame[FP_RESPONSE_HEADER_LEN], payload, len);
+    }
+    frame[FP_RESPONSE_HEADER_LEN + len] = fp_crc_update(0, frame.data(), FP_RESPONSE_HEADER_LEN + len);
+
+    uint64_t delay_us = _config.response_delay_us;
+    if (_config.response_jitter_us > 0)
+    {
+        delay_us += rand() % (_config.response_jitter_us + 1);
+    }
+    send_frame(frame, host_os_micros() + delay_us);
+}
+
+void McmEmulator::send_frame(std::vector<uint8_t> frame, uint64_t due_us)
+{
+    if (chance(_config.crc_error_pct))
+    {
+        uint32_t bit = rand() % (frame.size() * 8);
+        frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        _stats.corrupted_frames++;
+    }
+    _outputs.insert({due_us, frame});
+    host_os_notify();
+}
+
+/**
+ * @brief Writes the frames which are due, a frame waits for the line to be idle unless coalesced
+ */
+void McmEmulator::send_due_frames(uint64_t now_us)
+{
+    std::vector<uint8_t> burst;
+
+    while (!_outputs.empty() && (_outputs.begin()->first <= now_us))
+    {
+        uint64_t idle_us = _config.is_coalesced ? 0 : (MCM_EMULATOR_IDLE_SYMBOLS * get_byte_us());
+        if (burst.empty() && (now_us < (_line_free_us + idle_us)))
+        {
+            break;
+        }
+        if (!burst.empty() && !_config.is_coalesced)
+        {
+            break;
+        }
+        burst.insert(burst.end(), _outputs.begin()->second.begin(), _outputs.begin()->second.end());
+        _outputs.erase(_outputs.begin());
+    }
+
+    if (!burst.empty())
+    {
+        uint64_t start_us = (_line_free_us > now_us) ? _line_free_us : now_us;
+        _line_free_us = start_us + (burst.size() * get_byte_us());
+        _port.write(burst.data(), burst.size());
+    }
+}
+
+void McmEmulator::schedule_event(uint32_t delay_ms, uint8_t code, uint8_t cmd_type, const uint8_t *data,
+                                 uint16_t len)
+{
+    mcm_emulator_event_t event;
+    event.code = code;
+    event.cmd_type = cmd_type;
+    if (len > 0)
+    {
+        event.data.assign(data, data + len);
+    }
+    _timed_events.insert({host_os_micros() + (delay_ms * 1000ULL), event});
+    host_os_notify();
+}
+
+void McmEmulator::queue_due_events(uint64_t now_us)
+{
+    bool is_queued = false;
+
+    while (!_timed_events.empty() && (_timed_events.begin()->first <= now_us))
+    {
+        mcm_emulator_event_t event = _timed_events.begin()->second;
+        _timed_events.erase(_timed_events.begin());
+
+        if (MODEM_EVENT_RESET == event.code)
+        {
+            reset_modem();
+            uint8_t count[2] = {(uint8_t)(_reset_count >> 8), (uint8_t)(_reset_count & 0xFF)};
+            event.data.assign(count, count + sizeof(count));
+        }
+        else if (MODEM_EVENT_JOINED == event.code)
+        {
+            _is_joined = true;
+            _stats.joins++;
+        }
+
+        if (NULL != _log)
+        {
+            fprintf(_log, "[MCM EMU] event 0x%02X, %u pending\n", event.code, (unsigned)_events.size() + 1);
+        }
+        is_queued |= queue_event(event.code, event.cmd_type, event.data.data(), event.data.size());
+    }
+
+    if (is_queued)
+    {
+        notify();
+    }
+}
+
+void McmEmulator::download_segments(uint64_t now_us)
+{
+    while (_has_file && (_segments_done < _segments) && (now_us >= _next_segment_us))
+    {
+        uint8_t data[sizeof(get_seg_file_status_t)];
+
+        _segments_done++;
+        _next_segment_us += _config.segment_period_ms * 1000ULL;
+        get_file_status(data);
+        if (queue_event(MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD, COMMAND_TYPE_GENERAL, data, sizeof(data)))
+        {
+            notify();
+        }
+    }
+}
+
+/**
+ * @brief Status of the segments, in the layout of get_seg_file_status_t
+ */
+void McmEmulator::get_file_status(uint8_t *data)
+{
+    uint32_t size = _image.size();
+    uint16_t status = 0;
+
+    for (uint32_t i = 0; i < FUOTA_SEG_STATUS_WINDOW; i++)
+    {
+        if ((i < _segments) && (i >= _segments_done))
+        {
+            status |= (1 << i);
+        }
+    }
+
+    data[0] = _file_bin_type & 0x0F;
+    data[1] = _image_version.major;
+    data[2] = _image_version.minor;
+    data[3] = _image_version.patch;
+    data[4] = (size >> 16) & 0xFF;
+    data[5] = (size >> 8) & 0xFF;
+    data[6] = size & 0xFF;
+    // next segment to come, the driver must not read it as a window
+    data[7] = (_file_seg_size & 0x0F) | (uint8_t)((_segments_done & 0x0F) << 4);
+    data[8] = status & 0xFF;
+    data[9] = status >> 8;
+}
+
+void McmEmulator::reset_modem()
+{
+    _events.clear();
+    _is_joined = false;
+    _class = MROVER_LORAWAN_CLASS_A;
+    _reset_count++;
+    _stats.resets++;
+    if (is_file_transfer_active())
+    {
+        ymodem_end(false);
+    }
+}
+
+void McmEmulator::set_reset_line(uint8_t level)
+{
+    if ((0 == level) && !_is_held_in_reset)
+    {
+        // nothing of the running modem survives, not even the frames on their way out
+        _is_held_in_reset = true;
+        _events.clear();
+        _timed_events.clear();
+        _outputs.clear();
+        _cmd_len = 0;
+        _is_joined = false;
+        if (is_file_transfer_active())
+        {
+            ymodem_end(false);
+        }
+    }
+    else if ((0 != level) && _is_held_in_reset)
+    {
+        _is_held_in_reset = false;
+        schedule_event(MCM_EMULATOR_RESET_MS, MODEM_EVENT_RESET, COMMAND_TYPE_GENERAL, NULL, 0);
+    }
+}
+
+/**
+ * @brief Time on air of an uplink on the current network
+ *
+ * Lorawan and sidewalk css use the lora modulation at lora_sf, 125 kHz, coding rate 4/5,
+ * explicit header and crc. Sidewalk fsk is 50 kbps and ble 1 Mbps. The overheads are
+ * the usual ones of each link, close enough to compare schedules.
+ */
+uint64_t McmEmulator::get_airtime_us(uint16_t payload_len)
+{
+    switch (_link_code)
+    {
+    case MROVER_CC_FSK_LINK_REQUEST:
+        return (uint64_t)(payload_len + MCM_EMULATOR_FSK_OVERHEAD) * 8 * MCM_EMULATOR_FSK_BIT_US;
+
+    case MROVER_CC_BLE_LINK_REQUEST:
+        return (uint64_t)(payload_len + MCM_EMULATOR_BLE_OVERHEAD) * 8 * MCM_EMULATOR_BLE_BIT_US;
+
+    default:
+        break;
+    }
+
+    int32_t sf = std::min(std::max((int32_t)_config.lora_sf, (int32_t)7), (int32_t)12);
+    int32_t low_rate = (sf >= 11) ? 1 : 0;
+    int32_t bytes = payload_len + ((MROVER_CC_JOIN_LORAWAN == _link_code) ? MCM_EMULATOR_LORAWAN_OVERHEAD
+                                                                          : MCM_EMULATOR_SIDEWALK_OVERHEAD);
+    // symbols of the payload, semtech an1200.13
+    int32_t numerator = (8 * bytes) - (4 * sf) + 28 + 16;
+    int32_t denominator = 4 * (sf - (2 * low_rate));
+    int32_t payload_symbols = 8 + std::max((int32_t)0, ((numerator + denominator - 1) / denominator) * 5);
+    uint64_t symbol_us = (1000000ULL << sf) / MCM_EMULATOR_LORA_BW_HZ;
+
+    // preamble is 4.25 symbols longer than its length
+    return ((MCM_EMULATOR_LORA_PREAMBLE * symbol_us) + ((symbol_us * 17) / 4) + (payload_symbols * symbol_us));
+}
+
+uint64_t McmEmulator::get_next_wake_us()
+{
+    uint64_t next_us = HOST_OS_FOREVER;
+
+    if (!_outputs.empty())
+    {
+        next_us = _outputs.begin()->first;
+        uint64_t idle_us = _config.is_coalesced ? 0 : (MCM_EMULATOR_IDLE_SYMBOLS * get_byte_us());
+        if (next_us < (_line_free_us + idle_us))
+        {
+            next_us = _line_free_us + idle_us;
+        }
+    }
+    if (!_timed_events.empty() && (_timed_events.begin()->first < next_us))
+    {
+        next_us = _timed_events.begin()->first;
+    }
+    if (_has_file && (_segments_done < _segments) && (_next_segment_us < next_us))
+    {
+        next_us = _next_segment_us;
+    }
+    if (_ym_deadline_us < next_us)
+    {
+        next_us = _ym_deadline_us;
+    }
+    if ((_cmd_len > 0) && ((_cmd_last_us + MCM_EMULATOR_CMD_TIMEOUT_US) < next_us))
+    {
+        next_us = _cmd_last_us + MCM_EMULATOR_CMD_TIMEOUT_US + 1;
+    }
+    return next_us;
+}
+
+void McmEmulator::ymodem_start()
+{
+    _ym_state = YM_WAIT_HEADER_C;
+    _ym_offset = 0;
+    _ym_block = 0;
+    _ym_retries = 0;
+    _ym_packet.clear();
+    // the receiver asks for the header once it has the response
+    _ym_deadline_us = host_os_micros() + (MCM_EMULATOR_YMODEM_TIMEOUT_MS * 1000ULL);
+}
+
+void McmEmulator::ymodem_receive(uint8_t data)
+{
+    if (CAN == data)
+    {
+        if (NULL != _log)
+        {
+            fprintf(_log, "[MCM EMU] ymodem cancelled by the receiver at %u B\n", (unsigned)_ym_offset);
+        }
+        _stats.ymodem_cancels++;
+        ymodem_end(false);
+        return;
+    }
+
+    switch (_ym_state)
+    {
+    case YM_WAIT_HEADER_C:
+        if (CRC16 == data)
+        {
+            // name, size and the sha-256 the receiver checks the image with
+            uint8_t header[YMODEM_BLOCK_SIZE_SOH] = {0};
+            uint8_t digest[SHA256_DIGEST_SIZE];
+            sha256_t sha;
+            sha256_init(&sha);
+            sha256_update(&sha, _image.data(), _image.size());
+            sha256_final(&sha, digest);
+
+            int len = snprintf((char *)header, sizeof(header), "%s", MCM_EMULATOR_FILE_NAME) + 1;
+            len += snprintf((char *)&header[len], sizeof(header) - len, "%u ", (unsigned)_image.size());
+            for (uint8_t i = 0; i < SHA256_DIGEST_SIZE; i++)
+            {
+                len += snprintf((char *)&header[len], sizeof(header) - len, "%02x", digest[i]);
+            }
+            ymodem_send_block(0, header, sizeof(header));
+            _ym_state = YM_WAIT_HEADER_ACK;
+        }
+        break;
+
+    case YM_WAIT_HEADER_ACK:
+        if (ACK == data)
+        {
+            _ym_state = YM_WAIT_DATA_C;
+            _ym_retries = 0;
+        }
+        else if (NAK == data)
+        {
+            ymodem_retry();
+        }
+        break;
+
+    case YM_WAIT_DATA_C:
+        if (CRC16 == data)
+        {
+            uint32_t len = _image.size();
+            ymodem_send_block(1, _image.data(), (len > YMODEM_BLOCK_SIZE_STX) ? YMODEM_BLOCK_SIZE_STX : len);
+            _ym_state = YM_WAIT_DATA_ACK;
+        }
+        break;
+
+    case YM_WAIT_DATA_ACK:
+        if (ACK == data)
+        {
+            _ym_offset += YMODEM_BLOCK_SIZE_STX;
+            _ym_retries = 0;
+            if (_ym_offset >= _image.size())
+            {
+                _ym_packet.assign(1, EOT);
+                ymodem_send_packet();
+                _ym_state = YM_WAIT_EOT_ACK;
+                break;
+            }
+            uint32_t len = _image.size() - _ym_offset;
+            ymodem_send_block(_ym_block + 1, &_image[_ym_offset],
+                              (len > YMODEM_BLOCK_SIZE_STX) ? YMODEM_BLOCK_SIZE_STX : len);
+        }
+        else if (NAK == data)
+        {
+            ymodem_retry();
+        }
+        break;
+
+    case YM_WAIT_EOT_ACK:
+        if (ACK == data)
+        {
+            _ym_state = YM_WAIT_END_C;
+            _ym_retries = 0;
+        }
+        else if (NAK == data)
+        {
+            ymodem_retry();
+        }
+        break;
+
+    case YM_WAIT_END_C:
+        if (CRC16 == data)
+        {
+            uint8_t header[YMODEM_BLOCK_SIZE_SOH] = {0};
+            ymodem_send_block(0, header, sizeof(header));
+            _ym_state = YM_WAIT_END_ACK;
+        }
+        break;
+
+    case YM_WAIT_END_ACK:
+        if (ACK == data)
+        {
+            _stats.ymodem_transfers++;
+            ymodem_end(true);
+        }
+        else if (NAK == data)
+        {
+            ymodem_retry();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void McmEmulator::ymodem_send_block(uint8_t block, const uint8_t *data, uint16_t len)
+{
+    uint16_t size = (len > YMODEM_BLOCK_SIZE_SOH) ? YMODEM_BLOCK_SIZE_STX : YMODEM_BLOCK_SIZE_SOH;
+
+    _ym_block = block;
+    _ym_packet.assign(size + YMODEM_PACKET_OVERHEAD, 0x1A);
+    _ym_packet[0] = (YMODEM_BLOCK_SIZE_STX == size) ? STX : SOH;
+    _ym_packet[1] = block;
+    _ym_packet[2] = 0xFF - block;
+    memcpy(&_ym_packet[3], data, len);
+    uint16_t crc = checksum_crc16_update(CHECKSUM_CRC16_INIT, &_ym_packet[3], size);
+    _ym_packet[3 + size] = crc >> 8;
+    _ym_packet[4 + size] = crc & 0xFF;
+    ymodem_send_packet();
+}
+
+/**
+ * @brief Sends the last packet, again on a retry, with the faults of the configuration
+ */
+void McmEmulator::ymodem_send_packet()
+{
+    _stats.ymodem_packets++;
+    _ym_deadline_us = host_os_micros() + (MCM_EMULATOR_YMODEM_TIMEOUT_MS * 1000ULL);
+
+    if (chance(_config.loss_pct))
+    {
+        return;
+    }
+
+    std::vector<uint8_t> packet = _ym_packet;
+    if (chance(_config.crc_error_pct))
+    {
+        uint32_t bit = rand() % (packet.size() * 8);
+        packet[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        _stats.corrupted_frames++;
+    }
+    uint64_t now_us = host_os_micros();
+    uint64_t start_us = (_line_free_us > now_us) ? _line_free_us : now_us;
+    _line_free_us = start_us + (packet.size() * get_byte_us());
+    _port.write(packet.data(), packet.size());
+}
+
+void McmEmulator::ymodem_check_timeout(uint64_t now_us)
+{
+    if (is_file_transfer_active() && (now_us >= _ym_deadline_us))
+    {
+        ymodem_retry();
+    }
+}
+
+/**
+ * @brief Sends the last packet again after a NAK or a timeout, the transfer is cancelled after too many
+ */
+void McmEmulator::ymodem_retry()
+{
+    if (_ym_packet.empty() || (++_ym_retries > MCM_EMULATOR_YMODEM_RETRIES))
+    {
+        // the receiver never asked for the header or stopped answering
+        if (NULL != _log)
+        {
+            fprintf(_log, "[MCM EMU] ymodem gave up at %u B\n", (unsigned)_ym_offset);
+        }
+        uint8_t cancel[2] = {CAN, CAN};
+        _port.write(cancel, sizeof(cancel));
+        _stats.ymodem_cancels++;
+        ymodem_end(false);
+        return;
+    }
+    _stats.ymodem_retries++;
+    ymodem_send_packet();
+}
+
+void McmEmulator::ymodem_end(bool is_done)
+{
+    if ((NULL != _log) && is_done)
+    {
+        fprintf(_log, "[MCM EMU] ymodem sent %u B\n", (unsigned)_image.size());
+    }
+    _ym_state = YM_IDLE;
+    _ym_packet.clear();
+    _ym_deadline_us = HOST_OS_FOREVER;
+    // events of the transfer time are announced now
+    notify();
+}
@@ -0,0 +1,271 @@
+/**
+ * @file mcm_emulator.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief MCM modem of the host builds, answers the OxTech serial protocol of commands_defs.h
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __MCM_EMULATOR_H__
+#define __MCM_EMULATOR_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <map>
+#include <deque>
+#include <vector>
+#include "HardwareSerial.h"
+#include "commands_defs.h"
+#include "api_processor.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define MCM_EMULATOR_BAUD_RATE 9600
+#define MCM_EMULATOR_CMD_HEADER_LEN 5 // command type, command code and length
+#define MCM_EMULATOR_CMD_FRAME_SIZE (MCM_EMULATOR_CMD_HEADER_LEN + MAX_SERIAL_SEND_PAYLOAD_SIZE + 1)
+#define MCM_EMULATOR_NOTIFY_FRAME_LEN 5
+
+#define MCM_EMULATOR_IDLE_SYMBOLS 4     // gap between two frames which are not coalesced, above the uart rx timeout
+#define MCM_EMULATOR_RESET_MS 200       // reset or firmware update command to the reset event
+#define MCM_EMULATOR_CLASS_SWITCH_MS 50 // set class command to the class switched event
+
+// airtime of an uplink, the radio overhead is added to the application payload
+#define MCM_EMULATOR_LORA_BW_HZ 125000
+#define MCM_EMULATOR_LORA_PREAMBLE 8
+#define MCM_EMULATOR_LORAWAN_OVERHEAD 13 // mac header, fhdr, fport and mic
+#define MCM_EMULATOR_SIDEWALK_OVERHEAD 20
+#define MCM_EMULATOR_FSK_BIT_US 20       // 50 kbps
+#define MCM_EMULATOR_FSK_OVERHEAD 12     // preamble, sync word, header and crc
+#define MCM_EMULATOR_BLE_BIT_US 1        // 1 Mbps
+#define MCM_EMULATOR_BLE_OVERHEAD 10
+
+#define MCM_EMULATOR_YMODEM_TIMEOUT_MS 3000 // sender sends the packet again when no answer comes
+#define MCM_EMULATOR_YMODEM_RETRIES 10
+#define MCM_EMULATOR_FILE_NAME "host_fw.bin"
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**
+ * @brief Behaviour of the modem, see McmEmulator::set_config()
+ *
+ * The percentages are drawn from a generator seeded by seed, so a run on the virtual
+ * clock with the same configuration and the same firmware is the same run.
+ */
+typedef struct
+{
+    uint32_t seed;
+    uint32_t response_delay_us;   // command received to the first byte of its response
+    uint32_t response_jitter_us;  // random extra delay of a response, up to this
+    uint32_t join_delay_ms;       // join or sidewalk link request to the JOINED event
+    bool is_join_fail;            // JOINFAIL instead of JOINED
+    uint32_t tx_delay_ms;         // uplink request to its TXDONE event
+    uint8_t tx_status;            // mrover_uplink_event_type_t of an unconfirmed uplink, a confirmed one is acked
+    uint8_t downlink_pct;         // uplinks echoed back as a downlink after their TXDONE
+    uint32_t downlink_delay_ms;   // TXDONE to the downlink
+    uint32_t segment_period_ms;   // time to download one segment of a file, see queue_file_download()
+    uint8_t loss_pct;             // commands and ymodem packets which get lost on the line
+    uint8_t crc_error_pct;        // frames and ymodem packets sent with one bit flipped
+    bool is_coalesced;            // frames due together go out back to back, without the idle gap
+    uint8_t lora_sf;              // spreading factor of the lorawan and sidewalk css uplinks, 7 to 12
+    uint8_t firmware_version[3];  // modem firmware of the version response, major, minor and patch
+} mcm_emulator_config_t;
+
+/**
+ * @brief Counters of the modem since the start or the last reset_stats()
+ */
+typedef struct
+{
+    uint32_t commands;          // frames with a valid crc
+    uint32_t bad_crc_commands;  // answered with MROVER_RC_BAD_CRC
+    uint32_t unknown_commands;  // answered with MROVER_RC_UNKNOWN
+    uint32_t lost_commands;     // dropped by loss_pct, never answered
+    uint32_t corrupted_frames;  // sent with a flipped bit by crc_error_pct
+    uint32_t notifications;
+    uint32_t events_queued;
+    uint32_t events_read;       // GET_EVENT responses carrying an event
+    uint32_t events_lost;       // event fifo was full
+    uint32_t ymodem_packets;    // packets sent, retries included
+    uint32_t ymodem_retries;
+    uint32_t ymodem_transfers;  // transfers the receiver acknowledged up to the EOT
+    uint32_t ymodem_cancels;
+    uint32_t joins;             // JOINED events, lorawan joins and sidewalk links
+    uint32_t resets;            // reset events, commands and reset line
+    uint32_t uplinks;           // uplinks accepted while joined
+    uint64_t airtime_us;        // time on air of these uplinks
+} mcm_emulator_stats_t;
+
+/**
+ * @brief Event waiting in the fifo of the modem for a GET_EVENT
+ */
+typedef struct
+{
+    uint8_t code;               // get_event_code_t
+    uint8_t cmd_type;           // command_types_t of the GET_EVENT response
+    std::vector<uint8_t> data;
+} mcm_emulator_event_t;
+
+/**
+ * @brief Emulated MCM on a serial port of the host builds
+ *
+ * The modem runs as a task of host_os. It answers every command of MROVER_COMMAND_LIST
+ * with the payload its parser expects, keeps up to MAX_PENDING_MESSAGES events and sends
+ * a notification each time events are added. Joins, uplinks, class switches and resets
+ * produce their events after the configured delays, like the radio would. A host file set
+ * with set_file_image() is announced by segmented file download events and sent with
+ * ymodem after MROVER_CC_START_FILE_TRANSFER.
+ *
+ * The port is usually one end of an in-memory line, the firmware has the other one,
+ * or a tty with HardwareSerial::attach_device() to serve another process or a board.
+ */
+class McmEmulator
+{
+public:
+    explicit McmEmulator(HardwareSerial &port) : _port(port) {}
+
+    /**
+     * @brief Starts the modem task, the modem boots and queues its reset event
+     */
+    bool begin();
+
+    void set_config(const mcm_emulator_config_t &config);
+    const mcm_emulator_config_t &get_config() { return _config; }
+    static mcm_emulator_config_t get_default_config();
+
+    /**
+     * @brief Adds an event to the fifo at once, a burst is several calls then notify()
+     * @return false if the fifo is full, the event is lost
+     */
+    bool queue_event(uint8_t code, uint8_t cmd_type, const uint8_t *data, uint16_t len);
+
+    /**
+     * @brief Sends the notification of the events in the fifo
+     */
+    void notify();
+
+    /**
+     * @brief Downlink of the network, queued as a DOWNDATA event of the current protocol
+     */
+    bool queue_downlink(const uint8_t *payload, uint16_t len, uint8_t port);
+
+    /**
+     * @brief Image sent by the next ymodem transfer, it is also the package of the file downloads
+     * @param version version of the image, checked against the one of the transfer request
+     */
+    void set_file_image(const std::vector<uint8_t> &image, ver_type_1_t version);
+
+    /**
+     * @brief Downloads the image of set_file_image() over the air, one segment every segment_period_ms
+     *
+     * A SEGMENTED_FILE_DOWNLOAD event reports the status after each downloaded segment, the image
+     * must fit in the FUOTA_SEG_STATUS_WINDOW segments of one status.
+     * @param bin_type FUOTA_BINARY_TYPE_HOST or FUOTA_BINARY_TYPE_MCM
+     * @param seg_size seg_size_t of the package
+     */
+    bool queue_file_download(uint8_t bin_type, uint8_t seg_size);
+
+    /**
+     * @brief Level of the reset line of the modem, low holds it in reset, the rising edge boots it
+     */
+    void set_reset_line(uint8_t level);
+
+    bool is_joined() { return _is_joined; }
+    bool is_file_transfer_active() { return YM_IDLE != _ym_state; }
+    size_t get_pending_events() { return _events.size(); }
+    void get_stats(mcm_emulator_stats_t *stats) { *stats = _stats; }
+    void reset_stats() { _stats = {}; }
+
+    /**
+     * @brief Prints one line per command and event to the given file, NULL for none
+     */
+    void set_log(FILE *log) { _log = log; }
+
+private:
+    typedef enum
+    {
+        YM_IDLE,
+        YM_WAIT_HEADER_C,   // receiver asks for the header with 'C'
+        YM_WAIT_HEADER_ACK,
+        YM_WAIT_DATA_C,     // receiver asks for the first data block with 'C'
+        YM_WAIT_DATA_ACK,
+        YM_WAIT_EOT_ACK,
+        YM_WAIT_END_C,      // receiver asks for the empty header that ends the batch with 'C'
+        YM_WAIT_END_ACK
+    } ymodem_state_t;
+
+    HardwareSerial &_port;
+    mcm_emulator_config_t _config = get_default_config();
+    mcm_emulator_stats_t _stats = {};
+    FILE *_log = NULL;
+    uint32_t _rng_state = 0;
+
+    uint8_t _cmd[MCM_EMULATOR_CMD_FRAME_SIZE];
+    uint16_t _cmd_len = 0;
+    uint64_t _cmd_last_us = 0;
+
+    std::deque<mcm_emulator_event_t> _events;
+    std::multimap<uint64_t, std::vector<uint8_t>> _outputs;          // frames by the time they go out
+    std::multimap<uint64_t, mcm_emulator_event_t> _timed_events;     // events by the time they are queued
+    uint64_t _line_free_us = 0;                                      // end of the last frame on the line
+
+    bool _is_joined = false;
+    bool _is_held_in_reset = false;
+    uint8_t _protocol = COMMAND_TYPE_LORAWAN;
+    uint16_t _link_code = MROVER_CC_JOIN_LORAWAN;   // join or link request of the current network
+    uint8_t _class = MROVER_LORAWAN_CLASS_A;
+    uint16_t _reset_count = 0;
+    uint16_t _sid_sequence = 0;
+    uint8_t _dev_eui[LORAWAN_DEV_EUI_JOIN_EUI_LEN];
+    uint8_t _join_eui[LORAWAN_DEV_EUI_JOIN_EUI_LEN];
+
+    std::vector<uint8_t> _image;
+    ver_type_1_t _image_version = {};
+    uint8_t _file_bin_type = 0;
+    uint8_t _file_seg_size = 0;
+    bool _has_file = false;
+    uint32_t _segments = 0;
+    uint32_t _segments_done = 0;
+    uint64_t _next_segment_us = HOST_OS_FOREVER;
+
+    ymodem_state_t _ym_state = YM_IDLE;
+    uint32_t _ym_offset = 0;                // image bytes sent in the blocks acknowledged
+    uint8_t _ym_block = 0;
+    std::vector<uint8_t> _ym_packet;        // last packet, sent again on NAK or timeout
+    uint64_t _ym_deadline_us = HOST_OS_FOREVER;
+    uint8_t _ym_retries = 0;
+
+    static void task_entry(void *arg);
+    void run();
+    uint32_t rand();
+    bool chance(uint8_t pct) { return (pct > 0) && ((rand() % 100) < pct); }
+    uint64_t get_byte_us() { return (HOST_SERIAL_BITS_PER_BYTE * 1000000ULL) / _port.baudRate(); }
+
+    void receive_command_byte(uint8_t data);
+    void handle_command(const uint8_t *cmd, uint16_t len);
+    void respond(uint8_t rc, uint8_t cmd_type, uint16_t cmd_code, const uint8_t *payload, uint16_t len);
+    void send_frame(std::vector<uint8_t> frame, uint64_t due_us);
+    void send_due_frames(uint64_t now_us);
+    void schedule_event(uint32_t delay_ms, uint8_t code, uint8_t cmd_type, const uint8_t *data, uint16_t len);
+    void queue_due_events(uint64_t now_us);
+    void download_segments(uint64_t now_us);
+    void get_file_status(uint8_t *data);
+    void reset_modem();
+    uint64_t get_airtime_us(uint16_t payload_len);
+    uint64_t get_next_wake_us();
+
+    void ymodem_start();
+    void ymodem_receive(uint8_t data);
+    void ymodem_send_block(uint8_t block, const uint8_t *data, uint16_t len);
+    void ymodem_send_packet();
+    void ymodem_check_timeout(uint64_t now_us);
+    void ymodem_retry();
+    void ymodem_end(bool is_done);
+};
+
+#endif // __MCM_EMULATOR_H__
@@ -0,0 +1,253 @@
+/**
+ * @file nvs.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief ESP-IDF NVS of the host builds, entries by namespace and key in memory
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "nvs_flash.h"
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    NVS_ENTRY_U16,
+    NVS_ENTRY_BLOB
+} nvs_entry_type_t;
+
+typedef struct
+{
+    nvs_entry_type_t type;
+    std::vector<uint8_t> value;
+} nvs_entry_t;
+
+typedef struct
+{
+    std::string name_space;
+    nvs_open_mode_t mode;
+    bool is_open;
+} nvs_open_handle_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static bool is_initialized = false;
+static std::map<std::string, nvs_entry_t> entries;       // by namespace, '/' and key
+static std::vector<nvs_open_handle_t> handles;           // handle is the index plus one
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static nvs_open_handle_t *nvs_get_handle(nvs_handle_t handle)
+{
+    if ((0 == handle) || (handle > handles.size()) || !handles[handle - 1].is_open)
+    {
+        return NULL;
+    }
+    return &handles[handle - 1];
+}
+
+static bool nvs_is_name_valid(const char *name)
+{
+    return (NULL != name) && (strlen(name) > 0) && (strlen(name) < NVS_KEY_NAME_MAX_SIZE);
+}
+
+static esp_err_t nvs_get_entry(nvs_handle_t handle, const char *key, nvs_entry_type_t type, nvs_entry_t **entry)
+{
+    nvs_open_handle_t *open_handle = nvs_get_handle(handle);
+    if (NULL == open_handle)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (!nvs_is_name_valid(key))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto it = entries.find(open_handle->name_space + "/" + key);
+    if (entries.end() == it)
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.type != type)
+    {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    *entry = &it->second;
+    return ESP_OK;
+}
+
+static esp_err_t nvs_set_entry(nvs_handle_t handle, const char *key, nvs_entry_type_t type, const void *value,
+                               size_t length)
+{
+    nvs_open_handle_t *open_handle = nvs_get_handle(handle);
+    if (NULL == open_handle)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (NVS_READONLY == open_handle->mode)
+    {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    if (!nvs_is_name_valid(key) || ((NULL == value) && (0 != length)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t &entry = entries[open_handle->name_space + "/" + key];
+    entry.type = type;
+    entry.value.assign((const uint8_t *)value, (const uint8_t *)value + length);
+    return ESP_OK;
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+esp_err_t nvs_flash_init(void)
+{
+    is_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    entries.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!is_initialized)
+    {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (!nvs_is_name_valid(name) || (NULL == out_handle))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // a closed handle is taken again, the firmware opens one per access
+    size_t index = 0;
+    while ((index < handles.size()) && handles[index].is_open)
+    {
+        index++;
+    }
+    if (index == handles.size())
+    {
+        handles.push_back({});
+    }
+    handles[index] = {name, open_mode, true};
+    *out_handle = (nvs_handle_t)(index + 1);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    nvs_open_handle_t *open_handle = nvs_get_handle(handle);
+    if (NULL != open_handle)
+    {
+        open_handle->is_open = false;
+    }
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    // every write is committed at once
+    return (NULL != nvs_get_handle(handle)) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char *key, uint16_t *out_value)
+{
+    nvs_entry_t *entry;
+    esp_err_t err = nvs_get_entry(handle, key, NVS_ENTRY_U16, &entry);
+    if (ESP_OK == err)
+    {
+        memcpy(out_value, entry->value.data(), sizeof(*out_value));
+    }
+    return err;
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char *key, uint16_t value)
+{
+    return nvs_set_entry(handle, key, NVS_ENTRY_U16, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    nvs_entry_t *entry;
+    esp_err_t err = nvs_get_entry(handle, key, NVS_ENTRY_BLOB, &entry);
+    if (ESP_OK != err)
+    {
+        return err;
+    }
+
+    // no buffer asks for the size only
+    if (NULL == out_value)
+    {
+        *length = entry->value.size();
+        return ESP_OK;
+    }
+    if (*length < entry->value.size())
+    {
+        *length = entry->value.size();
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    *length = entry->value.size();
+    memcpy(out_value, entry->value.data(), entry->value.size());
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return nvs_set_entry(handle, key, NVS_ENTRY_BLOB, value, length);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    nvs_open_handle_t *open_handle = nvs_get_handle(handle);
+    if (NULL == open_handle)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (NVS_READONLY == open_handle->mode)
+    {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    return (entries.erase(open_handle->name_space + "/" + key) > 0) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    nvs_open_handle_t *open_handle = nvs_get_handle(handle);
+    if (NULL == open_handle)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (NVS_READONLY == open_handle->mode)
+    {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    std::string prefix = open_handle->name_space + "/";
+    for (auto it = entries.lower_bound(prefix); (entries.end() != it) && (0 == it->first.compare(0, prefix.size(), prefix));)
+    {
+        it = entries.erase(it);
+    }
+    return ESP_OK;
+}
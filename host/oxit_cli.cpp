@@ -0,0 +1,317 @@
+/**
+ * @file oxit_cli.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Command line library of the host builds, lib/cli-lib only ships an esp32s3 archive
+ *        A line is "<app> <command> [argument]", "?" after the app or the command prints
+ *        the help. Bytes are read until the receive callback has none left.
+ * @version 0.1
+ * @date 2025-02-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <ctype.h>
+#include <stdio.h>
+#include "oxit_cli.h"
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define CLI_LINE_SIZE 160
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void cli_send_string(cli_handle_t *p_str_cli_hdl, const char *p_string)
+{
+    p_str_cli_hdl->tx_bytes_cb((const uint8_t *)p_string, strlen(p_string));
+}
+
+static bool cli_is_equal(cli_handle_t *p_str_cli_hdl, const char *p_first, const char *p_second)
+{
+    if (p_str_cli_hdl->config->case_sensitive)
+    {
+        return 0 == strcmp(p_first, p_second);
+    }
+    return 0 == strcasecmp(p_first, p_second);
+}
+
+/**
+ * @brief Cuts the next word of the line, the delimiters before it are skipped
+ * @return the word, NULL at the end of the line
+ */
+static char *cli_next_word(cli_handle_t *p_str_cli_hdl, char **pp_line)
+{
+    const char *p_delimiter = p_str_cli_hdl->config->arg_delimeter;
+    char *p_word = *pp_line + strspn(*pp_line, p_delimiter);
+    if ('\0' == *p_word)
+    {
+        return NULL;
+    }
+
+    char *p_end = p_word + strcspn(p_word, p_delimiter);
+    *pp_line = ('\0' != *p_end) ? (p_end + 1) : p_end;
+    *p_end = '\0';
+    return p_word;
+}
+
+static void cli_print_app_help(cli_handle_t *p_str_cli_hdl, const cli_app_t *p_app)
+{
+    char line[CLI_LINE_SIZE];
+
+    snprintf(line, sizeof(line), "%s %s\r", p_app->p_app_name, p_app->version);
+    cli_send_string(p_str_cli_hdl, line);
+    for (size_t i = 0; i < p_app->nbr_of_cmds; i++)
+    {
+        const cli_command_t *p_command = &p_app->p_commands[i];
+        snprintf(line, sizeof(line), "  %s" TAB_SPACE "%s\r", p_command->p_command_string,
+                 p_command->p_command_description);
+        cli_send_string(p_str_cli_hdl, line);
+    }
+}
+
+static void cli_execute(cli_handle_t *p_str_cli_hdl)
+{
+    char *p_line = p_str_cli_hdl->cmd_buffer;
+    char *p_app_name = cli_next_word(p_str_cli_hdl, &p_line);
+    if (NULL == p_app_name)
+    {
+        return;
+    }
+
+    for (node_t *p_node = p_str_cli_hdl->_app_list.head; NULL != p_node; p_node = p_node->next)
+    {
+        const cli_app_t *p_app = (const cli_app_t *)p_node->data;
+        if (!cli_is_equal(p_str_cli_hdl, p_app_name, p_app->p_app_name))
+        {
+            continue;
+        }
+
+        char *p_command_name = cli_next_word(p_str_cli_hdl, &p_line);
+        if ((NULL == p_command_name) || cli_is_equal(p_str_cli_hdl, p_command_name, p_str_cli_hdl->config->help_cmd))
+        {
+            cli_print_app_help(p_str_cli_hdl, p_app);
+            return;
+        }
+        for (size_t i = 0; i < p_app->nbr_of_cmds; i++)
+        {
+            const cli_command_t *p_command = &p_app->p_commands[i];
+            if (!cli_is_equal(p_str_cli_hdl, p_command_name, p_command->p_command_string))
+            {
+                continue;
+            }
+
+            // the rest of the line is the argument, without the delimiters around it
+            p_line += strspn(p_line, p_str_cli_hdl->config->arg_delimeter);
+            if (cli_is_equal(p_str_cli_hdl, p_line, p_str_cli_hdl->config->help_cmd))
+            {
+                cli_send_string(p_str_cli_hdl, p_command->p_command_usage);
+                cli_send_string(p_str_cli_hdl, "\r");
+                return;
+            }
+            p_command->command_handler(p_line, p_str_cli_hdl->tx_bytes_cb);
+            return;
+        }
+        cli_send_string(p_str_cli_hdl, "Command not found\r");
+        return;
+    }
+    cli_send_string(p_str_cli_hdl, "Application not found\r");
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+hal_error_code_t cli_init(cli_handle_t *const p_str_cli_hdl, cli_config_t *p_str_cfg)
+{
+    if ((NULL == p_str_cli_hdl) || (NULL == p_str_cfg) || (NULL == p_str_cli_hdl->cmd_buffer))
+    {
+        return HAL_ERROR_MEMORY_NULL;
+    }
+    p_str_cli_hdl->config = p_str_cfg;
+    p_str_cli_hdl->_startup_msg_done = false;
+    p_str_cli_hdl->_rx_idx = 0;
+    linked_list_init(&p_str_cli_hdl->_app_list);
+    return HAL_ERROR_OK;
+}
+
+hal_error_code_t cli_process(cli_handle_t *const p_str_cli_hdl)
+{
+    if ((NULL == p_str_cli_hdl) || (NULL == p_str_cli_hdl->config))
+    {
+        return HAL_ERROR_MEMORY_NULL;
+    }
+    if (!p_str_cli_hdl->_startup_msg_done)
+    {
+        cli_send_string(p_str_cli_hdl, p_str_cli_hdl->config->startup_msg);
+        p_str_cli_hdl->_startup_msg_done = true;
+    }
+
+    uint8_t u8_byte;
+    while (HAL_ERROR_OK == p_str_cli_hdl->rx_byte_cb(&u8_byte))
+    {
+        if (u8_byte > 0x7F)
+        {
+            return HAL_ERROR_OUT_OF_BOUND;
+        }
+        if (p_str_cli_hdl->config->echo_enable)
+        {
+            p_str_cli_hdl->tx_bytes_cb(&u8_byte, 1);
+        }
+
+        if ((DELETE == u8_byte) || (BACKSPACE == u8_byte))
+        {
+            if (p_str_cli_hdl->_rx_idx > 0)
+            {
+                p_str_cli_hdl->_rx_idx--;
+            }
+        }
+        else if ((uint8_t)p_str_cli_hdl->config->endline == u8_byte)
+        {
+            p_str_cli_hdl->cmd_buffer[p_str_cli_hdl->_rx_idx] = NULL_CHARACTER;
+            p_str_cli_hdl->_rx_idx = 0;
+            cli_execute(p_str_cli_hdl);
+        }
+        else if (('\n' != u8_byte) && (p_str_cli_hdl->_rx_idx < (p_str_cli_hdl->max_cmd_size - 1)))
+        {
+            p_str_cli_hdl->cmd_buffer[p_str_cli_hdl->_rx_idx++] = (char)u8_byte;
+        }
+    }
+    return HAL_ERROR_OK;
+}
+
+hal_error_code_t cli_register_new_app(cli_handle_t *const p_str_cli_hdl, cli_app_t *p_app)
+{
+    if ((NULL == p_str_cli_hdl) || (NULL == p_app))
+    {
+        return HAL_ERROR_MEMORY_NULL;
+    }
+    linked_list_create_and_append_node(&p_str_cli_hdl->_app_list, p_app);
+    return HAL_ERROR_OK;
+}
+
+hal_error_code_t cli_unregister_new_app(cli_handle_t *const p_str_cli_hdl, cli_app_t *p_app)
+{
+    if ((NULL == p_str_cli_hdl) || (NULL == p_app))
+    {
+        return HAL_ERROR_MEMORY_NULL;
+    }
+    for (node_t *p_node = p_str_cli_hdl->_app_list.head; NULL != p_node; p_node = p_node->next)
+    {
+        if (p_node->data == p_app)
+        {
+            linked_list_delete_node(&p_str_cli_hdl->_app_list, p_node);
+            return HAL_ERROR_OK;
+        }
+    }
+    return HAL_ERROR_NOT_FOUND;
+}
+
+void linked_list_init(linked_list_t *list)
+{
+    list->head = NULL;
+    list->tail = NULL;
+}
+
+void linked_list_drop(linked_list_t *list)
+{
+    while (NULL != list->head)
+    {
+        linked_list_delete_node(list, list->head);
+    }
+}
+
+void linked_list_append_node(linked_list_t *list, node_t *node)
+{
+    node->next = NULL;
+    node->prev = list->tail;
+    if (NULL != list->tail)
+    {
+        list->tail->next = node;
+    }
+    else
+    {
+        list->head = node;
+    }
+    list->tail = node;
+}
+
+void linked_list_remove_node(linked_list_t *list, node_t *node)
+{
+    if (NULL != node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        list->head = node->next;
+    }
+    if (NULL != node->next)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        list->tail = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+void linked_list_insert_node(linked_list_t *list, node_t *node, uint32_t idx)
+{
+    node_t *p_next = list->head;
+    while ((NULL != p_next) && (idx > 0))
+    {
+        p_next = p_next->next;
+        idx--;
+    }
+    if (NULL == p_next)
+    {
+        linked_list_append_node(list, node);
+        return;
+    }
+
+    node->next = p_next;
+    node->prev = p_next->prev;
+    if (NULL != p_next->prev)
+    {
+        p_next->prev->next = node;
+    }
+    else
+    {
+        list->head = node;
+    }
+    p_next->prev = node;
+}
+
+void linked_list_create_and_append_node(linked_list_t *list, void *data)
+{
+    node_t *node = (node_t *)malloc(sizeof(node_t));
+    if (NULL != node)
+    {
+        node->data = data;
+        linked_list_append_node(list, node);
+    }
+}
+
+void linked_list_delete_node(linked_list_t *list, node_t *node)
+{
+    linked_list_remove_node(list, node);
+    free(node);
+}
@@ -0,0 +1,325 @@
+/**
+ * @file api_metrics.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief this contain the implementation of the serial link metrics. Counters
+ * are plain increments on the send and receive paths, so they can be kept enabled.
+ * @version 0.1
+ * @date 2024-04-15
+ * 
+ * @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "api_metrics.h"
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+/**
+ * @brief Event codes 0x00 to API_METRICS_LAST_LINEAR_EVENT are counted at their own index
+ */
+#define API_METRICS_LAST_LINEAR_EVENT               MODEM_EVENT_LORAWAN_MAC_TIME
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+/**
+ * @brief Upper bounds of the round trip time buckets, 9600 baud frame takes 5 to 320 ms
+ */
+static const uint32_t rtt_bounds_ms[API_METRICS_RTT_BUCKETS - 1] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+static const mrover_return_code_t failure_codes[API_METRICS_FAILURE_CODES - 1] = {
+    MROVER_RC_UNKNOWN,
+    MROVER_RC_NOT_IMPLEMENTED,
+    MROVER_RC_FAIL,
+    MROVER_RC_BAD_CRC,
+    MROVER_RC_BAD_SIZE
+};
+
+static const uint8_t sparse_event_codes[API_METRICS_EVENT_CODES - API_METRICS_LAST_LINEAR_EVENT - 2] = {
+    MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD,
+    MODEM_EVENT_CLASS_SWITCHED,
+    MODEM_EVENT_NONE
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static api_metrics_cmd_t *api_metrics_get_cmd_slot(api_metrics_t *p_metrics, uint16_t u16_cmd_code);
+static uint8_t api_metrics_get_rtt_bucket(uint32_t u32_rtt_ms);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief This function returns the counters slot of the given command, the slot is
+ *        claimed by the command on its first use
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] u16_cmd_code Command code
+ * @return Pointer to the slot, NULL if the slot belongs to another command
+ */
+static api_metrics_cmd_t *api_metrics_get_cmd_slot(api_metrics_t *p_metrics, uint16_t u16_cmd_code)
+{
+    api_metrics_cmd_t *p_cmd = &p_metrics->h_cmd[MROVER_CC_TABLE_SLOT(u16_cmd_code)];
+
+    if (false == p_cmd->b_used)
+    {
+        p_cmd->b_used = true;
+        p_cmd->u16_cmd_code = u16_cmd_code;
+    }
+
+    return (u16_cmd_code == p_cmd->u16_cmd_code) ? p_cmd : NULL;
+}
+
+/**
+ * @brief This function returns the histogram bucket of a round trip time
+ *
+ * @param[in] u32_rtt_ms Round trip time in milliseconds
+ * @return Bucket index
+ */
+static uint8_t api_metrics_get_rtt_bucket(uint32_t u32_rtt_ms)
+{
+    uint8_t u8_bucket = 0;
+
+    while ((u8_bucket < (API_METRICS_RTT_BUCKETS - 1)) && (u32_rtt_ms >= rtt_bounds_ms[u8_bucket]))
+    {
+        u8_bucket++;
+    }
+
+    return u8_bucket;
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function Prototypes
+ *******************************************************************************/
+
+/******************************************************************************
+ * Function Definitions
+ *******************************************************************************/
+void api_metrics_reset(api_metrics_t *p_metrics)
+{
+    memset(p_metrics->h_cmd, 0, sizeof(p_metrics->h_cmd));
+    memset(p_metrics->u32_events, 0, sizeof(p_metrics->u32_events));
+    memset(&p_metrics->h_link, 0, sizeof(p_metrics->h_link));
+}
+
+
+void api_metrics_on_cmd_sent(api_metrics_t *p_metrics, uint16_t u16_cmd_code, uint16_t u16_len, uint32_t u32_now_ms)
+{
+    api_metrics_cmd_t *p_cmd = api_metrics_get_cmd_slot(p_metrics, u16_cmd_code);
+
+    p_metrics->h_link.u32_bytes_out += u16_len;
+    if (NULL != p_cmd)
+    {
+        p_cmd->u32_sent++;
+    }
+
+    p_metrics->b_rtt_pending = true;
+    p_metrics->u16_rtt_cmd_code = u16_cmd_code;
+    p_metrics->u32_rtt_start_ms = u32_now_ms;
+}
+
+
+void api_metrics_on_response(api_metrics_t *p_metrics, uint16_t u16_cmd_code, uint8_t u8_return_code, uint32_t u32_now_ms)
+{
+    api_metrics_cmd_t *p_cmd = api_metrics_get_cmd_slot(p_metrics, u16_cmd_code);
+
+    if (NULL == p_cmd)
+    {
+        return;
+    }
+
+    if (MROVER_RC_OK == u8_return_code)
+    {
+        p_cmd->u32_ok++;
+    }
+    else
+    {
+        uint8_t u8_index = 0;
+        while ((u8_index < (API_METRICS_FAILURE_CODES - 1)) && (failure_codes[u8_index] != u8_return_code))
+        {
+            u8_index++;
+        }
+        p_cmd->u32_failed[u8_index]++;
+    }
+
+    // late response of a timed out command has no round trip
+    if (p_metrics->b_rtt_pending && (u16_cmd_code == p_metrics->u16_rtt_cmd_code))
+    {
+        uint32_t u32_rtt_ms = u32_now_ms - p_metrics->u32_rtt_start_ms;
+        p_metrics->b_rtt_pending = false;
+        p_cmd->u32_rtt_sum_ms += u32_rtt_ms;
+        if (u32_rtt_ms > p_cmd->u32_rtt_max_ms)
+        {
+            p_cmd->u32_rtt_max_ms = u32_rtt_ms;
+        }
+        p_cmd->u32_rtt_buckets[api_metrics_get_rtt_bucket(u32_rtt_ms)]++;
+    }
+}
+
+
+void api_metrics_on_timeout(api_metrics_t *p_metrics, uint16_t u16_cmd_code)
+{
+    api_metrics_cmd_t *p_cmd = api_metrics_get_cmd_slot(p_metrics, u16_cmd_code);
+
+    if (NULL != p_cmd)
+    {
+        p_cmd->u32_timeouts++;
+    }
+
+    if (u16_cmd_code == p_metrics->u16_rtt_cmd_code)
+    {
+        p_metrics->b_rtt_pending = false;
+    }
+}
+
+
+void api_metrics_on_event(api_metrics_t *p_metrics, uint8_t u8_event_code)
+{
+    uint8_t u8_index = API_METRICS_EVENT_CODES - 1;
+
+    if (API_METRICS_LAST_LINEAR_EVENT >= u8_event_code)
+    {
+        u8_index = u8_event_code;
+    }
+    else
+    {
+        for (uint8_t u8_sparse = 0; u8_sparse < sizeof(sparse_event_codes); u8_sparse++)
+        {
+            if (sparse_event_codes[u8_sparse] == u8_event_code)
+            {
+                u8_index = API_METRICS_LAST_LINEAR_EVENT + 1 + u8_sparse;
+                break;
+            }
+        }
+    }
+
+    p_metrics->u32_events[u8_index]++;
+}
+
+
+void api_metrics_on_frame_in(api_metrics_t *p_metrics)
+{
+    p_metrics->h_link.u32_frames_in++;
+}
+
+
+void api_metrics_add_reassembler(api_metrics_t *p_metrics, const fp_reassembler_t *p_reassembler)
+{
+    p_metrics->h_link.u32_bytes_in += p_reassembler->u32_bytes_in;
+    p_metrics->h_link.u32_crc_errors += p_reassembler->u32_crc_errors;
+    p_metrics->h_link.u32_length_errors += p_reassembler->u32_length_errors;
+    p_metrics->h_link.u32_resync_count += p_reassembler->u32_resync_count;
+    p_metrics->h_link.u32_dropped_bytes += p_reassembler->u32_dropped_bytes;
+}
+
+
+const api_metrics_cmd_t *api_metrics_get_cmd(const api_metrics_t *p_metrics, uint16_t u16_cmd_code)
+{
+    const api_metrics_cmd_t *p_cmd = &p_metrics->h_cmd[MROVER_CC_TABLE_SLOT(u16_cmd_code)];
+
+    return (p_cmd->b_used && (u16_cmd_code == p_cmd->u16_cmd_code)) ? p_cmd : NULL;
+}
+
+
+uint32_t api_metrics_get_rtt_bound_ms(uint8_t u8_bucket)
+{
+    return (u8_bucket < (API_METRICS_RTT_BUCKETS - 1)) ? rtt_bounds_ms[u8_bucket] : 0;
+}
+
+
+mrover_return_code_t api_metrics_get_failure_code(uint8_t u8_index)
+{
+    return (u8_index < (API_METRICS_FAILURE_CODES - 1)) ? failure_codes[u8_index] : MROVER_RC_OK;
+}
+
+
+int16_t api_metrics_get_event_code(uint8_t u8_index)
+{
+    int16_t i16_event_code = -1;
+
+    if (API_METRICS_LAST_LINEAR_EVENT >= u8_index)
+    {
+        i16_event_code = u8_index;
+    }
+    else if (u8_index < (API_METRICS_EVENT_CODES - 1))
+    {
+        i16_event_code = sparse_event_codes[u8_index - API_METRICS_LAST_LINEAR_EVENT - 1];
+    }
+
+    return i16_event_code;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file api_metrics.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the serial link metrics of the api processor.
+ * @version 0.1
+ * @date 2024-04-11
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __API_METRICS_H__
+#define __API_METRICS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include "commands_defs.h"
+#include "frame_parse.h"
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+/**
+ * @brief Number of round trip time buckets, the last bucket takes everything
+ *        above the last bound of api_metrics_get_rtt_bound_ms()
+ */
+#define API_METRICS_RTT_BUCKETS                     10
+
+/**
+ * @brief Failure return codes counted per command, see api_metrics_get_failure_code()
+ */
+#define API_METRICS_FAILURE_CODES                   6
+
+/**
+ * @brief Event codes counted, see api_metrics_get_event_code()
+ */
+#define API_METRICS_EVENT_CODES                     26
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+/**
+ * @brief Counters of a single command
+ */
+typedef struct
+{
+    bool b_used;                                        // slot claimed by u16_cmd_code, GET_EVENT is code 0
+    uint16_t u16_cmd_code;                              // command code the counters belong to
+    uint32_t u32_sent;                                  // number of frames sent
+    uint32_t u32_ok;                                    // number of MROVER_RC_OK responses
+    uint32_t u32_failed[API_METRICS_FAILURE_CODES];     // number of error responses by return code
+    uint32_t u32_timeouts;                              // number of responses never received
+    uint32_t u32_rtt_sum_ms;                            // sum of the round trip times
+    uint32_t u32_rtt_max_ms;                            // longest round trip time
+    uint32_t u32_rtt_buckets[API_METRICS_RTT_BUCKETS];  // histogram of the round trip times
+} api_metrics_cmd_t;
+
+/**
+ * @brief Counters of the serial link and the frame parser
+ */
+typedef struct
+{
+    uint32_t u32_bytes_in;                              // bytes received
+    uint32_t u32_bytes_out;                             // bytes of the frames sent
+    uint32_t u32_frames_in;                             // frames parsed
+    uint32_t u32_crc_errors;                            // candidate frames with invalid crc
+    uint32_t u32_length_errors;                         // candidate frames with invalid length
+    uint32_t u32_resync_count;                          // runs of bytes discarded to find the next frame
+    uint32_t u32_dropped_bytes;                         // bytes discarded while resyncing
+} api_metrics_link_t;
+
+/**
+ * @brief Metrics registry, private members need not to be accessed directly
+ */
+typedef struct
+{
+    api_metrics_cmd_t h_cmd[MROVER_CC_TABLE_SIZE];      // indexed by MROVER_CC_TABLE_SLOT
+    uint32_t u32_events[API_METRICS_EVENT_CODES];       // GET_EVENT responses by event code
+    api_metrics_link_t h_link;
+    bool b_rtt_pending;                                 // mcm handles one command at a time
+    uint16_t u16_rtt_cmd_code;
+    uint32_t u32_rtt_start_ms;
+} api_metrics_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Clears all the counters
+ *
+ * Round trip in progress is kept, so its response is still measured.
+ *
+ * @param[out] p_metrics Pointer to the metrics registry
+ */
+void api_metrics_reset(api_metrics_t *p_metrics);
+
+/**
+ * @brief Counts a frame sent and starts its round trip
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] u16_cmd_code Command code of the frame
+ * @param[in] u16_len Length of the frame
+ * @param[in] u32_now_ms Current time in milliseconds
+ */
+void api_metrics_on_cmd_sent(api_metrics_t *p_metrics, uint16_t u16_cmd_code, uint16_t u16_len, uint32_t u32_now_ms);
+
+/**
+ * @brief Counts a response and closes the round trip of its command
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] u16_cmd_code Command code of the response
+ * @param[in] u8_return_code Return code of the response
+ * @param[in] u32_now_ms Current time in milliseconds
+ */
+void api_metrics_on_response(api_metrics_t *p_metrics, uint16_t u16_cmd_code, uint8_t u8_return_code, uint32_t u32_now_ms);
+
+/**
+ * @brief Counts a command whose response was never received
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] u16_cmd_code Command code of the command
+ */
+void api_metrics_on_timeout(api_metrics_t *p_metrics, uint16_t u16_cmd_code);
+
+/**
+ * @brief Counts an event read with GET_EVENT
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] u8_event_code Event code, get_event_code_t
+ */
+void api_metrics_on_event(api_metrics_t *p_metrics, uint8_t u8_event_code);
+
+/**
+ * @brief Counts a frame parsed
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ */
+void api_metrics_on_frame_in(api_metrics_t *p_metrics);
+
+/**
+ * @brief Adds the counters of a frame reassembler to the link counters
+ *
+ * @param[in,out] p_metrics Pointer to the metrics registry
+ * @param[in] p_reassembler Pointer to the reassembler
+ */
+void api_metrics_add_reassembler(api_metrics_t *p_metrics, const fp_reassembler_t *p_reassembler);
+
+/**
+ * @brief Returns the counters of the given command
+ *
+ * @param[in] p_metrics Pointer to the metrics registry
+ * @param[in] u16_cmd_code Command code
+ * @return Pointer to the counters, NULL if the command was never sent
+ */
+const api_metrics_cmd_t *api_metrics_get_cmd(const api_metrics_t *p_metrics, uint16_t u16_cmd_code);
+
+/**
+ * @brief Returns the upper bound of a round trip time bucket
+ *
+ * @param[in] u8_bucket Bucket index
+ * @return Upper bound in milliseconds, 0 for the last, unbounded bucket
+ */
+uint32_t api_metrics_get_rtt_bound_ms(uint8_t u8_bucket);
+
+/**
+ * @brief Returns the return code counted at the given index of u32_failed
+ *
+ * @param[in] u8_index Index in u32_failed
+ * @return Return code, MROVER_RC_OK for the last index, which counts the unknown codes
+ */
+mrover_return_code_t api_metrics_get_failure_code(uint8_t u8_index);
+
+/**
+ * @brief Returns the event code counted at the given index of u32_events
+ *
+ * @param[in] u8_index Index in u32_events
+ * @return Event code, -1 for the last index, which counts the unknown codes
+ */
+int16_t api_metrics_get_event_code(uint8_t u8_index);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __API_METRICS_H__
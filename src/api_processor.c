@@ -80,10 +80,57 @@
 /******************************************************************************
  * PRIVATE MACROS AND DEFINES
  ******************************************************************************/
+#define TRACE_MODULE_LEVEL                  TRACE_LEVEL_API_PROCESSOR
+
+#define API_PROCESSOR_CMD_DESCRIPTOR_ENTRY(cc, type, rsp_len_policy, rsp_len, parser, name)  [MROVER_CC_TABLE_SLOT(cc)] = {(cc), (type), (rsp_len_policy), (rsp_len), (parser), (name)},
+#define API_PROCESSOR_CMD_COUNT_ENTRY(cc, type, rsp_len_policy, rsp_len, parser, name)       + 1
+#define API_PROCESSOR_CMD_SLOT_BIT_ENTRY(cc, type, rsp_len_policy, rsp_len, parser, name)    | (1ULL << MROVER_CC_TABLE_SLOT(cc))
+
+/**
+ * @brief Header of the frame sent to the mcm module
+ *  1 byte command type, 2 byte command code and 2 byte length
+ */
+#define API_PROCESSOR_TX_HEADER_LEN                 5
 
 /******************************************************************************
  * PRIVATE TYPEDEFS
  ******************************************************************************/
+/**
+ * @brief Context passed to the frame reassembler while parsing the received data
+ */
+typedef struct
+{
+    mcm_module_hdl_t *mcm_module;       // module for which the data is received
+    api_processor_status_t status;      // status of the last frame parsed
+} api_processor_rx_context_t;
+
+/**
+ * @brief Reader of a response payload, the crc of the frame is checked before it is created
+ */
+typedef struct
+{
+    uint8_t *p_data;                    // payload of the response
+    uint16_t u16_len;                   // payload length
+    uint16_t u16_pos;                   // bytes read so far
+} api_processor_reader_t;
+
+/**
+ * @brief Parser for the payload of the response received for a command
+ */
+typedef api_processor_status_t (*api_processor_rsp_parser_t)(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+
+/**
+ * @brief Descriptor of a command supported by the mcm module, see MROVER_COMMAND_LIST
+ */
+typedef struct
+{
+    uint16_t u16_cmd_code;                      // command code, empty slot if p_name is NULL
+    command_types_t cmd_type;                   // default command type used to send the command
+    mrover_rsp_len_policy_t rsp_len_policy;     // how the response payload length is validated
+    uint16_t u16_rsp_len;                       // expected response payload length
+    api_processor_rsp_parser_t rsp_parser;      // parser for the response payload, NULL if nothing to parse
+    const char *p_name;                         // name of the command for the trace
+} api_processor_cmd_descriptor_t;
 
 /******************************************************************************
  * STATIC VARIABLES
@@ -96,143 +143,375 @@
 /******************************************************************************
  * STATIC FUNCTION PROTOTYPES
  ******************************************************************************/
-static api_processor_status_t api_processor_parse_response_frame(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len,api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_get_event_reset(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_get_event(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len,api_processor_response_t *p_response);
-static api_processor_status_t api_processor_get_event_tx_status(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_lorawan_down_data(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_sid_down_data(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_get_version(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_cmd_with_len_zero(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* module);
-static api_processor_status_t api_processor_parse_eui_cmd(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* eui_type);
-static api_processor_status_t api_processor_parse_get_class_cmd(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* eui_type);
-static api_processor_status_t api_procesor_parse_lorawan_class_switch(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_get_event_seg(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_parse_get_file_status(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response);
-static api_processor_status_t api_processor_handle_request_uplink(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_decode_response(mcm_module_hdl_t *mcm_module, uint8_t *data, const fp_frame_header_t *p_header, bool b_is_validated, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_event_reset(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_event(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_get_event_tx_status(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_lorawan_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_sid_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_version(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_eui_cmd(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_class_cmd(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_procesor_parse_lorawan_class_switch(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_event_seg(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_get_file_status(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_handle_request_uplink(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response);
+static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t *mcm_module, uint8_t* data,uint16_t len, bool b_is_validated);
+static void api_processor_on_rx_frame(uint8_t *p_frame, uint16_t u16_len, void *user_context);
+static api_processor_status_t api_processor_send_frame(mcm_module_hdl_t *mcm_module, command_types_t cmd_type, mrover_cc_codes_t cmd_code,
+                                                       const uint8_t *p_params, uint16_t u16_params_len, const uint8_t *p_payload, uint16_t u16_payload_len);
+static api_processor_status_t api_processor_send_frame_vec(mcm_module_hdl_t *mcm_module, command_types_t cmd_type, mrover_cc_codes_t cmd_code,
+                                                           const uint8_t *p_params, uint16_t u16_params_len, const uint8_t *p_payload, uint16_t u16_payload_len);
+static api_processor_status_t api_processor_send_command(mcm_module_hdl_t *mcm_module, mrover_cc_codes_t cmd_code, const uint8_t *p_params, uint16_t u16_params_len);
+static inline uint32_t api_processor_get_tick_ms(const mcm_module_hdl_t *mcm_module);
+
+/**
+ * @brief Descriptors of all the commands, indexed by MROVER_CC_TABLE_SLOT
+ */
+static const api_processor_cmd_descriptor_t cmd_descriptors[MROVER_CC_TABLE_SIZE] = {
+    MROVER_COMMAND_LIST(API_PROCESSOR_CMD_DESCRIPTOR_ENTRY)
+};
+
+// a command code hashed to the slot of another one would silently replace its descriptor
+_Static_assert(MROVER_CC_TABLE_SIZE <= 64, "slot bits of the check below are 64 bits wide");
+_Static_assert(__builtin_popcountll(0ULL MROVER_COMMAND_LIST(API_PROCESSOR_CMD_SLOT_BIT_ENTRY)) ==
+               (0 MROVER_COMMAND_LIST(API_PROCESSOR_CMD_COUNT_ENTRY)),
+               "two command codes share a slot of MROVER_CC_TABLE_SLOT, change the hash");
 
 /******************************************************************************
  * STATIC FUNCTIONS
  ******************************************************************************/
 
 /**
- * @brief This function parses the response frame and fills up the
+ * @brief This function returns the descriptor of the given command code
+ *
+ * @param[in] u16_cmd_code Command code
+ * @return Pointer to the descriptor, NULL if the command code is not supported
+ */
+static inline const api_processor_cmd_descriptor_t *api_processor_get_cmd_descriptor(uint16_t u16_cmd_code)
+{
+    const api_processor_cmd_descriptor_t *p_descriptor = &cmd_descriptors[MROVER_CC_TABLE_SLOT(u16_cmd_code)];
+
+    return ((NULL != p_descriptor->p_name) && (u16_cmd_code == p_descriptor->u16_cmd_code)) ? p_descriptor : NULL;
+}
+
+/**
+ * @brief Number of payload bytes not read yet
+ */
+static inline uint16_t api_processor_reader_left(const api_processor_reader_t *p_reader)
+{
+    return p_reader->u16_len - p_reader->u16_pos;
+}
+
+/**
+ * @brief Reads the next payload byte, the length is checked by the caller
+ */
+static inline uint8_t api_processor_read_u8(api_processor_reader_t *p_reader)
+{
+    return p_reader->p_data[p_reader->u16_pos++];
+}
+
+/**
+ * @brief Reads the next two payload bytes, most significant first
+ */
+static inline uint16_t api_processor_read_u16_be(api_processor_reader_t *p_reader)
+{
+    uint16_t u16_value = api_processor_read_u8(p_reader) << 8;
+    return u16_value | api_processor_read_u8(p_reader);
+}
+
+/**
+ * @brief Takes the next payload bytes in place
+ *
+ * @return Pointer to the bytes in the frame buffer
+ */
+static inline uint8_t *api_processor_read_bytes(api_processor_reader_t *p_reader, uint16_t u16_len)
+{
+    uint8_t *p_bytes = &p_reader->p_data[p_reader->u16_pos];
+    p_reader->u16_pos += u16_len;
+    return p_bytes;
+}
+
+/**
+ * @brief Reads the segmented file status, the payload of the event and of the FILE_STATUS response
+ */
+static void api_processor_read_seg_status(api_processor_reader_t *p_reader, get_seg_file_status_t *p_status)
+{
+    uint8_t seg_byte;
+
+    p_status->cmd_type.bin_type = api_processor_read_u8(p_reader) & 0x0F;
+    p_status->fw_ver.major = api_processor_read_u8(p_reader);
+    p_status->fw_ver.minor = api_processor_read_u8(p_reader);
+    p_status->fw_ver.patch = api_processor_read_u8(p_reader);
+    p_status->pkg_size[0] = api_processor_read_u8(p_reader);
+    p_status->pkg_size[1] = api_processor_read_u8(p_reader);
+    p_status->pkg_size[2] = api_processor_read_u8(p_reader);
+    seg_byte = api_processor_read_u8(p_reader);
+    p_status->seg_size = seg_byte & 0x0F;
+    p_status->nxt_seg_id = seg_byte >> 4;
+    // status bitmap is little endian
+    p_status->seg_status = api_processor_read_u8(p_reader);
+    p_status->seg_status |= api_processor_read_u8(p_reader) << 8;
+}
+
+/**
+ * @brief This function returns the current time from the module time source
+ *
+ * @param[in] mcm_module Pointer to the MCM module structure.
+ * @return Time in milliseconds, 0 if no time source is set
+ */
+static inline uint32_t api_processor_get_tick_ms(const mcm_module_hdl_t *mcm_module)
+{
+    return (NULL != mcm_module->get_tick_ms_cb) ? mcm_module->get_tick_ms_cb() : 0;
+}
+
+/**
+ * @brief This function sends the frame for the command in parts through the scatter-gather callback
+ *
+ * Only the header is built on the stack, the parameters and the payload are sent from the
+ * caller buffers and the CRC is calculated over the parts, so nothing is copied into u8_send_payload.
+ * Frame size is validated by the caller.
+ *
+ * @param[in] mcm_module Pointer to the MCM module structure.
+ * @param[in] cmd_type Command type of the frame
+ * @param[in] cmd_code Command code of the frame
+ * @param[in] p_params Pointer to the command parameters, can be NULL if u16_params_len is 0
+ * @param[in] u16_params_len Length of the command parameters
+ * @param[in] p_payload Pointer to the user payload, can be NULL if u16_payload_len is 0
+ * @param[in] u16_payload_len Length of the user payload
+ *
+ * @return API_PROCESSOR_SUCCESS if the frame is sent, otherwise appropriate error code.
+ */
+static api_processor_status_t api_processor_send_frame_vec(mcm_module_hdl_t *mcm_module, command_types_t cmd_type, mrover_cc_codes_t cmd_code,
+                                                           const uint8_t *p_params, uint16_t u16_params_len, const uint8_t *p_payload, uint16_t u16_payload_len)
+{
+    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    uint16_t u16_data_len = u16_params_len + u16_payload_len;
+    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + u16_data_len;
+
+    uint8_t u8_header[API_PROCESSOR_TX_HEADER_LEN];
+    u8_header[0] = cmd_type;
+    u8_header[1] = cmd_code >> 8;
+    u8_header[2] = cmd_code & 0xFF;
+    u8_header[3] = u16_data_len >> 8;
+    u8_header[4] = u16_data_len & 0xFF;
+
+    uint8_t u8_crc = fp_crc_update(0, u8_header, sizeof(u8_header));
+    u8_crc = fp_crc_update(u8_crc, p_params, u16_params_len);
+    u8_crc = fp_crc_update(u8_crc, p_payload, u16_payload_len);
+
+    serial_iovec_t iov[4];
+    uint8_t u8_iov_count = 0;
+    iov[u8_iov_count++] = (serial_iovec_t){u8_header, sizeof(u8_header)};
+    if (0 != u16_params_len)
+    {
+        iov[u8_iov_count++] = (serial_iovec_t){p_params, u16_params_len};
+    }
+    if (0 != u16_payload_len)
+    {
+        iov[u8_iov_count++] = (serial_iovec_t){p_payload, u16_payload_len};
+    }
+    iov[u8_iov_count++] = (serial_iovec_t){&u8_crc, sizeof(u8_crc)};
+
+    // send the parts to the module for sending
+    uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_vec_cb(iov, u8_iov_count, mcm_module->user_context);
+    if (max_payload_size != u16_sent_bytes)
+    {
+        TRACE_INFO("Failed to send data through serial port\n");
+        return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+    }
+    else
+    {
+        return_status = API_PROCESSOR_SUCCESS;
+    }
+
+    return return_status;
+}
+
+/**
+ * @brief This function builds the frame for the command and sends it through the serial port
+ *
+ * Frame is [cmd type][cmd code][length][params][payload][crc], length covers the
+ * params and the payload.
+ *
+ * @param[in] mcm_module Pointer to the MCM module structure.
+ * @param[in] cmd_type Command type of the frame
+ * @param[in] cmd_code Command code of the frame
+ * @param[in] p_params Pointer to the command parameters, can be NULL if u16_params_len is 0
+ * @param[in] u16_params_len Length of the command parameters
+ * @param[in] p_payload Pointer to the user payload, can be NULL if u16_payload_len is 0
+ * @param[in] u16_payload_len Length of the user payload
+ *
+ * @return API_PROCESSOR_SUCCESS if the frame is sent, otherwise appropriate error code.
+ */
+static api_processor_status_t api_processor_send_frame(mcm_module_hdl_t *mcm_module, command_types_t cmd_type, mrover_cc_codes_t cmd_code,
+                                                       const uint8_t *p_params, uint16_t u16_params_len, const uint8_t *p_payload, uint16_t u16_payload_len)
+{
+    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+
+    do
+    {
+        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        {
+            TRACE_INFO("MCM module is not initialized\n");
+            break;
+        }
+
+        uint16_t u16_data_len = u16_params_len + u16_payload_len;
+        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + u16_data_len;
+        if (MAX_SERIAL_SEND_PAYLOAD_SIZE < max_payload_size)
+        {
+            TRACE_INFO("Frame of %d bytes exceeds the maximum size\n", max_payload_size);
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
+            break;
+        }
+
+        if (NULL != mcm_module->h_serial_device.send_vec_cb)
+        {
+            return_status = api_processor_send_frame_vec(mcm_module, cmd_type, cmd_code, p_params, u16_params_len, p_payload, u16_payload_len);
+            break;
+        }
+
+        uint8_t *p_frame = mcm_module->u8_send_payload;
+        p_frame[0] = cmd_type;
+        p_frame[1] = cmd_code >> 8;
+        p_frame[2] = cmd_code & 0xFF;
+        p_frame[3] = u16_data_len >> 8;
+        p_frame[4] = u16_data_len & 0xFF;
+        if (0 != u16_params_len)
+        {
+            memcpy(&p_frame[API_PROCESSOR_TX_HEADER_LEN], p_params, u16_params_len);
+        }
+        if (0 != u16_payload_len)
+        {
+            memcpy(&p_frame[API_PROCESSOR_TX_HEADER_LEN + u16_params_len], p_payload, u16_payload_len);
+        }
+        p_frame[max_payload_size - 1] = 0; // crc is calculated over this byte too
+
+        // send the payload to the frame parser for crc check and other validation
+        fp_api_status_t status = fp_append_crc(p_frame, max_payload_size);
+        if (FP_SUCCESS != status)
+        {
+            TRACE_INFO("Failed to append crc\n");
+            break;
+        }
+
+        // send the data to the module for sending
+        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(p_frame, max_payload_size, mcm_module->user_context);
+        if (max_payload_size != u16_sent_bytes)
+        {
+            TRACE_INFO("Failed to send data through serial port\n");
+            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+            break;
+        }
+        return_status = API_PROCESSOR_SUCCESS;
+    } while (0);
+
+    if (API_PROCESSOR_SUCCESS == return_status)
+    {
+        api_metrics_on_cmd_sent(&mcm_module->h_metrics, cmd_code, MIN_TX_PAYLOAD_LEN + u16_params_len + u16_payload_len,
+                                api_processor_get_tick_ms(mcm_module));
+    }
+
+    return return_status;
+}
+
+/**
+ * @brief This function sends the command with its default command type from the descriptor
+ *
+ * @param[in] mcm_module Pointer to the MCM module structure.
+ * @param[in] cmd_code Command code to be sent
+ * @param[in] p_params Pointer to the command parameters, can be NULL if u16_params_len is 0
+ * @param[in] u16_params_len Length of the command parameters
+ *
+ * @return API_PROCESSOR_SUCCESS if the frame is sent, API_PROCESSOR_INVALID_PARAMETERS if the
+ *         command code has no descriptor, otherwise appropriate error code.
+ */
+static api_processor_status_t api_processor_send_command(mcm_module_hdl_t *mcm_module, mrover_cc_codes_t cmd_code, const uint8_t *p_params, uint16_t u16_params_len)
+{
+    const api_processor_cmd_descriptor_t *p_descriptor = api_processor_get_cmd_descriptor(cmd_code);
+
+    if (NULL == p_descriptor)
+    {
+        TRACE_ERROR("Command 0x%04x is not supported\n", cmd_code);
+        return API_PROCESSOR_INVALID_PARAMETERS;
+    }
+    return api_processor_send_frame(mcm_module, p_descriptor->cmd_type, cmd_code, p_params, u16_params_len, NULL, 0);
+}
+
+/**
+ * @brief This function decodes the payload of a response frame and fills up the
  *        api_processor_response_t structure.
  *
+ * The header is already decoded by fp_decode_frame_header(). The payload length is
+ * checked against the command descriptor, then the payload and the crc byte are added
+ * to the crc of the header a word at a time. The parser only runs on a frame with a
+ * valid crc, so a bad frame never reaches the typed fields or the module state.
+ *
  * @param[in] mcm_module Pointer to the MCM module structure.
  * @param[in] data Pointer to the data buffer containing the response frame.
- * @param[in] len Length of the data buffer containing the response frame.
+ * @param[in] p_header Header of the frame, with the crc of its bytes.
+ * @param[in] b_is_validated true if the crc of the frame is already checked by the
+ *            module reassembler, so the payload is not read for the crc
  * @param[out] p_response Pointer to the api_processor_response_t structure
  *                       that needs to be filled up.
  *
- * @return API_PROCESSOR_SUCCESS if the response is parsed successfully,
+ * @return API_PROCESSOR_SUCCESS if the response is decoded successfully,
  *         otherwise appropriate error code.
  */
-static api_processor_status_t api_processor_parse_response_frame(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len,api_processor_response_t *p_response)
+static api_processor_status_t api_processor_decode_response(mcm_module_hdl_t *mcm_module, uint8_t *data, const fp_frame_header_t *p_header, bool b_is_validated, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    p_response->return_code = data[0];
-    p_response->cmd_type = data[1];
-
-    // parse the command and its data according to the command type
-    p_response->cmd_code = data[2] << 8 | data[3];
-    uint16_t payload_len = data[4] << 8 | data[5];
-    // check that the response is ok or not
-    //, if not let the application layer handle this.
-    if (MROVER_RC_OK != p_response->return_code)
+    const api_processor_cmd_descriptor_t *p_descriptor = NULL;
+    api_processor_reader_t h_reader = {&data[FP_RESPONSE_HEADER_LEN], p_header->u16_payload_len, 0};
+
+    p_response->return_code = p_header->u8_return_code;
+    p_response->cmd_type = p_header->u8_cmd_type;
+    p_response->cmd_code = p_header->u16_cmd_code;
+
+    do
     {
-        return_status = API_PROCESSOR_SUCCESS;
-        return  return_status;
-    }
+        // an error response is left to the application layer, its payload is not parsed
+        if (MROVER_RC_OK == p_response->return_code)
+        {
+            p_descriptor = api_processor_get_cmd_descriptor(p_response->cmd_code);
+            if (NULL == p_descriptor)
+            {
+                TRACE_INFO("Wrong type of the command code received\n");
+                break;
+            }
 
-    switch(p_response->cmd_code)
-    {   
-        case MROVER_CC_GET_EVENT:
-        return_status = api_processor_parse_get_event(mcm_module,&data[6],payload_len,p_response);
-        break;
-        case MROVER_CC_GET_VERSION:
-        return_status = api_processor_parse_get_version(mcm_module,&data[6],payload_len,p_response);
-        break;
-        case MROVER_CC_RESET:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"reset");
-        break;
-        case MROVER_CC_FACTORY_RESET:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Factory reset");
-        break;
-        case MROVER_CC_SWITCH_NETWORK:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Switch network");
-        break;
-        case MROVER_CC_INIT_LORAWAN:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Init Lorawan");
-        break;
-        case MROVER_CC_SET_JOIN_EUI:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set Join Eui");
-        break;
-        case MROVER_CC_SET_DEV_EUI:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set Dev Eui");
-        break;
-        case MROVER_CC_SET_NW_KEY:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set Network key");
-        break;
-        case MROVER_CC_GET_DEV_EUI:
-        return_status = api_processor_parse_eui_cmd(mcm_module,&data[6],payload_len,p_response,"Dev eui");
-        break;
-        case MROVER_CC_GET_JOIN_EUI:
-        return_status = api_processor_parse_eui_cmd(mcm_module,&data[6],payload_len,p_response,"Join eui");
-        break;
-        case MROVER_CC_JOIN_LORAWAN:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Join Lorawan");
-        break;
-        case MROVER_CC_REQUEST_UPLINK:
-        return_status = api_processor_handle_request_uplink(mcm_module, &data[6], payload_len, p_response);
-        break;
-        case MROVER_CC_LEAVE_LORAWAN_NETWORK:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Leave Lorawan Network");
-        break;
-        case MROVER_CC_STOP_SID_LORAWAN_NETWORK:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Stop Sidewalk Network");
-        break;
-        case MROVER_CC_BLE_LINK_REQUEST:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"BLE Link Request");
-        break;
-        case MROVER_CC_BLE_CONNECTION_REQUEST:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"BLE Connection Request");
-        break;
-        case MROVER_CC_FSK_LINK_REQUEST:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"BLE FSK Link Request");
-        break;
-        case MROVER_CC_CSS_LINK_REQUEST:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"CSS Link Request");
-        break;
-        case MROVER_CC_SET_CSS_PWR_PROFILE:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set CSS Power Profile");
-        break;
-        case MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set downlink filtering command");
-        break;
-        case MROVER_CC_SET_LORAWAN_CLASS:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Set New class");
-        break;
-        case MROVER_CC_GET_LORAWAN_CLASS:
-        return_status = api_processor_parse_get_class_cmd(mcm_module,&data[6],payload_len,p_response,"Get Class status");
-        break;
-        case MROVER_CC_START_FILE_TRANSFER:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module,&data[6],payload_len,p_response,"Start File Transfer");
-        break;
-        case MROVER_CC_TRIGGER_FW_UPDATE:
-        return_status = api_processor_parse_cmd_with_len_zero(mcm_module, &data[6], payload_len, p_response, "Trigger FW Update");
-        break;
-        case MROVER_CC_FILE_STATUS:
-        return_status = api_processor_parse_get_file_status(mcm_module, &data[6], payload_len, p_response);
-        break;
+            if (((MROVER_RSP_LEN_EXACT == p_descriptor->rsp_len_policy) && (p_descriptor->u16_rsp_len != h_reader.u16_len)) ||
+                ((MROVER_RSP_LEN_MIN == p_descriptor->rsp_len_policy) && (p_descriptor->u16_rsp_len > h_reader.u16_len)))
+            {
+                TRACE_INFO("Wrong payload length %d for %s command\n", h_reader.u16_len, p_descriptor->p_name);
+                break;
+            }
+        }
 
-        default:
-            TRACE_INFO("Wrong type of the command code received\n");
-            return_status = API_PROCESSOR_ERROR;
-        break;
+        // XOR of a frame including its crc byte is 0
+        if ((false == b_is_validated) &&
+            (0 != fp_crc_update(p_header->u8_crc, h_reader.p_data, h_reader.u16_len + 1)))
+        {
+            TRACE_INFO("Invalid CRC\n");
+            break;
+        }
 
-    }
+        // nothing to parse for an error response or a command without response data
+        return_status = API_PROCESSOR_SUCCESS;
+        if ((NULL != p_descriptor) && (NULL != p_descriptor->rsp_parser))
+        {
+            return_status = p_descriptor->rsp_parser(mcm_module, &h_reader, p_response);
+        }
+
+        // the count is the state of the mcm, it is taken even if the event data is malformed,
+        // the descriptor guarantees the GET_EVENT header was read
+        if ((MROVER_CC_GET_EVENT == p_response->cmd_code) && (MROVER_RC_OK == p_response->return_code))
+        {
+            mcm_module->_no_of_curr_pen_evt = p_response->cmd_response_data.get_event_data.pending_events;
+        }
+    } while (0);
 
     return return_status;
 }
@@ -241,31 +520,25 @@ static api_processor_status_t api_processor_parse_response_frame(mcm_module_hdl_
  * @brief This function parses the data for the event GET_EVENT_TX_STATUS.
  *
  * @param[in] mcm_module Pointer to the MCM module structure.
- * @param[in] data Pointer to the data buffer containing the event data.
- * @param[in] len Length of the data buffer containing the event data.
+ * @param[in,out] p_reader Reader of the event data.
  * @param[out] p_response Pointer to the api_processor_response_t structure
  *                       that needs to be filled up.
  *
  * @return API_PROCESSOR_SUCCESS if the response is parsed successfully,
  *         otherwise appropriate error code.
  */
-static api_processor_status_t api_processor_parse_get_event_reset(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_get_event_reset(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == data)
-        {
-            TRACE_INFO("In get event reset data is null\n");
-            break;
-        }
-        if(2 != len)
+        if(2 != api_processor_reader_left(p_reader))
         {
             TRACE_INFO("In get event reset data length is not 2\n");
             break;
         }
-        p_response->cmd_response_data.get_event_data.get_event_data_value.reset_data.reset_count = (data[0] << 8 | data[1]);
+        p_response->cmd_response_data.get_event_data.get_event_data_value.reset_data.reset_count = api_processor_read_u16_be(p_reader);
         return_status = API_PROCESSOR_SUCCESS;
     }while(0);
 
@@ -276,114 +549,118 @@ static api_processor_status_t api_processor_parse_get_event_reset(mcm_module_hdl
  * @brief This function parses the response frame of the event GET_EVENT command
  * 
  * @param[in] mcm_module pointer to the MCM module object
- * @param[in] data pointer to the buffer which contains the response frame
- * @param[in] len length of the response frame
+ * @param[in,out] p_reader Reader of the response payload
  * @param[out] p_response pointer to the structure of the api_processor_response_t
  * 
  * @retval API_PROCESSOR_SUCCESS if the response frame is parsed successfully
  * @retval API_PROCESSOR_ERROR if there is any error in parsing
  * 
  */
-static api_processor_status_t api_processor_parse_get_event(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len,api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_get_event(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_SUCCESS;
-    p_response->cmd_response_data.get_event_data.get_event_code = data[0];
-    mcm_module->_no_of_curr_pen_evt = data[1];
-    len = len - 2;
+    if (GET_EVENT_HEADER_LEN > api_processor_reader_left(p_reader))
+    {
+        TRACE_INFO("Invalid data payload for get event\n");
+        return API_PROCESSOR_INVALID_SERIAL_DATA;
+    }
+    // pending count reaches the module once the crc is checked, see api_processor_decode_response()
+    p_response->cmd_response_data.get_event_data.get_event_code = api_processor_read_u8(p_reader);
+    p_response->cmd_response_data.get_event_data.pending_events = api_processor_read_u8(p_reader);
 
     switch (p_response->cmd_response_data.get_event_data.get_event_code)
     {
         case MODEM_EVENT_RESET:
-            TRACE_INFO("MODEM_EVENT_RESET\n");
-            return_status = api_processor_parse_get_event_reset(mcm_module,&data[2],len, p_response);
+            TRACE_DEBUG("MODEM_EVENT_RESET\n");
+            return_status = api_processor_parse_get_event_reset(mcm_module, p_reader, p_response);
             break;
 
         case MODEM_EVENT_ALARM:
-            TRACE_INFO("MODEM_EVENT_ALARM\n");
+            TRACE_DEBUG("MODEM_EVENT_ALARM\n");
             break;
 
         case MODEM_EVENT_JOINED:
-            TRACE_INFO("MODEM_EVENT_JOINED\n");
+            TRACE_DEBUG("MODEM_EVENT_JOINED\n");
             break;
 
         case MODEM_EVENT_TXDONE:
-            TRACE_INFO("MODEM_EVENT_TXDONE\n");
-            return_status = api_processor_get_event_tx_status(mcm_module,&data[2],len, p_response);
+            TRACE_DEBUG("MODEM_EVENT_TXDONE\n");
+            return_status = api_processor_get_event_tx_status(mcm_module, p_reader, p_response);
             break;
 
         case MODEM_EVENT_DOWNDATA:
-            TRACE_INFO("MODEM_EVENT_DOWNDATA\n");
-            return_status = api_processor_get_event_down_data(mcm_module,&data[2],len, p_response);
+            TRACE_DEBUG("MODEM_EVENT_DOWNDATA\n");
+            return_status = api_processor_get_event_down_data(mcm_module, p_reader, p_response);
             break;
 
         case MODEM_EVENT_UPLOADDONE:
-            TRACE_INFO("MODEM_EVENT_UPLOADDONE\n");
+            TRACE_DEBUG("MODEM_EVENT_UPLOADDONE\n");
             break;
 
         case MODEM_EVENT_SETCONF:
-            TRACE_INFO("MODEM_EVENT_SETCONF\n");
+            TRACE_DEBUG("MODEM_EVENT_SETCONF\n");
             break;
 
         case MODEM_EVENT_MUTE:
-            TRACE_INFO("MODEM_EVENT_MUTE\n");
+            TRACE_DEBUG("MODEM_EVENT_MUTE\n");
             break;
 
         case MODEM_EVENT_STREAMDONE:
-            TRACE_INFO("MODEM_EVENT_STREAMDONE\n");
+            TRACE_DEBUG("MODEM_EVENT_STREAMDONE\n");
             break;
 
         case MODEM_EVENT_JOINFAIL:
-            TRACE_INFO("MODEM_EVENT_JOINFAIL\n");
+            TRACE_DEBUG("MODEM_EVENT_JOINFAIL\n");
             break;
 
         case MODEM_EVENT_TIME:
-            TRACE_INFO("MODEM_EVENT_TIME\n");
+            TRACE_DEBUG("MODEM_EVENT_TIME\n");
             break;
 
         case MODEM_EVENT_TIMEOUT_ADR_CHANGED:
-            TRACE_INFO("MODEM_EVENT_TIMEOUT_ADR_CHANGED\n");
+            TRACE_DEBUG("MODEM_EVENT_TIMEOUT_ADR_CHANGED\n");
             break;
 
         case MODEM_EVENT_NEW_LINK_ADR:
-            TRACE_INFO("MODEM_EVENT_NEW_LINK_ADR\n");
+            TRACE_DEBUG("MODEM_EVENT_NEW_LINK_ADR\n");
             break;
 
         case MODEM_EVENT_LINK_CHECK:
-            TRACE_INFO("MODEM_EVENT_LINK_CHECK\n");
+            TRACE_DEBUG("MODEM_EVENT_LINK_CHECK\n");
             break;
 
         case MODEM_EVENT_ALMANAC_UPDATE:
-            TRACE_INFO("MODEM_EVENT_ALMANAC_UPDATE\n");
+            TRACE_DEBUG("MODEM_EVENT_ALMANAC_UPDATE\n");
             break;
 
         case MODEM_EVENT_USER_RADIO_ACCESS:
-            TRACE_INFO("MODEM_EVENT_USER_RADIO_ACCESS\n");
+            TRACE_DEBUG("MODEM_EVENT_USER_RADIO_ACCESS\n");
             break;
 
         case MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
-            TRACE_INFO("MODEM_EVENT_CLASS_B_PING_SLOT_INFO\n");
+            TRACE_DEBUG("MODEM_EVENT_CLASS_B_PING_SLOT_INFO\n");
             break;
 
         case MODEM_EVENT_CLASS_B_STATUS:
-            TRACE_INFO("MODEM_EVENT_CLASS_B_STATUS\n");
+            TRACE_DEBUG("MODEM_EVENT_CLASS_B_STATUS\n");
             break;
 
         case MODEM_EVENT_LORAWAN_MAC_TIME:
-            TRACE_INFO("MODEM_EVENT_LORAWAN_MAC_TIME\n");
+            TRACE_DEBUG("MODEM_EVENT_LORAWAN_MAC_TIME\n");
             break;
 
         case MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD:
-            TRACE_INFO("MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD\n");
-            return_status = api_processor_parse_get_event_seg(mcm_module, &data[2], len, p_response);
+            TRACE_DEBUG("MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD\n");
+            return_status = api_processor_parse_get_event_seg(mcm_module, p_reader, p_response);
             break;
 
         case MODEM_EVENT_CLASS_SWITCHED:
-            TRACE_INFO("MODEM_EVENT_CLASS_SWITCHED\n");
-            return_status = api_procesor_parse_lorawan_class_switch(mcm_module,&data[2],len, p_response);
+            TRACE_DEBUG("MODEM_EVENT_CLASS_SWITCHED\n");
+            return_status = api_procesor_parse_lorawan_class_switch(mcm_module, p_reader, p_response);
             break;
 
         case MODEM_EVENT_NONE:
-            TRACE_INFO("MODEM_EVENT_NONE\n");
+            TRACE_DEBUG("MODEM_EVENT_NONE\n");
             return_status = API_PROCESSOR_SUCCESS;
             break;
 
@@ -401,31 +678,31 @@ static api_processor_status_t api_processor_parse_get_event(mcm_module_hdl_t *mc
  * @brief This function parses the data for the event GET_EVENT_TX_STATUS.
  *
  * @param[in] mcm_module Pointer to the MCM module structure.
- * @param[in] data Pointer to the data buffer containing the event data.
- * @param[in] len Length of the data buffer containing the event data.
+ * @param[in,out] p_reader Reader of the event data.
  * @param[out] p_response Pointer to the api_processor_response_t structure
  *                       that needs to be filled up.
  *
  * @return API_PROCESSOR_SUCCESS if the response is parsed successfully,
  *         otherwise appropriate error code.
  */
-static api_processor_status_t api_processor_get_event_tx_status(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_get_event_tx_status(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == data || 1 != len)
+        if (1 != api_processor_reader_left(p_reader))
         {
             TRACE_INFO("Invalid data payload for get event tx status\n");
             break;
         }
-        if(MROVER_TX_DONE_WITH_ACK < data[0])
+        uint8_t tx_status = api_processor_read_u8(p_reader);
+        if(MROVER_TX_DONE_WITH_ACK < tx_status)
         {
-            TRACE_INFO("Got the invalid tx status value 0x%02x\n",data[0]);
+            TRACE_INFO("Got the invalid tx status value 0x%02x\n",tx_status);
             break;
         }
-        p_response->cmd_response_data.get_event_data.get_event_data_value.tx_status_data.tx_status = data[0];
+        p_response->cmd_response_data.get_event_data.get_event_data_value.tx_status_data.tx_status = tx_status;
         return_status = API_PROCESSOR_SUCCESS;
     } while (0);
         
@@ -438,21 +715,20 @@ static api_processor_status_t api_processor_get_event_tx_status(mcm_module_hdl_t
  * @brief This function parses the data for the event GET_EVENT_DOWN_DATA.
  *
  * @param[in] mcm_module Pointer to the MCM module structure.
- * @param[in] data Pointer to the data buffer containing the event data.
- * @param[in] len Length of the data buffer containing the event data.
+ * @param[in,out] p_reader Reader of the event data.
  * @param[out] p_response Pointer to the api_processor_response_t structure
  *                       that needs to be filled up.
  *
  * @return API_PROCESSOR_SUCCESS if the response is parsed successfully,
  *         otherwise appropriate error code.
  */
-static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == data || MIN_DOWNLINK_PAYLOAD_LEN > len)
+        if (MIN_DOWNLINK_PAYLOAD_LEN > api_processor_reader_left(p_reader))
         {
             TRACE_INFO("Invalid data payload for get event downlink\n");
             break;
@@ -462,12 +738,12 @@ static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t
         if(COMMAND_TYPE_LORAWAN == p_response->cmd_type)
         {
             // parse for the lorawan
-            return_status = api_processor_parse_lorawan_down_data(mcm_module, data, len, p_response);
+            return_status = api_processor_parse_lorawan_down_data(mcm_module, p_reader, p_response);
         }
         // no need to validate, as we already validated the command type in the frame before
         else 
         {
-           return_status = api_processor_parse_sid_down_data(mcm_module,data,len,p_response);
+           return_status = api_processor_parse_sid_down_data(mcm_module, p_reader, p_response);
         }
     } while (0);
     
@@ -481,25 +757,25 @@ static api_processor_status_t api_processor_get_event_down_data(mcm_module_hdl_t
  * RSSI and SNR values for the downlink reception
  * 
  * @param[in] mcm_module pointer to the mcm module
- * @param[in] data pointer to the data received
- * @param[in] len length of the data
+ * @param[in,out] p_reader Reader of the downlink data
  * @param[out] p_response structure containing the response of the command
  * 
  * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
  * in parsing, returns API_PROCESSOR_ERROR
  * 
  */
-static api_processor_status_t api_processor_parse_lorawan_down_data(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_lorawan_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    get_evt_down_data_t *p_down_data = &p_response->cmd_response_data.get_event_data.get_event_data_value.down_data;
 
     do
     {   
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.rssi = data[0];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.snr = data[1];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.lrwan_sid_seq_port= data[2];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.payload = data + 3;
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.payload_len = len - 3;
+        p_down_data->rssi = api_processor_read_u8(p_reader);
+        p_down_data->snr = api_processor_read_u8(p_reader);
+        p_down_data->lrwan_sid_seq_port = api_processor_read_u8(p_reader);
+        p_down_data->payload_len = api_processor_reader_left(p_reader);
+        p_down_data->payload = api_processor_read_bytes(p_reader, p_down_data->payload_len);
         
         return_status = API_PROCESSOR_SUCCESS;
 
@@ -509,13 +785,18 @@ static api_processor_status_t api_processor_parse_lorawan_down_data(mcm_module_h
 }
 
 
-static api_processor_status_t api_procesor_parse_lorawan_class_switch(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_procesor_parse_lorawan_class_switch(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do 
     {
-        p_response->cmd_response_data.get_event_data.get_event_data_value.class_switch_data.new_class = data[0];
+        if (1 != api_processor_reader_left(p_reader))
+        {
+            TRACE_INFO("Invalid data payload for class switch event\n");
+            break;
+        }
+        p_response->cmd_response_data.get_event_data.get_event_data_value.class_switch_data.new_class = api_processor_read_u8(p_reader);
         return_status = API_PROCESSOR_SUCCESS;
 
     }while (0);
@@ -523,32 +804,19 @@ static api_processor_status_t api_procesor_parse_lorawan_class_switch(mcm_module
     return return_status;
 }
 
-static api_processor_status_t api_processor_parse_get_event_seg(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_get_event_seg(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (len!=sizeof(get_seg_file_status_t))
+        if (api_processor_reader_left(p_reader) != sizeof(get_seg_file_status_t))
         {
             return_status = API_PROCESSOR_INVALID_SERIAL_DATA;
             break;
         }
-        
 
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.cmd_type.bin_type = data[0] & 0x0F;
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.fw_ver.major = data[1];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.fw_ver.minor = data[2];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.fw_ver.patch = data[3];
-
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.pkg_size[0] = data[4];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.pkg_size[1] = data[5];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.pkg_size[2] = data[6];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.seg_size = data[7] & 0x0F;
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.nxt_seg_id = data[7] >> 4;
-        p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data.seg_status = data[9] << 8 | data[8];
-       
-        
+        api_processor_read_seg_status(p_reader, &p_response->cmd_response_data.get_event_data.get_event_data_value.download_segment_data);
 
         return_status = API_PROCESSOR_SUCCESS;
 
@@ -561,26 +829,30 @@ static api_processor_status_t api_processor_parse_get_event_seg(mcm_module_hdl_t
  * @brief This function parses the downlink data for sidewalk.
  * 
  * @param[in] mcm_module pointer to the mcm module
- * @param[in] data pointer to the data received
- * @param[in] len length of the data
+ * @param[in,out] p_reader Reader of the downlink data
  * @param[out] p_response structure containing the response of the command
  * 
  * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
  * in parsing, returns API_PROCESSOR_ERROR
  * 
  */
-static api_processor_status_t api_processor_parse_sid_down_data(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_sid_down_data(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    get_evt_down_data_t *p_down_data = &p_response->cmd_response_data.get_event_data.get_event_data_value.down_data;
 
     do
     {   
-        
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.lrwan_sid_seq_port = (data[0] << 8) | data[1];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.rssi = data[2];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.snr = data[3];
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.payload = data + 4;
-        p_response->cmd_response_data.get_event_data.get_event_data_value.down_data.payload_len = len - 4;
+        if (MIN_SID_DOWNLINK_PAYLOAD_LEN > api_processor_reader_left(p_reader))
+        {
+            TRACE_INFO("Invalid data payload for sidewalk downlink\n");
+            break;
+        }
+        p_down_data->lrwan_sid_seq_port = api_processor_read_u16_be(p_reader);
+        p_down_data->rssi = api_processor_read_u8(p_reader);
+        p_down_data->snr = api_processor_read_u8(p_reader);
+        p_down_data->payload_len = api_processor_reader_left(p_reader);
+        p_down_data->payload = api_processor_read_bytes(p_reader, p_down_data->payload_len);
 
         return_status = API_PROCESSOR_SUCCESS;
     } while (0);
@@ -595,153 +867,77 @@ static api_processor_status_t api_processor_parse_sid_down_data(mcm_module_hdl_t
  * version number of the device
  * 
  * @param[in] mcm_module pointer to the mcm module
- * @param[in] data pointer to the data received
- * @param[in] len length of the data
+ * @param[in,out] p_reader Reader of the response payload
  * @param[out] p_response structure containing the response of the command
  * 
  * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
  * in parsing, returns API_PROCESSOR_ERROR
  * 
  */
-static api_processor_status_t api_processor_parse_get_version(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_get_version(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    get_ver_data_t *p_ver_info = &p_response->cmd_response_data.ver_info;
 
-    do
-    {
-        if((NULL == data) || (GET_VERSION_RESPONSE_PAYLOAD_LEN != len) )
-        {
-            TRACE_INFO("Invalid data payload for get version\n");
-            break;
-        }        
-        p_response->cmd_response_data.ver_info.bootloader.major = data[0];
-        p_response->cmd_response_data.ver_info.bootloader.minor = data[1];
-        p_response->cmd_response_data.ver_info.bootloader.patch = (data[2] << 8) | data[3];
-
-        p_response->cmd_response_data.ver_info.modem_fw.major = data[4];
-        p_response->cmd_response_data.ver_info.modem_fw.minor = data[5];
-        p_response->cmd_response_data.ver_info.modem_fw.patch = (data[6] << 8) | data[7];
-        
-        p_response->cmd_response_data.ver_info.modem_hw.major = data[8];
-        p_response->cmd_response_data.ver_info.modem_hw.minor = data[9];
-        p_response->cmd_response_data.ver_info.modem_hw.patch = data[10];
-        
-        p_response->cmd_response_data.ver_info.sidewalk.major = data[11];
-        p_response->cmd_response_data.ver_info.sidewalk.minor = data[12];
-        p_response->cmd_response_data.ver_info.sidewalk.patch = data[13];
-        
-        p_response->cmd_response_data.ver_info.lorawan.major = data[14];
-        p_response->cmd_response_data.ver_info.lorawan.minor = data[15];
-        p_response->cmd_response_data.ver_info.lorawan.patch = data[16];
+    // length is validated by the command descriptor
+    p_ver_info->bootloader.major = api_processor_read_u8(p_reader);
+    p_ver_info->bootloader.minor = api_processor_read_u8(p_reader);
+    p_ver_info->bootloader.patch = api_processor_read_u16_be(p_reader);
 
-        return_status = API_PROCESSOR_SUCCESS;
+    p_ver_info->modem_fw.major = api_processor_read_u8(p_reader);
+    p_ver_info->modem_fw.minor = api_processor_read_u8(p_reader);
+    p_ver_info->modem_fw.patch = api_processor_read_u16_be(p_reader);
 
-    } while (0);
-    
+    p_ver_info->modem_hw.major = api_processor_read_u8(p_reader);
+    p_ver_info->modem_hw.minor = api_processor_read_u8(p_reader);
+    p_ver_info->modem_hw.patch = api_processor_read_u8(p_reader);
 
-    return return_status;
+    p_ver_info->sidewalk.major = api_processor_read_u8(p_reader);
+    p_ver_info->sidewalk.minor = api_processor_read_u8(p_reader);
+    p_ver_info->sidewalk.patch = api_processor_read_u8(p_reader);
+
+    p_ver_info->lorawan.major = api_processor_read_u8(p_reader);
+    p_ver_info->lorawan.minor = api_processor_read_u8(p_reader);
+    p_ver_info->lorawan.patch = api_processor_read_u8(p_reader);
 
+    return API_PROCESSOR_SUCCESS;
 }
 
-static api_processor_status_t api_processor_parse_get_file_status(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response)
+static api_processor_status_t api_processor_parse_get_file_status(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-
-    do
-    {
-        if((NULL == data) || (sizeof(get_seg_file_status_t) != len) )
-        {
-            TRACE_INFO("Invalid data payload for get file status\n");
-            break;
-        }
-        p_response->cmd_response_data.seg_file_status.cmd_type.bin_type = data[0] & 0x0F;
-        p_response->cmd_response_data.seg_file_status.fw_ver.major = data[1];
-        p_response->cmd_response_data.seg_file_status.fw_ver.minor = data[2];
-        p_response->cmd_response_data.seg_file_status.fw_ver.patch = data[3];
-        p_response->cmd_response_data.seg_file_status.pkg_size[0] = data[4];
-        p_response->cmd_response_data.seg_file_status.pkg_size[1] = data[5];
-        p_response->cmd_response_data.seg_file_status.pkg_size[2] = data[6];
-        p_response->cmd_response_data.seg_file_status.seg_size = data[7] & 0x0F;
-        p_response->cmd_response_data.seg_file_status.nxt_seg_id = data[7] >> 4;
-        p_response->cmd_response_data.seg_file_status.seg_status = data[9] << 8 | data[8];
-
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-
-
-    return return_status;
+    // length is validated by the command descriptor
+    api_processor_read_seg_status(p_reader, &p_response->cmd_response_data.seg_file_status);
 
+    return API_PROCESSOR_SUCCESS;
 }
 
 
 /**
- * 
- * 
- * @brief This function is used to parse the data of command which have zero length of payload.
- *        This function fills up the response structure with the command type,
- *        command and command response status.
- *
- * @param mcm_module Pointer to the MCM module structure.
- * @param data Pointer to the data buffer containing the data.
- * @param len Length of the data buffer containing the data.
- * @param p_response Pointer to the api_processor_response_t structure
- *                   that needs to be filled up.
- * @param module Name of the module.
- *
- * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
- *         in parsing, returns API_PROCESSOR_ERROR
- */
-static api_processor_status_t api_processor_parse_cmd_with_len_zero(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-     do
-    {
-        if(0 != len)
-        {
-            TRACE_INFO("Wrong payload length for %s command\n",module);
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-    
-    return return_status;
-
-}
-/**
- * @brief This function is used to parse the data of command which have
- *        length of payload zero. It fills up the response structure with
- *        the command type, command and command response status.
+ * @brief This function is used to parse the data of get dev eui and get join eui
+ *        command. Length of the payload is validated by the command descriptor.
  *
  * @param mcm_module Pointer to the MCM module structure.
- * @param data Pointer to the data buffer containing the data.
- * @param len Length of the data buffer containing the data.
+ * @param p_reader Reader of the response payload.
  * @param p_response Pointer to the api_processor_response_t structure
  *                   that needs to be filled up.
- * @param module Name of the module.
  *
  * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
  *         in parsing, returns API_PROCESSOR_ERROR
  */
-static api_processor_status_t api_processor_parse_eui_cmd(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* eui_type)
+static api_processor_status_t api_processor_parse_eui_cmd(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if(LORAWAN_DEV_EUI_JOIN_EUI_LEN != len)
-        {
-            TRACE_INFO("Wrong payload length for %s command\n",eui_type);
-            break;
-        }
+        const uint8_t *p_eui = api_processor_read_bytes(p_reader, LORAWAN_DEV_EUI_JOIN_EUI_LEN);
         if(MROVER_CC_GET_DEV_EUI == p_response->cmd_code)
         {
-            p_response->cmd_response_data.dev_eui = data;
+            p_response->cmd_response_data.dev_eui = p_eui;
            
         }
         else
         {
-            p_response->cmd_response_data.join_eui = data;
+            p_response->cmd_response_data.join_eui = p_eui;
             
         }
 
@@ -753,49 +949,13 @@ static api_processor_status_t api_processor_parse_eui_cmd(mcm_module_hdl_t *mcm_
     return  return_status;
 }
 
-static api_processor_status_t api_processor_parse_get_class_cmd(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* eui_type)
+static api_processor_status_t api_processor_parse_get_class_cmd(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if(1 != len)
-        {
-            TRACE_INFO("Wrong payload length for %s command\n",eui_type);
-            break;
-        }
-
-        p_response->cmd_response_data.get_event_data.get_event_data_value.class_switch_data.new_class = data[0];
-
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-    
-
-    return  return_status;
-}
-
-static api_processor_status_t api_processor_parse_cmd(mcm_module_hdl_t *mcm_module,uint8_t *data, uint16_t len, api_processor_response_t *p_response,const char* eui_type)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-
-    do
-    {
-        if(LORAWAN_DEV_EUI_JOIN_EUI_LEN != len)
-        {
-            TRACE_INFO("Wrong payload length for %s command\n",eui_type);
-            break;
-        }
-        if(MROVER_CC_GET_DEV_EUI == p_response->cmd_code)
-        {
-            p_response->cmd_response_data.dev_eui = data;
-           
-        }
-        else
-        {
-            p_response->cmd_response_data.join_eui = data;
-            
-        }
+        p_response->cmd_response_data.get_event_data.get_event_data_value.class_switch_data.new_class = api_processor_read_u8(p_reader);
 
         return_status = API_PROCESSOR_SUCCESS;
 
@@ -813,11 +973,13 @@ static api_processor_status_t api_processor_parse_cmd(mcm_module_hdl_t *mcm_modu
  * @param mcm_module Pointer to the MCM module structure.
  * @param data Pointer to the data buffer containing the data.
  * @param len Length of the data buffer containing the data.
+ * @param b_is_validated true if the CRC of the frame is already checked by the module
+ *        reassembler, so the payload is not read again for it
  *
  * @return API_PROCESSOR_SUCCESS if the parsing is successful. If any error
  *         in parsing, returns API_PROCESSOR_ERROR
  */
-static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t *mcm_module, uint8_t* data,uint16_t len)
+static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t *mcm_module, uint8_t* data,uint16_t len, bool b_is_validated)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
@@ -836,38 +998,29 @@ static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t
             break;
         }
         
-        bool is_frame_notification = fp_is_frame_notification(data, len);
-        TRACE_INFO("Frame notification check: %s\n", is_frame_notification ? "True" : "False");
+        api_metrics_on_frame_in(&mcm_module->h_metrics);
 
-        if (is_frame_notification)
+        // header is checked while it is decoded, a notify frame is decoded whole
+        fp_frame_header_t h_header;
+        fp_api_status_t status = fp_decode_frame_header(data, len, &h_header);
+        if (status != FP_SUCCESS)
         {
-            // Validate and parse for notification
-            fp_api_status_t status = fp_is_valid_notify_frame(data, len);
-            if (status != FP_SUCCESS)
-            {
-                TRACE_INFO("Failed to parse Notification\n");
-                break;
-            }
-            // Get the value of the pending event
-            mcm_module->_no_of_curr_pen_evt = fp_get_pending_event_count(data, len);
-            TRACE_INFO("Pending event count: %d\n", mcm_module->_no_of_curr_pen_evt);
+            TRACE_INFO("Failed to decode the frame header, status %d\n", status);
+            break;
+        }
+
+        if (MROVER_RC_NOTIFY_EVENTS == h_header.u8_return_code)
+        {
+            mcm_module->_no_of_curr_pen_evt = h_header.u8_pending_events;
+            TRACE_DEBUG("Pending event count: %d\n", mcm_module->_no_of_curr_pen_evt);
             mcm_module->handle_notification_cb(mcm_module->user_context);
             return_status = API_PROCESSOR_SUCCESS;
             break;
         }
         else
         {
-            // Parse the data
-            fp_api_status_t status = fp_is_valid_response_frame(data, len);
-            if (status != FP_SUCCESS)
-            {
-                TRACE_INFO("Failed to parse data\n");
-                break;
-            }
-
             api_processor_response_t response;
-            // Now parse the response frame
-            return_status = api_processor_parse_response_frame(mcm_module, data, len, &response);
+            return_status = api_processor_decode_response(mcm_module, data, &h_header, b_is_validated, &response);
 
             // In case of parsing error, just return error
             if (return_status != API_PROCESSOR_SUCCESS)
@@ -876,8 +1029,14 @@ static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t
                 break;
             }
 
+            api_metrics_on_response(&mcm_module->h_metrics, response.cmd_code, response.return_code, api_processor_get_tick_ms(mcm_module));
+            if ((MROVER_CC_GET_EVENT == response.cmd_code) && (MROVER_RC_OK == response.return_code))
+            {
+                api_metrics_on_event(&mcm_module->h_metrics, response.cmd_response_data.get_event_data.get_event_code);
+            }
+
             // Now call the callback function for response
-            TRACE_INFO("Calling response callback\n");
+            TRACE_DEBUG("Calling response callback\n");
             mcm_module->handle_response_cb(&response, mcm_module->user_context);
         }
 
@@ -887,6 +1046,28 @@ static api_processor_status_t api_processor_parse_single_frame(mcm_module_hdl_t
 }
 
 
+/**
+ * @brief This function is called by the frame reassembler for every complete
+ *        frame received from the MCM module
+ *
+ * @param[in] p_frame Pointer to the complete frame
+ * @param[in] u16_len Length of the frame
+ * @param[in,out] user_context Pointer to the api_processor_rx_context_t
+ */
+static void api_processor_on_rx_frame(uint8_t *p_frame, uint16_t u16_len, void *user_context)
+{
+    api_processor_rx_context_t *p_rx_context = (api_processor_rx_context_t *)user_context;
+    // reassembler emits only the frames with valid format, length and crc
+    api_processor_status_t status = api_processor_parse_single_frame(p_rx_context->mcm_module, p_frame, u16_len, true);
+
+    // keep the first failure, rest of the frames are still parsed
+    if (API_PROCESSOR_SUCCESS == p_rx_context->status)
+    {
+        p_rx_context->status = status;
+    }
+}
+
+
 /******************************************************************************
  * GLOBAL FUNCTIONS
  ******************************************************************************/
@@ -1010,6 +1191,11 @@ api_processor_status_t api_processor_init(mcm_module_hdl_t *mcm_module,serial_se
             break;
         }
         mcm_module->h_serial_device.send_data_cb = send_data_cb;
+        mcm_module->h_serial_device.send_vec_cb = NULL;
+        mcm_module->_no_of_curr_pen_evt = 0;
+        fp_reassembler_init(&mcm_module->h_rx_reassembler);
+        mcm_module->get_tick_ms_cb = NULL;
+        memset(&mcm_module->h_metrics, 0, sizeof(mcm_module->h_metrics));
 
         if(NULL == h_mrover_notification_cb)
         {
@@ -1033,52 +1219,20 @@ api_processor_status_t api_processor_init(mcm_module_hdl_t *mcm_module,serial_se
 
 
 
-void api_processor_get_lib_ver(ver_type_1_t *ver) {
-    if (ver != NULL) 
-    {
-        ver->major = API_PROCESSOR_LIB_MAJOR_VERSION; // Set major version
-        ver->minor = API_PROCESSOR_LIB_MINOR_VERSION; // Set minor version
-        ver->patch = API_PROCESSOR_LIB_PATCH_VERSION; // Set patch version
-    }
-}
-
-
-api_processor_status_t api_processor_cmd_get_event(mcm_module_hdl_t *mcm_module)
+api_processor_status_t api_processor_set_send_vec_cb(mcm_module_hdl_t *mcm_module, serial_send_vec_cb send_vec_cb)
 {
-    const uint16_t max_payload_size = 6;
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;
-        mcm_module->u8_send_payload[1] = MROVER_CC_GET_EVENT >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_GET_EVENT & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
+        if (NULL == mcm_module)
         {
-            TRACE_INFO("Failed to append crc\n");
+            TRACE_INFO("mcm_module is NULL\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
+        mcm_module->h_serial_device.send_vec_cb = send_vec_cb;
         return_status = API_PROCESSOR_SUCCESS;
     } while (0);
 
@@ -1086,42 +1240,20 @@ api_processor_status_t api_processor_cmd_get_event(mcm_module_hdl_t *mcm_module)
 }
 
 
-api_processor_status_t api_processor_cmd_get_version(mcm_module_hdl_t *mcm_module)
+api_processor_status_t api_processor_set_tick_cb(mcm_module_hdl_t *mcm_module, api_processor_tick_cb tick_cb)
 {
-    const uint16_t max_payload_size = 6;
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;
-        mcm_module->u8_send_payload[1] = MROVER_CC_GET_VERSION >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_GET_VERSION & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
+        if (NULL == mcm_module)
         {
-            TRACE_INFO("Failed to append crc\n");
+            TRACE_INFO("mcm_module is NULL\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
+        mcm_module->get_tick_ms_cb = tick_cb;
         return_status = API_PROCESSOR_SUCCESS;
     } while (0);
 
@@ -1129,42 +1261,26 @@ api_processor_status_t api_processor_cmd_get_version(mcm_module_hdl_t *mcm_modul
 }
 
 
-api_processor_status_t api_processor_cmd_reset(mcm_module_hdl_t *mcm_module)
+api_processor_status_t api_processor_get_metrics(mcm_module_hdl_t *mcm_module, api_metrics_t *p_metrics, bool b_reset)
 {
-
-    const uint16_t max_payload_size = 6;
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        if ((NULL == mcm_module) || (NULL == p_metrics))
         {
-            TRACE_INFO("MCM module is not initialized\n");
+            TRACE_INFO("Invalid parameters for the metrics\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;
-        mcm_module->u8_send_payload[1] = MROVER_CC_RESET >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_RESET & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
 
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
+        *p_metrics = mcm_module->h_metrics;
+        api_metrics_add_reassembler(p_metrics, &mcm_module->h_rx_reassembler);
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        if (b_reset)
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
+            api_metrics_reset(&mcm_module->h_metrics);
+            fp_reassembler_clear_counters(&mcm_module->h_rx_reassembler);
         }
         return_status = API_PROCESSOR_SUCCESS;
     } while (0);
@@ -1173,289 +1289,131 @@ api_processor_status_t api_processor_cmd_reset(mcm_module_hdl_t *mcm_module)
 }
 
 
-api_processor_status_t api_processor_cmd_factory_reset(mcm_module_hdl_t *mcm_module)
+void api_processor_report_timeout(mcm_module_hdl_t *mcm_module, mrover_cc_codes_t cmd_code)
 {
-    const uint16_t max_payload_size = 6;
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    if (NULL != mcm_module)
+    {
+        api_metrics_on_timeout(&mcm_module->h_metrics, cmd_code);
+    }
+}
 
-    do
+
+const char *api_processor_get_cmd_name(uint16_t u16_cmd_code)
+{
+    const api_processor_cmd_descriptor_t *p_descriptor = api_processor_get_cmd_descriptor(u16_cmd_code);
+
+    return (NULL != p_descriptor) ? p_descriptor->p_name : "Unknown";
+}
+
+
+void api_processor_get_lib_ver(ver_type_1_t *ver) {
+    if (ver != NULL) 
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
+        ver->major = API_PROCESSOR_LIB_MAJOR_VERSION; // Set major version
+        ver->minor = API_PROCESSOR_LIB_MINOR_VERSION; // Set minor version
+        ver->patch = API_PROCESSOR_LIB_PATCH_VERSION; // Set patch version
+    }
+}
 
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;
-        mcm_module->u8_send_payload[1] = MROVER_CC_FACTORY_RESET >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_FACTORY_RESET & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
 
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
+api_processor_status_t api_processor_cmd_get_event(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_GET_EVENT, NULL, 0);
+}
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
 
-    return return_status;
+api_processor_status_t api_processor_cmd_get_version(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_GET_VERSION, NULL, 0);
 }
 
 
-api_processor_status_t api_processor_cmd_switch_network(mcm_module_hdl_t *mcm_module)
+api_processor_status_t api_processor_cmd_reset(mcm_module_hdl_t *mcm_module)
 {
-    const uint16_t max_payload_size = 6;
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    return api_processor_send_command(mcm_module, MROVER_CC_RESET, NULL, 0);
+}
 
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SWITCH_NETWORK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SWITCH_NETWORK & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
+api_processor_status_t api_processor_cmd_factory_reset(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_FACTORY_RESET, NULL, 0);
+}
 
-    return return_status;
+
+api_processor_status_t api_processor_cmd_switch_network(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_SWITCH_NETWORK, NULL, 0);
 }
 
 
 api_processor_status_t api_processor_cmd_init_lorawan(mcm_module_hdl_t *mcm_module)
 {
-    const uint16_t max_payload_size = 6;
+    return api_processor_send_command(mcm_module, MROVER_CC_INIT_LORAWAN, NULL, 0);
+}
+
+
+api_processor_status_t api_processor_cmd_set_join_eui(mcm_module_hdl_t *mcm_module, uint8_t *p_join_eui, uint8_t u8_join_eui_len)
+{
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        if (u8_join_eui_len != LORAWAN_DEV_EUI_JOIN_EUI_LEN || p_join_eui == NULL)
         {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_INIT_LORAWAN >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_INIT_LORAWAN & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
+            TRACE_INFO("Join eui is not correct. Please provide a valid join eui\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
+        return_status = api_processor_send_command(mcm_module, MROVER_CC_SET_JOIN_EUI, p_join_eui, u8_join_eui_len);
     } while (0);
 
     return return_status;
 }
 
 
-api_processor_status_t api_processor_cmd_set_join_eui(mcm_module_hdl_t *mcm_module, uint8_t *p_join_eui, uint8_t u8_join_eui_len)
+api_processor_status_t api_processor_cmd_set_dev_eui(mcm_module_hdl_t *mcm_module, uint8_t *p_dev_eui, uint8_t u8_dev_eui_len)
 {
-    const uint16_t max_payload_size = 14;
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        if (u8_join_eui_len != 8 || p_join_eui == NULL)
+        if (u8_dev_eui_len != LORAWAN_DEV_EUI_JOIN_EUI_LEN || p_dev_eui == NULL)
         {
-            TRACE_INFO("Join eui is not correct. Please provide a valid join eui\n");
+            TRACE_INFO("Dev eui is not correct. Please provide a valid dev eui\n");
             return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_JOIN_EUI >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_JOIN_EUI & 0xFF;
-        mcm_module->u8_send_payload[3] = 0x00;
-        mcm_module->u8_send_payload[4] = u8_join_eui_len;
-        memcpy(&mcm_module->u8_send_payload[5], p_join_eui, u8_join_eui_len);
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
 
+        return_status = api_processor_send_command(mcm_module, MROVER_CC_SET_DEV_EUI, p_dev_eui, u8_dev_eui_len);
     } while (0);
 
     return return_status;
 }
 
 
-api_processor_status_t api_processor_cmd_set_dev_eui(mcm_module_hdl_t *mcm_module, uint8_t *p_dev_eui, uint8_t u8_dev_eui_len)
+api_processor_status_t api_processor_cmd_set_nwk_key(mcm_module_hdl_t *mcm_module, uint8_t *p_nwk_key, uint16_t u16_nwk_key_len)
 {
-    const uint16_t max_payload_size = 14;
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        if (p_nwk_key == NULL)
         {
-            TRACE_INFO("MCM module is not initialized\n");
+            TRACE_INFO("Please provide a valid network key\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        if (u8_dev_eui_len != 8 || p_dev_eui == NULL)
+        if (LORAWAN_NETWORK_KEY_LEN != u16_nwk_key_len)
         {
-            TRACE_INFO("Dev eui is not correct. Please provide a valid dev eui\n");
+            TRACE_INFO("Network key length must be 16 bytes\n");
             return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
 
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_DEV_EUI >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_DEV_EUI & 0xFF;
-        mcm_module->u8_send_payload[3] = 0x00;
-        mcm_module->u8_send_payload[4] = u8_dev_eui_len;
-        memcpy(&mcm_module->u8_send_payload[5], p_dev_eui, u8_dev_eui_len);
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_set_nwk_key(mcm_module_hdl_t *mcm_module, uint8_t *p_nwk_key, uint16_t u16_nwk_key_len)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = 22;
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        if (p_nwk_key == NULL)
-        {
-            TRACE_INFO("Please provide a valid network key\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if (16 != u16_nwk_key_len)
-        {
-            TRACE_INFO("Network key length must be 16 bytes\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_NW_KEY >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_NW_KEY & 0xFF;
-        mcm_module->u8_send_payload[3] = 0x00;
-        mcm_module->u8_send_payload[4] = u16_nwk_key_len;
-        memcpy(&mcm_module->u8_send_payload[5], p_nwk_key, u16_nwk_key_len);
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
+        return_status = api_processor_send_command(mcm_module, MROVER_CC_SET_NW_KEY, p_nwk_key, u16_nwk_key_len);
+    } while (0);
 
     return return_status;
 }
@@ -1463,133 +1421,17 @@ api_processor_status_t api_processor_cmd_set_nwk_key(mcm_module_hdl_t *mcm_modul
 
 api_processor_status_t api_processor_cmd_get_dev_eui(mcm_module_hdl_t *mcm_module)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = 6;
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_GET_DEV_EUI >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_GET_DEV_EUI & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-
-    return return_status;
+    return api_processor_send_command(mcm_module, MROVER_CC_GET_DEV_EUI, NULL, 0);
 }
 
 api_processor_status_t api_processor_cmd_get_join_eui(mcm_module_hdl_t *mcm_module)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = 6;
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_GET_JOIN_EUI >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_GET_JOIN_EUI & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-
-    return return_status;
+    return api_processor_send_command(mcm_module, MROVER_CC_GET_JOIN_EUI, NULL, 0);
 }
 
 api_processor_status_t api_processor_cmd_join_lorawan(mcm_module_hdl_t *mcm_module)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = 6;
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_JOIN_LORAWAN >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_JOIN_LORAWAN & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-
-    return return_status;
+    return api_processor_send_command(mcm_module, MROVER_CC_JOIN_LORAWAN, NULL, 0);
 }
 
 /**
@@ -1598,909 +1440,287 @@ api_processor_status_t api_processor_cmd_join_lorawan(mcm_module_hdl_t *mcm_modu
         unconfirmed frame as below -
         a. MROVER_UPLINK_UNCONFIRMED - unconfirmed data
         b. MROVER_UPLINK_CONFIRMED - confirmed data
- * @note 1. The application shall not use port 0 or the ports from 225 to 255 since they are reserved
-            for future standardized application extensions.
- * @param mcm_module MCM module handle
- * @param u8_port Port number on which data needs to be sent
- * @param u8_payload Pointer to the payload to be sent
- * @param u16_payload_size Length of the payload to be sent
- * @param h_uplink_type Type of the uplink frame - unconfirmed or confirmed
- * @return API_PROCESSOR_SUCCESS on success, API_PROCESSOR_ERROR on error.
- */
-api_processor_status_t api_processor_cmd_request_lorawan_uplink(mcm_module_hdl_t *mcm_module,uint8_t u8_port,uint8_t *u8_payload,uint16_t u16_payload_size,mrover_uplink_type_t h_uplink_type)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-
-    //validation the input data 
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        if(LORAWAN_TX_MAX_PAYLOAD_SIZE < u16_payload_size)
-        {
-            TRACE_INFO("Data payload cannot be exceeded more than 255 bytes\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        // The application shall not use port 0 or the ports from 225 to 255 since they are reserved
-        //for future standardized application extensions
-        if((0 == u8_port) || (225 <= u8_port))
-        {
-            TRACE_INFO("Please provide a valid port number\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if((NULL != u8_payload) && (0 == u16_payload_size)) // if data is present but size is zero
-        {
-            TRACE_INFO("Please provide a valid payload\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if((NULL == u8_payload) && (0 != u16_payload_size)) // if data is not present but size is not zero
-        {
-            TRACE_INFO("Please provide a valid payload\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if(MROVER_CONFIRMED_UPLINK < h_uplink_type)
-        {
-            TRACE_INFO("Please provide a valid uplink type\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        uint16_t u16_payload_len = u16_payload_size + 2; // 1 bytes for port number and 1 byte for uplink type
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_REQUEST_UPLINK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_REQUEST_UPLINK & 0xFF;
-        mcm_module->u8_send_payload[3] = u16_payload_len >> 8;
-        mcm_module->u8_send_payload[4] = u16_payload_len & 0xFF;
-        mcm_module->u8_send_payload[5] = u8_port;
-        mcm_module->u8_send_payload[6] = h_uplink_type;
-        memcpy(&mcm_module->u8_send_payload[7],u8_payload,u16_payload_size);
-
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + u16_payload_len;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-    
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_leave_lorawan_network(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-     const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN;
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_LEAVE_LORAWAN_NETWORK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_LEAVE_LORAWAN_NETWORK & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-api_processor_status_t api_processor_cmd_stop_lorawan_network(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + 1; // extra byte for the payload
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;
-        mcm_module->u8_send_payload[1] = MROVER_CC_STOP_SID_LORAWAN_NETWORK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_STOP_SID_LORAWAN_NETWORK & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0x01;
-        mcm_module->u8_send_payload[5] = 0x01;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_ble_link_request(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN; // extra byte for the payload
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_BLE_LINK_REQUEST >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_BLE_LINK_REQUEST & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_ble_conn_request(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN; // extra byte for the payload
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_BLE_CONNECTION_REQUEST >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_BLE_CONNECTION_REQUEST & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_fsk_link_request(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN; // extra byte for the payload
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_FSK_LINK_REQUEST >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_FSK_LINK_REQUEST & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-api_processor_status_t api_processor_cmd_sid_css_link_request(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN; // extra byte for the payload
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_CSS_LINK_REQUEST >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_CSS_LINK_REQUEST & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 0;
-        mcm_module->u8_send_payload[5] = 0;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_set_css_profile(mcm_module_hdl_t* mcm_module,mrover_css_pwr_profile_t h_profile)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + 1; // extra byte for the payload
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        if(MROVER_CC_SET_CSS_PWR_PROFILE < h_profile){
-            TRACE_INFO("Invalid CSS profile\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_CSS_PWR_PROFILE >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_CSS_PWR_PROFILE & 0xFF;
-        mcm_module->u8_send_payload[3] = 0;
-        mcm_module->u8_send_payload[4] = 1;
-        mcm_module->u8_send_payload[5] = h_profile;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-    } while (0);
-
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_send_uplink(mcm_module_hdl_t* mcm_module, uint8_t *u8_payload, uint16_t u16_payload_size, mrover_uplink_type_t h_uplink_type)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        // Validate payload size based on link type
-        if (SIDEWALK_TX_MAX_BLE_PAYLOAD_SIZE < u16_payload_size)
-        {
-            TRACE_INFO("Data payload cannot be exceed more than 255 bytes\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if((NULL == u8_payload) || (0 == u16_payload_size))
-        {
-            TRACE_INFO("Data payload cannot be empty\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        if(MROVER_CONFIRMED_UPLINK < h_uplink_type)
-        {
-            TRACE_INFO("Please provide a valid uplink type\n");
-            return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break;
-        }
-
-        uint16_t u16_payload_len = u16_payload_size + 1; // 1 byte for uplink type
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_REQUEST_UPLINK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_REQUEST_UPLINK & 0xFF;
-        mcm_module->u8_send_payload[3] = u16_payload_len >> 8;
-        mcm_module->u8_send_payload[4] = u16_payload_len & 0xFF;
-        mcm_module->u8_send_payload[5] = h_uplink_type;
-        memcpy(&mcm_module->u8_send_payload[6], u8_payload, u16_payload_size);
-
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + u16_payload_len;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
-            break;
-        }
-
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-    
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_set_sid_downlink_filter(mcm_module_hdl_t* mcm_module, mrover_sid_downlink_filter_t h_filtering)
+ * @note 1. The application shall not use port 0 or the ports from 225 to 255 since they are reserved
+            for future standardized application extensions.
+ * @param mcm_module MCM module handle
+ * @param u8_port Port number on which data needs to be sent
+ * @param u8_payload Pointer to the payload to be sent
+ * @param u16_payload_size Length of the payload to be sent
+ * @param h_uplink_type Type of the uplink frame - unconfirmed or confirmed
+ * @return API_PROCESSOR_SUCCESS on success, API_PROCESSOR_ERROR on error.
+ */
+api_processor_status_t api_processor_cmd_request_lorawan_uplink(mcm_module_hdl_t *mcm_module,uint8_t u8_port,uint8_t *u8_payload,uint16_t u16_payload_size,mrover_uplink_type_t h_uplink_type)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-         if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        if(MROVER_SID_DISABLE_FILTERING < h_filtering)
+        if(LORAWAN_TX_MAX_PAYLOAD_SIZE < u16_payload_size)
         {
-            TRACE_INFO("Wrong filtering value\n");
+            TRACE_INFO("Data payload cannot be exceeded more than 255 bytes\n");
             return_status = API_PROCESSOR_INVALID_PARAMETERS;
-            break; 
-        }
-
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + 1; // extra byte for the payload
-
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK & 0xFF;
-        mcm_module->u8_send_payload[3] = 0x00;
-        mcm_module->u8_send_payload[4] = 0x01;
-        mcm_module->u8_send_payload[5] = h_filtering;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append crc\n");
             break;
         }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        // The application shall not use port 0 or the ports from 225 to 255 since they are reserved
+        //for future standardized application extensions
+        if((0 == u8_port) || (225 <= u8_port))
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+            TRACE_INFO("Please provide a valid port number\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
-        return_status = API_PROCESSOR_SUCCESS;
-
-    } while (0);
-    
-    return return_status;
-}
-
-
-api_processor_status_t api_processor_cmd_sid_stop(mcm_module_hdl_t* mcm_module)
-{
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
-     do
-    {
-         if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        if((NULL != u8_payload) && (0 == u16_payload_size)) // if data is present but size is zero
         {
-            TRACE_INFO("MCM module is not initialized\n");
+            TRACE_INFO("Please provide a valid payload\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + 1; // extra byte for the payload
-
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_SIDEWALK;
-        mcm_module->u8_send_payload[1] = MROVER_CC_STOP_SID_LORAWAN_NETWORK >> 8;
-        mcm_module->u8_send_payload[2] = MROVER_CC_STOP_SID_LORAWAN_NETWORK & 0xFF;
-        mcm_module->u8_send_payload[3] = 0x00;
-        mcm_module->u8_send_payload[4] = 0x01;
-        mcm_module->u8_send_payload[5] = SIDEWALK_STOP_DATA_PAYLOAD;
-
-        // send the payload to the frame parser for crc check and other validation
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
+        if((NULL == u8_payload) && (0 != u16_payload_size)) // if data is not present but size is not zero
         {
-            TRACE_INFO("Failed to append crc\n");
+            TRACE_INFO("Please provide a valid payload\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // send the data to the module for sending
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(mcm_module->u8_send_payload, max_payload_size,mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        if(MROVER_CONFIRMED_UPLINK < h_uplink_type)
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+            TRACE_INFO("Please provide a valid uplink type\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
-        return_status = API_PROCESSOR_SUCCESS;
 
+        const uint8_t u8_params[] = {u8_port, (uint8_t)h_uplink_type}; // 1 bytes for port number and 1 byte for uplink type
+        return_status = api_processor_send_frame(mcm_module, COMMAND_TYPE_LORAWAN, MROVER_CC_REQUEST_UPLINK, u8_params, sizeof(u8_params), u8_payload, u16_payload_size);
     } while (0);
-    
+
     return return_status;
+}
 
+
+api_processor_status_t api_processor_cmd_leave_lorawan_network(mcm_module_hdl_t* mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_LEAVE_LORAWAN_NETWORK, NULL, 0);
 }
 
-//TODO Oxit: Paresh: Rename file to something more relevant
+api_processor_status_t api_processor_cmd_stop_lorawan_network(mcm_module_hdl_t* mcm_module)
+{
+    const uint8_t u8_params[] = {0x01};
+    return api_processor_send_frame(mcm_module, COMMAND_TYPE_LORAWAN, MROVER_CC_STOP_SID_LORAWAN_NETWORK, u8_params, sizeof(u8_params), NULL, 0);
+}
 
-api_processor_status_t api_processor_parse_rx_data(mcm_module_hdl_t *mcm_module,uint8_t* data,uint16_t len)
-{   
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
-    TRACE_INFO("Parsing RX data: length = %d\n", len); // Debug print for data length
 
-    // TODO: currently we are only handling for 2 concurrent frame, can be done for the multiple frame also 
-    // check if frame is single or multiple
-    if(fp_is_single_frame(data,len))
-    {
-        TRACE_INFO("Single frame detected\n"); // Debug print for single frame
-        return_status = api_processor_parse_single_frame(mcm_module,data,len);
-    }
-    else
-    {
-        TRACE_INFO("Multiple frame detected\n"); // Debug print for multiple frame
-        // if frame is notification, then just parse first MIN_RX_PAYLOAD_LEN, as notification, rest as the response
-        if(MROVER_RC_NOTIFY_EVENTS == data[0])
-        {   
-            TRACE_INFO("Notification frame detected\n"); // Debug print for notification
-            // parser for notification
-            return_status = api_processor_parse_single_frame(mcm_module,data,MIN_RX_PAYLOAD_LEN);
+api_processor_status_t api_processor_cmd_sid_ble_link_request(mcm_module_hdl_t* mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_BLE_LINK_REQUEST, NULL, 0);
+}
 
-            if((len-MIN_RX_PAYLOAD_LEN) > MIN_RX_PAYLOAD_LEN) // if response is available
-            {
-                TRACE_INFO("Parsing response frame\n"); // Debug print for response
-                // parser for response
-                return_status = api_processor_parse_single_frame(mcm_module, data + MIN_RX_PAYLOAD_LEN, len - MIN_RX_PAYLOAD_LEN);
-            }
-        }
-        else
-        {
-            TRACE_INFO("Response frame detected\n"); // Debug print for response frame
-            // response frame first
-            return_status = api_processor_parse_single_frame(mcm_module,data,(len-MIN_RX_PAYLOAD_LEN));
 
-            if((len-MIN_RX_PAYLOAD_LEN) >= MIN_RX_PAYLOAD_LEN)
-            {
-                TRACE_INFO("Parsing notification after response\n"); // Debug print for notification after response
-                // then notification
-                data = data + (len-MIN_RX_PAYLOAD_LEN); // move the data pointer to the start of the notification
-                return_status = api_processor_parse_single_frame(mcm_module, data, MIN_RX_PAYLOAD_LEN);
-            }
-        }
-    }
-    TRACE_INFO("Finished parsing RX data with status: %d\n", return_status); // Debug print for return status
-    return return_status;
+api_processor_status_t api_processor_cmd_sid_ble_conn_request(mcm_module_hdl_t* mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_BLE_CONNECTION_REQUEST, NULL, 0);
 }
 
 
-inline uint8_t api_processor_get_pending_events(mcm_module_hdl_t *mcm_module)
+api_processor_status_t api_processor_cmd_sid_fsk_link_request(mcm_module_hdl_t* mcm_module)
 {
-    return mcm_module->_no_of_curr_pen_evt;
+    return api_processor_send_command(mcm_module, MROVER_CC_FSK_LINK_REQUEST, NULL, 0);
 }
 
-api_processor_status_t api_processor_cmd_set_lorawan_class(mcm_module_hdl_t *mcm_module, 
-                                                           mrover_lorawan_class_t lorawan_class)
+api_processor_status_t api_processor_cmd_sid_css_link_request(mcm_module_hdl_t* mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_CSS_LINK_REQUEST, NULL, 0);
+}
+
+
+api_processor_status_t api_processor_cmd_sid_set_css_profile(mcm_module_hdl_t* mcm_module,mrover_css_pwr_profile_t h_profile)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        // Clear the payload buffer
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + 1; // 1 byte for class payload
-
-        // Construct the payload
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;                  // Command type
-        mcm_module->u8_send_payload[1] = MROVER_CC_SET_LORAWAN_CLASS >> 8;     // Command code MSB
-        mcm_module->u8_send_payload[2] = MROVER_CC_SET_LORAWAN_CLASS & 0xFF;   // Command code LSB
-        mcm_module->u8_send_payload[3] = 0x00;                                 
-        mcm_module->u8_send_payload[4] = 0x01;                                 
-        mcm_module->u8_send_payload[5] = (uint8_t)lorawan_class;               // LoRaWAN class
-
-        // Append CRC
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append CRC\n");
-            break;
-        }
-
-        // Send the payload
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(
-            mcm_module->u8_send_payload, max_payload_size, mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+        if(MROVER_CSS_PWR_PROFILE_B < h_profile){
+            TRACE_INFO("Invalid CSS profile\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        return_status = API_PROCESSOR_SUCCESS;
-
+        const uint8_t u8_params[] = {(uint8_t)h_profile};
+        return_status = api_processor_send_command(mcm_module, MROVER_CC_SET_CSS_PWR_PROFILE, u8_params, sizeof(u8_params));
     } while (0);
 
     return return_status;
 }
 
-api_processor_status_t api_processor_cmd_get_lorawan_class(mcm_module_hdl_t *mcm_module)
+
+api_processor_status_t api_processor_cmd_sid_send_uplink(mcm_module_hdl_t* mcm_module, uint8_t *u8_payload, uint16_t u16_payload_size, mrover_uplink_type_t h_uplink_type)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        // Validate payload size based on link type
+        if (SIDEWALK_TX_MAX_BLE_PAYLOAD_SIZE < u16_payload_size)
         {
-            TRACE_INFO("MCM module is not initialized\n");
+            TRACE_INFO("Data payload cannot be exceed more than 255 bytes\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // Clear the payload buffer
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN;
-
-        // Construct the payload
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_LORAWAN;                  // Command type
-        mcm_module->u8_send_payload[1] = MROVER_CC_GET_LORAWAN_CLASS >> 8;     // Command code MSB
-        mcm_module->u8_send_payload[2] = MROVER_CC_GET_LORAWAN_CLASS & 0xFF;   // Command code LSB
-        mcm_module->u8_send_payload[3] = 0x00;                                 // Reserved
-        mcm_module->u8_send_payload[4] = 0x00;                                 // Payload length
-        mcm_module->u8_send_payload[5] = 0x00;                                 // Placeholder for optional data
-
-        // Append CRC
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
+        if((NULL == u8_payload) || (0 == u16_payload_size))
         {
-            TRACE_INFO("Failed to append CRC\n");
+            TRACE_INFO("Data payload cannot be empty\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // Send the payload
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(
-            mcm_module->u8_send_payload, max_payload_size, mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        if(MROVER_CONFIRMED_UPLINK < h_uplink_type)
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+            TRACE_INFO("Please provide a valid uplink type\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        return_status = API_PROCESSOR_SUCCESS;
-
+        const uint8_t u8_params[] = {(uint8_t)h_uplink_type}; // 1 byte for uplink type
+        return_status = api_processor_send_frame(mcm_module, COMMAND_TYPE_SIDEWALK, MROVER_CC_REQUEST_UPLINK, u8_params, sizeof(u8_params), u8_payload, u16_payload_size);
     } while (0);
 
     return return_status;
 }
 
-api_processor_status_t api_processor_cmd_start_file_transfer(mcm_module_hdl_t *mcm_module,ver_type_1_t version)
+
+api_processor_status_t api_processor_cmd_set_sid_downlink_filter(mcm_module_hdl_t* mcm_module, mrover_sid_downlink_filter_t h_filtering)
 {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
-
-        // Clear the payload buffer
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + sizeof(ver_type_1_t);
-
-        // Construct the payload
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;                  // Command type
-        mcm_module->u8_send_payload[1] = MROVER_CC_START_FILE_TRANSFER >> 8;     // Command code MSB
-        mcm_module->u8_send_payload[2] = MROVER_CC_START_FILE_TRANSFER & 0xFF;   // Command code LSB
-        mcm_module->u8_send_payload[3] = 0x00;                                 // Reserved
-        mcm_module->u8_send_payload[4] = sizeof(ver_type_1_t);                 // Payload length
-        mcm_module->u8_send_payload[5] = version.major;                      
-        mcm_module->u8_send_payload[6] = version.minor;
-        mcm_module->u8_send_payload[7] = version.patch;
-
-        // Append CRC
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append CRC\n");
-            break;
-        }
-
-        // Send the payload
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(
-            mcm_module->u8_send_payload, max_payload_size, mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        if(MROVER_SID_DISABLE_FILTERING < h_filtering)
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
+            TRACE_INFO("Wrong filtering value\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
+            break; 
         }
 
-        return_status = API_PROCESSOR_SUCCESS;
-
-
+        const uint8_t u8_params[] = {(uint8_t)h_filtering};
+        return_status = api_processor_send_command(mcm_module, MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK, u8_params, sizeof(u8_params));
     } while (0);
 
     return return_status;
 }
 
-api_processor_status_t api_processor_cmd_get_seg_file_transfer_status(mcm_module_hdl_t *mcm_module)
+
+api_processor_status_t api_processor_cmd_sid_stop(mcm_module_hdl_t* mcm_module)
 {
+    const uint8_t u8_params[] = {SIDEWALK_STOP_DATA_PAYLOAD};
+    return api_processor_send_frame(mcm_module, COMMAND_TYPE_SIDEWALK, MROVER_CC_STOP_SID_LORAWAN_NETWORK, u8_params, sizeof(u8_params), NULL, 0);
+}
+
+//TODO Oxit: Paresh: Rename file to something more relevant
+
+api_processor_status_t api_processor_parse_rx_data(mcm_module_hdl_t *mcm_module,uint8_t* data,uint16_t len)
+{   
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    TRACE_DEBUG("Parsing RX data: length = %d\n", len); // Debug print for data length
 
     do
     {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
+        if (NULL == mcm_module)
         {
             TRACE_INFO("MCM module is not initialized\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // Clear the payload buffer
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN;
-
-        // Construct the payload
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;                  // Command type
-        mcm_module->u8_send_payload[1] = MROVER_CC_FILE_STATUS >> 8;     // Command code MSB
-        mcm_module->u8_send_payload[2] = MROVER_CC_FILE_STATUS & 0xFF;   // Command code LSB
-        mcm_module->u8_send_payload[3] = 0x00;                                 // Reserved
-        mcm_module->u8_send_payload[4] = 0x00;                 // Payload length
-        mcm_module->u8_send_payload[5] = 0x00;                      
-
-        // Append CRC
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
+        if (NULL == data)
         {
-            TRACE_INFO("Failed to append CRC\n");
+            TRACE_INFO("Serial data cannot be NULL\n");
+            return_status = API_PROCESSOR_INVALID_PARAMETERS;
             break;
         }
 
-        // Send the payload
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(
-            mcm_module->u8_send_payload, max_payload_size, mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
+        // every complete frame is parsed from the callback, rest of the bytes are kept for the next call
+        api_processor_rx_context_t rx_context = {mcm_module, API_PROCESSOR_SUCCESS};
+        fp_api_status_t status = fp_reassembler_feed(&mcm_module->h_rx_reassembler, data, len, api_processor_on_rx_frame, &rx_context);
+        if (FP_SUCCESS != status)
         {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
+            TRACE_INFO("Failed to reassemble the frames\n");
             break;
         }
 
-        return_status = API_PROCESSOR_SUCCESS;
-
-
+        return_status = rx_context.status;
     } while (0);
 
+    TRACE_DEBUG("Finished parsing RX data with status: %d\n", return_status); // Debug print for return status
     return return_status;
-
 }
 
-api_processor_status_t api_processor_cmd_trigger_fw_update(mcm_module_hdl_t *mcm_module, ver_type_1_t version)
+
+bool api_processor_is_rx_frame_pending(mcm_module_hdl_t *mcm_module)
 {
-    api_processor_status_t return_status = API_PROCESSOR_ERROR;
+    return (NULL != mcm_module) ? fp_reassembler_has_partial_frame(&mcm_module->h_rx_reassembler) : false;
+}
 
-    do
-    {
-        if (NULL == mcm_module || NULL == mcm_module->h_serial_device.send_data_cb)
-        {
-            TRACE_INFO("MCM module is not initialized\n");
-            break;
-        }
 
-        // Clear the payload buffer
-        memset(mcm_module->u8_send_payload, 0, MAX_SERIAL_SEND_PAYLOAD_SIZE);
-        const uint16_t max_payload_size = MIN_TX_PAYLOAD_LEN + sizeof(ver_type_1_t);
-
-        // Construct the payload
-        mcm_module->u8_send_payload[0] = COMMAND_TYPE_GENERAL;                  // Command type
-        mcm_module->u8_send_payload[1] = MROVER_CC_TRIGGER_FW_UPDATE >> 8;     // Command code MSB
-        mcm_module->u8_send_payload[2] = MROVER_CC_TRIGGER_FW_UPDATE & 0xFF;   // Command code LSB
-        mcm_module->u8_send_payload[3] = 0x00;                                 // Reserved
-        mcm_module->u8_send_payload[4] = sizeof(ver_type_1_t);                 // Payload length
-        mcm_module->u8_send_payload[5] = version.major;                      
-        mcm_module->u8_send_payload[6] = version.minor;
-        mcm_module->u8_send_payload[7] = version.patch;                    
-
-        // Append CRC
-        fp_api_status_t status = fp_append_crc(mcm_module->u8_send_payload, max_payload_size);
-        if (FP_SUCCESS != status)
-        {
-            TRACE_INFO("Failed to append CRC\n");
-            break;
-        }
+api_processor_status_t api_processor_parse_rx_frame(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len)
+{
+    // frame comes from outside of the module, so it is validated again
+    return api_processor_parse_single_frame(mcm_module, data, len, false);
+}
 
-        // Send the payload
-        uint16_t u16_sent_bytes = mcm_module->h_serial_device.send_data_cb(
-            mcm_module->u8_send_payload, max_payload_size, mcm_module->user_context);
-        if (max_payload_size != u16_sent_bytes)
-        {
-            TRACE_INFO("Failed to send data through serial port\n");
-            return_status = API_PROCESSOR_SERIAL_PORT_ERROR;
-            break;
-        }
 
-        return_status = API_PROCESSOR_SUCCESS;
+inline uint8_t api_processor_get_pending_events(mcm_module_hdl_t *mcm_module)
+{
+    return mcm_module->_no_of_curr_pen_evt;
+}
 
+api_processor_status_t api_processor_cmd_set_lorawan_class(mcm_module_hdl_t *mcm_module, 
+                                                           mrover_lorawan_class_t lorawan_class)
+{
+    const uint8_t u8_params[] = {(uint8_t)lorawan_class}; // 1 byte for class payload
+    return api_processor_send_command(mcm_module, MROVER_CC_SET_LORAWAN_CLASS, u8_params, sizeof(u8_params));
+}
 
-    } while (0);
+api_processor_status_t api_processor_cmd_get_lorawan_class(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_GET_LORAWAN_CLASS, NULL, 0);
+}
 
-    return return_status;
+api_processor_status_t api_processor_cmd_start_file_transfer(mcm_module_hdl_t *mcm_module,ver_type_1_t version)
+{
+    const uint8_t u8_params[] = {version.major, version.minor, version.patch};
+    return api_processor_send_command(mcm_module, MROVER_CC_START_FILE_TRANSFER, u8_params, sizeof(u8_params));
+}
+
+api_processor_status_t api_processor_cmd_get_seg_file_transfer_status(mcm_module_hdl_t *mcm_module)
+{
+    return api_processor_send_command(mcm_module, MROVER_CC_FILE_STATUS, NULL, 0);
+}
 
+api_processor_status_t api_processor_cmd_trigger_fw_update(mcm_module_hdl_t *mcm_module, ver_type_1_t version)
+{
+    const uint8_t u8_params[] = {version.major, version.minor, version.patch};
+    return api_processor_send_command(mcm_module, MROVER_CC_TRIGGER_FW_UPDATE, u8_params, sizeof(u8_params));
 }
 
 /**
  * @brief This function handles the uplink request from the MCM module.
  *
  * @param[in] mcm_module Pointer to the MCM module structure.
- * @param[in] data Pointer to the data buffer containing the uplink request.
- * @param[in] len Length of the data buffer containing the uplink request.
+ * @param[in,out] p_reader Reader of the uplink request.
  * @param[out] p_response Pointer to the api_processor_response_t structure
  *                       that needs to be filled up.
  *
  * @return API_PROCESSOR_SUCCESS if the request is processed successfully,
  *         otherwise appropriate error code.
  */
-static api_processor_status_t api_processor_handle_request_uplink(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len, api_processor_response_t *p_response) {
+static api_processor_status_t api_processor_handle_request_uplink(mcm_module_hdl_t *mcm_module, api_processor_reader_t *p_reader, api_processor_response_t *p_response) {
     api_processor_status_t return_status = API_PROCESSOR_ERROR;
 
-    // Basic sanity checks
-    if (data == NULL || len < 1) {
-        TRACE_INFO("Invalid data for uplink request\n");
-        return API_PROCESSOR_INVALID_PARAMETERS;
-    }
-
     // Debug print to indicate the start of processing the uplink request
-    TRACE_INFO("Processing uplink request with length: %d\n", len);
+    TRACE_DEBUG("Processing uplink request with length: %d\n", p_reader->u16_len);
 
     // @todo : Noman - Process the uplink request here
 
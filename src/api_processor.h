@@ -74,6 +74,8 @@ extern "C" {
  **********************************************************************************************************/
 #include <stdint.h>
 #include "commands_defs.h"
+#include "frame_parse.h"
+#include "api_metrics.h"
 
 
 /**********************************************************************************************************
@@ -216,6 +218,7 @@ typedef union
 typedef struct
 {
     get_event_code_t get_event_code;
+    uint8_t pending_events;             // events still waiting in the mcm after this one
     get_event_cb_value_t get_event_data_value;
 } get_event_data_t;
 
@@ -297,9 +300,23 @@ typedef void (*serial_receive_data_cb)(uint8_t *data,uint16_t size,void* user_co
 typedef void (*mrover_notification_cb)(void *user_context);
 typedef void(*mrover_response_cb)(const api_processor_response_t *response,void* user_context);
 
+/**
+ * @brief One contiguous part of a frame to be sent
+ */
+typedef struct
+{
+    const uint8_t *p_data;
+    uint16_t u16_len;
+} serial_iovec_t;
+
+typedef uint16_t (*serial_send_vec_cb)(const serial_iovec_t *p_iov, uint8_t u8_iov_count, void *user_context);
+
+typedef uint32_t (*api_processor_tick_cb)(void);
+
 typedef struct
 {
     serial_send_data_cb send_data_cb;
+    serial_send_vec_cb send_vec_cb;         // optional, frame is sent in parts without copying the payload
 } serial_module_hdl_t;  
 
 
@@ -308,8 +325,10 @@ typedef struct {
     mrover_notification_cb handle_notification_cb;              // callback function for notification 
     mrover_response_cb handle_response_cb;                        // callback for response 
     uint8_t u8_send_payload[MAX_SERIAL_SEND_PAYLOAD_SIZE];
-    uint8_t u8_received_payload[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE];
+    fp_reassembler_t h_rx_reassembler;                          // reassembles the frames from the received serial bytes
     uint8_t _no_of_curr_pen_evt;                             // keep the context for number of current pending events, private variable need not to be access directly
+    api_processor_tick_cb get_tick_ms_cb;                       // optional, millisecond time source for the round trip times
+    api_metrics_t h_metrics;                                    // serial link metrics, read with api_processor_get_metrics
     void *user_context;
 }mcm_module_hdl_t; 
 
@@ -337,6 +356,58 @@ api_processor_status_t api_processor_init(
                         mrover_response_cb h_mrover_response_cb
 );
 
+/**
+ * @brief Sets the scatter-gather callback to send the frames
+ *
+ * When set, a frame is sent as the header, the command parameters, the caller
+ * payload and the CRC, without copying the payload into the send buffer.
+ * The callback must send all the parts in order and return the total number of bytes sent.
+ *
+ * @param[in,out] mcm_module Pointer to the MCM module handle
+ * @param[in] send_vec_cb Callback function for sending the frame parts, NULL to use send_data_cb
+ * @return API_PROCESSOR_SUCCESS if the callback is set otherwise error code
+ */
+api_processor_status_t api_processor_set_send_vec_cb(mcm_module_hdl_t *mcm_module, serial_send_vec_cb send_vec_cb);
+
+/**
+ * @brief Sets the millisecond time source used to measure the command round trip times
+ *
+ * @param[in,out] mcm_module Pointer to the MCM module handle
+ * @param[in] tick_cb Callback returning the current time in milliseconds, NULL to not measure
+ * @return API_PROCESSOR_SUCCESS if the callback is set otherwise error code
+ */
+api_processor_status_t api_processor_set_tick_cb(mcm_module_hdl_t *mcm_module, api_processor_tick_cb tick_cb);
+
+/**
+ * @brief Copies the serial link metrics of the module
+ *
+ * Link counters include the ones of the module frame reassembler.
+ *
+ * @param[in,out] mcm_module Pointer to the MCM module handle
+ * @param[out] p_metrics Pointer to the copy of the metrics
+ * @param[in] b_reset true to clear the counters after the copy, to read the metrics in windows
+ * @return API_PROCESSOR_SUCCESS if the metrics are copied otherwise error code
+ */
+api_processor_status_t api_processor_get_metrics(mcm_module_hdl_t *mcm_module, api_metrics_t *p_metrics, bool b_reset);
+
+/**
+ * @brief Reports that the response of the command has not been received in time
+ *
+ * Module does not keep time by itself, timeout is detected by the caller.
+ *
+ * @param[in,out] mcm_module Pointer to the MCM module handle
+ * @param[in] cmd_code Command code of the command
+ */
+void api_processor_report_timeout(mcm_module_hdl_t *mcm_module, mrover_cc_codes_t cmd_code);
+
+/**
+ * @brief Returns the name of the command
+ *
+ * @param[in] u16_cmd_code Command code
+ * @return Name of the command, "Unknown" if the command is not supported
+ */
+const char *api_processor_get_cmd_name(uint16_t u16_cmd_code);
+
 /**
  * @brief Retrieves the library version
  *
@@ -348,6 +419,9 @@ void api_processor_get_lib_ver(ver_type_1_t *ver);
 /**
  * @brief Parses the received serial data and processes it
  *
+ * The data can contain any number of frames, or only a part of a frame. A partial
+ * frame is kept by the module and completed by the next call.
+ *
  * @param[in] mcm_module Pointer to the MCM module handle
  * @param[in] data Pointer to the received data
  * @param[in] len Length of the received data
@@ -355,6 +429,27 @@ void api_processor_get_lib_ver(ver_type_1_t *ver);
  */
 api_processor_status_t api_processor_parse_rx_data(mcm_module_hdl_t *mcm_module,uint8_t* data,uint16_t len);
 
+/**
+ * @brief Check if a partially received frame is waiting for more serial data
+ *
+ * @param[in] mcm_module Pointer to the MCM module handle
+ * @return true if the rest of a frame is awaited, false otherwise
+ */
+bool api_processor_is_rx_frame_pending(mcm_module_hdl_t *mcm_module);
+
+/**
+ * @brief Parses one complete frame and processes it
+ *
+ * Used when the frames are reassembled outside of the module, e.g. by a serial
+ * rx task running its own fp_reassembler_t.
+ *
+ * @param[in] mcm_module Pointer to the MCM module handle
+ * @param[in] data Pointer to the complete response or notification frame
+ * @param[in] len Length of the frame
+ * @return API_PROCESSOR_SUCCESS if frame is parsed successfully otherwise error code
+ */
+api_processor_status_t api_processor_parse_rx_frame(mcm_module_hdl_t *mcm_module, uint8_t *data, uint16_t len);
+
 /**
  * @brief Returns the number of pending events reported by mcm module
  *
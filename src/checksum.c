@@ -0,0 +1,266 @@
+/**
+ * @file checksum.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief this contain the implementation of the checksums. Both work on several
+ * bytes per step, they run for every frame and every firmware block on the core
+ * that also services the uart.
+ * @version 0.1
+ * @date 2024-04-15
+ * 
+ * @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "checksum.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+/*
+ * The tables are built by the compiler, no value is pasted in. A CRC without init
+ * and final xor is linear, so entry i is the XOR of the entries of the bits set in i
+ * and a table is spanned by the eight single bit entries. Those are the enum
+ * constants below, each one is a single register shift of the one before it.
+ */
+#define CRC16_POLY                  0x1021
+#define CRC16_SHIFT(r)              ((((r) << 1) ^ (((r) & 0x8000) ? CRC16_POLY : 0)) & 0xFFFF)
+
+// the reflected register is kept as two 16 bit halves, an enum constant holds an int
+#define CRC32_POLY_HI               0xEDB8
+#define CRC32_POLY_LO               0x8320
+#define CRC32_SHIFT_HI(hi, lo)      (((hi) >> 1) ^ (((lo) & 1) ? CRC32_POLY_HI : 0))
+#define CRC32_SHIFT_LO(hi, lo)      ((((lo) >> 1) | (((hi) & 1) << 15)) ^ (((lo) & 1) ? CRC32_POLY_LO : 0))
+#define CRC32_BIT(b)                (((uint32_t)CRC32_BIT##b##_HI << 16) | (uint32_t)CRC32_BIT##b##_LO)
+
+#define CHECKSUM_SPAN(i, b, value)  (((i) & (1 << (b))) ? (value) : 0)
+#define CHECKSUM_ENTRY(i, b0, b1, b2, b3, b4, b5, b6, b7)                                  \
+    (CHECKSUM_SPAN(i, 0, b0) ^ CHECKSUM_SPAN(i, 1, b1) ^ CHECKSUM_SPAN(i, 2, b2) ^        \
+     CHECKSUM_SPAN(i, 3, b3) ^ CHECKSUM_SPAN(i, 4, b4) ^ CHECKSUM_SPAN(i, 5, b5) ^        \
+     CHECKSUM_SPAN(i, 6, b6) ^ CHECKSUM_SPAN(i, 7, b7))
+
+// bit b of the byte followed by k zero bytes is x^(16 + 8k + b) mod the polynomial
+#define CRC16_TABLE_0(i)            CHECKSUM_ENTRY(i, CRC16_X16, CRC16_X17, CRC16_X18, CRC16_X19, CRC16_X20, CRC16_X21, CRC16_X22, CRC16_X23)
+#define CRC16_TABLE_1(i)            CHECKSUM_ENTRY(i, CRC16_X24, CRC16_X25, CRC16_X26, CRC16_X27, CRC16_X28, CRC16_X29, CRC16_X30, CRC16_X31)
+#define CRC16_TABLE_2(i)            CHECKSUM_ENTRY(i, CRC16_X32, CRC16_X33, CRC16_X34, CRC16_X35, CRC16_X36, CRC16_X37, CRC16_X38, CRC16_X39)
+#define CRC16_TABLE_3(i)            CHECKSUM_ENTRY(i, CRC16_X40, CRC16_X41, CRC16_X42, CRC16_X43, CRC16_X44, CRC16_X45, CRC16_X46, CRC16_X47)
+#define CRC32_TABLE(i)              CHECKSUM_ENTRY(i, CRC32_BIT(0), CRC32_BIT(1), CRC32_BIT(2), CRC32_BIT(3), CRC32_BIT(4), CRC32_BIT(5), CRC32_BIT(6), CRC32_BIT(7))
+
+#define CHECKSUM_TABLE_4(E, n)      E(n), E((n) + 1), E((n) + 2), E((n) + 3)
+#define CHECKSUM_TABLE_16(E, n)     CHECKSUM_TABLE_4(E, n), CHECKSUM_TABLE_4(E, (n) + 4), CHECKSUM_TABLE_4(E, (n) + 8), CHECKSUM_TABLE_4(E, (n) + 12)
+#define CHECKSUM_TABLE_64(E, n)     CHECKSUM_TABLE_16(E, n), CHECKSUM_TABLE_16(E, (n) + 16), CHECKSUM_TABLE_16(E, (n) + 32), CHECKSUM_TABLE_16(E, (n) + 48)
+#define CHECKSUM_TABLE_256(E)       CHECKSUM_TABLE_64(E, 0), CHECKSUM_TABLE_64(E, 64), CHECKSUM_TABLE_64(E, 128), CHECKSUM_TABLE_64(E, 192)
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+/**
+ * @brief x^n mod 0x1021, the CRC-16 of a single bit, x^16 is the polynomial itself
+ */
+enum
+{
+    CRC16_X16 = CRC16_POLY,            CRC16_X17 = CRC16_SHIFT(CRC16_X16), CRC16_X18 = CRC16_SHIFT(CRC16_X17),
+    CRC16_X19 = CRC16_SHIFT(CRC16_X18), CRC16_X20 = CRC16_SHIFT(CRC16_X19), CRC16_X21 = CRC16_SHIFT(CRC16_X20),
+    CRC16_X22 = CRC16_SHIFT(CRC16_X21), CRC16_X23 = CRC16_SHIFT(CRC16_X22), CRC16_X24 = CRC16_SHIFT(CRC16_X23),
+    CRC16_X25 = CRC16_SHIFT(CRC16_X24), CRC16_X26 = CRC16_SHIFT(CRC16_X25), CRC16_X27 = CRC16_SHIFT(CRC16_X26),
+    CRC16_X28 = CRC16_SHIFT(CRC16_X27), CRC16_X29 = CRC16_SHIFT(CRC16_X28), CRC16_X30 = CRC16_SHIFT(CRC16_X29),
+    CRC16_X31 = CRC16_SHIFT(CRC16_X30), CRC16_X32 = CRC16_SHIFT(CRC16_X31), CRC16_X33 = CRC16_SHIFT(CRC16_X32),
+    CRC16_X34 = CRC16_SHIFT(CRC16_X33), CRC16_X35 = CRC16_SHIFT(CRC16_X34), CRC16_X36 = CRC16_SHIFT(CRC16_X35),
+    CRC16_X37 = CRC16_SHIFT(CRC16_X36), CRC16_X38 = CRC16_SHIFT(CRC16_X37), CRC16_X39 = CRC16_SHIFT(CRC16_X38),
+    CRC16_X40 = CRC16_SHIFT(CRC16_X39), CRC16_X41 = CRC16_SHIFT(CRC16_X40), CRC16_X42 = CRC16_SHIFT(CRC16_X41),
+    CRC16_X43 = CRC16_SHIFT(CRC16_X42), CRC16_X44 = CRC16_SHIFT(CRC16_X43), CRC16_X45 = CRC16_SHIFT(CRC16_X44),
+    CRC16_X46 = CRC16_SHIFT(CRC16_X45), CRC16_X47 = CRC16_SHIFT(CRC16_X46),
+};
+
+/**
+ * @brief CRC-32 entry of the byte with only bit b set, bit 7 is the polynomial itself
+ */
+enum
+{
+    CRC32_BIT7_HI = CRC32_POLY_HI,                              CRC32_BIT7_LO = CRC32_POLY_LO,
+    CRC32_BIT6_HI = CRC32_SHIFT_HI(CRC32_BIT7_HI, CRC32_BIT7_LO), CRC32_BIT6_LO = CRC32_SHIFT_LO(CRC32_BIT7_HI, CRC32_BIT7_LO),
+    CRC32_BIT5_HI = CRC32_SHIFT_HI(CRC32_BIT6_HI, CRC32_BIT6_LO), CRC32_BIT5_LO = CRC32_SHIFT_LO(CRC32_BIT6_HI, CRC32_BIT6_LO),
+    CRC32_BIT4_HI = CRC32_SHIFT_HI(CRC32_BIT5_HI, CRC32_BIT5_LO), CRC32_BIT4_LO = CRC32_SHIFT_LO(CRC32_BIT5_HI, CRC32_BIT5_LO),
+    CRC32_BIT3_HI = CRC32_SHIFT_HI(CRC32_BIT4_HI, CRC32_BIT4_LO), CRC32_BIT3_LO = CRC32_SHIFT_LO(CRC32_BIT4_HI, CRC32_BIT4_LO),
+    CRC32_BIT2_HI = CRC32_SHIFT_HI(CRC32_BIT3_HI, CRC32_BIT3_LO), CRC32_BIT2_LO = CRC32_SHIFT_LO(CRC32_BIT3_HI, CRC32_BIT3_LO),
+    CRC32_BIT1_HI = CRC32_SHIFT_HI(CRC32_BIT2_HI, CRC32_BIT2_LO), CRC32_BIT1_LO = CRC32_SHIFT_LO(CRC32_BIT2_HI, CRC32_BIT2_LO),
+    CRC32_BIT0_HI = CRC32_SHIFT_HI(CRC32_BIT1_HI, CRC32_BIT1_LO), CRC32_BIT0_LO = CRC32_SHIFT_LO(CRC32_BIT1_HI, CRC32_BIT1_LO),
+};
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+/**
+ * @brief Slice-by-4 tables of CRC-16/XMODEM, table k is the CRC of the byte followed
+ *        by k zero bytes. Generated at compile time from the polynomial 0x1021, kept in flash.
+ */
+static const uint16_t crc16_tables[4][256] = {
+    {CHECKSUM_TABLE_256(CRC16_TABLE_0)},
+    {CHECKSUM_TABLE_256(CRC16_TABLE_1)},
+    {CHECKSUM_TABLE_256(CRC16_TABLE_2)},
+    {CHECKSUM_TABLE_256(CRC16_TABLE_3)},
+};
+
+/**
+ * @brief Table of CRC-32 (IEEE 802.3), generated at compile time from the reflected
+ *        polynomial 0xEDB88320, kept in flash
+ */
+static const uint32_t crc32_table[256] = {
+    CHECKSUM_TABLE_256(CRC32_TABLE)
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+uint16_t checksum_crc16_update(uint16_t u16_crc, const uint8_t *p_data, uint32_t u32_len)
+{
+    if (NULL == p_data)
+    {
+        return u16_crc;
+    }
+
+    while (u32_len >= 4)
+    {
+        u16_crc = crc16_tables[3][p_data[0] ^ (u16_crc >> 8)] ^
+                  crc16_tables[2][p_data[1] ^ (u16_crc & 0xFF)] ^
+                  crc16_tables[1][p_data[2]] ^
+                  crc16_tables[0][p_data[3]];
+        p_data += 4;
+        u32_len -= 4;
+    }
+
+    while (u32_len--)
+    {
+        u16_crc = (u16_crc << 8) ^ crc16_tables[0][(u16_crc >> 8) ^ *p_data++];
+    }
+
+    return u16_crc;
+}
+
+uint8_t checksum_xor8_update(uint8_t u8_crc, const uint8_t *p_data, uint32_t u32_len)
+{
+    uint32_t u32_acc = 0;
+
+    if (NULL == p_data)
+    {
+        return u8_crc;
+    }
+
+    // bytes up to the word boundary
+    while ((0 != u32_len) && (0 != ((uintptr_t)p_data & 0x03)))
+    {
+        u8_crc ^= *p_data++;
+        u32_len--;
+    }
+
+    while (u32_len >= 4)
+    {
+        // aligned, so the copy is a single load
+        uint32_t u32_word;
+        memcpy(&u32_word, p_data, sizeof(u32_word));
+        u32_acc ^= u32_word;
+        p_data += 4;
+        u32_len -= 4;
+    }
+
+    while (u32_len--)
+    {
+        u8_crc ^= *p_data++;
+    }
+
+    // fold the lanes of the word, byte order does not matter for XOR
+    u32_acc ^= u32_acc >> 16;
+    u32_acc ^= u32_acc >> 8;
+
+    return u8_crc ^ (uint8_t)u32_acc;
+}
+
+uint32_t checksum_crc32_update(uint32_t u32_crc, const uint8_t *p_data, uint32_t u32_len)
+{
+    if (NULL == p_data)
+    {
+        return u32_crc;
+    }
+
+    // the register is kept inverted between the calls, so parts can be chained
+    u32_crc = ~u32_crc;
+    while (u32_len--)
+    {
+        u32_crc = (u32_crc >> 8) ^ crc32_table[(u32_crc ^ *p_data++) & 0xFF];
+    }
+
+    return ~u32_crc;
+}
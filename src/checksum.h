@@ -0,0 +1,149 @@
+/**
+ * @file checksum.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the checksums of the mcm frames and the ymodem blocks.
+ * @version 0.1
+ * @date 2024-04-11
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __CHECKSUM_H__
+#define __CHECKSUM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+/**
+ * @brief Start value of the CRC-16/XMODEM used by ymodem, polynomial 0x1021
+ */
+#define CHECKSUM_CRC16_INIT                         0x0000
+
+/**
+ * @brief Start value of the XOR checksum of the mcm frames
+ */
+#define CHECKSUM_XOR8_INIT                          0x00
+
+/**
+ * @brief Start value of the CRC-32 (IEEE 802.3) of the firmware images
+ */
+#define CHECKSUM_CRC32_INIT                         0x00000000
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Updates the CRC-16/XMODEM with the given data
+ *
+ * Four bytes are processed per step with the slice-by-4 tables. The data can be
+ * given in parts of any size, start with CHECKSUM_CRC16_INIT.
+ *
+ * @param[in] u16_crc CRC calculated so far
+ * @param[in] p_data Pointer to the next part of the data
+ * @param[in] u32_len Length of the next part of the data
+ * @return The updated CRC
+ */
+uint16_t checksum_crc16_update(uint16_t u16_crc, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Updates the XOR checksum with the given data
+ *
+ * Aligned data is processed a 32 bit word at a time. As XOR is its own inverse,
+ * XORing the same bytes again removes them from the checksum. Start with CHECKSUM_XOR8_INIT.
+ *
+ * @param[in] u8_crc Checksum calculated so far
+ * @param[in] p_data Pointer to the next part of the data
+ * @param[in] u32_len Length of the next part of the data
+ * @return The updated checksum
+ */
+uint8_t checksum_xor8_update(uint8_t u8_crc, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Updates the CRC-32 (IEEE 802.3) with the given data
+ *
+ * The data can be given in parts of any size, start with CHECKSUM_CRC32_INIT.
+ * The result of one part is the start value of the next one.
+ *
+ * @param[in] u32_crc CRC calculated so far
+ * @param[in] p_data Pointer to the next part of the data
+ * @param[in] u32_len Length of the next part of the data
+ * @return The updated CRC
+ */
+uint32_t checksum_crc32_update(uint32_t u32_crc, const uint8_t *p_data, uint32_t u32_len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __CHECKSUM_H__
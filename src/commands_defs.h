@@ -77,6 +77,7 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include "trace_buffer.h"
 
 /**********************************************************************************************************
  * MACROS AND DEFINES
@@ -121,6 +122,17 @@ extern "C" {
  */
 #define MIN_DOWNLINK_PAYLOAD_LEN                    3
 
+/**
+ * @brief In case of get event sidewalk downlink data
+ *  2 byte for the sequence number, 1 byte for the rssi and 1 byte for the snr
+ */
+#define MIN_SID_DOWNLINK_PAYLOAD_LEN                4
+
+/**
+ * @brief In case of get event, 1 byte event code and 1 byte pending event count
+ */
+#define GET_EVENT_HEADER_LEN                        2
+
 #define LORAWAN_DEV_EUI_JOIN_EUI_LEN                8
 
 #define LORAWAN_NETWORK_KEY_LEN                     16
@@ -144,22 +156,6 @@ extern "C" {
 
 #define SIDEWALK_STOP_DATA_PAYLOAD                  0x01
 
-
-/**
- * @brief set the value 
- *  0 to disable the trace buffer and 1 to enable the trace buffer
- * 
- */
-#define ENABLE_TRACE_BUFFER                         1
-
-#define TRACE_INFO(...)                             do                              \
-                                                    {                               \
-                                                        if (ENABLE_TRACE_BUFFER)    \
-                                                            printf(__VA_ARGS__);    \
-                                                    } while (0);
-
-
-
 /**********************************************************************************************************
  * TYPEDEFS
  **********************************************************************************************************/
@@ -224,6 +220,60 @@ typedef enum{
     MROVER_CC_TRIGGER_FW_UPDATE                    = 0x00D5,   // trigger firmware update
 }mrover_cc_codes_t;
 
+/**
+ * @brief Policy to validate the payload length of the response received for a command
+ */
+typedef enum {
+    MROVER_RSP_LEN_EXACT    = 0x00,     // payload length must be equal to the response length
+    MROVER_RSP_LEN_MIN      = 0x01      // payload length must be at least the response length
+}mrover_rsp_len_policy_t;
+
+/**
+ * @brief Number of slots in the command descriptor tables, must be a power of two
+ */
+#define MROVER_CC_TABLE_SIZE                        64
+
+/**
+ * @brief Perfect hash of the command code to the slot of the command descriptor tables
+ *        It is collision free for the command codes of mrover_cc_codes_t, a new command
+ *        code on the slot of another one fails the _Static_assert of api_processor.c
+ */
+#define MROVER_CC_TABLE_SLOT(cc)                    ((((cc) ^ ((cc) >> 4)) + (((cc) >> 8) * 6)) & (MROVER_CC_TABLE_SIZE - 1))
+
+/**
+ * @brief List of all the commands supported by the mcm module, single place to add a new command
+ *
+ * ENTRY(command code, default command type, response length policy, response length, response parser, name)
+ * Response parser is NULL for the commands which does not carry any response data
+ */
+#define MROVER_COMMAND_LIST(ENTRY)                                                                                                                              \
+    ENTRY(MROVER_CC_GET_EVENT,                       COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_MIN,   2,                                api_processor_parse_get_event,          "Get event")                        \
+    ENTRY(MROVER_CC_GET_VERSION,                     COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, GET_VERSION_RESPONSE_PAYLOAD_LEN, api_processor_parse_get_version,        "Get version")                      \
+    ENTRY(MROVER_CC_RESET,                           COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Reset")                            \
+    ENTRY(MROVER_CC_FACTORY_RESET,                   COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Factory reset")                    \
+    ENTRY(MROVER_CC_SWITCH_NETWORK,                  COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Switch network")                   \
+    ENTRY(MROVER_CC_INIT_LORAWAN,                    COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Init Lorawan")                     \
+    ENTRY(MROVER_CC_SET_JOIN_EUI,                    COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set Join Eui")                     \
+    ENTRY(MROVER_CC_SET_DEV_EUI,                     COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set Dev Eui")                      \
+    ENTRY(MROVER_CC_SET_NW_KEY,                      COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set Network key")                  \
+    ENTRY(MROVER_CC_GET_DEV_EUI,                     COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, LORAWAN_DEV_EUI_JOIN_EUI_LEN,     api_processor_parse_eui_cmd,            "Dev eui")                          \
+    ENTRY(MROVER_CC_GET_JOIN_EUI,                    COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, LORAWAN_DEV_EUI_JOIN_EUI_LEN,     api_processor_parse_eui_cmd,            "Join eui")                         \
+    ENTRY(MROVER_CC_JOIN_LORAWAN,                    COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Join Lorawan")                     \
+    ENTRY(MROVER_CC_REQUEST_UPLINK,                  COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_MIN,   1,                                api_processor_handle_request_uplink,    "Request uplink")                   \
+    ENTRY(MROVER_CC_LEAVE_LORAWAN_NETWORK,           COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Leave Lorawan Network")            \
+    ENTRY(MROVER_CC_STOP_SID_LORAWAN_NETWORK,        COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Stop Sidewalk Network")            \
+    ENTRY(MROVER_CC_BLE_LINK_REQUEST,                COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "BLE Link Request")                 \
+    ENTRY(MROVER_CC_BLE_CONNECTION_REQUEST,          COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "BLE Connection Request")           \
+    ENTRY(MROVER_CC_FSK_LINK_REQUEST,                COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "FSK Link Request")                 \
+    ENTRY(MROVER_CC_CSS_LINK_REQUEST,                COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "CSS Link Request")                 \
+    ENTRY(MROVER_CC_SET_CSS_PWR_PROFILE,             COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set CSS Power Profile")            \
+    ENTRY(MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK, COMMAND_TYPE_SIDEWALK, MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set downlink filtering command")   \
+    ENTRY(MROVER_CC_GET_LORAWAN_CLASS,               COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 1,                                api_processor_parse_get_class_cmd,      "Get Class status")                 \
+    ENTRY(MROVER_CC_SET_LORAWAN_CLASS,               COMMAND_TYPE_LORAWAN,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Set New class")                    \
+    ENTRY(MROVER_CC_START_FILE_TRANSFER,             COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Start File Transfer")              \
+    ENTRY(MROVER_CC_FILE_STATUS,                     COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, sizeof(get_seg_file_status_t),    api_processor_parse_get_file_status,    "Get File Status")                  \
+    ENTRY(MROVER_CC_TRIGGER_FW_UPDATE,               COMMAND_TYPE_GENERAL,  MROVER_RSP_LEN_EXACT, 0,                                NULL,                                   "Trigger FW Update")
+
 /**
  * @brief Type of the event returned by the mcm module 
  *         Oxtech guide 4.5.3.1 
@@ -79,6 +79,16 @@ extern "C" {
 /**********************************************************************************************************
  * MACROS AND DEFINES
  **********************************************************************************************************/
+/**
+ * @brief Response frame overhead, 1 byte return code, 1 byte command type,
+ *        2 byte command code, 2 byte length and 1 byte crc
+ */
+#define FP_RESPONSE_FRAME_OVERHEAD                  7
+
+/**
+ * @brief Number of header bytes in a response frame before the payload
+ */
+#define FP_RESPONSE_HEADER_LEN                      6
 
 /**********************************************************************************************************
  * TYPEDEFS
@@ -95,6 +105,47 @@ typedef enum {
 
 }fp_api_status_t;
 
+/**
+ * @brief Header of a received frame, see fp_decode_frame_header()
+ */
+typedef struct
+{
+    uint8_t u8_return_code;         // MROVER_RC_NOTIFY_EVENTS for a notify frame
+    uint8_t u8_cmd_type;            // response frame only
+    uint16_t u16_cmd_code;          // response frame only
+    uint16_t u16_payload_len;       // response frame only, bytes between the header and the crc
+    uint8_t u8_pending_events;      // notify frame only
+    uint8_t u8_crc;                 // XOR of the bytes decoded, 0 for a whole valid frame
+} fp_frame_header_t;
+
+/**
+ * @brief Callback invoked by the reassembler for every complete and CRC valid frame
+ *
+ * The frame buffer is owned by the reassembler and is only valid for the
+ * duration of the callback.
+ */
+typedef void (*fp_frame_cb)(uint8_t *p_frame, uint16_t u16_len, void *user_context);
+
+/**
+ * @brief State of the streaming frame reassembler
+ *
+ * Bytes can be fed at any boundary, the reassembler keeps the partially
+ * received frame between the calls. Private members need not to be accessed directly.
+ */
+typedef struct
+{
+    uint8_t u8_buffer[MAX_SERIAL_RECEIVE_PAYLOAD_SIZE]; // partially received frame
+    uint16_t u16_index;                                 // number of bytes present in the buffer
+    uint8_t u8_buffer_crc;                              // XOR of the bytes present in the buffer
+    bool b_resyncing;                                   // bytes are being dropped since the last frame
+    uint32_t u32_bytes_in;                              // number of bytes fed
+    uint32_t u32_frames_count;                          // number of complete frames emitted
+    uint32_t u32_dropped_bytes;                         // number of bytes discarded while resyncing
+    uint32_t u32_crc_errors;                            // number of candidate frames with invalid crc
+    uint32_t u32_length_errors;                         // number of candidate frames with invalid length
+    uint32_t u32_resync_count;                          // number of runs of discarded bytes
+} fp_reassembler_t;
+
 /**********************************************************************************************************
  * EXPORTED VARIABLES
  **********************************************************************************************************/
@@ -113,79 +164,88 @@ typedef enum {
 fp_api_status_t fp_append_crc(uint8_t *data,uint16_t len);
 
 /**
- * @brief Check if the frame is valid
+ * @brief This function updates the running CRC with the given data.
+ *
+ * It allows the CRC of a frame to be calculated over the parts of the frame
+ * which are not contiguous in memory. Start with the CRC value 0.
+ *
+ * @param[in] u8_crc CRC calculated so far.
+ * @param[in] p_data Pointer to the next part of the frame.
+ * @param[in] u16_len Length of the next part of the frame.
+ *
+ * @return The updated CRC.
+ */
+uint8_t fp_crc_update(uint8_t u8_crc, const uint8_t *p_data, uint16_t u16_len);
+
+/**
+ * @brief Decodes the header of a response frame, or a whole notify frame, in one pass
  *
- * This function checks if the frame is valid by checking for
- * the return code, command type and command code and the CRC
+ * Every byte is read once, checked against the frame format and added to the CRC, so
+ * a bad frame is rejected at its first invalid byte. A response frame is checked up
+ * to its length field, its payload and CRC byte are left to the caller, which decodes
+ * them and finishes the CRC with fp_crc_update() on the same pass. A notify frame is
+ * always MIN_RX_PAYLOAD_LEN bytes, its pending event count and CRC are checked here.
  *
- * @param[in] data Pointer to the frame data
- * @param[in] len Length of the frame data
+ * @param[in] p_data Pointer to the frame data
+ * @param[in] u16_len Length of the frame data
+ * @param[out] p_header Decoded header
  *
- * @retval FP_SUCCESS The frame is valid
- * @retval FP_INVALID_PARAMETERS Invalid data pointer or length
+ * @retval FP_SUCCESS The header is valid, for a notify frame the whole frame is valid
+ * @retval FP_INVALID_PARAMETERS Invalid pointer, frame shorter than MIN_RX_PAYLOAD_LEN,
+ *         longer than MAX_SERIAL_RECEIVE_PAYLOAD_SIZE or length field not matching the frame length
  * @retval FP_INVALID_RETURN_CODE Invalid return code in the frame
  * @retval FP_INVALID_COMMAND_TYPE Invalid command type in the frame
  * @retval FP_INVALID_COMMAND_CODE Invalid command code in the frame
- * @retval FP_INVALID_CRC Invalid CRC in the frame
- * @retval FP_ERROR Generic error
- *
+ * @retval FP_INVALID_CRC Invalid CRC of a notify frame
+ * @retval FP_ERROR Pending event count of a notify frame above MAX_PENDING_MESSAGES
  */
-fp_api_status_t fp_is_valid_response_frame(uint8_t *data, uint16_t len);
+fp_api_status_t fp_decode_frame_header(const uint8_t *p_data, uint16_t u16_len, fp_frame_header_t *p_header);
 
 /**
- * @brief Check if the frame is notification or response
+ * @brief Initializes the streaming frame reassembler
  *
+ * @param[out] p_reassembler Pointer to the reassembler state
  *
- * @param[in] data Pointer to the frame data
- * @param[in] len Length of the frame data
- *
- * @retval true The frame is notification
- * @retval false The frame is response
- *
+ * @retval FP_SUCCESS The reassembler is initialized
+ * @retval FP_INVALID_PARAMETERS Invalid reassembler pointer
  */
-bool fp_is_frame_notification(uint8_t *data, uint16_t len);
+fp_api_status_t fp_reassembler_init(fp_reassembler_t *p_reassembler);
 
 /**
- * @brief Check if the frame is a valid notify frame
+ * @brief Feeds received bytes to the streaming frame reassembler
  *
- * This function checks if the frame is valid notify frame by checking for
- * the return code and the notification code.
+ * The bytes can be split or merged at any boundary. Every complete notify or
+ * response frame is passed to the callback in the order it was received. If the
+ * header or the CRC of a candidate frame is invalid, the first byte is dropped and
+ * the buffered bytes are rescanned, so the next valid frame is not lost.
  *
- * @param[in] data Pointer to the frame data
- * @param[in] len Length of the frame data
- *
- * @retval FP_SUCCESS The frame is valid notify frame
- * @retval FP_INVALID_PARAMETERS Invalid data pointer or length
- * @retval FP_INVALID_RETURN_CODE Invalid return code in the frame
- * @retval FP_INVALID_COMMAND_CODE Invalid command code in the frame
- * @retval FP_ERROR Generic error
+ * @param[in,out] p_reassembler Pointer to the reassembler state
+ * @param[in] p_data Pointer to the received bytes
+ * @param[in] u16_len Number of received bytes
+ * @param[in] frame_cb Callback invoked for every complete frame
+ * @param[in] user_context User context passed to the callback
  *
+ * @retval FP_SUCCESS All bytes are consumed
+ * @retval FP_INVALID_PARAMETERS Invalid reassembler, data pointer or callback
  */
-fp_api_status_t fp_is_valid_notify_frame(uint8_t *data, uint16_t len);
+fp_api_status_t fp_reassembler_feed(fp_reassembler_t *p_reassembler, const uint8_t *p_data, uint16_t u16_len, fp_frame_cb frame_cb, void *user_context);
 
 /**
- * @brief This function returns the number of pending events.
+ * @brief Check if the reassembler holds a partially received frame
  *
- * @param[in] data Pointer to the notification frame received.
- * @param[in] len Length of the notification frame.
+ * @param[in] p_reassembler Pointer to the reassembler state
  *
- * @return The number of pending events.
+ * @retval true Part of a frame is received, rest of the bytes are awaited
+ * @retval false No partial frame is buffered
  */
-uint8_t fp_get_pending_event_count(uint8_t *data, uint16_t len);
+bool fp_reassembler_has_partial_frame(const fp_reassembler_t *p_reassembler);
 
 /**
- * @brief Check if the frame is a single frame.
- *
- * This function checks if the frame is a single frame by checking if the first
- * byte is MROVER_RC_NOTIFY_EVENTS and the length is MIN_RX_PAYLOAD_LEN.
- *
- * @param[in] p_data Pointer to the frame data.
- * @param[in] u16_len Length of the frame.
+ * @brief Clears the statistics counters of the reassembler, the buffered bytes are kept
  *
- * @retval true The frame is a single frame.
- * @retval false The frame is not a single frame.
+ * @param[in,out] p_reassembler Pointer to the reassembler state
  */
-bool fp_is_single_frame(uint8_t *p_data,uint16_t u16_len);
+void fp_reassembler_clear_counters(fp_reassembler_t *p_reassembler);
 
 
 
@@ -68,7 +68,9 @@
  * INCLUDES
  ******************************************************************************/
 #include "frame_parse.h"
+#include "checksum.h"
 #include <stdbool.h>
+#include <string.h>
 
 /******************************************************************************
  * EXTERN VARIABLES
@@ -77,14 +79,37 @@
 /******************************************************************************
  * PRIVATE MACROS AND DEFINES
  ******************************************************************************/
+#define TRACE_MODULE_LEVEL                  TRACE_LEVEL_FRAME_PARSER
+
+#define FP_COMMAND_SLOT_ENTRY(cc, type, rsp_len_policy, rsp_len, parser, name)    [MROVER_CC_TABLE_SLOT(cc)] = {(cc), (type)},
 
 /******************************************************************************
  * PRIVATE TYPEDEFS
  ******************************************************************************/
+typedef enum
+{
+    FP_CANDIDATE_INCOMPLETE = 0,    // header is valid so far, more bytes are needed
+    FP_CANDIDATE_COMPLETE,          // complete frame with valid crc is available
+    FP_CANDIDATE_INVALID,           // header is invalid, buffer needs resync
+    FP_CANDIDATE_BAD_LENGTH,        // length field is out of range, buffer needs resync
+    FP_CANDIDATE_BAD_CRC            // frame is complete but crc is invalid, buffer needs resync
+} fp_candidate_status_t;
+
+typedef struct
+{
+    uint16_t u16_cmd_code;
+    uint8_t u8_cmd_type;
+} fp_command_slot_t;
 
 /******************************************************************************
  * STATIC VARIABLES
  ******************************************************************************/
+/**
+ * @brief Command codes known to the frame parser, indexed by MROVER_CC_TABLE_SLOT
+ */
+static const fp_command_slot_t fp_command_slots[MROVER_CC_TABLE_SIZE] = {
+    MROVER_COMMAND_LIST(FP_COMMAND_SLOT_ENTRY)
+};
 
 /******************************************************************************
  * GLOBAL VARIABLES
@@ -108,13 +133,7 @@
  */
 static uint8_t fp_calculate_crc(uint8_t *u8_data, uint16_t u16_len)
 {
-    uint8_t u8_crc = 0;
-    for (uint16_t u16_index = 0; u16_index < u16_len; u16_index++)
-    {
-        u8_crc ^= u8_data[u16_index];
-    }
-
-    return u8_crc;
+    return checksum_xor8_update(CHECKSUM_XOR8_INIT, u8_data, u16_len);
 }
 
 /**
@@ -180,47 +199,116 @@ static bool is_valid_command_type(uint8_t u8_command_type)
  */
 static bool is_valid_command_code(uint16_t u16_command_code)
 {
-    bool b_is_valid_command_code = false;
+    const fp_command_slot_t *p_slot = &fp_command_slots[MROVER_CC_TABLE_SLOT(u16_command_code)];
+
+    // empty slots have command type 0, which is not a valid command type
+    return ((0 != p_slot->u8_cmd_type) && (u16_command_code == p_slot->u16_cmd_code)) ? true : false;
+}
+
+/**
+ * @brief This function checks the bytes buffered at the start of the reassembler
+ *        against the notify and the response frame format
+ *
+ * Only the bytes already received are checked, so it can be called after every
+ * byte. The buffer may hold more bytes than the candidate frame.
+ *
+ * @param[in] p_data Pointer to the buffered bytes
+ * @param[in] u16_len Number of buffered bytes
+ * @param[in] u8_buffer_crc XOR of all the buffered bytes, checked instead of the frame
+ *            when the buffer holds exactly the candidate frame
+ * @param[out] p_frame_len Length of the complete frame, valid for FP_CANDIDATE_COMPLETE
+ * @return Status of the candidate frame
+ */
+static fp_candidate_status_t fp_check_candidate_frame(const uint8_t *p_data, uint16_t u16_len, uint8_t u8_buffer_crc, uint16_t *p_frame_len)
+{
+    fp_candidate_status_t candidate_status = FP_CANDIDATE_INVALID;
+    uint16_t u16_frame_len = 0;
 
-    switch (u16_command_code)
+    do
     {
-        // intentional fall through for the cases
-    case MROVER_CC_GET_EVENT:
-    case MROVER_CC_GET_VERSION:
-    case MROVER_CC_RESET:
-    case MROVER_CC_FACTORY_RESET:
-    case MROVER_CC_SWITCH_NETWORK:
-    case MROVER_CC_INIT_LORAWAN:
-    case MROVER_CC_SET_JOIN_EUI:
-    case MROVER_CC_SET_DEV_EUI:
-    case MROVER_CC_SET_NW_KEY:
-    case MROVER_CC_GET_DEV_EUI:
-    case MROVER_CC_GET_JOIN_EUI:
-    case MROVER_CC_JOIN_LORAWAN:
-    case MROVER_CC_REQUEST_UPLINK:
-    case MROVER_CC_LEAVE_LORAWAN_NETWORK:
-    case MROVER_CC_STOP_SID_LORAWAN_NETWORK:
-    case MROVER_CC_BLE_LINK_REQUEST:
-    case MROVER_CC_BLE_CONNECTION_REQUEST:
-    case MROVER_CC_FSK_LINK_REQUEST:
-    case MROVER_CC_CSS_LINK_REQUEST:
-    case MROVER_CC_SET_CSS_PWR_PROFILE:
-    case MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK:
-    case MROVER_CC_GET_LORAWAN_CLASS:
-    case MROVER_CC_SET_LORAWAN_CLASS:
-    case MROVER_CC_START_FILE_TRANSFER:
-    case MROVER_CC_FILE_STATUS:
-    case MROVER_CC_TRIGGER_FW_UPDATE:
-        b_is_valid_command_code = true;
-        
-        break;
-    
-    default:
-        break;
-    }
+        if (false == is_valid_response_code(p_data[0]))
+        {
+            break;
+        }
+
+        if (MROVER_RC_NOTIFY_EVENTS == p_data[0])
+        {
+            // notify frame is always MIN_RX_PAYLOAD_LEN, [0x20][len_hi][len_lo][pending][crc]
+            if ((u16_len >= 3) && (LENGTH_IN_NOTIFICATION_PAYLOAD != ((p_data[1] << 8) | p_data[2])))
+            {
+                candidate_status = FP_CANDIDATE_BAD_LENGTH;
+                break;
+            }
+
+            if ((u16_len >= 4) && (MAX_PENDING_MESSAGES < p_data[3]))
+            {
+                break;
+            }
+
+            u16_frame_len = MIN_RX_PAYLOAD_LEN;
+        }
+        else
+        {
+            if ((u16_len >= 2) && (false == is_valid_command_type(p_data[1])))
+            {
+                break;
+            }
+
+            if ((u16_len >= 4) && (false == is_valid_command_code((p_data[2] << 8) | p_data[3])))
+            {
+                break;
+            }
+
+            if (u16_len < FP_RESPONSE_HEADER_LEN)
+            {
+                candidate_status = FP_CANDIDATE_INCOMPLETE;
+                break;
+            }
+
+            uint16_t u16_payload_len = (p_data[4] << 8) | p_data[5];
+            if ((MAX_SERIAL_RECEIVE_PAYLOAD_SIZE - FP_RESPONSE_FRAME_OVERHEAD) < u16_payload_len)
+            {
+                candidate_status = FP_CANDIDATE_BAD_LENGTH;
+                break;
+            }
+
+            u16_frame_len = FP_RESPONSE_FRAME_OVERHEAD + u16_payload_len;
+        }
+
+        if (u16_len < u16_frame_len)
+        {
+            candidate_status = FP_CANDIDATE_INCOMPLETE;
+            break;
+        }
+
+        // XOR of a frame including its crc byte is 0, the running XOR saves a pass over the frame
+        uint8_t u8_frame_crc = (u16_len == u16_frame_len) ? u8_buffer_crc : fp_calculate_crc((uint8_t *)p_data, u16_frame_len);
+        if (0 != u8_frame_crc)
+        {
+            TRACE_INFO("Invalid CRC, resyncing the frame\n");
+            candidate_status = FP_CANDIDATE_BAD_CRC;
+            break;
+        }
+
+        *p_frame_len = u16_frame_len;
+        candidate_status = FP_CANDIDATE_COMPLETE;
+    } while (0);
 
-    return b_is_valid_command_code;
+    return candidate_status;
+}
 
+/**
+ * @brief This function removes the given number of bytes from the start of the
+ *        reassembler buffer and moves the remaining bytes to the front
+ *
+ * @param[in,out] p_reassembler Pointer to the reassembler state
+ * @param[in] u16_count Number of bytes to be removed
+ */
+static void fp_reassembler_discard(fp_reassembler_t *p_reassembler, uint16_t u16_count)
+{
+    p_reassembler->u8_buffer_crc = checksum_xor8_update(p_reassembler->u8_buffer_crc, p_reassembler->u8_buffer, u16_count);
+    p_reassembler->u16_index -= u16_count;
+    memmove(p_reassembler->u8_buffer, &p_reassembler->u8_buffer[u16_count], p_reassembler->u16_index);
 }
 
 
@@ -270,135 +358,219 @@ fp_api_status_t fp_append_crc(uint8_t *data,uint16_t len)
 }
 
 
-fp_api_status_t fp_is_valid_response_frame(uint8_t *data, uint16_t len)
+uint8_t fp_crc_update(uint8_t u8_crc, const uint8_t *p_data, uint16_t u16_len)
+{
+    if (NULL != p_data)
+    {
+        u8_crc ^= fp_calculate_crc((uint8_t *)p_data, u16_len);
+    }
+
+    return u8_crc;
+}
+
+
+fp_api_status_t fp_decode_frame_header(const uint8_t *p_data, uint16_t u16_len, fp_frame_header_t *p_header)
 {
     fp_api_status_t return_status = FP_ERROR;
 
     do
     {
-        if (false == is_valid_response_code(data[0]))
+        // frame can come from outside of the reassembler, so trust no length
+        if ((NULL == p_data) || (NULL == p_header) || (MIN_RX_PAYLOAD_LEN > u16_len) || (MAX_SERIAL_RECEIVE_PAYLOAD_SIZE < u16_len))
         {
-            TRACE_INFO("Invalid response code %d\n", data[0]);
+            TRACE_INFO("Invalid frame length %d\n", u16_len);
+            return_status = FP_INVALID_PARAMETERS;
+            break;
+        }
+
+        p_header->u8_return_code = p_data[0];
+        p_header->u8_crc = p_data[0];
+        if (false == is_valid_response_code(p_data[0]))
+        {
+            TRACE_INFO("Invalid response code %d\n", p_data[0]);
             return_status = FP_INVALID_RETURN_CODE;
             break;
         }
 
-        if (false == is_valid_command_type(data[1]))
+        if (MROVER_RC_NOTIFY_EVENTS == p_data[0])
         {
-            TRACE_INFO("Invalid command code %d\n", data[1]);
-            return_status = FP_INVALID_COMMAND_TYPE;
+            // [0x20][len_hi][len_lo][pending][crc]
+            uint16_t u16_notify_len = (p_data[1] << 8) | p_data[2];
+            p_header->u8_crc ^= p_data[1] ^ p_data[2];
+            if ((LENGTH_IN_NOTIFICATION_PAYLOAD != u16_notify_len) || (MIN_RX_PAYLOAD_LEN != u16_len))
+            {
+                TRACE_INFO("Invalid length for notification %d\n", u16_notify_len);
+                return_status = FP_INVALID_PARAMETERS;
+                break;
+            }
+
+            p_header->u8_pending_events = p_data[3];
+            p_header->u8_crc ^= p_data[3];
+            if (MAX_PENDING_MESSAGES < p_data[3])
+            {
+                TRACE_INFO("Invalid pending messages %d\n", p_data[3]);
+                break;
+            }
+
+            p_header->u8_crc ^= p_data[4];
+            if (0 != p_header->u8_crc)
+            {
+                TRACE_INFO("Invalid CRC for the notification frame\n");
+                return_status = FP_INVALID_CRC;
+                break;
+            }
+
+            return_status = FP_SUCCESS;
+            break;
+        }
+
+        if (FP_RESPONSE_FRAME_OVERHEAD > u16_len)
+        {
+            TRACE_INFO("Invalid response frame length %d\n", u16_len);
+            return_status = FP_INVALID_PARAMETERS;
             break;
         }
 
-        uint16_t u16_command_code = (data[2] << 8) | data[3];
-        if (false == is_valid_command_code(u16_command_code))
+        p_header->u8_cmd_type = p_data[1];
+        p_header->u8_crc ^= p_data[1];
+        if (false == is_valid_command_type(p_data[1]))
         {
-            TRACE_INFO("Invalid command code %d\n", u16_command_code);
+            TRACE_INFO("Invalid command type %d\n", p_data[1]);
             return_status = FP_INVALID_COMMAND_TYPE;
             break;
         }
 
-        // check for crc
+        p_header->u16_cmd_code = (p_data[2] << 8) | p_data[3];
+        p_header->u8_crc ^= p_data[2] ^ p_data[3];
+        if (false == is_valid_command_code(p_header->u16_cmd_code))
+        {
+            TRACE_INFO("Invalid command code %d\n", p_header->u16_cmd_code);
+            return_status = FP_INVALID_COMMAND_CODE;
+            break;
+        }
 
-        uint8_t crc = fp_calculate_crc(data, len - 1);
-        if (crc != data[len - 1])
+        p_header->u16_payload_len = (p_data[4] << 8) | p_data[5];
+        p_header->u8_crc ^= p_data[4] ^ p_data[5];
+        if ((FP_RESPONSE_FRAME_OVERHEAD + p_header->u16_payload_len) != u16_len)
         {
-            TRACE_INFO("Invalid CRC\n");
-            return_status = FP_INVALID_CRC;
+            TRACE_INFO("Response payload length %d does not match the frame length %d\n", p_header->u16_payload_len, u16_len);
+            return_status = FP_INVALID_PARAMETERS;
             break;
         }
 
         return_status = FP_SUCCESS;
-
     } while (0);
 
     return return_status;
 }
 
 
-bool fp_is_frame_notification(uint8_t *data, uint16_t len)
-{
-   return (MROVER_RC_NOTIFY_EVENTS == data[0]?true:false);
-}
-
-
-fp_api_status_t fp_is_valid_notify_frame(uint8_t *data, uint16_t len)
+fp_api_status_t fp_reassembler_init(fp_reassembler_t *p_reassembler)
 {
     fp_api_status_t return_status = FP_ERROR;
 
     do
-    {   
-        // validate crc
-        uint8_t crc = fp_calculate_crc(data, len - 1);
-        if (crc != data[len - 1])
+    {
+        if (NULL == p_reassembler)
         {
-            TRACE_INFO("Invalid CRC for the notification frame\n");
-            return_status = FP_INVALID_CRC;
+            TRACE_INFO("Reassembler pointer cannot be NULL\n");
+            return_status = FP_INVALID_PARAMETERS;
             break;
         }
 
-        uint16_t u16_len = (data[1] << 8) | data[2];
+        memset(p_reassembler, 0, sizeof(fp_reassembler_t));
+        return_status = FP_SUCCESS;
+    } while (0);
+
+    return return_status;
+}
+
 
-        if(LENGTH_IN_NOTIFICATION_PAYLOAD != u16_len)
+fp_api_status_t fp_reassembler_feed(fp_reassembler_t *p_reassembler, const uint8_t *p_data, uint16_t u16_len, fp_frame_cb frame_cb, void *user_context)
+{
+    fp_api_status_t return_status = FP_ERROR;
+
+    do
+    {
+        if ((NULL == p_reassembler) || (NULL == p_data) || (NULL == frame_cb))
         {
-            TRACE_INFO("Invalid length for notification %d\n", u16_len);
+            TRACE_INFO("Invalid parameters for the reassembler\n");
+            return_status = FP_INVALID_PARAMETERS;
             break;
         }
 
-        uint8_t u8_pending_messages = data[3];
-        if(MAX_PENDING_MESSAGES < u8_pending_messages)
+        p_reassembler->u32_bytes_in += u16_len;
+        for (uint16_t u16_index = 0; u16_index < u16_len; u16_index++)
         {
-            TRACE_INFO("Invalid pending messages %d\n", u8_pending_messages);
-            break;
+            p_reassembler->u8_buffer[p_reassembler->u16_index++] = p_data[u16_index];
+            p_reassembler->u8_buffer_crc ^= p_data[u16_index];
+
+            // rescan the buffer until more bytes are needed, a frame may be followed by
+            // the start of the next one after a resync
+            while (p_reassembler->u16_index > 0)
+            {
+                uint16_t u16_frame_len = 0;
+                fp_candidate_status_t candidate_status = fp_check_candidate_frame(p_reassembler->u8_buffer, p_reassembler->u16_index,
+                                                                                  p_reassembler->u8_buffer_crc, &u16_frame_len);
+
+                if (FP_CANDIDATE_INCOMPLETE == candidate_status)
+                {
+                    break;
+                }
+
+                if (FP_CANDIDATE_COMPLETE == candidate_status)
+                {
+                    p_reassembler->b_resyncing = false;
+                    p_reassembler->u32_frames_count++;
+                    frame_cb(p_reassembler->u8_buffer, u16_frame_len, user_context);
+                    fp_reassembler_discard(p_reassembler, u16_frame_len);
+                    continue;
+                }
+
+                if (FP_CANDIDATE_BAD_CRC == candidate_status)
+                {
+                    p_reassembler->u32_crc_errors++;
+                }
+                else if (FP_CANDIDATE_BAD_LENGTH == candidate_status)
+                {
+                    p_reassembler->u32_length_errors++;
+                }
+
+                // a run of dropped bytes is one resync
+                if (false == p_reassembler->b_resyncing)
+                {
+                    p_reassembler->b_resyncing = true;
+                    p_reassembler->u32_resync_count++;
+                }
+
+                // invalid candidate, drop the first byte and look for the next frame start
+                p_reassembler->u32_dropped_bytes++;
+                fp_reassembler_discard(p_reassembler, 1);
+            }
         }
 
         return_status = FP_SUCCESS;
-    }while(0);
+    } while (0);
 
     return return_status;
 }
 
 
-uint8_t fp_get_pending_event_count(uint8_t *data, uint16_t len)
+void fp_reassembler_clear_counters(fp_reassembler_t *p_reassembler)
 {
-    return data[3];
-}
-
-
-bool fp_is_single_frame(uint8_t *p_data,uint16_t u16_len)
-{   
-    bool b_return_value = false;
-    // check if first byte is MROVER_RC_NOTIFY_EVENTS
-    if(MROVER_RC_NOTIFY_EVENTS == p_data[0])
+    if (NULL != p_reassembler)
     {
-        if(MIN_RX_PAYLOAD_LEN < u16_len) // as the notification frame is always MIN_RX_PAYLOAD_LEN
-        {
-            b_return_value = false;
-        }
-        else
-        {
-            b_return_value = true;
-        }
+        p_reassembler->u32_bytes_in = 0;
+        p_reassembler->u32_frames_count = 0;
+        p_reassembler->u32_dropped_bytes = 0;
+        p_reassembler->u32_crc_errors = 0;
+        p_reassembler->u32_length_errors = 0;
+        p_reassembler->u32_resync_count = 0;
     }
+}
 
-    else
-    {
-        // decode for the response frame
-        uint16_t u16_command_len = (p_data[4] << 8) | p_data[5];
-        // 1 byte return code, 1 byte command code 
-        // 2 byte command code 2 byte length 
-        // u16_command_len payload length
-        // 1 byte crc
-        uint16_t rec_total_len = 1 + 1 + 2 + 2 + u16_command_len + 1;
-        if(rec_total_len == u16_len)
-        {
-            b_return_value = true; // single frame
-        }
-        else
-        {
-            b_return_value = false; // multiple frame
-        }
-    }
 
-    return b_return_value;
-}
\ No newline at end of file
+bool fp_reassembler_has_partial_frame(const fp_reassembler_t *p_reassembler)
+{
+    return ((NULL != p_reassembler) && (0 != p_reassembler->u16_index)) ? true : false;
+}
@@ -0,0 +1,274 @@
+/**
+ * @file fw_digest.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief SHA-256 of a firmware image, computed while the image is received.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fw_digest.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define FW_DIGEST_HEX_LEN   (2 * SHA256_DIGEST_SIZE)
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static int8_t fw_digest_hex_value(uint8_t u8_char);
+static void fw_digest_keep(uint8_t *p_dest, uint32_t u32_dest_start, uint32_t u32_dest_len, uint32_t u32_offset,
+                           const uint8_t *p_data, uint32_t u32_len);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static int8_t fw_digest_hex_value(uint8_t u8_char)
+{
+    if ((u8_char >= '0') && (u8_char <= '9'))
+    {
+        return u8_char - '0';
+    }
+    if ((u8_char >= 'a') && (u8_char <= 'f'))
+    {
+        return u8_char - 'a' + 10;
+    }
+    if ((u8_char >= 'A') && (u8_char <= 'F'))
+    {
+        return u8_char - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Copies the part of the data falling in [u32_dest_start, u32_dest_start + u32_dest_len) of the image
+ */
+static void fw_digest_keep(uint8_t *p_dest, uint32_t u32_dest_start, uint32_t u32_dest_len, uint32_t u32_offset,
+                           const uint8_t *p_data, uint32_t u32_len)
+{
+    uint32_t u32_start = (u32_offset > u32_dest_start) ? u32_offset : u32_dest_start;
+    uint32_t u32_end = u32_offset + u32_len;
+
+    if (u32_end > (u32_dest_start + u32_dest_len))
+    {
+        u32_end = u32_dest_start + u32_dest_len;
+    }
+    if (u32_start < u32_end)
+    {
+        memcpy(&p_dest[u32_start - u32_dest_start], &p_data[u32_start - u32_offset], u32_end - u32_start);
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+void fw_digest_begin(fw_digest_t *p_digest, uint32_t u32_image_size, const uint8_t *p_expected)
+{
+    if (NULL == p_digest)
+    {
+        return;
+    }
+
+    memset(p_digest, 0, sizeof(fw_digest_t));
+    sha256_init(&p_digest->h_sha);
+    p_digest->u32_image_size = u32_image_size;
+    p_digest->b_has_expected = (NULL != p_expected);
+    if (p_digest->b_has_expected)
+    {
+        memcpy(p_digest->u8_expected, p_expected, SHA256_DIGEST_SIZE);
+        p_digest->u32_hash_end = u32_image_size;
+    }
+    else if (u32_image_size > (FW_DIGEST_IMAGE_HEADER_SIZE + SHA256_DIGEST_SIZE))
+    {
+        p_digest->u32_hash_end = u32_image_size - SHA256_DIGEST_SIZE;
+    }
+    else
+    {
+        // too short to carry a digest, hashed anyway so the cost does not depend on it
+        p_digest->u32_hash_end = u32_image_size;
+    }
+}
+
+void fw_digest_update(fw_digest_t *p_digest, const uint8_t *p_data, uint32_t u32_len)
+{
+    if ((NULL == p_digest) || (NULL == p_data) || (p_digest->u32_offset >= p_digest->u32_image_size))
+    {
+        return;
+    }
+    if (u32_len > (p_digest->u32_image_size - p_digest->u32_offset))
+    {
+        u32_len = p_digest->u32_image_size - p_digest->u32_offset;
+    }
+
+    if (p_digest->u32_offset < p_digest->u32_hash_end)
+    {
+        uint32_t u32_hash_len = p_digest->u32_hash_end - p_digest->u32_offset;
+        sha256_update(&p_digest->h_sha, p_data, (u32_len < u32_hash_len) ? u32_len : u32_hash_len);
+    }
+    fw_digest_keep(p_digest->u8_header, 0, FW_DIGEST_IMAGE_HEADER_SIZE, p_digest->u32_offset, p_data, u32_len);
+    if (p_digest->u32_image_size >= SHA256_DIGEST_SIZE)
+    {
+        fw_digest_keep(p_digest->u8_tail, p_digest->u32_image_size - SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE,
+                       p_digest->u32_offset, p_data, u32_len);
+    }
+    p_digest->u32_offset += u32_len;
+}
+
+fw_digest_result_t fw_digest_check(fw_digest_t *p_digest)
+{
+    uint8_t u8_digest[SHA256_DIGEST_SIZE];
+    const uint8_t *p_expected;
+
+    if (NULL == p_digest)
+    {
+        return FW_DIGEST_MISMATCH;
+    }
+
+    sha256_final(&p_digest->h_sha, u8_digest);
+    if (p_digest->u32_offset != p_digest->u32_image_size)
+    {
+        return FW_DIGEST_MISMATCH;
+    }
+
+    if (p_digest->b_has_expected)
+    {
+        p_expected = p_digest->u8_expected;
+    }
+    else if ((p_digest->u32_hash_end != p_digest->u32_image_size) &&
+             (FW_DIGEST_IMAGE_MAGIC == p_digest->u8_header[0]) &&
+             (1 == p_digest->u8_header[FW_DIGEST_HASH_APPENDED_OFFSET]))
+    {
+        p_expected = p_digest->u8_tail;
+    }
+    else
+    {
+        return FW_DIGEST_NONE;
+    }
+
+    return (0 == memcmp(u8_digest, p_expected, SHA256_DIGEST_SIZE)) ? FW_DIGEST_MATCH : FW_DIGEST_MISMATCH;
+}
+
+bool fw_digest_parse_header(const uint8_t *p_fields, uint16_t u16_len, uint8_t *p_expected)
+{
+    uint16_t u16_pos = 0;
+
+    if ((NULL == p_fields) || (NULL == p_expected))
+    {
+        return false;
+    }
+
+    while (u16_pos < u16_len)
+    {
+        uint16_t u16_start;
+
+        while ((u16_pos < u16_len) && (' ' == p_fields[u16_pos]))
+        {
+            u16_pos++;
+        }
+        u16_start = u16_pos;
+        while ((u16_pos < u16_len) && (' ' != p_fields[u16_pos]) && ('\0' != p_fields[u16_pos]))
+        {
+            u16_pos++;
+        }
+
+        if ((u16_pos - u16_start) == FW_DIGEST_HEX_LEN)
+        {
+            uint8_t i;
+            for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+            {
+                int8_t i8_high = fw_digest_hex_value(p_fields[u16_start + 2 * i]);
+                int8_t i8_low = fw_digest_hex_value(p_fields[u16_start + 2 * i + 1]);
+                if ((i8_high < 0) || (i8_low < 0))
+                {
+                    break;
+                }
+                p_expected[i] = (uint8_t)((i8_high << 4) | i8_low);
+            }
+            if (SHA256_DIGEST_SIZE == i)
+            {
+                return true;
+            }
+        }
+
+        if ((u16_pos < u16_len) && ('\0' == p_fields[u16_pos]))
+        {
+            // the fields end at the first null
+            break;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file fw_digest.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the SHA-256 of a firmware image, computed while the image is received.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __FW_DIGEST_H__
+#define __FW_DIGEST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sha256.h"
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define FW_DIGEST_IMAGE_MAGIC           0xE9    // first byte of an esp32 application image
+#define FW_DIGEST_HASH_APPENDED_OFFSET  23      // hash_appended of esp_image_header_t
+#define FW_DIGEST_IMAGE_HEADER_SIZE     24      // size of esp_image_header_t
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef enum
+{
+    FW_DIGEST_NONE,     // no expected digest, neither given nor appended to the image
+    FW_DIGEST_MATCH,
+    FW_DIGEST_MISMATCH
+} fw_digest_result_t;
+
+/**
+ * @brief Digest of an image received in order
+ *
+ * The expected digest is the one given to fw_digest_begin(), from the transfer
+ * header or a manifest. Without one, the SHA-256 the esp32 build appends to the
+ * image is used: it covers the image but its last SHA256_DIGEST_SIZE bytes, which
+ * are kept aside while the rest is hashed.
+ * Private members need not to be accessed directly.
+ */
+typedef struct
+{
+    sha256_t h_sha;
+    uint32_t u32_image_size;
+    uint32_t u32_offset;                                // bytes of the image given so far
+    uint32_t u32_hash_end;                              // bytes covered by the digest
+    bool b_has_expected;
+    uint8_t u8_expected[SHA256_DIGEST_SIZE];
+    uint8_t u8_header[FW_DIGEST_IMAGE_HEADER_SIZE];     // start of the image
+    uint8_t u8_tail[SHA256_DIGEST_SIZE];                // end of the image, the appended digest
+} fw_digest_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Starts the digest of an image
+ *
+ * @param[out] p_digest Pointer to the digest state
+ * @param[in] u32_image_size Size of the image in bytes
+ * @param[in] p_expected SHA-256 of the whole image, NULL to use the one appended to the image
+ */
+void fw_digest_begin(fw_digest_t *p_digest, uint32_t u32_image_size, const uint8_t *p_expected);
+
+/**
+ * @brief Hashes the next part of the image, as it is written
+ *
+ * @param[in,out] p_digest Pointer to the digest state
+ * @param[in] p_data Pointer to the next part of the image
+ * @param[in] u32_len Length of the next part, bytes past the image size are ignored
+ */
+void fw_digest_update(fw_digest_t *p_digest, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Compares the digest with the expected one, once the whole image is given
+ *
+ * @param[in,out] p_digest Pointer to the digest state
+ * @return The result of the comparison, FW_DIGEST_MISMATCH for an incomplete image
+ */
+fw_digest_result_t fw_digest_check(fw_digest_t *p_digest);
+
+/**
+ * @brief Looks for a SHA-256 in the fields of a ymodem header, after the file size
+ *
+ * The fields are separated by spaces, the digest is the one made of 64 hex digits.
+ *
+ * @param[in] p_fields Pointer to the fields
+ * @param[in] u16_len Length of the fields
+ * @param[out] p_expected Buffer of SHA256_DIGEST_SIZE bytes for the digest
+ * @return true if a digest is found
+ */
+bool fw_digest_parse_header(const uint8_t *p_fields, uint16_t u16_len, uint8_t *p_expected);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __FW_DIGEST_H__
@@ -0,0 +1,279 @@
+/**
+ * @file fw_partition.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Firmware partitions written while the image is received
+ * @version 0.1
+ * @date 2024-12-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fw_partition.h"
+#include "checksum.h"
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#endif
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define FW_PARTITION_READ_BACK_SIZE 1024
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+#ifdef ARDUINO
+
+bool OtaFwPartition::begin(uint32_t image_size)
+{
+    return resume(image_size, 0);
+}
+
+bool OtaFwPartition::resume(uint32_t image_size, uint32_t offset)
+{
+    this->_partition = esp_ota_get_next_update_partition(NULL);
+    if ((NULL == this->_partition) || (image_size > this->_partition->size) || (offset > image_size))
+    {
+        Serial.printf("[FW PARTITION] ERR: Not enough space for OTA.\n");
+        this->_partition = NULL;
+        return false;
+    }
+    this->_image_size = image_size;
+    this->_written = offset;
+    // a sector holding committed bytes is not erased again, the ones after it are
+    this->_erased_until = (offset + FW_PARTITION_SECTOR_SIZE - 1) & ~(uint32_t)(FW_PARTITION_SECTOR_SIZE - 1);
+    return true;
+}
+
+bool OtaFwPartition::write(const uint8_t *data, uint32_t len)
+{
+    esp_err_t err = ESP_OK;
+
+    if ((NULL == this->_partition) || ((this->_written + len) > this->_image_size))
+    {
+        return false;
+    }
+    while ((ESP_OK == err) && ((this->_written + len) > this->_erased_until))
+    {
+        err = esp_partition_erase_range(this->_partition, this->_erased_until, FW_PARTITION_SECTOR_SIZE);
+        this->_erased_until += FW_PARTITION_SECTOR_SIZE;
+    }
+    if (ESP_OK == err)
+    {
+        err = esp_partition_write(this->_partition, this->_written, data, len);
+    }
+    if (ESP_OK != err)
+    {
+        Serial.printf("[FW PARTITION] ERR: Write error (%s).\n", esp_err_to_name(err));
+        return false;
+    }
+    this->_written += len;
+    return true;
+}
+
+bool OtaFwPartition::end()
+{
+    if ((NULL == this->_partition) || (this->_written != this->_image_size))
+    {
+        Serial.printf("[FW PARTITION] ERR: Image incomplete (%lu of %lu bytes).\n",
+                      (unsigned long)this->_written, (unsigned long)this->_image_size);
+        return false;
+    }
+    // the whole image is verified before the boot partition is switched
+    esp_err_t err = esp_ota_set_boot_partition(this->_partition);
+    this->_partition = NULL;
+    if (ESP_OK != err)
+    {
+        Serial.printf("[FW PARTITION] ERR: Image verification failed (%s).\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+void OtaFwPartition::abort()
+{
+    // nothing is erased, a later resume() keeps what is written
+    this->_partition = NULL;
+}
+
+bool OtaFwPartition::read_running(uint32_t offset, uint8_t *data, uint32_t len)
+{
+    const esp_partition_t *running = esp_ota_get_running_partition();
+
+    if ((NULL == running) || (offset > running->size) || (len > (running->size - offset)))
+    {
+        return false;
+    }
+    return ESP_OK == esp_partition_read(running, offset, data, len);
+}
+
+#endif // ARDUINO
+
+FileFwPartition::~FileFwPartition()
+{
+    abort();
+    if (NULL != this->_running)
+    {
+        fclose(this->_running);
+    }
+}
+
+bool FileFwPartition::begin(uint32_t image_size)
+{
+    abort();
+    if ((0 == image_size) || (image_size > this->_capacity))
+    {
+        return false;
+    }
+    this->_file = fopen(this->_path, "w+b");
+    if (NULL == this->_file)
+    {
+        return false;
+    }
+    this->_image_size = image_size;
+    this->_written = 0;
+    this->_crc = CHECKSUM_CRC16_INIT;
+    return true;
+}
+
+bool FileFwPartition::resume(uint32_t image_size, uint32_t offset)
+{
+    uint8_t block[FW_PARTITION_READ_BACK_SIZE];
+    uint32_t remaining = offset;
+
+    abort();
+    if ((0 == image_size) || (image_size > this->_capacity) || (offset > image_size))
+    {
+        return false;
+    }
+    this->_file = fopen(this->_path, "r+b");
+    if (NULL == this->_file)
+    {
+        return false;
+    }
+    // the crc checked by end() covers the kept bytes too
+    this->_crc = CHECKSUM_CRC16_INIT;
+    while (remaining > 0)
+    {
+        uint32_t chunk = (remaining > sizeof(block)) ? sizeof(block) : remaining;
+        if (fread(block, 1, chunk, this->_file) != chunk)
+        {
+            abort();
+            return false;
+        }
+        this->_crc = checksum_crc16_update(this->_crc, block, chunk);
+        remaining -= chunk;
+    }
+    if (0 != fseek(this->_file, offset, SEEK_SET))
+    {
+        abort();
+        return false;
+    }
+    this->_image_size = image_size;
+    this->_written = offset;
+    return true;
+}
+
+bool FileFwPartition::write(const uint8_t *data, uint32_t len)
+{
+    if ((NULL == this->_file) || ((this->_written + len) > this->_image_size))
+    {
+        return false;
+    }
+    size_t written = fwrite(data, 1, len, this->_file);
+    this->_crc = checksum_crc16_update(this->_crc, data, (uint32_t)written);
+    this->_written += (uint32_t)written;
+    return (written == len);
+}
+
+bool FileFwPartition::end()
+{
+    uint8_t block[FW_PARTITION_READ_BACK_SIZE];
+    uint16_t crc = CHECKSUM_CRC16_INIT;
+    uint32_t remaining = this->_image_size;
+    bool is_valid = false;
+
+    do
+    {
+        if ((NULL == this->_file) || (this->_written != this->_image_size))
+        {
+            break;
+        }
+        // read back what is in the file, not what was given to write()
+        if ((0 != fflush(this->_file)) || (0 != fseek(this->_file, 0, SEEK_SET)))
+        {
+            break;
+        }
+        while (remaining > 0)
+        {
+            uint32_t chunk = (remaining > sizeof(block)) ? sizeof(block) : remaining;
+            if (fread(block, 1, chunk, this->_file) != chunk)
+            {
+                break;
+            }
+            if ((remaining == this->_image_size) && (FW_PARTITION_IMAGE_MAGIC != block[0]))
+            {
+                break;
+            }
+            crc = checksum_crc16_update(crc, block, chunk);
+            remaining -= chunk;
+        }
+        is_valid = (0 == remaining) && (crc == this->_crc);
+    } while (0);
+
+    if (NULL != this->_file)
+    {
+        fclose(this->_file);
+        this->_file = NULL;
+    }
+    return is_valid;
+}
+
+void FileFwPartition::abort()
+{
+    if (NULL != this->_file)
+    {
+        fclose(this->_file);
+        this->_file = NULL;
+    }
+    this->_written = 0;
+}
+
+bool FileFwPartition::read_running(uint32_t offset, uint8_t *data, uint32_t len)
+{
+    if ((NULL == this->_running) && (NULL != this->_running_path))
+    {
+        this->_running = fopen(this->_running_path, "rb");
+    }
+    return (NULL != this->_running) && (0 == fseek(this->_running, offset, SEEK_SET)) &&
+           (fread(data, 1, len, this->_running) == len);
+}
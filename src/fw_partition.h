@@ -0,0 +1,156 @@
+/**
+ * @file fw_partition.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Destination of a firmware image written while it is received
+ * @version 0.1
+ * @date 2024-12-06
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#ifndef __FW_PARTITION_H__
+#define __FW_PARTITION_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#ifdef ARDUINO
+#include <esp_partition.h>
+#endif
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define FW_PARTITION_IMAGE_MAGIC 0xE9 // first byte of an esp32 application image
+#define FW_PARTITION_SECTOR_SIZE 4096 // erase unit of the flash
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+
+/**
+ * @brief Firmware partition written in order, from the start of the image to its end
+ *
+ * begin() prepares the partition for the image, write() appends to it and end()
+ * verifies the whole image before it is marked as the one to boot. resume()
+ * keeps the part written before a reset and appends after it.
+ */
+class FwPartition
+{
+public:
+    virtual ~FwPartition() {}
+
+    /**
+     * @brief Prepares the partition for an image
+     * @param image_size size of the image in bytes
+     * @return true if the image fits and the partition is ready
+     */
+    virtual bool begin(uint32_t image_size) = 0;
+
+    /**
+     * @brief Prepares the partition to continue an image written before a reset
+     * @param image_size size of the image in bytes
+     * @param offset number of bytes of the image already in the partition
+     * @return true if those bytes are kept and the next write() appends after them
+     */
+    virtual bool resume(uint32_t image_size, uint32_t offset) = 0;
+
+    /**
+     * @brief Appends the next part of the image
+     * @return true if all the bytes are written
+     */
+    virtual bool write(const uint8_t *data, uint32_t len) = 0;
+
+    /**
+     * @brief Verifies the image, on success the next boot runs it
+     * @return true if the image is complete and valid
+     */
+    virtual bool end() = 0;
+
+    /**
+     * @brief Stops writing the image, the running firmware stays the boot one
+     */
+    virtual void abort() = 0;
+
+    /**
+     * @brief Reads the running image, the base a delta patch copies from
+     * @return true if all the bytes are read
+     */
+    virtual bool read_running(uint32_t offset, uint8_t *data, uint32_t len) = 0;
+
+    /**
+     * @brief Number of bytes written since begin()
+     */
+    uint32_t get_written() { return _written; }
+
+protected:
+    uint32_t _image_size = 0;
+    uint32_t _written = 0;
+};
+
+#ifdef ARDUINO
+
+/**
+ * @brief Inactive OTA partition of the esp32
+ *
+ * Sectors are erased as the writes reach them, not all at begin(), so the
+ * sectors written before a reset survive until the image is resumed.
+ */
+class OtaFwPartition : public FwPartition
+{
+public:
+    bool begin(uint32_t image_size) override;
+    bool resume(uint32_t image_size, uint32_t offset) override;
+    bool write(const uint8_t *data, uint32_t len) override;
+    bool end() override;
+    void abort() override;
+    bool read_running(uint32_t offset, uint8_t *data, uint32_t len) override;
+
+private:
+    const esp_partition_t *_partition = NULL;
+    uint32_t _erased_until = 0;
+};
+
+#endif // ARDUINO
+
+/**
+ * @brief Partition kept in a file of the given capacity, for the host builds
+ *
+ * The image is checked like the bootloader would check its first byte, and read
+ * back at the end to compare its CRC with the one of the bytes written.
+ * The running image, if any, is read from another file.
+ */
+class FileFwPartition : public FwPartition
+{
+public:
+    FileFwPartition(const char *path, uint32_t capacity, const char *running_path = NULL)
+        : _path(path), _capacity(capacity), _running_path(running_path) {}
+    ~FileFwPartition();
+
+    bool begin(uint32_t image_size) override;
+    bool resume(uint32_t image_size, uint32_t offset) override;
+    bool write(const uint8_t *data, uint32_t len) override;
+    bool end() override;
+    void abort() override;
+    bool read_running(uint32_t offset, uint8_t *data, uint32_t len) override;
+
+private:
+    const char *_path;
+    uint32_t _capacity;
+    const char *_running_path;
+    FILE *_file = NULL;
+    FILE *_running = NULL;
+    uint16_t _crc = 0;
+};
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+
+#endif // __FW_PARTITION_H__
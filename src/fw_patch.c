@@ -0,0 +1,455 @@
+/**
+ * @file fw_patch.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Streaming decoder of compressed and delta firmware images.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fw_patch.h"
+#include "checksum.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define FW_PATCH_READ_CHUNK     64      // bytes of the running image read at a time
+#define FW_PATCH_MAX_SHIFT      28      // a varint holds at most 32 bits
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+typedef enum
+{
+    FW_PATCH_STATE_HEADER,
+    FW_PATCH_STATE_OP,
+    FW_PATCH_STATE_LEN,         // varint of an extended length
+    FW_PATCH_STATE_ARG,         // varint of a distance or a base offset
+    FW_PATCH_STATE_LITERAL,
+    FW_PATCH_STATE_DONE
+} fw_patch_state_t;
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+static const uint8_t fw_patch_min_len[] = {FW_PATCH_MIN_LITERAL, FW_PATCH_MIN_WINDOW, FW_PATCH_MIN_BASE};
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static uint32_t fw_patch_get_u32(const uint8_t *p_data);
+static bool fw_patch_put(fw_patch_t *p_patch, uint8_t u8_byte);
+static fw_patch_status_t fw_patch_check_base(fw_patch_t *p_patch);
+static fw_patch_status_t fw_patch_start_op(fw_patch_t *p_patch);
+static fw_patch_status_t fw_patch_copy(fw_patch_t *p_patch);
+static bool fw_patch_read_varint(fw_patch_t *p_patch, uint8_t u8_byte, bool *p_is_complete);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static uint32_t fw_patch_get_u32(const uint8_t *p_data)
+{
+    return (uint32_t)p_data[0] | ((uint32_t)p_data[1] << 8) | ((uint32_t)p_data[2] << 16) |
+           ((uint32_t)p_data[3] << 24);
+}
+
+/**
+ * @brief Appends a decoded byte to the window, which is written when full
+ */
+static bool fw_patch_put(fw_patch_t *p_patch, uint8_t u8_byte)
+{
+    p_patch->u8_window[p_patch->u32_decoded & p_patch->u32_window_mask] = u8_byte;
+    p_patch->u32_decoded++;
+    if (0 == (p_patch->u32_decoded & p_patch->u32_window_mask))
+    {
+        return p_patch->write_cb(p_patch->u8_window, p_patch->u32_window_mask + 1, p_patch->user_context);
+    }
+    return true;
+}
+
+static fw_patch_status_t fw_patch_check_base(fw_patch_t *p_patch)
+{
+    uint8_t u8_chunk[FW_PATCH_READ_CHUNK];
+    uint32_t u32_crc = CHECKSUM_CRC32_INIT;
+    uint32_t u32_offset = 0;
+
+    if (0 == p_patch->h_header.u32_base_size)
+    {
+        return FW_PATCH_SUCCESS;
+    }
+    if (NULL == p_patch->read_cb)
+    {
+        return FW_PATCH_BASE_MISMATCH;
+    }
+
+    while (u32_offset < p_patch->h_header.u32_base_size)
+    {
+        uint32_t u32_len = p_patch->h_header.u32_base_size - u32_offset;
+        if (u32_len > sizeof(u8_chunk))
+        {
+            u32_len = sizeof(u8_chunk);
+        }
+        if (!p_patch->read_cb(u32_offset, u8_chunk, u32_len, p_patch->user_context))
+        {
+            return FW_PATCH_READ_FAILED;
+        }
+        u32_crc = checksum_crc32_update(u32_crc, u8_chunk, u32_len);
+        u32_offset += u32_len;
+    }
+
+    return (u32_crc == p_patch->h_header.u32_base_crc) ? FW_PATCH_SUCCESS : FW_PATCH_BASE_MISMATCH;
+}
+
+/**
+ * @brief Checks the length of the operation just read, and goes on with its argument or bytes
+ */
+static fw_patch_status_t fw_patch_start_op(fw_patch_t *p_patch)
+{
+    if ((p_patch->u32_len > (p_patch->h_header.u32_image_size - p_patch->u32_decoded)))
+    {
+        return FW_PATCH_INVALID_FORMAT;
+    }
+
+    p_patch->u32_arg = 0;
+    p_patch->u8_shift = 0;
+    p_patch->u8_state = (FW_PATCH_OP_LITERAL == p_patch->u8_op) ? FW_PATCH_STATE_LITERAL : FW_PATCH_STATE_ARG;
+    return FW_PATCH_SUCCESS;
+}
+
+/**
+ * @brief Runs a window or base operation once its argument is read
+ */
+static fw_patch_status_t fw_patch_copy(fw_patch_t *p_patch)
+{
+    if (FW_PATCH_OP_WINDOW == p_patch->u8_op)
+    {
+        uint32_t u32_distance = p_patch->u32_arg;
+        if ((0 == u32_distance) || (u32_distance > p_patch->u32_decoded) ||
+            (u32_distance > (p_patch->u32_window_mask + 1)))
+        {
+            return FW_PATCH_INVALID_FORMAT;
+        }
+        // byte by byte, a copy may overlap the bytes it produces
+        while (p_patch->u32_len--)
+        {
+            uint8_t u8_byte = p_patch->u8_window[(p_patch->u32_decoded - u32_distance) & p_patch->u32_window_mask];
+            if (!fw_patch_put(p_patch, u8_byte))
+            {
+                return FW_PATCH_WRITE_FAILED;
+            }
+        }
+    }
+    else
+    {
+        uint8_t u8_chunk[FW_PATCH_READ_CHUNK];
+        // zigzag: even values move forward, odd ones backward
+        int32_t i32_delta = (int32_t)(p_patch->u32_arg >> 1) ^ -(int32_t)(p_patch->u32_arg & 1);
+        uint32_t u32_offset = p_patch->u32_base_next + (uint32_t)i32_delta;
+
+        if ((u32_offset > p_patch->h_header.u32_base_size) ||
+            (p_patch->u32_len > (p_patch->h_header.u32_base_size - u32_offset)))
+        {
+            return FW_PATCH_INVALID_FORMAT;
+        }
+        p_patch->u32_base_next = u32_offset + p_patch->u32_len;
+
+        while (p_patch->u32_len)
+        {
+            uint32_t u32_len = (p_patch->u32_len > sizeof(u8_chunk)) ? sizeof(u8_chunk) : p_patch->u32_len;
+            if (!p_patch->read_cb(u32_offset, u8_chunk, u32_len, p_patch->user_context))
+            {
+                return FW_PATCH_READ_FAILED;
+            }
+            for (uint32_t i = 0; i < u32_len; i++)
+            {
+                if (!fw_patch_put(p_patch, u8_chunk[i]))
+                {
+                    return FW_PATCH_WRITE_FAILED;
+                }
+            }
+            u32_offset += u32_len;
+            p_patch->u32_len -= u32_len;
+        }
+    }
+
+    p_patch->u8_state = FW_PATCH_STATE_OP;
+    return FW_PATCH_SUCCESS;
+}
+
+/**
+ * @brief Adds a byte to the varint being read
+ * @return false if the varint does not fit 32 bits
+ */
+static bool fw_patch_read_varint(fw_patch_t *p_patch, uint8_t u8_byte, bool *p_is_complete)
+{
+    if ((p_patch->u8_shift > FW_PATCH_MAX_SHIFT) ||
+        ((FW_PATCH_MAX_SHIFT == p_patch->u8_shift) && ((u8_byte & 0x7F) > 0x0F)))
+    {
+        return false;
+    }
+    p_patch->u32_arg |= (uint32_t)(u8_byte & 0x7F) << p_patch->u8_shift;
+    p_patch->u8_shift += 7;
+    *p_is_complete = (0 == (u8_byte & 0x80));
+    return true;
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+bool fw_patch_read_header(const uint8_t *p_data, uint32_t u32_len, fw_patch_header_t *p_header)
+{
+    fw_patch_header_t h_header;
+
+    if ((NULL == p_data) || (u32_len < FW_PATCH_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    h_header.u32_magic = fw_patch_get_u32(&p_data[0]);
+    h_header.u8_version = p_data[4];
+    h_header.u8_window_bits = p_data[5];
+    h_header.u16_reserved = (uint16_t)(p_data[6] | (p_data[7] << 8));
+    h_header.u32_image_size = fw_patch_get_u32(&p_data[8]);
+    h_header.u32_base_size = fw_patch_get_u32(&p_data[12]);
+    h_header.u32_base_crc = fw_patch_get_u32(&p_data[16]);
+
+    if ((FW_PATCH_MAGIC != h_header.u32_magic) || (FW_PATCH_FORMAT_VERSION != h_header.u8_version) ||
+        (h_header.u8_window_bits < FW_PATCH_MIN_WINDOW_BITS) || (h_header.u8_window_bits > FW_PATCH_MAX_WINDOW_BITS) ||
+        (0 == h_header.u32_image_size))
+    {
+        return false;
+    }
+
+    if (NULL != p_header)
+    {
+        *p_header = h_header;
+    }
+    return true;
+}
+
+fw_patch_status_t fw_patch_init(fw_patch_t *p_patch, fw_patch_read_cb read_cb, fw_patch_write_cb write_cb,
+                                void *user_context)
+{
+    if ((NULL == p_patch) || (NULL == write_cb))
+    {
+        return FW_PATCH_INVALID_PARAMETERS;
+    }
+
+    memset(p_patch, 0, offsetof(fw_patch_t, u8_window));
+    p_patch->read_cb = read_cb;
+    p_patch->write_cb = write_cb;
+    p_patch->user_context = user_context;
+    p_patch->e_status = FW_PATCH_SUCCESS;
+    p_patch->u8_state = FW_PATCH_STATE_HEADER;
+
+    return FW_PATCH_SUCCESS;
+}
+
+fw_patch_status_t fw_patch_feed(fw_patch_t *p_patch, const uint8_t *p_data, uint32_t u32_len)
+{
+    uint32_t u32_pos = 0;
+
+    if ((NULL == p_patch) || ((NULL == p_data) && (0 != u32_len)))
+    {
+        return FW_PATCH_INVALID_PARAMETERS;
+    }
+
+    while ((FW_PATCH_SUCCESS == p_patch->e_status) && (u32_pos < u32_len))
+    {
+        uint8_t u8_byte = p_data[u32_pos];
+        bool b_is_complete = false;
+
+        switch (p_patch->u8_state)
+        {
+        case FW_PATCH_STATE_HEADER:
+            p_patch->u8_header[p_patch->u8_header_len++] = u8_byte;
+            u32_pos++;
+            if (FW_PATCH_HEADER_SIZE == p_patch->u8_header_len)
+            {
+                if (!fw_patch_read_header(p_patch->u8_header, FW_PATCH_HEADER_SIZE, &p_patch->h_header))
+                {
+                    p_patch->e_status = FW_PATCH_INVALID_FORMAT;
+                    break;
+                }
+                p_patch->u32_window_mask = (1UL << p_patch->h_header.u8_window_bits) - 1;
+                p_patch->e_status = fw_patch_check_base(p_patch);
+                p_patch->u8_state = FW_PATCH_STATE_OP;
+            }
+            break;
+
+        case FW_PATCH_STATE_OP:
+            u32_pos++;
+            p_patch->u8_op = u8_byte >> FW_PATCH_OP_SHIFT;
+            if (p_patch->u8_op > FW_PATCH_OP_BASE)
+            {
+                p_patch->e_status = FW_PATCH_INVALID_FORMAT;
+                break;
+            }
+            p_patch->u32_len = u8_byte & FW_PATCH_LEN_MASK;
+            if (FW_PATCH_LEN_EXTENDED == p_patch->u32_len)
+            {
+                p_patch->u32_arg = 0;
+                p_patch->u8_shift = 0;
+                p_patch->u8_state = FW_PATCH_STATE_LEN;
+                break;
+            }
+            p_patch->u32_len += fw_patch_min_len[p_patch->u8_op];
+            p_patch->e_status = fw_patch_start_op(p_patch);
+            break;
+
+        case FW_PATCH_STATE_LEN:
+            u32_pos++;
+            if (!fw_patch_read_varint(p_patch, u8_byte, &b_is_complete) ||
+                (p_patch->u32_arg > (UINT32_MAX - FW_PATCH_LEN_EXTENDED - FW_PATCH_MIN_BASE)))
+            {
+                p_patch->e_status = FW_PATCH_INVALID_FORMAT;
+            }
+            else if (b_is_complete)
+            {
+                p_patch->u32_len += p_patch->u32_arg + fw_patch_min_len[p_patch->u8_op];
+                p_patch->e_status = fw_patch_start_op(p_patch);
+            }
+            break;
+
+        case FW_PATCH_STATE_ARG:
+            u32_pos++;
+            if (!fw_patch_read_varint(p_patch, u8_byte, &b_is_complete))
+            {
+                p_patch->e_status = FW_PATCH_INVALID_FORMAT;
+            }
+            else if (b_is_complete)
+            {
+                p_patch->e_status = fw_patch_copy(p_patch);
+            }
+            break;
+
+        case FW_PATCH_STATE_LITERAL:
+            // as many bytes of the literal as this part holds
+            while ((u32_pos < u32_len) && (0 != p_patch->u32_len))
+            {
+                if (!fw_patch_put(p_patch, p_data[u32_pos++]))
+                {
+                    p_patch->e_status = FW_PATCH_WRITE_FAILED;
+                    break;
+                }
+                p_patch->u32_len--;
+            }
+            if ((FW_PATCH_SUCCESS == p_patch->e_status) && (0 == p_patch->u32_len))
+            {
+                p_patch->u8_state = FW_PATCH_STATE_OP;
+            }
+            break;
+
+        default:
+            // nothing may follow the last operation
+            p_patch->e_status = FW_PATCH_INVALID_FORMAT;
+            break;
+        }
+
+        if ((FW_PATCH_STATE_OP == p_patch->u8_state) &&
+            (p_patch->u32_decoded == p_patch->h_header.u32_image_size))
+        {
+            p_patch->u8_state = FW_PATCH_STATE_DONE;
+        }
+    }
+    p_patch->u32_input += u32_pos;
+
+    return p_patch->e_status;
+}
+
+fw_patch_status_t fw_patch_finish(fw_patch_t *p_patch)
+{
+    uint32_t u32_pending;
+
+    if (NULL == p_patch)
+    {
+        return FW_PATCH_INVALID_PARAMETERS;
+    }
+    if (FW_PATCH_SUCCESS != p_patch->e_status)
+    {
+        return p_patch->e_status;
+    }
+    if (FW_PATCH_STATE_DONE != p_patch->u8_state)
+    {
+        p_patch->e_status = FW_PATCH_INCOMPLETE;
+        return p_patch->e_status;
+    }
+
+    // a full window is written already by fw_patch_put()
+    u32_pending = p_patch->u32_decoded & p_patch->u32_window_mask;
+    if ((0 != u32_pending) && !p_patch->write_cb(p_patch->u8_window, u32_pending, p_patch->user_context))
+    {
+        p_patch->e_status = FW_PATCH_WRITE_FAILED;
+    }
+
+    return p_patch->e_status;
+}
+
+uint32_t fw_patch_get_image_size(const fw_patch_t *p_patch)
+{
+    return ((NULL == p_patch) || (FW_PATCH_STATE_HEADER == p_patch->u8_state)) ? 0 : p_patch->h_header.u32_image_size;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file fw_patch.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the streaming decoder of compressed and delta firmware images.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __FW_PATCH_H__
+#define __FW_PATCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define FW_PATCH_MAGIC                  0x3150584F  // "OXP1"
+#define FW_PATCH_FORMAT_VERSION         1
+#define FW_PATCH_HEADER_SIZE            20
+
+#define FW_PATCH_MIN_WINDOW_BITS        8
+#ifndef FW_PATCH_MAX_WINDOW_BITS
+#define FW_PATCH_MAX_WINDOW_BITS        12          // RAM of the decoder, a patch with a larger window is refused
+#endif
+#define FW_PATCH_MAX_WINDOW_SIZE        (1UL << FW_PATCH_MAX_WINDOW_BITS)
+
+/**
+ * Operations of the patch, after the header. The 2 high bits of the first byte
+ * select the operation, the 6 low ones the length minus its minimum; 63 means a
+ * LEB128 varint follows with the rest of the length.
+ *   literal: the bytes follow
+ *   window:  LEB128 distance back into the decoded bytes
+ *   base:    zigzag LEB128 offset in the running image, from the end of the previous base copy
+ */
+#define FW_PATCH_OP_LITERAL             0
+#define FW_PATCH_OP_WINDOW              1
+#define FW_PATCH_OP_BASE                2
+#define FW_PATCH_OP_SHIFT               6
+#define FW_PATCH_LEN_MASK               0x3F
+#define FW_PATCH_LEN_EXTENDED           0x3F
+#define FW_PATCH_MIN_LITERAL            1
+#define FW_PATCH_MIN_WINDOW             3
+#define FW_PATCH_MIN_BASE               4
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef enum
+{
+    FW_PATCH_SUCCESS = 0,
+    FW_PATCH_INVALID_PARAMETERS,
+    FW_PATCH_INVALID_FORMAT,    // corrupt patch, or one decoding past the image size
+    FW_PATCH_BASE_MISMATCH,     // running image is not the one the patch is built against
+    FW_PATCH_READ_FAILED,
+    FW_PATCH_WRITE_FAILED,
+    FW_PATCH_INCOMPLETE         // patch ended before the whole image is decoded
+} fw_patch_status_t;
+
+/**
+ * @brief Header of a patch, little endian
+ */
+typedef struct
+{
+    uint32_t u32_magic;         // FW_PATCH_MAGIC
+    uint8_t u8_version;         // FW_PATCH_FORMAT_VERSION
+    uint8_t u8_window_bits;     // window of the decoded bytes is 1 << u8_window_bits
+    uint16_t u16_reserved;
+    uint32_t u32_image_size;    // size of the decoded image
+    uint32_t u32_base_size;     // bytes of the running image the patch copies from, 0 for a compressed image
+    uint32_t u32_base_crc;      // CRC-32 of those bytes
+} fw_patch_header_t;
+
+/**
+ * @brief Reads bytes of the running image, the base of a delta patch
+ * @return true if all the bytes are read
+ */
+typedef bool (*fw_patch_read_cb)(uint32_t u32_offset, uint8_t *p_data, uint32_t u32_len, void *user_context);
+
+/**
+ * @brief Takes the next decoded bytes of the image, at most a window at a time
+ * @return true if the bytes are written
+ */
+typedef bool (*fw_patch_write_cb)(const uint8_t *p_data, uint32_t u32_len, void *user_context);
+
+/**
+ * @brief Decoder of a patch, fed in parts of any size
+ *
+ * The decoded bytes are kept in a window the window operations copy from, which is
+ * also the output buffer: it is handed to the write callback each time it is full.
+ * Private members need not to be accessed directly.
+ */
+typedef struct
+{
+    fw_patch_header_t h_header;
+    fw_patch_read_cb read_cb;
+    fw_patch_write_cb write_cb;
+    void *user_context;
+    fw_patch_status_t e_status;     // first error, every later call returns it
+    uint8_t u8_state;
+    uint8_t u8_op;
+    uint8_t u8_shift;               // of the varint being read
+    uint8_t u8_header_len;
+    uint32_t u32_len;               // of the operation being decoded
+    uint32_t u32_arg;               // varint being read
+    uint32_t u32_window_mask;
+    uint32_t u32_decoded;           // bytes decoded so far
+    uint32_t u32_base_next;         // offset in the running image after the last base copy
+    uint32_t u32_input;             // bytes of the patch fed so far
+    uint8_t u8_header[FW_PATCH_HEADER_SIZE];
+    uint8_t u8_window[FW_PATCH_MAX_WINDOW_SIZE];
+} fw_patch_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Reads the header at the start of a patch
+ *
+ * @param[in] p_data Pointer to the first bytes of the file
+ * @param[in] u32_len Number of bytes
+ * @param[out] p_header Pointer to the header, may be NULL
+ * @return true if the file starts with the header of a patch this decoder can decode
+ */
+bool fw_patch_read_header(const uint8_t *p_data, uint32_t u32_len, fw_patch_header_t *p_header);
+
+/**
+ * @brief Prepares the decoder for a patch
+ *
+ * @param[out] p_patch Pointer to the decoder
+ * @param[in] read_cb Callback reading the running image, only called by delta patches
+ * @param[in] write_cb Callback taking the decoded image
+ * @param[in] user_context Context given to the callbacks
+ * @return FW_PATCH_SUCCESS, or FW_PATCH_INVALID_PARAMETERS
+ */
+fw_patch_status_t fw_patch_init(fw_patch_t *p_patch, fw_patch_read_cb read_cb, fw_patch_write_cb write_cb,
+                                void *user_context);
+
+/**
+ * @brief Decodes the next part of the patch, header included
+ *
+ * The CRC of the running image is checked once the header is complete, before the
+ * first byte is decoded.
+ *
+ * @param[in,out] p_patch Pointer to the decoder
+ * @param[in] p_data Pointer to the next part of the patch
+ * @param[in] u32_len Length of the part
+ * @return FW_PATCH_SUCCESS, or the first error of the patch
+ */
+fw_patch_status_t fw_patch_feed(fw_patch_t *p_patch, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Writes the last decoded bytes once the whole patch is fed
+ *
+ * @param[in,out] p_patch Pointer to the decoder
+ * @return FW_PATCH_SUCCESS if the whole image is decoded and written
+ */
+fw_patch_status_t fw_patch_finish(fw_patch_t *p_patch);
+
+/**
+ * @brief Size of the decoded image, 0 until the header is fed
+ */
+uint32_t fw_patch_get_image_size(const fw_patch_t *p_patch);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __FW_PATCH_H__
@@ -0,0 +1,272 @@
+/**
+ * @file fw_resume.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Progress record which lets a firmware download resume after a reset.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "fw_resume.h"
+#include "checksum.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static bool fw_resume_is_record_usable(const fw_resume_record_t *p_record, uint32_t u32_version,
+                                       uint32_t u32_image_size);
+static void fw_resume_save(fw_resume_t *p_resume);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Checks the record is for this image and its committed part can be kept
+ */
+static bool fw_resume_is_record_usable(const fw_resume_record_t *p_record, uint32_t u32_version,
+                                       uint32_t u32_image_size)
+{
+    return (FW_RESUME_RECORD_MAGIC == p_record->u32_magic) &&
+           (u32_version == p_record->u32_version) &&
+           (u32_image_size == p_record->u32_image_size) &&
+           (0 != p_record->u32_committed) &&
+           (p_record->u32_committed < u32_image_size) &&
+           (p_record->u32_committed <= (FW_RESUME_MAX_SECTORS * FW_RESUME_SAVE_INTERVAL)) &&
+           (0 == (p_record->u32_committed % FW_RESUME_SAVE_INTERVAL));
+}
+
+/**
+ * @brief Saves the record with the CRCs of the committed sectors
+ */
+static void fw_resume_save(fw_resume_t *p_resume)
+{
+    if ((NULL != p_resume->save_cb) && p_resume->save_cb(&p_resume->h_record, p_resume->user_context))
+    {
+        p_resume->u32_saves++;
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+fw_resume_status_t fw_resume_init(fw_resume_t *p_resume, fw_resume_load_cb load_cb, fw_resume_save_cb save_cb,
+                                  void *user_context)
+{
+    if (NULL == p_resume)
+    {
+        return FW_RESUME_INVALID_PARAMETERS;
+    }
+
+    memset(p_resume, 0, sizeof(fw_resume_t));
+    p_resume->load_cb = load_cb;
+    p_resume->save_cb = save_cb;
+    p_resume->user_context = user_context;
+
+    return FW_RESUME_SUCCESS;
+}
+
+uint32_t fw_resume_begin(fw_resume_t *p_resume, uint32_t u32_version, uint32_t u32_image_size)
+{
+    if (NULL == p_resume)
+    {
+        return 0;
+    }
+
+    p_resume->u32_resume_offset = 0;
+    p_resume->u32_offset = 0;
+    p_resume->u32_sector_hash = CHECKSUM_CRC32_INIT;
+    p_resume->u32_skipped_bytes = 0;
+    p_resume->u32_rewrites = 0;
+
+    // the record is read in place, it is too large for the stack of the caller
+    memset(&p_resume->h_record, 0, sizeof(p_resume->h_record));
+    if ((NULL != p_resume->load_cb) && (NULL != p_resume->save_cb) &&
+        p_resume->load_cb(&p_resume->h_record, p_resume->user_context) &&
+        fw_resume_is_record_usable(&p_resume->h_record, u32_version, u32_image_size))
+    {
+        // the record stays as it is until the download goes past it
+        p_resume->u32_resume_offset = p_resume->h_record.u32_committed;
+        return p_resume->u32_resume_offset;
+    }
+
+    memset(&p_resume->h_record, 0, sizeof(p_resume->h_record));
+    p_resume->h_record.u32_magic = FW_RESUME_RECORD_MAGIC;
+    p_resume->h_record.u32_version = u32_version;
+    p_resume->h_record.u32_image_size = u32_image_size;
+
+    return 0;
+}
+
+fw_resume_action_t fw_resume_check_block(fw_resume_t *p_resume, const uint8_t *p_data, uint32_t u32_len)
+{
+    if ((NULL == p_resume) || (p_resume->u32_offset >= p_resume->u32_resume_offset))
+    {
+        return FW_RESUME_WRITE;
+    }
+
+    // a block across a sector means other block sizes, the sector can not be checked
+    uint32_t u32_in_sector = p_resume->u32_offset % FW_RESUME_SAVE_INTERVAL;
+    if ((NULL == p_data) || ((u32_in_sector + u32_len) > FW_RESUME_SAVE_INTERVAL))
+    {
+        p_resume->u32_resume_offset = 0;
+        return FW_RESUME_MISMATCH;
+    }
+
+    // kept until the whole sector is checked, it is written again if it differs
+    memcpy(&p_resume->u8_sector[u32_in_sector], p_data, u32_len);
+    p_resume->u32_sector_hash = checksum_crc32_update(p_resume->u32_sector_hash, p_data, u32_len);
+    p_resume->u32_offset += u32_len;
+    if (0 != (p_resume->u32_offset % FW_RESUME_SAVE_INTERVAL))
+    {
+        return FW_RESUME_SKIP;
+    }
+
+    uint32_t u32_sector = (p_resume->u32_offset / FW_RESUME_SAVE_INTERVAL) - 1;
+    uint32_t u32_hash = p_resume->u32_sector_hash;
+    p_resume->u32_sector_hash = CHECKSUM_CRC32_INIT;
+    if (u32_hash == p_resume->h_record.u32_sector_crc[u32_sector])
+    {
+        p_resume->u32_skipped_bytes += FW_RESUME_SAVE_INTERVAL;
+        return FW_RESUME_SKIP;
+    }
+
+    // the committed part ends before the sector, the record says so before the partition is touched
+    p_resume->u32_offset -= FW_RESUME_SAVE_INTERVAL;
+    p_resume->u32_resume_offset = p_resume->u32_offset;
+    p_resume->h_record.u32_committed = p_resume->u32_offset;
+    p_resume->u32_rewrites++;
+    fw_resume_save(p_resume);
+
+    return FW_RESUME_REWRITE;
+}
+
+const uint8_t *fw_resume_get_sector(const fw_resume_t *p_resume, uint32_t *p_offset, uint32_t *p_len)
+{
+    if ((NULL == p_resume) || (NULL == p_offset) || (NULL == p_len))
+    {
+        return NULL;
+    }
+
+    *p_offset = p_resume->u32_offset;
+    *p_len = FW_RESUME_SAVE_INTERVAL;
+    return p_resume->u8_sector;
+}
+
+void fw_resume_commit(fw_resume_t *p_resume, const uint8_t *p_data, uint32_t u32_len)
+{
+    if (NULL == p_resume)
+    {
+        return;
+    }
+
+    p_resume->u32_sector_hash = checksum_crc32_update(p_resume->u32_sector_hash, p_data, u32_len);
+    p_resume->u32_offset += u32_len;
+    if (0 != (p_resume->u32_offset % FW_RESUME_SAVE_INTERVAL))
+    {
+        return;
+    }
+
+    uint32_t u32_sector = (p_resume->u32_offset / FW_RESUME_SAVE_INTERVAL) - 1;
+    uint32_t u32_hash = p_resume->u32_sector_hash;
+    p_resume->u32_sector_hash = CHECKSUM_CRC32_INIT;
+    if ((NULL == p_resume->save_cb) || (u32_sector >= FW_RESUME_MAX_SECTORS) ||
+        (p_resume->u32_offset >= p_resume->h_record.u32_image_size))
+    {
+        return;
+    }
+
+    p_resume->h_record.u32_sector_crc[u32_sector] = u32_hash;
+    p_resume->h_record.u32_committed = p_resume->u32_offset;
+    fw_resume_save(p_resume);
+}
+
+void fw_resume_finish(fw_resume_t *p_resume)
+{
+    if (NULL == p_resume)
+    {
+        return;
+    }
+
+    p_resume->u32_resume_offset = 0;
+    p_resume->h_record.u32_magic = 0;
+    if (NULL != p_resume->save_cb)
+    {
+        p_resume->save_cb(NULL, p_resume->user_context);
+    }
+}
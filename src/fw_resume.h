@@ -0,0 +1,249 @@
+/**
+ * @file fw_resume.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the progress record which lets a firmware download resume after a reset.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __FW_RESUME_H__
+#define __FW_RESUME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define FW_RESUME_RECORD_MAGIC      0x46575232  // "FWR2"
+
+/**
+ * @brief Progress is saved each time this many more bytes are committed.
+ *        It is the flash sector size, so the committed part ends on a sector boundary
+ *        and a multiple of both ymodem block sizes.
+ */
+#define FW_RESUME_SAVE_INTERVAL     4096
+
+/**
+ * @brief Sectors the record holds a CRC-32 of, the committed part of a larger image stops there
+ */
+#ifndef FW_RESUME_MAX_SECTORS
+#define FW_RESUME_MAX_SECTORS       384         // 1.5 MB, the ota slot of a 4 MB flash is 1.25 MB
+#endif
+
+/**
+ * @brief Bytes of a record to store, the CRCs of the sectors past the committed part are left out
+ */
+#define FW_RESUME_RECORD_SIZE(committed) \
+    (offsetof(fw_resume_record_t, u32_sector_crc) + (((committed) / FW_RESUME_SAVE_INTERVAL) * sizeof(uint32_t)))
+
+/**
+ * @brief Packs a version into the record, the version of the image comes from the modem
+ */
+#define FW_RESUME_VERSION(major, minor, patch) \
+    (((uint32_t)(major) << 16) | ((uint32_t)(minor) << 8) | (uint32_t)(patch))
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef enum
+{
+    FW_RESUME_SUCCESS = 0,
+    FW_RESUME_INVALID_PARAMETERS
+} fw_resume_status_t;
+
+typedef enum
+{
+    FW_RESUME_WRITE,    // block is past the committed part, write it and call fw_resume_commit()
+    FW_RESUME_SKIP,     // block is in the committed part, acknowledge it without writing
+    FW_RESUME_REWRITE,  // sector the block ends differs from the committed one, write it from fw_resume_get_sector()
+    FW_RESUME_MISMATCH  // re-sent blocks are not the committed ones, the image must start over
+} fw_resume_action_t;
+
+/**
+ * @brief Progress record kept in the non volatile storage
+ */
+typedef struct
+{
+    uint32_t u32_magic;         // FW_RESUME_RECORD_MAGIC when the record is valid
+    uint32_t u32_version;       // version of the image, see FW_RESUME_VERSION()
+    uint32_t u32_image_size;    // size of the image in bytes
+    uint32_t u32_committed;     // bytes of the image in the partition, whole sectors
+    uint32_t u32_sector_crc[FW_RESUME_MAX_SECTORS];     // CRC-32 of each committed sector
+} fw_resume_record_t;
+
+/**
+ * @brief Reads the record from the non volatile storage, a shorter record than the one saved is not used
+ * @return true if a record is read
+ */
+typedef bool (*fw_resume_load_cb)(fw_resume_record_t *p_record, void *user_context);
+
+/**
+ * @brief Writes the first FW_RESUME_RECORD_SIZE(u32_committed) bytes of the record, a NULL record erases it
+ * @return true if the storage is updated
+ */
+typedef bool (*fw_resume_save_cb)(const fw_resume_record_t *p_record, void *user_context);
+
+/**
+ * @brief Progress of the download in progress
+ *
+ * A ymodem sender always starts from the first block, so the resume is done by
+ * the receiver: blocks already committed before the reset are kept with their
+ * sector and acknowledged without being written. A re-sent sector which hashes
+ * to its saved CRC is skipped, the first one which does not is written from the
+ * kept bytes and every block after it is written too, in the same transfer.
+ * Private members need not to be accessed directly.
+ */
+typedef struct
+{
+    fw_resume_record_t h_record;    // progress as last saved
+    uint32_t u32_resume_offset;     // committed bytes of the interrupted download, 0 when starting over
+    uint32_t u32_offset;            // bytes of the image received in this download
+    uint32_t u32_sector_hash;       // CRC-32 of the bytes of the current sector
+    uint8_t u8_sector[FW_RESUME_SAVE_INTERVAL];     // re-sent bytes of the sector being checked
+    fw_resume_load_cb load_cb;
+    fw_resume_save_cb save_cb;
+    void *user_context;
+    uint32_t u32_saves;             // number of records saved
+    uint32_t u32_skipped_bytes;     // bytes acknowledged without being written again
+    uint32_t u32_rewrites;          // sectors which differed from the interrupted image
+} fw_resume_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Initializes the progress tracking
+ *
+ * @param[out] p_resume Pointer to the progress state
+ * @param[in] load_cb Callback reading the record, NULL disables the resume
+ * @param[in] save_cb Callback writing the record, NULL disables the resume
+ * @param[in] user_context User context passed to the callbacks
+ *
+ * @retval FW_RESUME_SUCCESS The progress tracking is initialized
+ * @retval FW_RESUME_INVALID_PARAMETERS Invalid progress pointer
+ */
+fw_resume_status_t fw_resume_init(fw_resume_t *p_resume, fw_resume_load_cb load_cb, fw_resume_save_cb save_cb,
+                                  void *user_context);
+
+/**
+ * @brief Starts tracking a download
+ *
+ * The saved record is used when it is for the same version and size of image.
+ *
+ * @param[in,out] p_resume Pointer to the progress state
+ * @param[in] u32_version Version of the image, see FW_RESUME_VERSION()
+ * @param[in] u32_image_size Size of the image in bytes
+ * @return Number of bytes the partition already holds, 0 when the image starts over
+ */
+uint32_t fw_resume_begin(fw_resume_t *p_resume, uint32_t u32_version, uint32_t u32_image_size);
+
+/**
+ * @brief Tells what to do with the next block of the image, before it is written
+ *
+ * @param[in,out] p_resume Pointer to the progress state
+ * @param[in] p_data Pointer to the bytes of the block which are part of the image
+ * @param[in] u32_len Number of those bytes
+ * @return The action for the block
+ */
+fw_resume_action_t fw_resume_check_block(fw_resume_t *p_resume, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Sector to write after FW_RESUME_REWRITE, the committed part now ends at its start
+ *
+ * @param[in] p_resume Pointer to the progress state
+ * @param[out] p_offset Offset of the sector in the image, where the partition resumes
+ * @param[out] p_len Number of bytes of the sector
+ * @return Pointer to the re-sent bytes of the sector, pass them to fw_resume_commit() once written
+ */
+const uint8_t *fw_resume_get_sector(const fw_resume_t *p_resume, uint32_t *p_offset, uint32_t *p_len);
+
+/**
+ * @brief Records a block written to the partition, the record is saved on each FW_RESUME_SAVE_INTERVAL
+ *
+ * @param[in,out] p_resume Pointer to the progress state
+ * @param[in] p_data Pointer to the bytes written
+ * @param[in] u32_len Number of bytes written
+ */
+void fw_resume_commit(fw_resume_t *p_resume, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Erases the record, once the image is complete or can not be resumed
+ *
+ * @param[in,out] p_resume Pointer to the progress state
+ */
+void fw_resume_finish(fw_resume_t *p_resume);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __FW_RESUME_H__
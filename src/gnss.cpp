@@ -2,6 +2,7 @@
 #include "hal/uart_types.h"
 #include <TinyGPS++.h>
 #include "gnss.h"
+#include "uart_capture.h"
 
 // #####################################################################
 // Build Defs
@@ -46,6 +47,7 @@
 // This is required due to need to retrieve messages without auto-callbacks
 #define MAX_EOE_BUF   (2048)
 #define MAX_RESP_SIZE (256)
+#define GNSS_CAPTURE_CHUNK (64) // bytes of the sentences read before they are captured
 
 // Default time to wait for a response from the GNSS module
 #define TYP_CMD_RESP_TIMEOUT_ms (5000)
@@ -213,6 +215,8 @@ bool gnssCheckin(gnss_data_t *gnss_data_rtn)
 {
 
     bool rtnVal = false;
+    uint8_t capture[GNSS_CAPTURE_CHUNK];
+    size_t captured = 0;
 
     while (GPS_Serial.available())
     {                               // If data is available from GPS
@@ -221,7 +225,14 @@ bool gnssCheckin(gnss_data_t *gnss_data_rtn)
 #ifdef PRINT_ALL_QUECTEL_RESPONSES
         Serial.print(c);
 #endif
+        capture[captured++] = (uint8_t)c;
+        if (captured == sizeof(capture))
+        {
+            UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_RX, capture, captured);
+            captured = 0;
+        }
     }
+    UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_RX, capture, captured);
 
     // Check if new GPS location data is available
     if (gps.location.isUpdated())
@@ -298,6 +309,8 @@ bool gnssCheckin(gnss_data_t *gnss_data_rtn)
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 void sendCommandToGNSS(const char *command)
 {
+    UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_TX, command, strlen(command));
+    UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_TX, "\r\n", 2);
     GPS_Serial.println(command);
     delay(50); // Brief delay to ensure command is processed
 }
@@ -308,6 +321,7 @@ void sendCommandToGNSS(const char *command)
 void sendDataToGNSS(char *cmd, int len)
 {
     // DO I NEED TO ADD CR/LF? $$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+    UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_TX, cmd, len);
     GPS_Serial.write((uint8_t *)cmd, len);
     delay(50); // Brief delay to ensure command is processed
 }
@@ -399,10 +413,12 @@ bool waitForGNSSResponse(unsigned long timeout_ms, char *response_buffer, size_t
             if (startDetected && c == '\n')
             {
                 response_buffer[index] = '\0'; // Null-terminate the string
+                UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_RX, response_buffer, index);
                 return true;                   // Full response received
             }
         }
     }
 
+    UART_CAPTURE(UART_CAPTURE_GNSS_PORT, UART_CAPTURE_GNSS_RX, response_buffer, index);
     return false; // Response timeout or buffer overflow
 }
\ No newline at end of file
@@ -6,7 +6,12 @@
 
 #include "host_fuota.h"
 #include "api_processor.h"
+#include <string.h>
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdio.h>
+#endif
 
 /******************************************************************************
  * EXTERN VARIABLES
@@ -15,6 +20,14 @@
 /******************************************************************************
  * PRIVATE MACROS AND DEFINES
  ******************************************************************************/
+// protocol core also builds on the host, see env:native
+#if defined(ARDUINO)
+#define HOST_FUOTA_LOG(...)     Serial.printf(__VA_ARGS__)
+#elif defined(HOST_FUOTA_NO_LOG)
+#define HOST_FUOTA_LOG(...)
+#else
+#define HOST_FUOTA_LOG(...)     printf(__VA_ARGS__)
+#endif
 
 /******************************************************************************
  * PRIVATE TYPEDEFS
@@ -81,7 +94,6 @@ uint32_t calculate_no_of_segments(uint8_t *pkg_size, uint32_t seg_size_byte)
 
 bool is_all_segments_downloaded(get_seg_file_status_t seg_file_status)
 {
-    bool is_downloaded = true;
     uint32_t pkg_full_size =  seg_file_status.pkg_size[0] << 16 | seg_file_status.pkg_size[1] << 8 | seg_file_status.pkg_size[2];   
     // Determine the segment size based on the segment size type
     uint32_t seg_size = get_seg_size_bytes(seg_file_status.seg_size);
@@ -90,19 +102,169 @@ bool is_all_segments_downloaded(get_seg_file_status_t seg_file_status)
         return false;
     }
     uint32_t total_segments = (pkg_full_size + seg_size - 1) / seg_size;
-    Serial.printf("Total segments: %d\n", total_segments);
-    for (uint32_t i = 0; i < total_segments; i++)
+    if (total_segments > FUOTA_SEG_STATUS_WINDOW)
     {
-        if ((seg_file_status.seg_status & (1 << i)) != 0)
+        // one status can not tell, see fuota_seg_tracker_apply_status()
+        return false;
+    }
+    uint32_t mask = (1UL << total_segments) - 1;
+    return (seg_file_status.seg_status & mask) == 0;
+}
+
+bool fuota_seg_tracker_init(fuota_seg_tracker_t *p_tracker, uint32_t *p_words, uint16_t u16_words,
+                            uint32_t u32_pkg_size, uint32_t u32_seg_size)
+{
+    bool return_status = false;
+
+    do
+    {
+        if ((NULL == p_tracker) || (NULL == p_words) || (0 == u32_seg_size))
         {
-            is_downloaded = false;
-            Serial.printf("Segment %d is not downloaded\n", i);
             break;
         }
+        memset(p_tracker, 0, sizeof(fuota_seg_tracker_t));
+        uint32_t u32_segments = (u32_pkg_size + u32_seg_size - 1) / u32_seg_size;
+        uint32_t u32_words = FUOTA_SEG_TRACKER_WORDS(u32_segments);
+        if ((0 == u32_segments) || (u32_words > u16_words))
+        {
+            break;
+        }
+
+        // every segment pending, the bits past the last segment stay clear
+        memset(p_words, 0xFF, u32_words * sizeof(uint32_t));
+        if (0 != (u32_segments % 32))
+        {
+            p_words[u32_words - 1] = (1UL << (u32_segments % 32)) - 1;
+        }
+        p_tracker->p_pending = p_words;
+        p_tracker->u16_words = (uint16_t)u32_words;
+        p_tracker->u32_segments = u32_segments;
+        p_tracker->u32_pending = u32_segments;
+        p_tracker->u32_pkg_size = u32_pkg_size;
+        p_tracker->u32_seg_size = u32_seg_size;
+        return_status = true;
+    } while (0);
+
+    return return_status;
+}
+
+void fuota_seg_tracker_update(fuota_seg_tracker_t *p_tracker, uint32_t u32_first_segment, uint32_t u32_status,
+                              uint8_t u8_count)
+{
+    if ((NULL == p_tracker) || (u32_first_segment >= p_tracker->u32_segments) || (0 == u8_count) || (u8_count > 32))
+    {
+        return;
+    }
+    if (u8_count > (p_tracker->u32_segments - u32_first_segment))
+    {
+        u8_count = (uint8_t)(p_tracker->u32_segments - u32_first_segment);
+    }
+
+    // the window covers at most two words
+    uint64_t u64_mask = ((u8_count == 32) ? 0xFFFFFFFFULL : ((1ULL << u8_count) - 1)) << (u32_first_segment % 32);
+    uint64_t u64_bits = ((uint64_t)u32_status << (u32_first_segment % 32)) & u64_mask;
+    uint32_t u32_word = u32_first_segment / 32;
+
+    for (uint8_t i = 0; (i < 2) && (0 != u64_mask); i++, u32_word++)
+    {
+        uint32_t u32_old = p_tracker->p_pending[u32_word];
+        uint32_t u32_new = (u32_old & ~(uint32_t)u64_mask) | (uint32_t)u64_bits;
+        p_tracker->p_pending[u32_word] = u32_new;
+        p_tracker->u32_pending += __builtin_popcount(u32_new);
+        p_tracker->u32_pending -= __builtin_popcount(u32_old);
+        u64_mask >>= 32;
+        u64_bits >>= 32;
+    }
+}
+
+uint32_t fuota_seg_tracker_get_segments(const get_seg_file_status_t *p_status)
+{
+    if (NULL == p_status)
+    {
+        return 0;
+    }
+
+    uint32_t u32_pkg_size = p_status->pkg_size[0] << 16 | p_status->pkg_size[1] << 8 | p_status->pkg_size[2];
+    uint32_t u32_seg_size = get_seg_size_bytes(p_status->seg_size);
+    return (0 == u32_seg_size) ? 0 : ((u32_pkg_size + u32_seg_size - 1) / u32_seg_size);
+}
+
+bool fuota_seg_tracker_apply_status(fuota_seg_tracker_t *p_tracker, uint32_t *p_words, uint16_t u16_words,
+                                    const get_seg_file_status_t *p_status)
+{
+    if ((NULL == p_tracker) || (NULL == p_status))
+    {
+        return false;
+    }
+    // segments past the status can not be reported, the package would never complete
+    if (fuota_seg_tracker_get_segments(p_status) > FUOTA_SEG_TRACKER_MAX_SEGMENTS)
+    {
+        memset(p_tracker, 0, sizeof(fuota_seg_tracker_t));
+        return false;
+    }
+
+    uint32_t u32_pkg_size = p_status->pkg_size[0] << 16 | p_status->pkg_size[1] << 8 | p_status->pkg_size[2];
+    uint32_t u32_seg_size = get_seg_size_bytes(p_status->seg_size);
+    if ((0 == p_tracker->u32_segments) || (u32_pkg_size != p_tracker->u32_pkg_size) ||
+        (u32_seg_size != p_tracker->u32_seg_size) ||
+        (0 != memcmp(&p_status->fw_ver, &p_tracker->h_version, sizeof(ver_type_1_t))))
+    {
+        if (!fuota_seg_tracker_init(p_tracker, p_words, u16_words, u32_pkg_size, u32_seg_size))
+        {
+            return false;
+        }
+        p_tracker->h_version = p_status->fw_ver;
     }
 
-    return is_downloaded;
+    fuota_seg_tracker_update(p_tracker, 0, p_status->seg_status, FUOTA_SEG_STATUS_WINDOW);
+
+    return fuota_seg_tracker_is_complete(p_tracker);
+}
+
+uint8_t fuota_seg_tracker_get_percent(const fuota_seg_tracker_t *p_tracker)
+{
+    if ((NULL == p_tracker) || (0 == p_tracker->u32_segments))
+    {
+        return 0;
+    }
+    return (uint8_t)(((uint64_t)(p_tracker->u32_segments - p_tracker->u32_pending) * 100) / p_tracker->u32_segments);
 }
+
+bool fuota_seg_tracker_is_complete(const fuota_seg_tracker_t *p_tracker)
+{
+    return (NULL != p_tracker) && (0 != p_tracker->u32_segments) && (0 == p_tracker->u32_pending);
+}
+
+uint32_t fuota_seg_tracker_get_pending(const fuota_seg_tracker_t *p_tracker, uint32_t u32_from, uint32_t *p_list,
+                                       uint32_t u32_max)
+{
+    uint32_t u32_count = 0;
+
+    if ((NULL == p_tracker) || (NULL == p_list) || (u32_from >= p_tracker->u32_segments))
+    {
+        return 0;
+    }
+
+    uint32_t u32_word = u32_from / 32;
+    uint32_t u32_bits = p_tracker->p_pending[u32_word] & (0xFFFFFFFFUL << (u32_from % 32));
+    while (u32_count < u32_max)
+    {
+        // whole words of downloaded segments are skipped at once
+        while (0 == u32_bits)
+        {
+            if (++u32_word >= p_tracker->u16_words)
+            {
+                return u32_count;
+            }
+            u32_bits = p_tracker->p_pending[u32_word];
+        }
+        p_list[u32_count++] = (u32_word * 32) + __builtin_ctz(u32_bits);
+        u32_bits &= u32_bits - 1;
+    }
+
+    return u32_count;
+}
+
 uint8_t get_cmd_type_from_seg_file_status(get_seg_file_status_t seg_file_status)
 {
     return seg_file_status.cmd_type.cmd_type;
@@ -25,6 +25,23 @@ extern "C" {
 #define SEG_DOWNLOADED                  0x00
 #define SEG_PENDING                     0x01
 
+#define FUOTA_SEG_STATUS_WINDOW         16              // segments reported by one seg_status
+#define FUOTA_MAX_PKG_SIZE              (1UL << 24)     // pkg_size is 3 bytes
+
+/**
+ * @brief Largest package the statuses of the modem can report
+ *
+ *  The MCM API documents seg_status as the state of segments 0 to 15 and does
+ *  not say what nxt_seg_id means for more segments, so no window is derived
+ *  from it. A package of more segments is refused rather than completed on a
+ *  guess. At the 64k segments of SEG_SIZE_64 this is a 1 MB package.
+ */
+#define FUOTA_SEG_TRACKER_MAX_SEGMENTS  FUOTA_SEG_STATUS_WINDOW
+
+// bitmap words for a number of segments, and for the largest package the statuses can report
+#define FUOTA_SEG_TRACKER_WORDS(segments)   (((segments) + 31) / 32)
+#define FUOTA_SEG_TRACKER_MAX_WORDS         FUOTA_SEG_TRACKER_WORDS(FUOTA_SEG_TRACKER_MAX_SEGMENTS)
+
 /**********************************************************************************************************
  * TYPEDEFS
  **********************************************************************************************************/
@@ -36,6 +53,25 @@ typedef enum
     SEG_SIZE_512 = 0x03
 } seg_size_t;
 
+/**
+ * @brief Download state of every segment of a package
+ *
+ * One bit per segment, set while the segment is pending. The count of pending
+ * segments is kept up to date by each update, so the progress is O(1) and the
+ * pending list costs one step per pending segment, whatever the package size.
+ * The bitmap storage is given by the caller, see FUOTA_SEG_TRACKER_WORDS().
+ */
+typedef struct
+{
+    uint32_t *p_pending;        // bit set for each segment not downloaded yet
+    uint16_t u16_words;         // size of the bitmap storage in words
+    uint32_t u32_segments;      // number of segments of the package, 0 when nothing is tracked
+    uint32_t u32_pending;       // number of bits set in the bitmap
+    uint32_t u32_pkg_size;      // package tracked, a status of another package restarts the tracking
+    uint32_t u32_seg_size;
+    ver_type_1_t h_version;
+} fuota_seg_tracker_t;
+
 
 /**********************************************************************************************************
  * EXPORTED VARIABLES
@@ -46,7 +82,79 @@ typedef enum
  **********************************************************************************************************/
 uint32_t get_seg_size_bytes(uint8_t seg_size_type);
 uint32_t calculate_no_of_segments(uint8_t *pkg_size, uint32_t seg_size_byte);
+/**
+ * @brief Checks a single status, only packages of up to FUOTA_SEG_STATUS_WINDOW segments fit in one
+ * @return true if the status covers the whole package and no segment is pending
+ */
 bool is_all_segments_downloaded(get_seg_file_status_t seg_file_status);
+
+/**
+ * @brief Starts tracking a package, every segment is pending
+ *
+ * @param p_tracker Pointer to the tracker
+ * @param p_words Storage of the bitmap
+ * @param u16_words Number of words of the storage
+ * @param u32_pkg_size Size of the package in bytes
+ * @param u32_seg_size Size of a segment in bytes
+ * @return true if the bitmap of the package fits in the storage
+ */
+bool fuota_seg_tracker_init(fuota_seg_tracker_t *p_tracker, uint32_t *p_words, uint16_t u16_words,
+                            uint32_t u32_pkg_size, uint32_t u32_seg_size);
+
+/**
+ * @brief Updates the state of up to 32 consecutive segments
+ *
+ * @param p_tracker Pointer to the tracker
+ * @param u32_first_segment Segment of bit 0 of the status
+ * @param u32_status Bit i is SEG_PENDING for segment u32_first_segment + i
+ * @param u8_count Number of segments in the status, at most 32
+ */
+void fuota_seg_tracker_update(fuota_seg_tracker_t *p_tracker, uint32_t u32_first_segment, uint32_t u32_status,
+                              uint8_t u8_count);
+
+/**
+ * @brief Number of segments of the package of a status
+ * @return 0 when the segment size is unknown
+ */
+uint32_t fuota_seg_tracker_get_segments(const get_seg_file_status_t *p_status);
+
+/**
+ * @brief Applies a status from the modem, statuses of a package can come over several events
+ *
+ * Bit i of seg_status is segment i, nxt_seg_id is not used. A status of another
+ * package, segment size or version restarts the tracking. A package of more
+ * than FUOTA_SEG_TRACKER_MAX_SEGMENTS segments is not tracked.
+ *
+ * @param p_tracker Pointer to the tracker
+ * @param p_words Storage of the bitmap
+ * @param u16_words Number of words of the storage
+ * @param p_status Status received
+ * @return true if no segment of the package is pending, false as well when the package is not tracked
+ */
+bool fuota_seg_tracker_apply_status(fuota_seg_tracker_t *p_tracker, uint32_t *p_words, uint16_t u16_words,
+                                    const get_seg_file_status_t *p_status);
+
+/**
+ * @brief Percent of the segments downloaded, 0 when nothing is tracked
+ */
+uint8_t fuota_seg_tracker_get_percent(const fuota_seg_tracker_t *p_tracker);
+
+/**
+ * @brief Checks all segments of the tracked package are downloaded
+ */
+bool fuota_seg_tracker_is_complete(const fuota_seg_tracker_t *p_tracker);
+
+/**
+ * @brief Lists the pending segments in ascending order
+ *
+ * @param p_tracker Pointer to the tracker
+ * @param u32_from First segment to look at, to continue a list which was cut
+ * @param p_list Buffer for the segment numbers
+ * @param u32_max Size of the buffer in entries
+ * @return Number of segments written to the list
+ */
+uint32_t fuota_seg_tracker_get_pending(const fuota_seg_tracker_t *p_tracker, uint32_t u32_from, uint32_t *p_list,
+                                       uint32_t u32_max);
 uint8_t get_cmd_type_from_seg_file_status(get_seg_file_status_t seg_file_status);
 #ifdef __cplusplus
 }
@@ -21,16 +21,27 @@
 #define LORAWAN_PORT 152
 
 // Interval in seconds for sending sensor data as uplink
+// The schedule can be set from the build flags, e.g. -DCSS_UPLINK_INTERVAL_SECONDS=30 for the simulation
 // #define UPLINK_INTERVAL_SECONDS /* (10) */ /* (20) */ (15) /* (5) */  /* 60 */
+#ifndef CSS_UPLINK_INTERVAL_SECONDS
 #define CSS_UPLINK_INTERVAL_SECONDS  (10) /* (5) */  /* 60 */
+#endif
+#ifndef FSK_UPLINK_INTERVAL_SECONDS
 #define FSK_UPLINK_INTERVAL_SECONDS  (15) /* (5) */  /* 60 */
+#endif
+#ifndef BLE_UPLINK_INTERVAL_SECONDS
 #define BLE_UPLINK_INTERVAL_SECONDS  (10) /* (5) */  /* 60 */
+#endif
 
 // Timeout in seconds for no response after last sent uplink
+#ifndef UPLINK_NO_RESPONSE_TIMEOUT_SECONDS
 #define UPLINK_NO_RESPONSE_TIMEOUT_SECONDS /* (10) */  (2)  /* 5  *//* 60 */
+#endif
 
 // Timeout before we attempt a reconnect (with no network)
+#ifndef NOT_CONN_LIMIT_BEF_RESTART
 #define NOT_CONN_LIMIT_BEF_RESTART (90)
+#endif
 
 // Data len (was depending on strlen() but if lat/lon had a '0' byte the length would be off)
 #define FIXED_ARRAY_LEN (9) // Protocol type + 4 bytes Lat + 4 bytes Lon
@@ -59,6 +70,24 @@
 #define HOST_APP_VERSION_MINOR    0x05
 #define HOST_APP_VERSION_PATCH    0x00
 
+// trace records formatted per idle loop iteration, the rest waits for the next one
+#define TRACE_FLUSH_PER_LOOP      4
+
+// pending segments listed by the fuota command, the count covers the rest
+#define FUOTA_STATUS_PRINT_SEGMENTS 16
+
+// block and repetitions of the checksum command, a ymodem packet checked 100 times
+#define CHECKSUM_TIMING_BLOCK_SIZE  1024
+#define CHECKSUM_TIMING_LOOPS       100
+
+// uart streams captured from the boot, the gnss sentences fill the ring much faster than the mcm frames
+#ifndef UART_CAPTURE_BOOT_MASK
+#define UART_CAPTURE_BOOT_MASK UART_CAPTURE_MASK_MCM
+#endif
+
+// time given to answer the firmware update prompt, the loop keeps running meanwhile
+#define FW_UPDATE_PROMPT_TIMEOUT_MS 30000
+
 // Payload - Data type (array[0])
 #define DATA_TYPE_GNSS_BLE (1)
 #define DATA_TYPE_GNSS_FSK (2)
@@ -82,7 +111,6 @@ typedef enum
     STATE_UPLINK_STATUS,
     STATE_IDLE,
     STATE_NO_LORAWAN_CRED,
-    STATE_FIRMWARE_UPDATE,
 } system_state;
 
 // Structure to hold the uplink data
@@ -81,6 +81,8 @@
 #include "lrwan_sidewalk_ex.h"
 #include "led_control.h"
 #include "gnss.h"
+#include "uart_capture.h"
+#include "checksum.h"
 
 /******************************************************************************
  * EXTERN VARIABLES
@@ -118,6 +120,13 @@ uplink_data_t uplink_data;
 
 static bool is_device_joined = false;
 
+/**
+ * @brief Time spent in loop(), reported by the stats command
+ */
+static uint32_t loop_count   = 0;
+static uint32_t loop_sum_us  = 0;
+static uint32_t loop_max_us  = 0;
+
 /**
  * @brief Device connection mode.
  *
@@ -175,7 +184,7 @@ static void read_sensor(void /* float *temperature, float *humidity */);
  * @return True if successful, false otherwise.
  */
 // static bool send_uplink(float temperature, float humidity);
-static bool send_uplink(uint8_t *data_send, uint16_t datalen);
+static bool send_uplink(uplink_data_t *p_uplink_data, uint16_t datalen);
 
 /**
  * @brief Handles the downlink data.
@@ -232,6 +241,26 @@ static void store_retrieve_GNSS(uint8_t store_or_retrieve, gnss_data_t *gnss_dat
  */
 static void print_state(void);
 
+/**
+ * @brief Runs one step of the application state machine, called from loop()
+ *
+ */
+void run_state_machine();
+
+/**
+ * @brief Asks whether to apply a downloaded firmware, the answer is read without blocking the loop
+ *
+ * @param is_new_firmware True when a firmware has just been downloaded, starts the prompt
+ */
+static void process_fw_update_prompt(bool is_new_firmware);
+
+/**
+ * @brief Reads and writes the progress record of the host firmware download in NVS,
+ *        so a download interrupted by a reset resumes after the committed blocks
+ */
+static bool load_fw_progress(fw_resume_record_t *p_record, void *user_context);
+static bool save_fw_progress(const fw_resume_record_t *p_record, void *user_context);
+
 /******************************************************************************
  * STATIC FUNCTIONS
  ******************************************************************************/
@@ -265,7 +294,9 @@ static bool initiate_network_join()
     return true;
 }
 
+#ifndef TIME_TO_WAIT_FOR_VALID_GNSS
 #define TIME_TO_WAIT_FOR_VALID_GNSS (2200) // 2 seconds + buffer as GNSS is on a 1 second schedule
+#endif
 // Spinning to wait for valid GNSS data as we were seeing occasional 0,0's that didn't make sense
 static void read_sensor(void)
 {
@@ -342,7 +373,7 @@ static void read_sensor(void)
 #endif
 }
 
-static bool send_uplink(uint8_t *data_send, uint16_t datalen)
+static bool send_uplink(uplink_data_t *p_uplink_data, uint16_t datalen)
 {
     bool uplink_done = false;
 
@@ -387,15 +418,11 @@ static bool send_uplink(uint8_t *data_send, uint16_t datalen)
         // Code to send uplink with temperature and humidity data
         // Serial.printf("Sending uplink: Temp = %.2f, Humidity = %.2f, Reboot counter = %d\r\n", temperature, humidity, uplink_data.reboot_count);
 
-        uplink_data_t uplink_data = {0}; // Initialize the uplink_data structure
-        // uplink_data.dta = {0}; // Initialize the data field to 0
-        memcpy(uplink_data.dta, data_send, data_len); // Copy the data to the uplink_data structure
-
-        // reboot counter is already assigned on bootup
+        // uplink data is built in place by the caller and handed down to the uart without a copy
         Serial.print("Uplink in hex: ");
-        helper_print_hex_array((uint8_t *)&uplink_data, sizeof(uplink_data));
+        helper_print_hex_array((uint8_t *)p_uplink_data, sizeof(uplink_data_t));
 
-        mcm.send_uplink((uint8_t *)&uplink_data, sizeof(uplink_data), LORAWAN_PORT, /*  MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF */ MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_CONF);
+        mcm.send_uplink((uint8_t *)p_uplink_data, sizeof(uplink_data_t), LORAWAN_PORT, /*  MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF */ MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_CONF);
 
         uplink_done = true; // Assume success if we reach this point
 
@@ -409,39 +436,35 @@ static bool handle_downlink()
 {
     bool rtn_val = false;
 
-    // lets check if any download is available
-    if (mcm.is_downlink_available())
+    // lets check if any download is available, a class c burst is handled at once
+    mcm_downlink_t *downlink;
+    while (nullptr != (downlink = mcm.borrow_downlink()))
     {
         set_led_state(LED_RECEIVED_DOWNLINK);
 
         Serial.println("--------------------Downlink available--------------------");
-        // retrieve the downlink and meta data
-        uint8_t received_data[BUFFER_SIZE];
-        uint16_t received_len;
-        int8_t rssi;
-        int8_t snr;
-        uint16_t seq_port;
-
-        mcm.get_downlink_data(received_data, &received_len, &rssi, &snr, &seq_port);
-
-        Serial.printf("Rssi: %d\r\n", rssi);
-        Serial.printf("Snr: %d\r\n", snr);
-        if (ConnectionMode::CONNECTION_MODE_LORAWAN == mcm.get_connect_mode())
+        // downlink and meta data are read in place from the pool slot
+        Serial.printf("Rssi: %d\r\n", downlink->rssi);
+        Serial.printf("Snr: %d\r\n", downlink->snr);
+        if (COMMAND_TYPE_LORAWAN == downlink->protocol)
         {
             // if mode is lorawan then its port
-            Serial.printf("Lorawan port: %d\r\n", seq_port);
+            Serial.printf("Lorawan port: %d\r\n", downlink->seq_port);
         }
         else
         {
             // if mode is sidewalk then its sidewalk sequence
-            Serial.printf("Sidewalk sequence: %d\r\n", seq_port);
+            Serial.printf("Sidewalk sequence: %d\r\n", downlink->seq_port);
         }
 
-        Serial.printf("Receivced payload Size: %d\r\n", received_len);
+        Serial.printf("Receivced payload Size: %d\r\n", downlink->len);
         Serial.println("Received Downlink data: ");
-        helper_print_hex_array(received_data, received_len);
+        helper_print_hex_array(downlink->payload, downlink->len);
         Serial.printf("\r\n");
 
+        // slot goes back to the pool
+        mcm.release_downlink(downlink);
+
         // Set flag that downlink arrived
         rtn_val = true;
 
@@ -598,6 +621,20 @@ static void initSPIFFS()
     Serial.println("SPIFFS mounted successfully");
 }
 
+static bool load_fw_progress(fw_resume_record_t *p_record, void *user_context)
+{
+    return nvs_storage_get_fw_progress((uint8_t *)p_record, sizeof(fw_resume_record_t));
+}
+
+static bool save_fw_progress(const fw_resume_record_t *p_record, void *user_context)
+{
+    if (NULL == p_record)
+    {
+        return nvs_storage_clear_fw_progress();
+    }
+    return nvs_storage_set_fw_progress((const uint8_t *)p_record, FW_RESUME_RECORD_SIZE(p_record->u32_committed));
+}
+
 /******************************************************************************
  * GLOBAL FUNCTIONS
  ******************************************************************************/
@@ -675,6 +712,12 @@ void setup()
     pinMode(BUTTON_PIN, INPUT_PULLUP);
     attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), buttonISR, FALLING);
 
+    // host firmware downloads keep their progress in NVS
+    mcm.ymodem.setProgressStorage(load_fw_progress, save_fw_progress, NULL);
+
+    // the reset notification of the mcm is the first record
+    uart_capture_start(UART_CAPTURE_BOOT_MASK);
+
     // Initialize peripherals and callback functions etc. related to serial interface with MCM.
     MCM_STATUS status = mcm.begin();
 
@@ -759,6 +802,8 @@ void loop()
     // structure to retrieve and hold the gnss data
     // static gnss_data_t gnss_data = {0};
 
+    uint32_t loop_start_us = micros();
+
     process_blink_requests(); // Add this line to process LED states
     // Run the state machine to handle the current application state
     // This function checks the current state and performs the appropriate actions
@@ -789,6 +834,20 @@ void loop()
     }
 #endif
 
+    // trace records are formatted only while no command is waiting for its response
+    if (!mcm.is_command_pending())
+    {
+        trace_buffer_flush(TRACE_FLUSH_PER_LOOP);
+    }
+
+    uint32_t loop_us = micros() - loop_start_us;
+    loop_count++;
+    loop_sum_us += loop_us;
+    if (loop_us > loop_max_us)
+    {
+        loop_max_us = loop_us;
+    }
+
 #endif
 }
 
@@ -796,7 +855,7 @@ void loop()
  * @brief Array of state names corresponding to the system_state enum.
  */
 const char *state_names[] = {"STATE_SET_CONNECT_MODE", "STATE_JOIN_NETWORK",    "STATE_READ_SENSOR",          "STATE_SEND_UPLINK", "STATE_UPLINK_STATUS", "STATE_IDLE",
-                             "STATE_NO_LORAWAN_CRED",  "STATE_FIRMWARE_UPDATE", "STATE_HOST_FIRMWARE_UPDATE", "UNKNOWN_STATE"};
+                             "STATE_NO_LORAWAN_CRED",  "UNKNOWN_STATE"};
 
 /**
  * @brief Sets the current state of the system and prints the state name to the Serial monitor.
@@ -824,7 +883,8 @@ void run_state_machine()
     static uint32_t time_last_connected = millis(); // Time not connected
 
     // check for new binary file downloaded
-    if (mcm.is_new_firmware())
+    bool is_new_firmware = mcm.is_new_firmware();
+    if (is_new_firmware)
     {
         // Check binary type from segment file status
         if (mcm.seg_file_status.cmd_type.bin_type == FUOTA_BINARY_TYPE_MCM)
@@ -839,8 +899,9 @@ void run_state_machine()
         {
             Serial.println("Unknown binary type downloaded");
         }
-        set_state(STATE_FIRMWARE_UPDATE);
     }
+    // the states go on while the prompt waits for its answer
+    process_fw_update_prompt(is_new_firmware);
 
     check_device_connection();
 
@@ -897,8 +958,9 @@ void run_state_machine()
             // if uplink is done then go to the next state
             // otherwise keep in idle state
 
-            // Create array of location data
-            uint8_t xmt_array[19] = {0}; // 1 byte for type, 16 (MAX_USER_PAYLOAD) bytes for data, 2 bytes for overhead
+            // Create location data directly in the uplink payload, unused bytes and reboot count are sent as 0
+            uplink_data_t uplink_payload = {0};
+            uint8_t *xmt_array = uplink_payload.dta; // 1 byte for type, 8 bytes for lat/lon, rest of MAX_USER_PAYLOAD is padding
 
             // retrieve latitude and longitude from "store_retrieve_GNSS" function and insert
             // these values into the array (convert floats to uint32_t by multiplying by 1000000
@@ -939,7 +1001,7 @@ void run_state_machine()
             xmt_array[7] = (longitude >> 8) & 0xFF;
             xmt_array[8] = longitude & 0xFF;
 
-            if (send_uplink(xmt_array, FIXED_ARRAY_LEN /* temp, hum */))
+            if (send_uplink(&uplink_payload, FIXED_ARRAY_LEN /* temp, hum */))
             {
                 set_state(STATE_UPLINK_STATUS);
                 last_uplink_time = millis();
@@ -1001,16 +1063,15 @@ void run_state_machine()
             break;
 
         case STATE_IDLE: {
-            // do nothing if ymodem transfer is going on
-            if (mcm.ymodem.getState() != YMODEM_IDLE)
-            {
-                break;
-            }
+            // the file transfer owns the uart, no event nor downlink is read until it is over,
+            // uplinks are held by mcm meanwhile
+            bool is_transfer_active = mcm.is_file_transfer_active();
+
             // Handle downlink if any
             bool data_arrived = handle_downlink();
 
             // If MCM has been rebooted, set the connection mode again
-            if (mcm.get_context_mgr_is_mcm_reset())
+            if (!is_transfer_active && mcm.get_context_mgr_is_mcm_reset())
             {
                 get_seg_file_status_t file_status;
                 // send get segment command
@@ -1025,7 +1086,8 @@ void run_state_machine()
             // RAS Add 4/12/25
             // Check for not connected beyond limit
             // If so, go back to connect mode
-            if (data_arrived == true /*            mcm.is_connected()    */)
+            // no downlink is read during a transfer, it is no drought
+            if ((data_arrived == true /*            mcm.is_connected()    */) || is_transfer_active)
             {
                 time_last_connected = millis(); // Reset the counter
             }
@@ -1088,58 +1150,337 @@ void run_state_machine()
 
             break;
         }
-        case STATE_FIRMWARE_UPDATE: {
-            Serial.println("Do you want to proceed with firmware update? (y/n)");
-            unsigned long start_time = millis();
-            while (!Serial.available())
-            {
-                if (millis() - start_time > 30000)
-                { // 30 seconds timeout
-                    Serial.println("Timeout waiting for input.");
-                    break; // Exit the function or handle timeout as needed
-                }
-            }
+        default:
+            // Handle unexpected states
+            break;
+    }
+}
+
+static void process_fw_update_prompt(bool is_new_firmware)
+{
+    static bool is_prompt_active = false;
+    static uint32_t prompt_start_time = 0;
+
+    if (is_new_firmware)
+    {
+        Serial.println("Do you want to proceed with firmware update? (y/n)");
+        is_prompt_active = true;
+        prompt_start_time = millis();
+        return;
+    }
+    if (!is_prompt_active)
+    {
+        return;
+    }
 
-            char response = Serial.read();
+    // read before the cli, so the answer is not taken as a command
+    int response = -1;
+    if (Serial.available())
+    {
+        response = Serial.read();
+        // Clear any remaining characters in buffer
+        while (Serial.available())
+        {
+            Serial.read();
+        }
+    }
+    else if ((millis() - prompt_start_time) <= FW_UPDATE_PROMPT_TIMEOUT_MS)
+    {
+        return;
+    }
+    else
+    {
+        Serial.println("Timeout waiting for input.");
+    }
+    is_prompt_active = false;
 
-            // Clear any remaining characters in buffer
-            while (Serial.available())
+    if (response == 'y' || response == 'Y')
+    {
+        // the transfer runs in the background, from mcm.handle_rx_events()
+        Serial.println("Proceeding with firmware update...");
+        mcm.process_fw_update();
+    }
+    else
+    {
+        Serial.println("Firmware update cancelled");
+        set_state(STATE_SET_CONNECT_MODE);
+    }
+}
+
+void send_uplink_now()
+{
+    currentState = STATE_READ_SENSOR;
+}
+
+void send_fw_update_request()
+{
+    get_seg_file_status_t file_status;
+    // send get segment command
+    mcm.get_segmented_file_download_status(&file_status);
+}
+
+void print_link_stats(bool reset)
+{
+    // too large for the loop task stack
+    static api_metrics_t metrics;
+    mcm.get_metrics(&metrics, reset);
+
+    const api_metrics_link_t *link = &metrics.h_link;
+    Serial.printf("Link: in %lu B, out %lu B, frames %lu, crc err %lu, len err %lu, resync %lu, dropped %lu B\n",
+                  (unsigned long)link->u32_bytes_in, (unsigned long)link->u32_bytes_out,
+                  (unsigned long)link->u32_frames_in, (unsigned long)link->u32_crc_errors,
+                  (unsigned long)link->u32_length_errors, (unsigned long)link->u32_resync_count,
+                  (unsigned long)link->u32_dropped_bytes);
+
+    for (uint8_t slot = 0; slot < MROVER_CC_TABLE_SIZE; slot++)
+    {
+        const api_metrics_cmd_t *cmd = &metrics.h_cmd[slot];
+        if (cmd->u32_sent == 0)
+        {
+            continue;
+        }
+        uint32_t measured = 0;
+        for (uint8_t i = 0; i < API_METRICS_RTT_BUCKETS; i++)
+        {
+            measured += cmd->u32_rtt_buckets[i];
+        }
+        Serial.printf("%s (0x%04X): sent %lu, ok %lu, timeout %lu, avg %lu ms, max %lu ms\n",
+                      api_processor_get_cmd_name(cmd->u16_cmd_code), cmd->u16_cmd_code,
+                      (unsigned long)cmd->u32_sent, (unsigned long)cmd->u32_ok,
+                      (unsigned long)cmd->u32_timeouts,
+                      (unsigned long)(measured ? (cmd->u32_rtt_sum_ms / measured) : 0),
+                      (unsigned long)cmd->u32_rtt_max_ms);
+        for (uint8_t i = 0; i < API_METRICS_FAILURE_CODES; i++)
+        {
+            if (cmd->u32_failed[i])
             {
-                Serial.read();
+                mrover_return_code_t rc = api_metrics_get_failure_code(i);
+                if (rc == MROVER_RC_OK)
+                {
+                    Serial.printf("    fail other rc: %lu\n", (unsigned long)cmd->u32_failed[i]);
+                }
+                else
+                {
+                    Serial.printf("    fail rc 0x%02X: %lu\n", rc, (unsigned long)cmd->u32_failed[i]);
+                }
             }
-
-            if (response == 'y' || response == 'Y')
+        }
+        Serial.print("    rtt");
+        for (uint8_t i = 0; i < API_METRICS_RTT_BUCKETS; i++)
+        {
+            uint32_t bound = api_metrics_get_rtt_bound_ms(i);
+            if (bound)
             {
-                Serial.println("Proceeding with firmware update...");
-                mcm.process_fw_update();
-                set_state(STATE_IDLE);
-                delay(1000);
+                Serial.printf(" <=%lu:%lu", (unsigned long)bound, (unsigned long)cmd->u32_rtt_buckets[i]);
             }
             else
             {
-                Serial.println("Firmware update cancelled");
-                set_state(STATE_SET_CONNECT_MODE);
+                Serial.printf(" more:%lu", (unsigned long)cmd->u32_rtt_buckets[i]);
             }
+        }
+        Serial.println();
+    }
 
-            break;
+    for (uint8_t i = 0; i < API_METRICS_EVENT_CODES; i++)
+    {
+        if (metrics.u32_events[i] == 0)
+        {
+            continue;
+        }
+        int16_t code = api_metrics_get_event_code(i);
+        if (code < 0)
+        {
+            Serial.printf("Event other: %lu\n", (unsigned long)metrics.u32_events[i]);
+        }
+        else
+        {
+            Serial.printf("Event 0x%02X: %lu\n", code, (unsigned long)metrics.u32_events[i]);
         }
+    }
 
-        default:
-            // Handle unexpected states
-            break;
+    Serial.printf("Loop: %lu iterations, avg %lu us, max %lu us\n", (unsigned long)loop_count,
+                  (unsigned long)(loop_count ? (loop_sum_us / loop_count) : 0), (unsigned long)loop_max_us);
+
+    trace_buffer_stats_t trace_stats;
+    trace_buffer_get_stats(&trace_stats, reset);
+    Serial.printf("Trace: written %lu, dropped %lu, flushed %lu, pending %u words, max %u words\n",
+                  (unsigned long)trace_stats.u32_written, (unsigned long)trace_stats.u32_dropped,
+                  (unsigned long)trace_stats.u32_flushed, trace_stats.u16_pending_words,
+                  trace_stats.u16_max_pending_words);
+    if (reset)
+    {
+        loop_count  = 0;
+        loop_sum_us = 0;
+        loop_max_us = 0;
     }
 }
 
-void send_uplink_now()
+void print_fuota_status()
 {
-    currentState = STATE_READ_SENSOR;
+    const fuota_seg_tracker_t *tracker = mcm.get_segment_tracker();
+    uint32_t pending[FUOTA_STATUS_PRINT_SEGMENTS];
+
+    if (0 == tracker->u32_segments)
+    {
+        Serial.println("FUOTA: no segmented download reported");
+        return;
+    }
+    Serial.printf("FUOTA: v%d.%d.%d, %lu B in %lu segments, %u %% downloaded, %lu pending\n",
+                  tracker->h_version.major, tracker->h_version.minor, tracker->h_version.patch,
+                  (unsigned long)tracker->u32_pkg_size, (unsigned long)tracker->u32_segments,
+                  fuota_seg_tracker_get_percent(tracker), (unsigned long)tracker->u32_pending);
+
+    uint32_t count = fuota_seg_tracker_get_pending(tracker, 0, pending, FUOTA_STATUS_PRINT_SEGMENTS);
+    if (0 != count)
+    {
+        Serial.print("Pending:");
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Serial.printf(" %lu", (unsigned long)pending[i]);
+        }
+        Serial.println((tracker->u32_pending > count) ? " ..." : "");
+    }
 }
 
-void send_fw_update_request()
+void print_trace_log()
 {
-    get_seg_file_status_t file_status;
-    // send get segment command
-    mcm.get_segmented_file_download_status(&file_status);
+    // formats everything waiting in the trace buffer, even with a command pending
+    while (trace_buffer_flush(TRACE_FLUSH_PER_LOOP))
+    {
+    }
+}
+
+static void print_checksum_rate(const char *name, uint32_t elapsed_us)
+{
+    uint64_t bytes = (uint64_t)CHECKSUM_TIMING_BLOCK_SIZE * CHECKSUM_TIMING_LOOPS;
+    Serial.printf("%s: %lu ns per block, %lu KB/s\n", name,
+                  (unsigned long)(((uint64_t)elapsed_us * 1000) / CHECKSUM_TIMING_LOOPS),
+                  (unsigned long)((0 != elapsed_us) ? ((bytes * 1000000) / ((uint64_t)elapsed_us * 1024)) : 0));
+}
+
+void print_checksum_timing()
+{
+    static uint8_t block[CHECKSUM_TIMING_BLOCK_SIZE];
+    uint32_t sink = 0;
+    uint32_t start_us;
+
+    for (uint32_t i = 0; i < sizeof(block); i++)
+    {
+        block[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    // interrupts keep running, a uart burst during the loop shows up in the time
+    Serial.printf("Checksum of a %u B block, %u loops\n", (unsigned)sizeof(block), (unsigned)CHECKSUM_TIMING_LOOPS);
+    start_us = micros();
+    for (uint32_t i = 0; i < CHECKSUM_TIMING_LOOPS; i++)
+    {
+        sink += checksum_crc16_update(CHECKSUM_CRC16_INIT, block, sizeof(block));
+    }
+    print_checksum_rate("crc16", micros() - start_us);
+
+    start_us = micros();
+    for (uint32_t i = 0; i < CHECKSUM_TIMING_LOOPS; i++)
+    {
+        sink += checksum_xor8_update(CHECKSUM_XOR8_INIT, block, sizeof(block));
+    }
+    print_checksum_rate("xor8", micros() - start_us);
+
+    start_us = micros();
+    for (uint32_t i = 0; i < CHECKSUM_TIMING_LOOPS; i++)
+    {
+        sink += checksum_crc32_update(CHECKSUM_CRC32_INIT, block, sizeof(block));
+    }
+    print_checksum_rate("crc32", micros() - start_us);
+
+    // keeps the loops from being optimised away
+    Serial.printf("sink %08lx\n", (unsigned long)sink);
+}
+
+static void print_capture_status()
+{
+    uart_capture_stats_t stats;
+    uart_capture_get_stats(&stats);
+    uint8_t mask = uart_capture_get_mask();
+
+    Serial.printf("Capture:%s%s%s, %lu records, %lu overwritten, %lu of %u B used\n",
+                  (mask & UART_CAPTURE_MASK_MCM) ? " mcm" : "", (mask & UART_CAPTURE_MASK_GNSS) ? " gnss" : "",
+                  (0 == mask) ? " off" : "", (unsigned long)stats.u32_records, (unsigned long)stats.u32_overwritten,
+                  (unsigned long)stats.u32_used, (unsigned)UART_CAPTURE_BUFFER_SIZE);
+    Serial.printf("mcm rx %lu B, mcm tx %lu B, gnss rx %lu B, gnss tx %lu B\n",
+                  (unsigned long)stats.u32_bytes[UART_CAPTURE_MCM_RX], (unsigned long)stats.u32_bytes[UART_CAPTURE_MCM_TX],
+                  (unsigned long)stats.u32_bytes[UART_CAPTURE_GNSS_RX], (unsigned long)stats.u32_bytes[UART_CAPTURE_GNSS_TX]);
+}
+
+/**
+ * @brief Prints the capture file as hex lines, bench/uart_replay.cpp turns a console log back into the file
+ */
+static void dump_capture()
+{
+    uint8_t data[UART_CAPTURE_DUMP_LINE_BYTES];
+    uint16_t crc = CHECKSUM_CRC16_INIT;
+    uint32_t offset = 0;
+    uint32_t read_size;
+
+    // new records would overwrite the ones being printed
+    uint8_t mask = uart_capture_get_mask();
+    uart_capture_start(0);
+
+    Serial.printf("%s %lu\n", UART_CAPTURE_DUMP_BEGIN, (unsigned long)uart_capture_get_file_size());
+    while ((read_size = uart_capture_read_file(offset, data, sizeof(data))) > 0)
+    {
+        Serial.print(UART_CAPTURE_DUMP_LINE);
+        for (uint32_t i = 0; i < read_size; i++)
+        {
+            Serial.printf("%02x", data[i]);
+        }
+        Serial.println();
+        crc = checksum_crc16_update(crc, data, read_size);
+        offset += read_size;
+    }
+    Serial.printf("%s %04x\n", UART_CAPTURE_DUMP_END, crc);
+
+    uart_capture_start(mask);
+}
+
+void run_capture_command(const char *arg)
+{
+    if ((NULL == arg) || (0 == strlen(arg)) || (0 == strcmp(arg, "status")))
+    {
+        print_capture_status();
+    }
+    else if (0 == strcmp(arg, "mcm"))
+    {
+        uart_capture_start(UART_CAPTURE_MASK_MCM);
+    }
+    else if (0 == strcmp(arg, "gnss"))
+    {
+        uart_capture_start(UART_CAPTURE_MASK_GNSS);
+        Serial.printf("GNSS sentences fill the %u B ring in about 2 minutes, dump it before they overwrite it\n",
+                      (unsigned)UART_CAPTURE_BUFFER_SIZE);
+    }
+    else if (0 == strcmp(arg, "all"))
+    {
+        // the gnss sentences push the mcm frames out of the ring within minutes
+        uart_capture_start(UART_CAPTURE_MASK_ALL);
+        Serial.printf("GNSS sentences fill the %u B ring in about 2 minutes, dump it before they overwrite the MCM frames\n",
+                      (unsigned)UART_CAPTURE_BUFFER_SIZE);
+    }
+    else if (0 == strcmp(arg, "off"))
+    {
+        uart_capture_start(0);
+    }
+    else if (0 == strcmp(arg, "clear"))
+    {
+        uart_capture_clear();
+    }
+    else if (0 == strcmp(arg, "dump"))
+    {
+        dump_capture();
+    }
+    else
+    {
+        Serial.println("Usage: capture [status|mcm|gnss|all|off|clear|dump]");
+    }
 }
 
 static void handleButtonPress()
@@ -69,6 +69,7 @@
 #include <cstdio>
 #include "mcm_rover.h"
 #include "host_fuota.h"
+#include "uart_capture.h"
 
 /******************************************************************************
  * EXTERN VARIABLES
@@ -77,6 +78,9 @@
 /******************************************************************************
  * PRIVATE MACROS AND DEFINES
  ******************************************************************************/
+#define TRACE_MODULE_LEVEL                  TRACE_LEVEL_MCM
+
+static_assert(MCM_DOWNLINK_POOL_SLOTS <= 32, "downlink_in_use has a bit per slot");
 
 /******************************************************************************
  * PRIVATE TYPEDEFS
@@ -85,14 +89,10 @@
 /******************************************************************************
  * STATIC VARIABLES
  ******************************************************************************/
-uint8_t temp_buffer[BUFFER_SIZE];
-String version;
-
-// TODO: remove it after the mcm reset bug fixed
-//  currently there is a bug,due to which
-// mcm gives 2 events for software reset
-//  this is a workaround
-uint16_t reset_event_count = 0;
+// trace records are written from the rx task and the loop
+static portMUX_TYPE trace_mux = portMUX_INITIALIZER_UNLOCKED;
+// capture records are written from the uart event task and the loop
+static portMUX_TYPE capture_mux = portMUX_INITIALIZER_UNLOCKED;
 /******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
@@ -120,34 +120,113 @@ uint16_t reset_event_count = 0;
 static uint16_t on_send_function(uint8_t *data, uint16_t size, void *ctx)
 {
     MCM *curr_instance = (MCM *)ctx;
-    curr_instance->set_received_size(0);
-    curr_instance->set_is_rx_received(0);
-    Serial.printf("HMI TX: (%d Bytes)", size);
-    for (int i = 0; i < size; i++)
+    // a frame in the middle of the ymodem stream would break the transfer
+    if (curr_instance->is_file_transfer_active())
     {
-        Serial.printf(" %02x", data[i]);
+        TRACE_INFO("HMI TX: cc 0x%04x refused, file transfer in progress\n", (data[1] << 8) | data[2]);
+        return 0;
     }
-    Serial.println("");
+    curr_instance->begin_command((mrover_cc_codes_t)((data[1] << 8) | data[2]));
+    TRACE_INFO("HMI TX: cc 0x%04x (%d Bytes)\n", (data[1] << 8) | data[2], size);
+    UART_CAPTURE(curr_instance->get_capture_port(), UART_CAPTURE_MCM_TX, data, size);
     return (uint16_t)curr_instance->get_serial().write(data, size);
 }
 
+static uint16_t on_send_vec_function(const serial_iovec_t *iov, uint8_t iov_count, void *ctx)
+{
+    MCM *curr_instance = (MCM *)ctx;
+    if (curr_instance->is_file_transfer_active())
+    {
+        TRACE_INFO("HMI TX: cc 0x%04x refused, file transfer in progress\n",
+                   (iov[0].p_data[1] << 8) | iov[0].p_data[2]);
+        return 0;
+    }
+    // first part always carries the whole header
+    curr_instance->begin_command((mrover_cc_codes_t)((iov[0].p_data[1] << 8) | iov[0].p_data[2]));
+
+    uint16_t size = 0;
+    for (uint8_t part = 0; part < iov_count; part++)
+    {
+        size += iov[part].u16_len;
+    }
+
+    TRACE_INFO("HMI TX: cc 0x%04x (%d Bytes)\n", (iov[0].p_data[1] << 8) | iov[0].p_data[2], size);
+
+    // parts are written back to back, uart tx buffer gathers them into one frame
+    uint16_t sent = 0;
+    for (uint8_t part = 0; part < iov_count; part++)
+    {
+        UART_CAPTURE(curr_instance->get_capture_port(), UART_CAPTURE_MCM_TX, iov[part].p_data, iov[part].u16_len);
+        sent += (uint16_t)curr_instance->get_serial().write(iov[part].p_data, iov[part].u16_len);
+    }
+    return sent;
+}
+
+static uint32_t on_tick_function(void)
+{
+    return (uint32_t)millis();
+}
+
+static uint32_t on_trace_tick(void)
+{
+    return (uint32_t)micros();
+}
+
+static void on_trace_lock(void)
+{
+    portENTER_CRITICAL(&trace_mux);
+}
+
+static void on_trace_unlock(void)
+{
+    portEXIT_CRITICAL(&trace_mux);
+}
+
+static void on_capture_lock(void)
+{
+    portENTER_CRITICAL(&capture_mux);
+}
+
+static void on_capture_unlock(void)
+{
+    portEXIT_CRITICAL(&capture_mux);
+}
+
+static void on_trace_output(const char *line)
+{
+    Serial.print(line);
+}
+
+static bool is_rx_ymodem(void *user_context)
+{
+    // state is changed by the loop, the rx task reads it
+    MCM *curr_instance = (MCM *)user_context;
+    return (YMODEM_IDLE != curr_instance->ymodem.getState());
+}
+
+static void mcm_rx_task(void *ctx)
+{
+    MCM *curr_instance = (MCM *)ctx;
+    curr_instance->run_rx_task();
+}
+
 static void handle_notification(void *ctx)
 {
     MCM *curr_instance = (MCM *)ctx;
     // Host application could do any relevant action based on the notification
     if (curr_instance->get_is_debug_enabled())
     {
-        Serial.printf("Notification received\n");
-        Serial.printf("Number of pending events are %d\n", api_processor_get_pending_events(curr_instance->get_module_handle()));
+        TRACE_INFO("Notification received\n");
+        TRACE_INFO("Number of pending events are %d\n", api_processor_get_pending_events(curr_instance->get_module_handle()));
     }
 } 
 
-static void handle_mcm_response(const api_processor_response_t *mcm_response, void *ctx)
+static void dispatch_mcm_response(const api_processor_response_t *mcm_response, void *ctx)
 {
     MCM *curr_instance = (MCM *)ctx;
 
     if (curr_instance->get_is_debug_enabled())
-        Serial.printf("Response received\n");
+        TRACE_INFO("Response received\n");
 
     /**
      * @brief Using the return code we can analyze that the last command was successful or not
@@ -158,13 +237,13 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
     {
         if (curr_instance->get_is_debug_enabled())
         {
-            Serial.printf("Last command failed with error code %d\n", mcm_response->return_code);
-            Serial.printf("Last command is 0x%04x\n", mcm_response->cmd_code);
+            TRACE_INFO("Last command failed with error code %d\n", mcm_response->return_code);
+            TRACE_INFO("Last command is 0x%04x\n", mcm_response->cmd_code);
         }
         mrover_cc_codes_t cmd_code = mcm_helper_get_command_code(mcm_response);
         if(MROVER_CC_FILE_STATUS == cmd_code)
         {
-          Serial.printf("No file found.\n");
+          TRACE_INFO("No file found.\n");
         }
         return;
     }
@@ -180,10 +259,10 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
     {
     case MROVER_CC_GET_EVENT:
     {
-        Serial.printf("MROVER_CC_GET_EVENT\n");
+        TRACE_INFO("MROVER_CC_GET_EVENT\n");
         // get event command always carries the number of pending events to be read
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Number of pending events are %d\n", api_processor_get_pending_events(curr_instance->get_module_handle()));
+            TRACE_INFO("Number of pending events are %d\n", api_processor_get_pending_events(curr_instance->get_module_handle()));
 
         /**
          * @brief Now the command response data contains the data related to the command.
@@ -196,20 +275,20 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
         {
         case MODEM_EVENT_RESET:
         {
-            Serial.printf("MODEM_EVENT_RESET\n");
+            TRACE_INFO("MODEM_EVENT_RESET\n");
             if (curr_instance->get_is_debug_enabled())
             {
-                Serial.printf("Response of the reset command has been received\n");
+                TRACE_INFO("Response of the reset command has been received\n");
                 /**
                  * @brief data related to the get event has been in the get_event_data_value,
                  * The reset event contain its own data set in the reset data structure, which has single value of reset count
                  *
                  */
-                Serial.printf("Reset count %d\n", mcm_helper_get_event_reset_count(mcm_response));
+                TRACE_INFO("Reset count %d\n", mcm_helper_get_event_reset_count(mcm_response));
             }
-            reset_event_count++;
-            // Serial.printf("Reset count %d\n", reset_event_count);
-            // if(reset_event_count <= 2)
+            curr_instance->increment_reset_event_count();
+            // Serial.printf("Reset count %d\n", curr_instance->get_reset_event_count());
+            // if(curr_instance->get_reset_event_count() <= 2)
             //     break;
 
             // reset the module
@@ -237,16 +316,16 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
              * No data is associated with this event type
              */
             {
-                Serial.printf("MODEM_EVENT_JOINED\n");
+                TRACE_INFO("MODEM_EVENT_JOINED\n");
                 if (COMMAND_TYPE_LORAWAN == mcm_helper_get_command_type(mcm_response))
                 {
                     if (curr_instance->get_is_debug_enabled())
-                        Serial.printf("Device has been successfully joined to lorawan network\n");
+                        TRACE_INFO("Device has been successfully joined to lorawan network\n");
                 }
                 else if (COMMAND_TYPE_SIDEWALK == mcm_response->cmd_type)
                 {
                     if (curr_instance->get_is_debug_enabled())
-                        Serial.printf("Device has been successfully time synced to sidewalk network\n");
+                        TRACE_INFO("Device has been successfully time synced to sidewalk network\n");
                 }
 
                 curr_instance->set_is_joined_network(true);
@@ -261,16 +340,16 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
          */
         case MODEM_EVENT_JOINFAIL:
         {
-            Serial.printf("MODEM_EVENT_JOINFAIL\n");
+            TRACE_INFO("MODEM_EVENT_JOINFAIL\n");
             if (COMMAND_TYPE_LORAWAN == mcm_helper_get_command_type(mcm_response))
             {
                 if (curr_instance->get_is_debug_enabled())
-                    Serial.printf("Join fail event occurred\n");
+                    TRACE_INFO("Join fail event occurred\n");
             }
             else if (COMMAND_TYPE_SIDEWALK == mcm_helper_get_command_type(mcm_response))
             {
                 if (curr_instance->get_is_debug_enabled())
-                    Serial.printf("Sidewalk time sync fail event\n");
+                    TRACE_INFO("Sidewalk time sync fail event\n");
             }
             curr_instance->set_is_joined_network(false);
         }
@@ -288,28 +367,28 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
              *
              */
             {
-                Serial.printf("MODEM_EVENT_TXDONE\n");
+                TRACE_INFO("MODEM_EVENT_TXDONE\n");
                 curr_instance->set_is_last_uplink_pending(false);
                 switch (mcm_helper_get_event_tx_status(mcm_response))
                 {
                 case MROVER_TX_NOT_SEND:
-                    Serial.printf("MROVER_TX_NOT_SEND\n");
+                    TRACE_INFO("MROVER_TX_NOT_SEND\n");
                     if (curr_instance->get_is_debug_enabled())
-                        Serial.printf("Unable to send the last packet\n");
+                        TRACE_INFO("Unable to send the last packet\n");
                     curr_instance->set_last_tx_status(MCM_TX_STATUS ::MCM_TX_NOT_SEND);
                     break;
 
                 case MROVER_TX_DONE_WITHOUT_ACK:
-                    Serial.printf("MROVER_TX_DONE_WITHOUT_ACK\n");
+                    TRACE_INFO("MROVER_TX_DONE_WITHOUT_ACK\n");
                     if (curr_instance->get_is_debug_enabled())
-                        Serial.printf("Last Tx done with no ack\n");
+                        TRACE_INFO("Last Tx done with no ack\n");
                     curr_instance->set_last_tx_status(MCM_TX_STATUS ::MCM_TX_WO_ACK);
                     break;
 
                 case MROVER_TX_DONE_WITH_ACK:
-                    Serial.printf("MROVER_TX_DONE_WITH_ACK\n");
+                    TRACE_INFO("MROVER_TX_DONE_WITH_ACK\n");
                     if (curr_instance->get_is_debug_enabled())
-                        Serial.printf("Last Tx done with ack\n");
+                        TRACE_INFO("Last Tx done with ack\n");
                     curr_instance->set_last_tx_status(MCM_TX_STATUS ::MCM_TX_ACK);
                     break;
 
@@ -322,144 +401,154 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
 
         case MODEM_EVENT_DOWNDATA:
         {
-            Serial.printf("MODEM_EVENT_DOWNDATA\n");
+            TRACE_INFO("MODEM_EVENT_DOWNDATA\n");
             if (curr_instance->get_is_debug_enabled())
-                Serial.printf("downlink has been received\n");
-            int8_t rssi;
-            int8_t snr;
+                TRACE_INFO("downlink has been received\n");
             uint16_t payload_len = mcm_helper_get_downlink_len(mcm_response); // first determine the downlink length of the received data
-            uint16_t seq_port;
-            uint8_t *payload = curr_instance->get_downlink_buffer();
 
-            mcm_helper_get_downlink_data(mcm_response, &rssi, &snr, payload, &seq_port);
+            // downlink stays in the pool slot until the application releases it
+            mcm_downlink_t *downlink = curr_instance->alloc_downlink(payload_len);
+            if (nullptr == downlink)
+            {
+                TRACE_INFO("Downlink dropped, no free slot\n");
+                break;
+            }
+            downlink->len = payload_len;
+            downlink->protocol = mcm_helper_get_command_type(mcm_response);
+            downlink->timestamp = millis();
+            mcm_helper_get_downlink_data(mcm_response, &downlink->rssi, &downlink->snr, downlink->payload, &downlink->seq_port);
 
-            curr_instance->set_downlink_meta_data(payload_len, rssi, snr, seq_port, true);
             if (curr_instance->get_is_debug_enabled())
             {
-                Serial.printf("Rssi: %d\n", rssi);
-                Serial.printf("Snr: %d\n", snr);
-                if (COMMAND_TYPE_LORAWAN == mcm_helper_get_command_type(mcm_response)) // helper function to get the command type
+                TRACE_INFO("Rssi: %d\n", downlink->rssi);
+                TRACE_INFO("Snr: %d\n", downlink->snr);
+                if (COMMAND_TYPE_LORAWAN == downlink->protocol)
                 {
-                    Serial.printf("Port %d\n", seq_port);
+                    TRACE_INFO("Port %d\n", downlink->seq_port);
                 }
 
                 else
                 {
-                    Serial.printf("Sequence %d\n", seq_port);
+                    TRACE_INFO("Sequence %d\n", downlink->seq_port);
                     // since we received the sidewalk downlink, we can stop the sidewalk uplink
                 }
 
                 Serial.printf("Payload: ");
-                for (int i = 0; i < payload_len; i++)
+                for (int i = 0; i < downlink->len; i++)
                 {
-                    Serial.printf("0x%02x,", payload[i]);
+                    Serial.printf("0x%02x,", downlink->payload[i]);
                 }
                 Serial.printf("\n");
             }
 
+            // the callback consumes the downlink, nobody borrows it afterwards
             if (nullptr != curr_instance->get_on_rx_callback_func())
             {
-                curr_instance->get_on_rx_callback_func()(payload, payload_len, rssi, snr, seq_port);
+                curr_instance->get_on_rx_callback_func()(downlink->payload, downlink->len, downlink->rssi, downlink->snr, downlink->seq_port);
+                curr_instance->release_downlink(downlink);
+            }
+            else
+            {
+                curr_instance->queue_downlink(downlink);
             }
         }
         break;
         case MODEM_EVENT_CLASS_SWITCHED:
         {
-            Serial.printf("MODEM_EVENT_CLASS_SWITCHED\n");
+            TRACE_INFO("MODEM_EVENT_CLASS_SWITCHED\n");
             curr_instance->_change_class = true;
             switch (mcm_helper_get_event_new_class(mcm_response))
             {
             case MROVER_LORAWAN_CLASS_A:
-                Serial.printf("MROVER_LORAWAN_CLASS_A\n");
+                TRACE_INFO("MROVER_LORAWAN_CLASS_A\n");
                 curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_A;
                 break;
 
             case MROVER_LORAWAN_CLASS_B:
-                Serial.printf("MROVER_LORAWAN_CLASS_B\n");
+                TRACE_INFO("MROVER_LORAWAN_CLASS_B\n");
                 curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_B;
                 break;
 
             case MROVER_LORAWAN_CLASS_C:
-                Serial.printf("MROVER_LORAWAN_CLASS_C\n");
+                TRACE_INFO("MROVER_LORAWAN_CLASS_C\n");
                 curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_C;
                 break;
             }
             if (curr_instance->get_is_debug_enabled())
             {
-                Serial.printf("Class switch event received\n");
-                Serial.printf("New class is %c\r\n", "ABC"[mcm_helper_get_event_new_class(mcm_response)]);
+                TRACE_INFO("Class switch event received\n");
+                TRACE_INFO("New class is %c\r\n", "ABC"[mcm_helper_get_event_new_class(mcm_response)]);
             }
         }
         break;
         case MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD:
         {
-            Serial.printf("MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD\n");
+            TRACE_INFO("MODEM_EVENT_SEGMENTED_FILE_DOWNLOAD\n");
             if (curr_instance->get_is_debug_enabled())
-                Serial.printf("Segmented downlink event received\n");
+                TRACE_INFO("Segmented downlink event received\n");
 
             curr_instance->seg_file_status = mcm_helper_get_event_seg_down(mcm_response);
-            Serial.printf("binary file type: %d\n", curr_instance->seg_file_status.cmd_type.bin_type);
-            Serial.printf("Firmware Version: %d.%d.%d\n",
-                          curr_instance->seg_file_status.fw_ver.major,
-                          curr_instance->seg_file_status.fw_ver.minor,
-                          curr_instance->seg_file_status.fw_ver.patch);
-            Serial.printf("Package Size: %d %d %d\n",
-                          curr_instance->seg_file_status.pkg_size[0],
-                          curr_instance->seg_file_status.pkg_size[1],
-                          curr_instance->seg_file_status.pkg_size[2]);
-            Serial.printf("Segment Size: %d\n", curr_instance->seg_file_status.seg_size);
-            Serial.printf("Segment ID: %d\n", curr_instance->seg_file_status.nxt_seg_id);
-            Serial.printf("Segment Status: 0x%04x\n", curr_instance->seg_file_status.seg_status);
-            Serial.printf("Checking if all segments are downloaded\n");
+            TRACE_INFO("binary file type: %d\n", curr_instance->seg_file_status.cmd_type.bin_type);
+            TRACE_INFO("Firmware Version: %d.%d.%d\n",
+                       curr_instance->seg_file_status.fw_ver.major,
+                       curr_instance->seg_file_status.fw_ver.minor,
+                       curr_instance->seg_file_status.fw_ver.patch);
+            TRACE_INFO("Package Size: %d %d %d\n",
+                       curr_instance->seg_file_status.pkg_size[0],
+                       curr_instance->seg_file_status.pkg_size[1],
+                       curr_instance->seg_file_status.pkg_size[2]);
+            TRACE_INFO("Segment Size: %d\n", curr_instance->seg_file_status.seg_size);
+            TRACE_INFO("Segment ID: %d\n", curr_instance->seg_file_status.nxt_seg_id);
+            TRACE_INFO("Segment Status: 0x%04x\n", curr_instance->seg_file_status.seg_status);
 
             // Check if all segments are downloaded
-            if (is_all_segments_downloaded(curr_instance->seg_file_status))
+            if (curr_instance->update_segment_status())
             {
-                Serial.printf("All segments downloaded\n");
+                TRACE_INFO("All segments downloaded\n");
 
                 // Debug prints to track binary type and version comparison
                 if (curr_instance->seg_file_status.cmd_type.bin_type == FUOTA_BINARY_TYPE_HOST)
                 {
-                    Serial.printf("Binary is for host, comparing versions\n");
-                    Serial.printf("Current Host Version: %d.%d.%d\n",
-                                  curr_instance->host_version.major,
-                                  curr_instance->host_version.minor,
-                                  curr_instance->host_version.patch);
-                    Serial.printf("Downloaded Firmware Version: %d.%d.%d\n",
-                                  curr_instance->seg_file_status.fw_ver.major,
-                                  curr_instance->seg_file_status.fw_ver.minor,
-                                  curr_instance->seg_file_status.fw_ver.patch);
+                    TRACE_INFO("Binary is for host, comparing versions\n");
+                    TRACE_INFO("Current Host Version: %d.%d.%d\n",
+                               curr_instance->host_version.major,
+                               curr_instance->host_version.minor,
+                               curr_instance->host_version.patch);
+                    TRACE_INFO("Downloaded Firmware Version: %d.%d.%d\n",
+                               curr_instance->seg_file_status.fw_ver.major,
+                               curr_instance->seg_file_status.fw_ver.minor,
+                               curr_instance->seg_file_status.fw_ver.patch);
 
                     if (curr_instance->seg_file_status.fw_ver.major != curr_instance->host_version.major ||
                         curr_instance->seg_file_status.fw_ver.minor != curr_instance->host_version.minor ||
                         curr_instance->seg_file_status.fw_ver.patch != curr_instance->host_version.patch)
                     {
-                        Serial.printf("New firmware version detected\n");
+                        TRACE_INFO("New firmware version detected\n");
                         curr_instance->is_new_firmware_downloaded = true;
                     }
                     else
                     {
-                        Serial.printf("No new firmware version detected\n");
+                        TRACE_INFO("No new firmware version detected\n");
                     }
                 }
                 else
                 {
-                    Serial.printf("Binary is not for host, new firmware downloaded\n");
+                    TRACE_INFO("Binary is not for host, new firmware downloaded\n");
                     curr_instance->is_new_firmware_downloaded = true;
                 }
             }
             else
             {
-                Serial.printf("Not all segments are downloaded yet\n");
+                TRACE_INFO("Not all segments are downloaded yet\n");
             }
         }
         break;
 
         case MODEM_EVENT_NONE:
-            Serial.printf("MODEM_EVENT_NONE\n");
+            TRACE_INFO("MODEM_EVENT_NONE\n");
             // this will indicate that no pending events
             if (curr_instance->get_is_debug_enabled())
-                Serial.printf("No event\n");
+                TRACE_INFO("No event\n");
             break;
         default:
             break;
@@ -473,7 +562,7 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_GET_VERSION:
     {
-        Serial.printf("MROVER_CC_GET_VERSION\n");
+        TRACE_INFO("MROVER_CC_GET_VERSION\n");
         ver_type_2_t bootloader;
         ver_type_2_t modem_fw;
         ver_type_1_t modem_hw;
@@ -481,7 +570,7 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
         ver_type_1_t lorawan;
 
         mcm_helper_get_version(mcm_response, &bootloader, &modem_fw, &modem_hw, &sidewalk, &lorawan);
-        version = "";
+        String version = "";
         char data[100];
         sprintf(data, "Bootloader: %d.%d.%d\n", bootloader.major, bootloader.minor, bootloader.patch);
         version += data;
@@ -493,13 +582,14 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
         version += data;
         sprintf(data, "Lorawan: %d.%d.%d\n", lorawan.major, lorawan.minor, lorawan.patch);
         version += data;
+        curr_instance->set_version_info(version);
         if (curr_instance->get_is_debug_enabled())
         {
-            Serial.printf("Bootloader: %d.%d.%d\n", bootloader.major, bootloader.minor, bootloader.patch);
-            Serial.printf("Modem firmware: %d.%d.%d\n", modem_fw.major, modem_fw.minor, modem_fw.patch);
-            Serial.printf("Modem hardware: %d.%d.%d\n", modem_hw.major, modem_hw.minor, modem_hw.patch);
-            Serial.printf("Sidewalk: %d.%d.%d\n", sidewalk.major, sidewalk.minor, sidewalk.patch);
-            Serial.printf("Lorawan: %d.%d.%d\n", lorawan.major, lorawan.minor, lorawan.patch);
+            TRACE_INFO("Bootloader: %d.%d.%d\n", bootloader.major, bootloader.minor, bootloader.patch);
+            TRACE_INFO("Modem firmware: %d.%d.%d\n", modem_fw.major, modem_fw.minor, modem_fw.patch);
+            TRACE_INFO("Modem hardware: %d.%d.%d\n", modem_hw.major, modem_hw.minor, modem_hw.patch);
+            TRACE_INFO("Sidewalk: %d.%d.%d\n", sidewalk.major, sidewalk.minor, sidewalk.patch);
+            TRACE_INFO("Lorawan: %d.%d.%d\n", lorawan.major, lorawan.minor, lorawan.patch);
         }
     }
     break;
@@ -511,9 +601,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_RESET:
-        Serial.printf("MROVER_CC_RESET\n");
+        TRACE_INFO("MROVER_CC_RESET\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command successfully received. Device would be reset only when there is no pending event\n");
+            TRACE_INFO("Command successfully received. Device would be reset only when there is no pending event\n");
         break;
 
     /**
@@ -521,9 +611,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_FACTORY_RESET:
-        Serial.printf("MROVER_CC_FACTORY_RESET\n");
+        TRACE_INFO("MROVER_CC_FACTORY_RESET\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Device has been factory reset\n");
+            TRACE_INFO("Device has been factory reset\n");
         break;
 
     /**
@@ -531,9 +621,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SWITCH_NETWORK:
-        Serial.printf("MROVER_CC_SWITCH_NETWORK\n");
+        TRACE_INFO("MROVER_CC_SWITCH_NETWORK\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Device has been switched successfully\n");
+            TRACE_INFO("Device has been switched successfully\n");
         break;
 
     /**
@@ -542,9 +632,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_INIT_LORAWAN:
-        Serial.printf("MROVER_CC_INIT_LORAWAN\n");
+        TRACE_INFO("MROVER_CC_INIT_LORAWAN\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Lorawan has been initiated successfully\n");
+            TRACE_INFO("Lorawan has been initiated successfully\n");
         break;
 
     /**
@@ -553,9 +643,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SET_JOIN_EUI:
-        Serial.printf("MROVER_CC_SET_JOIN_EUI\n");
+        TRACE_INFO("MROVER_CC_SET_JOIN_EUI\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Join eui has been set successfully\n");
+            TRACE_INFO("Join eui has been set successfully\n");
         break;
 
     /**
@@ -564,9 +654,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SET_DEV_EUI:
-        Serial.printf("MROVER_CC_SET_DEV_EUI\n");
+        TRACE_INFO("MROVER_CC_SET_DEV_EUI\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Dev eui has been set successfully\n");
+            TRACE_INFO("Dev eui has been set successfully\n");
         break;
     /**
      * @brief Response for the successful setting of
@@ -574,9 +664,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SET_NW_KEY:
-        Serial.printf("MROVER_CC_SET_NW_KEY\n");
+        TRACE_INFO("MROVER_CC_SET_NW_KEY\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Network key has been set successfully\n");
+            TRACE_INFO("Network key has been set successfully\n");
         break;
 
     /**
@@ -585,7 +675,7 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_GET_DEV_EUI:
     {
-        Serial.printf("MROVER_CC_GET_DEV_EUI\n");
+        TRACE_INFO("MROVER_CC_GET_DEV_EUI\n");
         // read the dev eui here
         const uint8_t *dev_eui = mcm_helper_get_dev_eui(mcm_response);
         if (curr_instance->get_is_debug_enabled())
@@ -607,7 +697,7 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_GET_JOIN_EUI:
     {
-        Serial.printf("MROVER_CC_GET_JOIN_EUI\n");
+        TRACE_INFO("MROVER_CC_GET_JOIN_EUI\n");
         // read the join eui here
         const uint8_t *join_eui = mcm_helper_get_join_eui(mcm_response);
         if (curr_instance->get_is_debug_enabled())
@@ -629,9 +719,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *          MROVER_CC_GET_EVENT
      */
     case MROVER_CC_JOIN_LORAWAN:
-        Serial.printf("MROVER_CC_JOIN_LORAWAN\n");
+        TRACE_INFO("MROVER_CC_JOIN_LORAWAN\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command to join lorawan executed successfully, Module will send us  event as soon we joined\n");
+            TRACE_INFO("Command to join lorawan executed successfully, Module will send us  event as soon we joined\n");
         break;
 
     /**
@@ -640,9 +730,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *        Result of this command would be responded by, MODEM_EVENT_TXDONE, sub event of  MROVER_CC_GET_EVENT
      */
     case MROVER_CC_REQUEST_UPLINK:
-        Serial.printf("MROVER_CC_REQUEST_UPLINK\n");
+        TRACE_INFO("MROVER_CC_REQUEST_UPLINK\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Uplink has been requested successfully\n");
+            TRACE_INFO("Uplink has been requested successfully\n");
         break;
 
     /**
@@ -650,9 +740,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_LEAVE_LORAWAN_NETWORK:
-        Serial.printf("MROVER_CC_LEAVE_LORAWAN_NETWORK\n");
+        TRACE_INFO("MROVER_CC_LEAVE_LORAWAN_NETWORK\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Device has been left the lorawan network\n");
+            TRACE_INFO("Device has been left the lorawan network\n");
         break;
 
     /**
@@ -662,16 +752,16 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_STOP_SID_LORAWAN_NETWORK:
     {
-        Serial.printf("MROVER_CC_STOP_SID_LORAWAN_NETWORK\n");
+        TRACE_INFO("MROVER_CC_STOP_SID_LORAWAN_NETWORK\n");
         if (curr_instance->get_is_debug_enabled())
         {
             if (COMMAND_TYPE_SIDEWALK == mcm_helper_get_command_type(mcm_response))
             {
-                Serial.printf("Device has stoped the sidewalk network\n");
+                TRACE_INFO("Device has stoped the sidewalk network\n");
             }
             else
             {
-                Serial.printf("Device has stoped the lorawan network\n");
+                TRACE_INFO("Device has stoped the lorawan network\n");
             }
         }
     }
@@ -684,9 +774,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_BLE_LINK_REQUEST:
     {
-        Serial.printf("MROVER_CC_BLE_LINK_REQUEST\n");
+        TRACE_INFO("MROVER_CC_BLE_LINK_REQUEST\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Ble link has been requested successfully\n");
+            TRACE_INFO("Ble link has been requested successfully\n");
     }
 
     break;
@@ -697,9 +787,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      */
     case MROVER_CC_BLE_CONNECTION_REQUEST:
     {
-        Serial.printf("MROVER_CC_BLE_CONNECTION_REQUEST\n");
+        TRACE_INFO("MROVER_CC_BLE_CONNECTION_REQUEST\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Ble connection has been requested successfully\n");
+            TRACE_INFO("Ble connection has been requested successfully\n");
     }
     break;
 
@@ -708,9 +798,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_FSK_LINK_REQUEST:
-        Serial.printf("MROVER_CC_FSK_LINK_REQUEST\n");
+        TRACE_INFO("MROVER_CC_FSK_LINK_REQUEST\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Ble FSK link has been requested successfully\n");
+            TRACE_INFO("Ble FSK link has been requested successfully\n");
         break;
 
     /**
@@ -718,9 +808,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_CSS_LINK_REQUEST:
-        Serial.printf("MROVER_CC_CSS_LINK_REQUEST\n");
+        TRACE_INFO("MROVER_CC_CSS_LINK_REQUEST\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Css link has been requested successfully\n");
+            TRACE_INFO("Css link has been requested successfully\n");
         break;
 
     /**
@@ -728,9 +818,9 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SET_CSS_PWR_PROFILE:
-        Serial.printf("MROVER_CC_SET_CSS_PWR_PROFILE\n");
+        TRACE_INFO("MROVER_CC_SET_CSS_PWR_PROFILE\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Css power profile has been set successfully\n");
+            TRACE_INFO("Css power profile has been set successfully\n");
         break;
 
     /**
@@ -738,119 +828,119 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
      *
      */
     case MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK:
-        Serial.printf("MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK\n");
+        TRACE_INFO("MROVER_CC_SET_FILTERING_DOWNLINK_SIDEWALK\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Downlink filtering has been set successfully\n");
+            TRACE_INFO("Downlink filtering has been set successfully\n");
         break;
 
     case MROVER_CC_SET_LORAWAN_CLASS:
-        Serial.printf("MROVER_CC_SET_LORAWAN_CLASS\n");
+        TRACE_INFO("MROVER_CC_SET_LORAWAN_CLASS\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command to change class has been successfully received by the mcm\n");
+            TRACE_INFO("Command to change class has been successfully received by the mcm\n");
         break;
     case MROVER_CC_GET_LORAWAN_CLASS:
     {
-        Serial.printf("MROVER_CC_GET_LORAWAN_CLASS\n");
+        TRACE_INFO("MROVER_CC_GET_LORAWAN_CLASS\n");
         switch (mcm_helper_get_device_class(mcm_response))
         {
         case MROVER_LORAWAN_CLASS_A:
-            Serial.printf("MROVER_LORAWAN_CLASS_A\n");
+            TRACE_INFO("MROVER_LORAWAN_CLASS_A\n");
             curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_A;
             break;
 
         case MROVER_LORAWAN_CLASS_B:
-            Serial.printf("MROVER_LORAWAN_CLASS_B\n");
+            TRACE_INFO("MROVER_LORAWAN_CLASS_B\n");
             curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_B;
             break;
 
         case MROVER_LORAWAN_CLASS_C:
-            Serial.printf("MROVER_LORAWAN_CLASS_C\n");
+            TRACE_INFO("MROVER_LORAWAN_CLASS_C\n");
             curr_instance->_dev_class = MCM_LORAWAN_CLASS_TYPE::MCM_LRWAN_CLASS_C;
             break;
         }
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command to Get class has been successfully received by the mcm\n");
+            TRACE_INFO("Command to Get class has been successfully received by the mcm\n");
         break;
     }
     case MROVER_CC_START_FILE_TRANSFER:
     {
-        Serial.printf("MROVER_CC_START_FILE_TRANSFER\n");
+        TRACE_INFO("MROVER_CC_START_FILE_TRANSFER\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command to start file transfer has been successfully received by the mcm\n");
-        // using the ymodem protocol
-        curr_instance->ymodem.sendCRCRequest();
+            TRACE_INFO("Command to start file transfer has been successfully received by the mcm\n");
+        // using the ymodem protocol, rx task has to route the header to ymodem
+        // so the state is changed before the transfer is requested
         curr_instance->ymodem.setState(WAIT_FOR_HEADER);
+        curr_instance->ymodem.sendCRCRequest();
         break;
     }
     case MROVER_CC_FILE_STATUS:
     {
-        Serial.printf("MROVER_CC_FILE_STATUS\n");
+        TRACE_INFO("MROVER_CC_FILE_STATUS\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("File status event received\n");
+            TRACE_INFO("File status event received\n");
 
         mcm_helper_get_seg_file_status(mcm_response, &curr_instance->seg_file_status);
-        Serial.printf("binary file type: %d\n", curr_instance->seg_file_status.cmd_type.bin_type);
-        Serial.printf("Firmware Version: %d.%d.%d\n",
-                      curr_instance->seg_file_status.fw_ver.major,
-                      curr_instance->seg_file_status.fw_ver.minor,
-                      curr_instance->seg_file_status.fw_ver.patch);
-        Serial.printf("Package Size: %d %d %d\n",
-                      curr_instance->seg_file_status.pkg_size[0],
-                      curr_instance->seg_file_status.pkg_size[1],
-                      curr_instance->seg_file_status.pkg_size[2]);
-        Serial.printf("Segment Size: %d\n", curr_instance->seg_file_status.seg_size);
-        Serial.printf("Segment ID: %d\n", curr_instance->seg_file_status.nxt_seg_id);
-        Serial.printf("Segment Status: 0x%04x\n", curr_instance->seg_file_status.seg_status);
-        Serial.printf("Checking if all segments are downloaded\n");
+        TRACE_INFO("binary file type: %d\n", curr_instance->seg_file_status.cmd_type.bin_type);
+        TRACE_INFO("Firmware Version: %d.%d.%d\n",
+                   curr_instance->seg_file_status.fw_ver.major,
+                   curr_instance->seg_file_status.fw_ver.minor,
+                   curr_instance->seg_file_status.fw_ver.patch);
+        TRACE_INFO("Package Size: %d %d %d\n",
+                   curr_instance->seg_file_status.pkg_size[0],
+                   curr_instance->seg_file_status.pkg_size[1],
+                   curr_instance->seg_file_status.pkg_size[2]);
+        TRACE_INFO("Segment Size: %d\n", curr_instance->seg_file_status.seg_size);
+        TRACE_INFO("Segment ID: %d\n", curr_instance->seg_file_status.nxt_seg_id);
+        TRACE_INFO("Segment Status: 0x%04x\n", curr_instance->seg_file_status.seg_status);
 
         // Check if all segments are downloaded
-        if (is_all_segments_downloaded(curr_instance->seg_file_status))
+        if (curr_instance->update_segment_status())
         {
-            Serial.printf("All segments downloaded\n");
+            TRACE_INFO("All segments downloaded\n");
 
             // Debug prints to track binary type and version comparison
             if (curr_instance->seg_file_status.cmd_type.bin_type == FUOTA_BINARY_TYPE_HOST)
             {
-                Serial.printf("Binary is for host, comparing versions\n");
-                Serial.printf("Current Host Version: %d.%d.%d\n",
-                              curr_instance->host_version.major,
-                              curr_instance->host_version.minor,
-                              curr_instance->host_version.patch);
-                Serial.printf("Downloaded Firmware Version: %d.%d.%d\n",
-                              curr_instance->seg_file_status.fw_ver.major,
-                              curr_instance->seg_file_status.fw_ver.minor,
-                              curr_instance->seg_file_status.fw_ver.patch);
+                TRACE_INFO("Binary is for host, comparing versions\n");
+                TRACE_INFO("Current Host Version: %d.%d.%d\n",
+                           curr_instance->host_version.major,
+                           curr_instance->host_version.minor,
+                           curr_instance->host_version.patch);
+                TRACE_INFO("Downloaded Firmware Version: %d.%d.%d\n",
+                           curr_instance->seg_file_status.fw_ver.major,
+                           curr_instance->seg_file_status.fw_ver.minor,
+                           curr_instance->seg_file_status.fw_ver.patch);
 
                 if (curr_instance->seg_file_status.fw_ver.major != curr_instance->host_version.major ||
                     curr_instance->seg_file_status.fw_ver.minor != curr_instance->host_version.minor ||
                     curr_instance->seg_file_status.fw_ver.patch != curr_instance->host_version.patch)
                 {
-                    Serial.printf("New firmware version detected\n");
+                    TRACE_INFO("New firmware version detected\n");
                     curr_instance->is_new_firmware_downloaded = true;
                 }
                 else
                 {
-                    Serial.printf("No new firmware version detected\n");
+                    TRACE_INFO("No new firmware version detected\n");
                 }
             }
             else
             {
-                Serial.printf("Binary is not for host, new firmware downloaded\n");
+                TRACE_INFO("Binary is not for host, new firmware downloaded\n");
                 curr_instance->is_new_firmware_downloaded = true;
             }
         }
         else
         {
-            Serial.printf("Not all segments are downloaded yet\n");
+            TRACE_INFO("Not all segments are downloaded yet\n");
         }
     }
     break;
 
     case MROVER_CC_TRIGGER_FW_UPDATE:
     {
-        Serial.printf("MROVER_CC_TRIGGER_FW_UPDATE\n");
+        TRACE_INFO("MROVER_CC_TRIGGER_FW_UPDATE\n");
         if (curr_instance->get_is_debug_enabled())
-            Serial.printf("Command to trigger firmware update has been successfully received by the mcm\n");
+            TRACE_INFO("Command to trigger firmware update has been successfully received by the mcm\n");
     }
     break;
     default:
@@ -858,12 +948,55 @@ static void handle_mcm_response(const api_processor_response_t *mcm_response, vo
     }
 }
 
+static void handle_mcm_response(const api_processor_response_t *mcm_response, void *ctx)
+{
+    MCM *curr_instance = (MCM *)ctx;
+    mrover_cc_codes_t cmd_code = mcm_helper_get_command_code(mcm_response);
+    mrover_return_code_t return_code = mcm_helper_get_response_code(mcm_response);
+    MCM_CMD_STATUS cmd_status = (MROVER_RC_OK == return_code) ? MCM_CMD_STATUS::MCM_CMD_DONE : MCM_CMD_STATUS::MCM_CMD_FAILED;
+
+    if (curr_instance->get_is_event_drain_active() && (MROVER_CC_GET_EVENT == cmd_code))
+    {
+        // response is already validated, keep the mcm busy with the next GET_EVENT
+        // while this event goes through the application.
+        // pending count comes with every GET_EVENT response
+        curr_instance->complete_command(cmd_code, cmd_status, return_code);
+        if ((MCM_CMD_STATUS::MCM_CMD_DONE != cmd_status) ||
+            (0 == api_processor_get_pending_events(curr_instance->get_module_handle())) ||
+            (MCM_STATUS::MCM_OK != curr_instance->get_event_async()))
+        {
+            curr_instance->set_is_event_drain_active(false);
+        }
+        dispatch_mcm_response(mcm_response, ctx);
+        return;
+    }
+
+    dispatch_mcm_response(mcm_response, ctx);
+
+    // response data has been consumed, now let the submitter of the command know
+    curr_instance->complete_command(cmd_code, cmd_status, return_code);
+}
+
 MCM::MCM(HardwareSerial &serial, uint8_t tx_pin, uint8_t rx_pin, uint8_t reset_pin) : __mcm_serial(serial),
                                                                                       _tx_pin(tx_pin),
                                                                                       _rx_pin(rx_pin),
                                                                                       _reset_pin(reset_pin),
                                                                                       ymodem(serial)
 {
+    // the records of several modems interleave in the one capture ring
+    static uint8_t instance_count = 0;
+    this->capture_port = instance_count++ % UART_CAPTURE_MAX_PORTS;
+    this->ymodem.setCapturePort(this->capture_port);
+
+    // every slot starts free
+    for (uint8_t slot = 0; slot < MCM_DOWNLINK_POOL_SLOTS; slot++)
+    {
+        this->downlink_free[slot] = slot;
+    }
+    this->downlink_free_count = MCM_DOWNLINK_POOL_SLOTS;
+    this->downlink_in_use = 0;
+    this->downlink_fifo_head = 0;
+    this->downlink_fifo_count = 0;
 }
 
 MCM_STATUS MCM::begin()
@@ -874,18 +1007,36 @@ MCM_STATUS MCM::begin()
     __mcm_serial.begin(_baud_rate, SERIAL_8N1, _rx_pin, _tx_pin);
     __mcm_serial.setRxBufferSize(BUFFER_SIZE);
     __mcm_serial.setTxBufferSize(BUFFER_SIZE);
-    // __mcm_serial.setRxTimeout(2);
+
+    // trace records are only formatted when the loop is idle, see trace_buffer_flush()
+    trace_buffer_set_platform_cb(on_trace_tick, on_trace_lock, on_trace_unlock, on_trace_output);
+    // uart bytes are captured with the timestamps of the trace records
+    uart_capture_set_platform_cb(on_trace_tick, on_capture_lock, on_capture_unlock);
+
+    // rx path has to be ready before the first byte comes in
+    if (!this->rx_path.begin(is_rx_ymodem, this) ||
+        (pdPASS != xTaskCreate(mcm_rx_task, "mcm_rx", MCM_RX_TASK_STACK_SIZE, this, MCM_RX_TASK_PRIORITY, &this->rx_task)))
+    {
+        Serial.printf("mcm begin: unable to create the rx path\n");
+        return MCM_STATUS::MCM_ERROR;
+    }
+
     // keep in mind below function is lambda function
+    // it runs in the uart event task, so only move the bytes to the rx task
     __mcm_serial.onReceive([this]()
                            {
-        //  size_t available = this->__mcm_serial.available();
-        this->received_size = this->__mcm_serial.readBytes(temp_buffer, BUFFER_SIZE);
+        uint8_t chunk[MCM_RX_CHUNK_SIZE];
+        int available;
+        while ((available = this->__mcm_serial.available()) > 0)
+        {
+            size_t read_size = this->__mcm_serial.read(chunk, min((size_t)available, sizeof(chunk)));
+            UART_CAPTURE(this->capture_port, UART_CAPTURE_MCM_RX, chunk, read_size);
+            this->rx_path.write(chunk, read_size);
+        }
         if (this->get_is_debug_enabled())
         {
             Serial.println("on_receive_callback");
-            Serial.printf("Received %d bytes\n", this->received_size);
-        }
-        this->is_rx_received = 1; }, true);
+        } }, true);
     if (this->get_is_debug_enabled())
         Serial.printf("mcm begin\n");
 
@@ -900,6 +1051,10 @@ MCM_STATUS MCM::begin()
 
     if (API_PROCESSOR_SUCCESS == status)
     {
+        // send the uplink payload straight from the caller buffer
+        api_processor_set_send_vec_cb(module, on_send_vec_function);
+        // round trip times of the commands are measured in milliseconds
+        api_processor_set_tick_cb(module, on_tick_function);
         return MCM_STATUS::MCM_OK;
     }
 
@@ -912,55 +1067,293 @@ String MCM::print_version()
     api_processor_cmd_get_version(this->module);
 
     this->process_received_data();
-    return version;
+    return this->version_info;
 }
 
 void MCM::process_received_data()
 {
+    // the send callbacks refused the command, no response is coming until the transfer is over
+    if (this->is_file_transfer_active())
+    {
+        return;
+    }
+
+    // response of the command just sent, wait until it is completed
+    if (this->is_command_pending())
+    {
+        this->wait_for_command();
+        return;
+    }
 
-    // wait until the response is received
+    // nothing submitted (e.g. waiting for the reset notification), take whatever mcm sends
     uint32_t timeout = millis();
-    while ((this->is_rx_received == 0) &&
-           ((millis() - timeout) < this->serial_rx_timeout))
+    do
     {
-        delay(100);
+        // rx task only queues complete frames
+        if (this->process_rx_queue() > 0)
+        {
+            return;
+        }
+        delay(1);
+    } while ((millis() - timeout) < this->serial_rx_timeout);
+
+    Serial.println("MCM: Response not received, Please check the connection");
+}
+
+uint16_t MCM::process_rx_queue()
+{
+    uint16_t processed = 0;
+
+    uint16_t raw_processed = 0;
+    mcm_rx_item_t item;
+
+    // a ymodem packet may write the flash, the next ones wait for the next poll
+    while ((raw_processed < MCM_RX_RAW_ITEMS_PER_POLL) && this->rx_path.receive(&item))
+    {
+        uint8_t *data = this->rx_path.get_data(&item);
+        processed++;
+        if (this->get_is_debug_enabled())
+        {
+            Serial.println("---------------------------------Received debug info-------------------------------------");
+        }
+
+        //  bytes received while y-modem is running goes to the ymodem protocol only
+        if (MCM_RX_ITEM_TYPE::MCM_RX_ITEM_RAW == item.type)
+        {
+            TRACE_DEBUG("YMODEM RX: %d bytes\n", item.len);
+            this->ymodem.receivePacket(data, item.len);
+            raw_processed++;
+        }
+        else
+        {
+            TRACE_DEBUG("HMI RX: %d bytes\n", item.len);
+            // byte dump only on request, it costs more than the frame at 115200 baud
+            if (this->get_is_debug_enabled())
+            {
+                Serial.printf("HMI RX :(%d bytes) ", item.len);
+                for (int i = 0; i < item.len; i++)
+                {
+                    Serial.printf("%02x ", data[i]);
+                }
+                Serial.println("");
+            }
+            api_processor_parse_rx_frame(this->module, data, item.len);
+        }
+        // slot goes back to the rx task
+        this->rx_path.release(&item);
+
+        if (this->get_is_debug_enabled())
+            Serial.println("-----------------------------------------------------------------------------------------");
+    }
+
+    return processed;
+}
+
+void MCM::run_rx_task()
+{
+    for (;;)
+    {
+        this->rx_path.run_once();
+    }
+}
+
+void MCM::get_rx_stats(mcm_rx_stats_t *stats)
+{
+    this->rx_path.get_stats(stats);
+}
+
+void MCM::set_version_info(const String &info)
+{
+    this->version_info = info;
+}
+
+uint16_t MCM::get_reset_event_count()
+{
+    return this->reset_event_count;
+}
+
+void MCM::increment_reset_event_count()
+{
+    this->reset_event_count++;
+}
+
+/**
+ * @brief Applies the last segmented file status to the segment tracker
+ * @return true if all the segments of the package are downloaded
+ */
+bool MCM::update_segment_status()
+{
+    uint32_t segments = fuota_seg_tracker_get_segments(&this->seg_file_status);
+    if (segments > FUOTA_SEG_TRACKER_MAX_SEGMENTS)
+    {
+        if (!this->is_seg_package_refused)
+        {
+            TRACE_ERROR("Segments: %lu in the package, the status reports at most %u, not tracked\n",
+                        (unsigned long)segments, (unsigned)FUOTA_SEG_TRACKER_MAX_SEGMENTS);
+            this->is_seg_package_refused = true;
+        }
+        this->seg_tracker = {};
+        return false;
+    }
+    this->is_seg_package_refused = false;
+
+    // storage grows with the package, the tracker starts over on the new one
+    uint16_t words = FUOTA_SEG_TRACKER_WORDS(segments);
+    if (words > this->seg_tracker_word_count)
+    {
+        delete[] this->seg_tracker_words;
+        this->seg_tracker_words = new uint32_t[words];
+        this->seg_tracker_word_count = words;
+        this->seg_tracker = {};
     }
-    if (this->is_rx_received == 0)
+
+    bool is_complete = fuota_seg_tracker_apply_status(&this->seg_tracker, this->seg_tracker_words,
+                                                      this->seg_tracker_word_count, &this->seg_file_status);
+    // one line whatever the number of segments
+    TRACE_INFO("Segments: %lu of %lu downloaded (%u %%)\n",
+               (unsigned long)(this->seg_tracker.u32_segments - this->seg_tracker.u32_pending),
+               (unsigned long)this->seg_tracker.u32_segments, fuota_seg_tracker_get_percent(&this->seg_tracker));
+    return is_complete;
+}
+
+const fuota_seg_tracker_t *MCM::get_segment_tracker()
+{
+    return &this->seg_tracker;
+}
+
+void MCM::get_metrics(api_metrics_t *metrics, bool reset)
+{
+    api_processor_get_metrics(this->module, metrics, reset);
+    // frames are reassembled by the rx task, not by the module, its counters are never cleared from here
+    this->rx_path.add_link_metrics(metrics, reset);
+}
+
+void MCM::wait_for_command()
+{
+    // poll() completes the command either on the response or on the timeout
+    while (this->is_command_pending())
+    {
+        this->poll();
+        if (this->is_command_pending() && (0 == this->rx_path.get_waiting()))
+        {
+            delay(1);
+        }
+    }
+}
+
+void MCM::poll()
+{
+    this->process_rx_queue();
+
+    // a modem which stops sending in the middle of the file is given up on, whoever polls
+    if (this->is_file_transfer_active())
+    {
+        this->ymodem.process_timeout();
+    }
+
+    if ((MCM_CMD_STATUS::MCM_CMD_PENDING == this->pending_cmd.status) &&
+        ((millis() - this->pending_cmd.start_time) >= this->serial_rx_timeout))
     {
         Serial.println("MCM: Response not received, Please check the connection");
+        api_processor_report_timeout(this->module, this->pending_cmd.cmd_code);
+        this->complete_command(this->pending_cmd.cmd_code, MCM_CMD_STATUS::MCM_CMD_TIMEOUT, MROVER_RC_FAIL);
     }
-    this->is_rx_received = 0;
-    if (this->get_is_debug_enabled())
+
+    // file transfer released the uart, the held uplink goes out the way a new one would
+    if (this->deferred_uplink.is_held && !this->is_file_transfer_active() &&
+        (MCM_CMD_STATUS::MCM_CMD_PENDING != this->pending_cmd.status))
     {
-        Serial.println("---------------------------------Received debug info-------------------------------------");
+        this->deferred_uplink.is_held = false;
+        this->deferred_uplink.due_time = millis();
+        if (ConnectionMode::CONNECTION_MODE_SIDEWALK_BLE == this->current_mode)
+        {
+            api_processor_cmd_sid_ble_conn_request(this->module);
+            this->deferred_uplink.due_time += MCM_BLE_CONN_SETUP_TIME_MS;
+        }
     }
-    
-    //  if y-modem is enabled then send the data to the ymodem protocol only
-    if (this->ymodem.getState() != YMODEM_IDLE) 
-    {
-      Serial.printf("YMODEM RX :(%d bytes) ", this->received_size);
-      // for (int i = 0; i < this->received_size; i++) 
-      // {
-      //   Serial.printf("%02x ", temp_buffer[i]);
-      // }
-      Serial.println("");
-      this->ymodem.receivePacket(temp_buffer, this->received_size);
-      this->set_received_size(0);
-      this->set_is_rx_received(0);
-    } 
-    else 
-    {
-      Serial.printf("HMI RX :(%d bytes) ", this->received_size);
-      for (int i = 0; i < this->received_size; i++) 
-      {
-        Serial.printf("%02x ", temp_buffer[i]);
-      }
-      Serial.println("");
-      api_processor_parse_rx_data(this->module, temp_buffer, this->received_size);  // TODO Oxit: Check if this can print just nothing
+
+    // ble connection had its time, request the sidewalk uplink now
+    if (this->deferred_uplink.is_scheduled && !this->deferred_uplink.is_held &&
+        (MCM_CMD_STATUS::MCM_CMD_PENDING != this->pending_cmd.status) &&
+        ((int32_t)(millis() - this->deferred_uplink.due_time) >= 0))
+    {
+        this->deferred_uplink.is_scheduled = false;
+        this->pending_cmd.next_on_complete = this->deferred_uplink.on_complete;
+        this->pending_cmd.next_user_ctx = this->deferred_uplink.user_ctx;
+        if (API_PROCESSOR_SUCCESS != this->request_uplink(this->deferred_uplink.data,
+                                                          this->deferred_uplink.len,
+                                                          this->deferred_uplink.port,
+                                                          this->deferred_uplink.uplink_type))
+        {
+            this->pending_cmd.next_on_complete = nullptr;
+            if (nullptr != this->deferred_uplink.on_complete)
+            {
+                this->deferred_uplink.on_complete(MROVER_CC_REQUEST_UPLINK, MCM_CMD_STATUS::MCM_CMD_FAILED,
+                                                  MROVER_RC_FAIL, this->deferred_uplink.user_ctx);
+            }
+        }
     }
+}
 
-    if (this->get_is_debug_enabled())
-        Serial.println("-----------------------------------------------------------------------------------------");
+bool MCM::is_command_pending()
+{
+    // an uplink held for the end of the file transfer is not waited for, it may take minutes
+    return (MCM_CMD_STATUS::MCM_CMD_PENDING == this->pending_cmd.status) ||
+           (this->deferred_uplink.is_scheduled && !this->deferred_uplink.is_held);
+}
+
+bool MCM::is_file_transfer_active()
+{
+    // from the start file transfer response until the transfer ends or times out
+    return this->ymodem.getState() != YMODEM_IDLE;
+}
+
+MCM_CMD_STATUS MCM::get_command_status()
+{
+    return this->pending_cmd.status;
+}
+
+void MCM::begin_command(mrover_cc_codes_t cmd_code)
+{
+    // mcm answers one command at a time, a command sent over an unanswered one abandons it
+    if (MCM_CMD_STATUS::MCM_CMD_PENDING == this->pending_cmd.status)
+    {
+        this->complete_command(this->pending_cmd.cmd_code, MCM_CMD_STATUS::MCM_CMD_FAILED, MROVER_RC_FAIL);
+    }
+
+    this->pending_cmd.cmd_code = cmd_code;
+    this->pending_cmd.status = MCM_CMD_STATUS::MCM_CMD_PENDING;
+    this->pending_cmd.start_time = millis();
+    this->pending_cmd.on_complete = this->pending_cmd.next_on_complete;
+    this->pending_cmd.user_ctx = this->pending_cmd.next_user_ctx;
+    this->pending_cmd.next_on_complete = nullptr;
+    this->pending_cmd.next_user_ctx = nullptr;
+}
+
+void MCM::complete_command(mrover_cc_codes_t cmd_code, MCM_CMD_STATUS status, mrover_return_code_t return_code)
+{
+    // late response of the timed out or abandoned command
+    if ((MCM_CMD_STATUS::MCM_CMD_PENDING != this->pending_cmd.status) || (cmd_code != this->pending_cmd.cmd_code))
+    {
+        return;
+    }
+
+    this->pending_cmd.status = status;
+    this->pending_cmd.return_code = return_code;
+
+    // drain stops at the first failed or lost command
+    if (MCM_CMD_STATUS::MCM_CMD_DONE != status)
+    {
+        this->is_event_drain_active = false;
+    }
+
+    // callback is free to submit the next command
+    on_cmd_complete_callback on_complete = this->pending_cmd.on_complete;
+    this->pending_cmd.on_complete = nullptr;
+    if (nullptr != on_complete)
+    {
+        on_complete(cmd_code, status, return_code, this->pending_cmd.user_ctx);
+    }
 }
 
 void MCM::sw_reset()
@@ -971,12 +1364,7 @@ void MCM::sw_reset()
     this->process_received_data();
 
     // device would not be reset until we get all the event for the device
-    while (api_processor_get_pending_events(this->module) > 0)
-    {
-        api_processor_cmd_get_event(this->module); // send the get event command
-
-        this->process_received_data();
-    }
+    this->drain_pending_events();
 
     delay(1000);
 }
@@ -1043,16 +1431,35 @@ MCM_STATUS MCM::set_lorawan_credentials(uint8_t *dev_eui, uint8_t *join_eui, uin
 }
 
 MCM_STATUS MCM::connect_network()
+{
+    // let the command submitted before finish first
+    this->wait_for_command();
+
+    MCM_STATUS status = this->connect_network_async();
+    if (MCM_STATUS::MCM_OK == status)
+    {
+        // wait for the response
+        this->wait_for_command();
+    }
+    return status;
+}
+
+MCM_STATUS MCM::connect_network_async(on_cmd_complete_callback callback, void *user_ctx)
 {
     MCM_STATUS status = MCM_STATUS::MCM_ERROR;
     api_processor_status_t api_status = API_PROCESSOR_ERROR;
     do
     {
-        if (ConnectionMode::CONNECTION_MODE_NC == this->current_mode)
+        if ((ConnectionMode::CONNECTION_MODE_NC == this->current_mode) || this->is_command_pending())
         {
             break;
         }
-        else if (ConnectionMode::CONNECTION_MODE_LORAWAN == this->current_mode)
+
+        // taken over by the command sent below
+        this->pending_cmd.next_on_complete = callback;
+        this->pending_cmd.next_user_ctx = user_ctx;
+
+        if (ConnectionMode::CONNECTION_MODE_LORAWAN == this->current_mode)
         {
             Serial.println("Initiating the lorawan connection");
             // initiating the lorawan connection
@@ -1061,8 +1468,6 @@ MCM_STATUS MCM::connect_network()
             {
                 break;
             }
-            // wait for the response
-            this->process_received_data();
             status = MCM_STATUS::MCM_OK;
         }
 
@@ -1075,8 +1480,6 @@ MCM_STATUS MCM::connect_network()
             {
                 break;
             }
-            // wait for the response
-            this->process_received_data();
             status = MCM_STATUS::MCM_OK;
         }
 
@@ -1088,8 +1491,6 @@ MCM_STATUS MCM::connect_network()
             {
                 break;
             }
-            // wait for the response
-            this->process_received_data();
             status = MCM_STATUS::MCM_OK;
         }
 
@@ -1101,14 +1502,18 @@ MCM_STATUS MCM::connect_network()
             {
                 break;
             }
-            // wait for the response
-            this->process_received_data();
             status = MCM_STATUS::MCM_OK;
         }
 
         // set context manager that joined received
         this->set_context_mgr_is_joined_cmd_received(true);
     } while (0);
+
+    if (MCM_STATUS::MCM_OK != status)
+    {
+        this->pending_cmd.next_on_complete = nullptr;
+        this->pending_cmd.next_user_ctx = nullptr;
+    }
     return status;
 }
 
@@ -1117,39 +1522,46 @@ void MCM::handle_rx_events()
 
    // uint16_t rx_bytes_rtn = 0;
 
-    // check if any data to process
-    // TODO: add the timeout here
-    if (this->is_rx_received)
+    // process any received data and the command timeout without blocking
+    this->poll();
+    // the file transfer owns the uart, events are read once it is over
+    if (this->is_file_transfer_active())
     {
-        //Serial.println("handle_rx_events: RX data received");
-        this->process_received_data();
-        //Serial.println("handle_rx_events: Data processed");
-        this->is_rx_received = 0;
-    }
-    // TODO: Oxit: process ymodem loop
-    //  device would not be reset until we get all the event for the device
-    if (this->ymodem.getState() != YMODEM_IDLE)
-    {
-        this->ymodem.process_timeout();
-        while (this->__mcm_serial.available())
-        {
-            this->received_size = this->__mcm_serial.readBytes(temp_buffer, BUFFER_SIZE);
-            Serial.printf("handle_rx_events: Read %d bytes from serial\n", this->received_size);
-            this->is_rx_received = 1;
-        }
-
         return;
     }
     
-    while (api_processor_get_pending_events(this->module) > 0)
-    {
-        Serial.println("handle_rx_events: Pending events detected");
-        api_processor_cmd_get_event(this->module); // send the get event command
-        Serial.println("handle_rx_events: Get event command sent");
+    // events are read by the drain, it goes on from poll() on the next calls
+    this->start_event_drain();
+}
 
-        this->process_received_data();
-        Serial.println("handle_rx_events: Event data processed");
+void MCM::start_event_drain()
+{
+    // async command in flight, events are read after its completion
+    if (this->is_event_drain_active || this->is_command_pending() ||
+        (0 == api_processor_get_pending_events(this->module)))
+    {
+        return;
     }
+
+    Serial.println("handle_rx_events: Pending events detected");
+    this->is_event_drain_active = (MCM_STATUS::MCM_OK == this->get_event_async());
+}
+
+void MCM::drain_pending_events()
+{
+    this->start_event_drain();
+    // every GET_EVENT response requests the next one, command stays pending until the last event
+    this->wait_for_command();
+}
+
+bool MCM::get_is_event_drain_active()
+{
+    return this->is_event_drain_active;
+}
+
+void MCM::set_is_event_drain_active(bool val)
+{
+    this->is_event_drain_active = val;
 }
 
 bool MCM::is_connected()
@@ -1169,40 +1581,138 @@ MCM_TX_STATUS MCM::get_last_tx_status()
 
 void MCM::send_uplink(uint8_t *data, uint16_t len, uint8_t port, MCM_UPLINK_TYPE send_uplink)
 {
-    this->is_last_uplink_pend = true;
-    api_processor_status_t api_status = API_PROCESSOR_ERROR;
-
-    /// Uplink Type conversion
-    mrover_uplink_type_t uplink_type = MROVER_UNCONFIRMED_UPLINK;
-    if (MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF == send_uplink)
-    {
-        uplink_type = MROVER_UNCONFIRMED_UPLINK;
-    }
-    else
+    // held until the end of the file transfer, the caller does not wait for it
+    if (this->is_file_transfer_active())
     {
-        uplink_type = MROVER_CONFIRMED_UPLINK;
+        this->send_uplink_async(data, len, port, send_uplink);
+        return;
     }
 
-    /// Uplink will be done on the currently active network
-    if (ConnectionMode::CONNECTION_MODE_LORAWAN == this->current_mode)
+    // let the command submitted before finish first
+    this->wait_for_command();
+
+    if (MCM_STATUS::MCM_OK == this->send_uplink_async(data, len, port, send_uplink))
     {
-        api_status = api_processor_cmd_request_lorawan_uplink(this->module, port, data, len, uplink_type);
+        this->wait_for_command();
     }
-    else
+}
+
+MCM_STATUS MCM::send_uplink_async(uint8_t *data, uint16_t len, uint8_t port, MCM_UPLINK_TYPE send_uplink,
+                                  on_cmd_complete_callback callback, void *user_ctx)
+{
+    MCM_STATUS status = MCM_STATUS::MCM_ERROR;
+    api_processor_status_t api_status = API_PROCESSOR_ERROR;
+
+    do
     {
+        /// Uplink Type conversion
+        mrover_uplink_type_t uplink_type = MROVER_UNCONFIRMED_UPLINK;
+        if (MCM_UPLINK_TYPE::MCM_UPLINK_TYPE_UNCONF == send_uplink)
+        {
+            uplink_type = MROVER_UNCONFIRMED_UPLINK;
+        }
+        else
+        {
+            uplink_type = MROVER_CONFIRMED_UPLINK;
+        }
+
+        /// modem is sending the file over the uart, the newest uplink is kept for the end of the transfer
+        if (this->is_file_transfer_active())
+        {
+            if (len > sizeof(this->deferred_uplink.held_data))
+            {
+                break;
+            }
+            // a position report held before is outdated by this one
+            if (this->deferred_uplink.is_scheduled && (nullptr != this->deferred_uplink.on_complete))
+            {
+                this->deferred_uplink.on_complete(MROVER_CC_REQUEST_UPLINK, MCM_CMD_STATUS::MCM_CMD_FAILED,
+                                                  MROVER_RC_FAIL, this->deferred_uplink.user_ctx);
+            }
+            memcpy(this->deferred_uplink.held_data, data, len);
+            this->deferred_uplink.data = this->deferred_uplink.held_data;
+            this->deferred_uplink.len = len;
+            this->deferred_uplink.port = port;
+            this->deferred_uplink.uplink_type = uplink_type;
+            this->deferred_uplink.on_complete = callback;
+            this->deferred_uplink.user_ctx = user_ctx;
+            this->deferred_uplink.is_held = true;
+            this->deferred_uplink.is_scheduled = true;
+            this->is_last_uplink_pend = true;
+            status = MCM_STATUS::MCM_OK;
+            break;
+        }
+
+        if (this->is_command_pending())
+        {
+            break;
+        }
+        this->is_last_uplink_pend = true;
+
         /// BLE connection will be established before attempting an uplink for sidewalk BLE mode
+        /// uplink is requested by poll() later on, data must stay valid until the completion
         if (ConnectionMode::CONNECTION_MODE_SIDEWALK_BLE == this->current_mode)
         {
-            api_status = api_processor_cmd_sid_ble_conn_request(this->module);
-            delay(5000);
+            api_processor_cmd_sid_ble_conn_request(this->module);
+            this->deferred_uplink.data = data;
+            this->deferred_uplink.len = len;
+            this->deferred_uplink.port = port;
+            this->deferred_uplink.uplink_type = uplink_type;
+            this->deferred_uplink.on_complete = callback;
+            this->deferred_uplink.user_ctx = user_ctx;
+            this->deferred_uplink.due_time = millis() + MCM_BLE_CONN_SETUP_TIME_MS;
+            this->deferred_uplink.is_scheduled = true;
+            status = MCM_STATUS::MCM_OK;
+            break;
         }
-        api_status = api_processor_cmd_sid_send_uplink(this->module, data, len, uplink_type);
-    }
 
-    if (API_PROCESSOR_SUCCESS == api_status)
+        this->pending_cmd.next_on_complete = callback;
+        this->pending_cmd.next_user_ctx = user_ctx;
+        api_status = this->request_uplink(data, len, port, uplink_type);
+        if (API_PROCESSOR_SUCCESS != api_status)
+        {
+            this->pending_cmd.next_on_complete = nullptr;
+            this->pending_cmd.next_user_ctx = nullptr;
+            break;
+        }
+        status = MCM_STATUS::MCM_OK;
+    } while (0);
+
+    return status;
+}
+
+api_processor_status_t MCM::request_uplink(uint8_t *data, uint16_t len, uint8_t port, mrover_uplink_type_t uplink_type)
+{
+    /// Uplink will be done on the currently active network
+    if (ConnectionMode::CONNECTION_MODE_LORAWAN == this->current_mode)
     {
-        this->process_received_data();
+        return api_processor_cmd_request_lorawan_uplink(this->module, port, data, len, uplink_type);
     }
+    return api_processor_cmd_sid_send_uplink(this->module, data, len, uplink_type);
+}
+
+MCM_STATUS MCM::get_event_async(on_cmd_complete_callback callback, void *user_ctx)
+{
+    MCM_STATUS status = MCM_STATUS::MCM_ERROR;
+    do
+    {
+        if (this->is_command_pending())
+        {
+            break;
+        }
+
+        this->pending_cmd.next_on_complete = callback;
+        this->pending_cmd.next_user_ctx = user_ctx;
+        if (API_PROCESSOR_SUCCESS != api_processor_cmd_get_event(this->module))
+        {
+            this->pending_cmd.next_on_complete = nullptr;
+            this->pending_cmd.next_user_ctx = nullptr;
+            break;
+        }
+        status = MCM_STATUS::MCM_OK;
+    } while (0);
+
+    return status;
 }
 
 void MCM::set_on_rx_callback(on_rx_callback callback)
@@ -1249,14 +1759,9 @@ HardwareSerial &MCM::get_serial()
     return __mcm_serial;
 }
 
-void MCM::set_is_rx_received(uint8_t val)
-{
-    is_rx_received = val;
-}
-
-void MCM::set_received_size(uint16_t val)
+uint8_t MCM::get_capture_port()
 {
-    received_size = val;
+    return this->capture_port;
 }
 
 void MCM::set_is_joined_network(bool val)
@@ -1269,11 +1774,6 @@ void MCM::set_is_last_uplink_pending(bool val)
     is_last_uplink_pend = val;
 }
 
-uint8_t *MCM::get_downlink_buffer()
-{
-    return downlink_buffer;
-}
-
 on_rx_callback MCM::get_on_rx_callback_func()
 {
     return on_rx_callback_func;
@@ -1291,26 +1791,95 @@ void MCM::set_serial_rx_timeout(uint32_t timeout)
 
 bool MCM::is_downlink_available()
 {
-    return this->is_downlink_avail;
+    return this->downlink_fifo_count > 0;
 }
 
-void MCM::set_downlink_meta_data(uint16_t len, int8_t rssi, int8_t snr, uint16_t seq_port, bool val)
+mcm_downlink_t *MCM::alloc_downlink(uint16_t len)
 {
-    this->downlink_buffer_size = len;
-    this->rssi = rssi;
-    this->snr = snr;
-    this->seq_port = seq_port;
-    this->is_downlink_avail = val;
+    if ((0 == this->downlink_free_count) || (len > MCM_DOWNLINK_SLOT_SIZE))
+    {
+        this->downlink_stats.dropped_count++;
+        return nullptr;
+    }
+
+    uint8_t slot = this->downlink_free[--this->downlink_free_count];
+    if (0 != (this->downlink_in_use & (1UL << slot)))
+    {
+        // free stack and bitmap disagree, the slot is not handed out twice
+        this->downlink_stats.dropped_count++;
+        return nullptr;
+    }
+    this->downlink_in_use |= (1UL << slot);
+    mcm_downlink_t *downlink = &this->downlink_pool[slot];
+    this->downlink_stats.received_count++;
+    uint8_t in_use = MCM_DOWNLINK_POOL_SLOTS - this->downlink_free_count;
+    if (in_use > this->downlink_stats.high_water)
+    {
+        this->downlink_stats.high_water = in_use;
+    }
+    return downlink;
+}
+
+void MCM::queue_downlink(mcm_downlink_t *downlink)
+{
+    // fifo never overflows, it has a place for every slot of the pool
+    uint8_t tail = (this->downlink_fifo_head + this->downlink_fifo_count) % MCM_DOWNLINK_POOL_SLOTS;
+    this->downlink_fifo[tail] = (uint8_t)(downlink - this->downlink_pool);
+    this->downlink_fifo_count++;
+}
+
+mcm_downlink_t *MCM::borrow_downlink()
+{
+    if (0 == this->downlink_fifo_count)
+    {
+        return nullptr;
+    }
+
+    mcm_downlink_t *downlink = &this->downlink_pool[this->downlink_fifo[this->downlink_fifo_head]];
+    this->downlink_fifo_head = (this->downlink_fifo_head + 1) % MCM_DOWNLINK_POOL_SLOTS;
+    this->downlink_fifo_count--;
+    return downlink;
+}
+
+void MCM::release_downlink(mcm_downlink_t *downlink)
+{
+    if ((nullptr == downlink) || (downlink < this->downlink_pool) ||
+        (downlink >= &this->downlink_pool[MCM_DOWNLINK_POOL_SLOTS]))
+    {
+        return;
+    }
+    // a slot released twice would be on the free stack twice and handed out to two owners
+    uint8_t slot = (uint8_t)(downlink - this->downlink_pool);
+    if (0 == (this->downlink_in_use & (1UL << slot)))
+    {
+        this->downlink_stats.bad_release_count++;
+        return;
+    }
+    this->downlink_in_use &= ~(1UL << slot);
+    this->downlink_free[this->downlink_free_count++] = slot;
+}
+
+void MCM::get_downlink_stats(mcm_downlink_stats_t *stats)
+{
+    *stats = this->downlink_stats;
+    stats->queued_count = this->downlink_fifo_count;
 }
 
 void MCM::get_downlink_data(uint8_t *data, uint16_t *len, int8_t *rssi, int8_t *snr, uint16_t *seq_port)
 {
-    *len = this->downlink_buffer_size;
-    memcpy(data, this->downlink_buffer, *len);
-    *rssi = this->rssi;
-    *snr = this->snr;
-    *seq_port = this->seq_port;
-    this->is_downlink_avail = false;
+    // copying variant of borrow_downlink(), kept for the existing users
+    mcm_downlink_t *downlink = this->borrow_downlink();
+    if (nullptr == downlink)
+    {
+        *len = 0;
+        return;
+    }
+    *len = downlink->len;
+    memcpy(data, downlink->payload, downlink->len);
+    *rssi = downlink->rssi;
+    *snr = downlink->snr;
+    *seq_port = downlink->seq_port;
+    this->release_downlink(downlink);
 }
 
 bool MCM::get_is_debug_enabled()
@@ -1359,11 +1928,7 @@ void MCM::hw_reset()
 
     delay(1000);
     this->process_received_data();
-    while (api_processor_get_pending_events(this->module) > 0)
-    {
-        api_processor_cmd_get_event(this->module); // send the get event command
-        this->process_received_data();
-    }
+    this->drain_pending_events();
 }
 
 MCM_STATUS MCM::set_lorawan_class(MCM_LORAWAN_CLASS_TYPE dev_class)
@@ -1442,6 +2007,9 @@ MCM_STATUS MCM::start_file_transfer(ver_type_1_t version)
     MCM_STATUS status = MCM_STATUS::MCM_ERROR;
     api_processor_status_t api_status = API_PROCESSOR_ERROR;
 
+    // a transfer interrupted by a reset resumes only for the same image
+    this->ymodem.setImageVersion(FW_RESUME_VERSION(version.major, version.minor, version.patch));
+
     do
     {
         // Send the start file transfer command
@@ -75,7 +75,12 @@ extern "C" {
  **********************************************************************************************************/
 #include <Arduino.h>
 #include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/task.h>
 #include "api_processor.h" 
+#include "mcm_rx_path.h"
 #include "ymodem.h"
 #include "host_fuota.h"
 
@@ -95,6 +100,28 @@ extern "C" {
 #define MCM_ROVER_LIB_VER_MINOR 3
 #define MCM_ROVER_LIB_VER_PATCH 0
 
+/**
+ * @brief Time given to the mcm to set up the ble connection before
+ * the sidewalk ble uplink is requested
+ */
+#define MCM_BLE_CONN_SETUP_TIME_MS (5000)
+
+/**
+ * @brief Serial rx path
+ * uart callback writes the bytes to the stream buffer, rx task turns them into
+ * frames and hands them over to the loop through the rx queue, see mcm_rx_path.h
+ */
+#define MCM_RX_TASK_STACK_SIZE (4096)
+#define MCM_RX_TASK_PRIORITY (5)
+#define MCM_RX_RAW_ITEMS_PER_POLL (1)   // ymodem packets handled per poll, the loop keeps its time during a transfer
+
+/**
+ * @brief Downlink pool
+ * downlink payload always fits in a single mcm response
+ */
+#define MCM_DOWNLINK_POOL_SLOTS (8)     // at most 32, a bit of downlink_in_use each
+#define MCM_DOWNLINK_SLOT_SIZE (MAX_SERIAL_RECEIVE_PAYLOAD_SIZE)
+
 /**********************************************************************************************************
  * TYPEDEFS AND CLASSES
  **********************************************************************************************************/
@@ -140,7 +167,52 @@ enum class MCM_LORAWAN_CLASS_TYPE
     MCM_LRWAN_CLASS_C = 0X02
 };
 
-typedef void(*on_rx_callback)(uint8_t *data, uint8_t len,int8_t rssi,uint8_t snr,uint16_t seq_port);
+/**
+ * @brief State of the command submitted to the mcm
+ * mcm handles one command at a time, so there is a single command in flight
+ */
+enum class MCM_CMD_STATUS {
+    MCM_CMD_IDLE,       // no command submitted yet
+    MCM_CMD_PENDING,    // command sent, waiting for the response
+    MCM_CMD_DONE,       // response received with MROVER_RC_OK
+    MCM_CMD_FAILED,     // response received with an error return code
+    MCM_CMD_TIMEOUT     // response not received within the serial rx timeout
+};
+
+/**
+ * @brief Downlink held in the pool, borrowed by the application and
+ * valid until it is released
+ */
+typedef struct {
+    uint8_t payload[MCM_DOWNLINK_SLOT_SIZE];
+    uint16_t len;
+    int8_t rssi;
+    int8_t snr;
+    uint16_t seq_port;          // lorawan port or sidewalk sequence
+    command_types_t protocol;   // COMMAND_TYPE_LORAWAN or COMMAND_TYPE_SIDEWALK
+    uint32_t timestamp;         // millis() at the reception
+} mcm_downlink_t;
+
+typedef struct {
+    uint32_t received_count;    // downlinks handed to the application
+    uint32_t dropped_count;     // downlinks lost, no free slot in the pool
+    uint8_t queued_count;       // downlinks waiting to be borrowed
+    uint8_t high_water;         // max slots in use at the same time
+    uint32_t bad_release_count; // releases of a slot which was not in use, ignored
+} mcm_downlink_stats_t;
+
+/**
+ * @brief Downlink callback, data is valid until the callback returns
+ * A registered callback consumes the downlinks, they are not queued for borrow_downlink()
+ */
+typedef void(*on_rx_callback)(uint8_t *data, uint16_t len,int8_t rssi,int8_t snr,uint16_t seq_port);
+
+/**
+ * @brief Completion callback of the asynchronous commands
+ * return_code is only valid for MCM_CMD_DONE and MCM_CMD_FAILED
+ */
+typedef void(*on_cmd_complete_callback)(mrover_cc_codes_t cmd_code, MCM_CMD_STATUS status, mrover_return_code_t return_code, void *user_ctx);
+
 
 
 class MCM {
@@ -154,24 +226,74 @@ class MCM {
     uint8_t _tx_pin;
     HardwareSerial& __mcm_serial;
     mcm_module_hdl_t *module = NULL;
-    uint8_t is_rx_received;
-    uint16_t received_size;
-    uint8_t sw_reset_evnet_count;
+    McmRxPath rx_path;
+    TaskHandle_t rx_task = NULL;
+    String version_info;                // filled by the get version response
+    // TODO: remove it after the mcm reset bug fixed
+    //  currently there is a bug,due to which
+    // mcm gives 2 events for software reset
+    //  this is a workaround
+    uint16_t reset_event_count = 0;
     bool is_joined_network;
     MCM_TX_STATUS last_tx_status;
-    bool is_downlink_avail =  false;
     bool is_last_uplink_pend;
-    uint8_t downlink_buffer[BUFFER_SIZE];
-    uint16_t downlink_buffer_size;
+    mcm_downlink_t downlink_pool[MCM_DOWNLINK_POOL_SLOTS];
+    uint8_t downlink_free[MCM_DOWNLINK_POOL_SLOTS];     // stack of free slot indexes
+    uint8_t downlink_free_count;
+    uint32_t downlink_in_use;                           // bit set for each slot handed out and not released
+    uint8_t downlink_fifo[MCM_DOWNLINK_POOL_SLOTS];     // slot indexes in the reception order
+    uint8_t downlink_fifo_head;
+    uint8_t downlink_fifo_count;
+    mcm_downlink_stats_t downlink_stats = {0};
     on_rx_callback on_rx_callback_func = nullptr;
     uint32_t serial_rx_timeout = 2000;
-    int8_t rssi;
-    uint8_t snr;
-    uint16_t seq_port;
     bool is_debug_enabled = false;
+    uint8_t capture_port;               // port of the uart capture records, in the order the instances are made
     bool _context_mgr_is_joined_cmd_received = false;
     bool _context_mgr_is_mcm_reset;
+
+    // command in flight, started by the send callbacks and completed by the response
+    struct {
+        mrover_cc_codes_t cmd_code;
+        MCM_CMD_STATUS status = MCM_CMD_STATUS::MCM_CMD_IDLE;
+        mrover_return_code_t return_code;
+        uint32_t start_time;
+        on_cmd_complete_callback on_complete = nullptr;
+        void *user_ctx = nullptr;
+        // callback staged by the async methods, taken over when the command is sent
+        on_cmd_complete_callback next_on_complete = nullptr;
+        void *next_user_ctx = nullptr;
+    } pending_cmd;
+
+    // sidewalk ble uplink waiting for the ble connection to come up,
+    // or uplink held while the file transfer owns the uart
+    struct {
+        bool is_scheduled = false;
+        bool is_held = false;           // sent once the file transfer is over
+        uint8_t held_data[MAX_SERIAL_SEND_PAYLOAD_SIZE];
+        uint32_t due_time;
+        uint8_t *data;
+        uint16_t len;
+        uint8_t port;
+        mrover_uplink_type_t uplink_type;
+        on_cmd_complete_callback on_complete;
+        void *user_ctx;
+    } deferred_uplink;
+
+    // GET_EVENT requests chained by the responses until no event is pending
+    bool is_event_drain_active = false;
+
+    // segments of the package the modem is downloading, over all the status events
+    fuota_seg_tracker_t seg_tracker = {};
+    uint32_t *seg_tracker_words = nullptr;      // sized by the first status of a package
+    uint16_t seg_tracker_word_count = 0;
+    bool is_seg_package_refused = false;        // logged once per package
+
     void process_received_data();
+    uint16_t process_rx_queue();
+    void start_event_drain();
+    void wait_for_command();
+    api_processor_status_t request_uplink(uint8_t *data, uint16_t len, uint8_t port, mrover_uplink_type_t uplink_type);
     
 public:
     ver_type_1_t host_version;
@@ -190,7 +312,20 @@ public:
     MCM_STATUS set_lorawan_credentials(uint8_t *dev_eui, uint8_t *join_eui,uint8_t *app_key);
     MCM_STATUS connect_network();
     void send_uplink(uint8_t *data, uint16_t len,uint8_t port,MCM_UPLINK_TYPE send_uplink);
+    MCM_STATUS connect_network_async(on_cmd_complete_callback callback = nullptr, void *user_ctx = nullptr);
+    MCM_STATUS send_uplink_async(uint8_t *data, uint16_t len, uint8_t port, MCM_UPLINK_TYPE send_uplink,
+                                 on_cmd_complete_callback callback = nullptr, void *user_ctx = nullptr);
+    MCM_STATUS get_event_async(on_cmd_complete_callback callback = nullptr, void *user_ctx = nullptr);
+    void poll();
+    bool is_command_pending();
+    bool is_file_transfer_active();
+    MCM_CMD_STATUS get_command_status();
+    void begin_command(mrover_cc_codes_t cmd_code);
+    void complete_command(mrover_cc_codes_t cmd_code, MCM_CMD_STATUS status, mrover_return_code_t return_code);
     void handle_rx_events();
+    void drain_pending_events();
+    bool get_is_event_drain_active();
+    void set_is_event_drain_active(bool val);
     bool is_connected();
     MCM_TX_STATUS get_last_tx_status();
     bool is_last_uplink_pending();
@@ -205,15 +340,24 @@ public:
     MCM_STATUS factory_reset();
     mcm_module_hdl_t* get_module_handle();
     HardwareSerial& get_serial();
-    void set_is_rx_received(uint8_t val);
-    void set_received_size(uint16_t val);
-    uint8_t get_sw_reset_event_count();
+    uint8_t get_capture_port();
+    void run_rx_task();
+    void get_rx_stats(mcm_rx_stats_t *stats);
+    void get_metrics(api_metrics_t *metrics, bool reset);
+    bool update_segment_status();
+    const fuota_seg_tracker_t *get_segment_tracker();
+    void set_version_info(const String &info);
+    uint16_t get_reset_event_count();
+    void increment_reset_event_count();
     void set_is_joined_network(bool val);
     void set_is_last_uplink_pending(bool val);
-    uint8_t* get_downlink_buffer();
+    mcm_downlink_t* alloc_downlink(uint16_t len);
+    void queue_downlink(mcm_downlink_t *downlink);
+    mcm_downlink_t* borrow_downlink();
+    void release_downlink(mcm_downlink_t *downlink);
+    void get_downlink_stats(mcm_downlink_stats_t *stats);
     on_rx_callback get_on_rx_callback_func();
     void set_last_tx_status(MCM_TX_STATUS status);
-    void set_downlink_meta_data(uint16_t len,int8_t rssi,int8_t snr,uint16_t seq_port,bool val);
     bool get_is_debug_enabled();
     void set_context_mgr_is_joined_cmd_received(bool val);
     bool get_context_mgr_is_joined_cmd_received();
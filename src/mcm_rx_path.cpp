@@ -0,0 +1,223 @@
+/**
+ * @file mcm_rx_path.cpp
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Serial rx path of one modem, from the uart callback to the loop
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "mcm_rx_path.h"
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void on_rx_path_frame(uint8_t *p_frame, uint16_t u16_len, void *user_context)
+{
+    McmRxPath *rx_path = (McmRxPath *)user_context;
+    rx_path->queue_frame(p_frame, u16_len);
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+bool McmRxPath::begin(mcm_rx_is_raw_cb is_raw_cb, void *user_ctx)
+{
+    this->is_raw_cb = is_raw_cb;
+    this->user_ctx = user_ctx;
+    this->raw_len = 0;
+    fp_reassembler_init(&this->reassembler);
+
+    this->stream = xStreamBufferCreate(MCM_RX_STREAM_SIZE, 1);
+    this->queue = xQueueCreate(MCM_RX_QUEUE_DEPTH, sizeof(mcm_rx_item_t));
+    this->free_slots = xQueueCreate(MCM_RX_POOL_SLOTS, sizeof(uint8_t));
+    if ((NULL == this->stream) || (NULL == this->queue) || (NULL == this->free_slots))
+    {
+        return false;
+    }
+    for (uint8_t slot = 0; slot < MCM_RX_POOL_SLOTS; slot++)
+    {
+        this->give_slot(slot);
+    }
+    return true;
+}
+
+size_t McmRxPath::write(const uint8_t *data, size_t len)
+{
+    size_t sent_size = xStreamBufferSend(this->stream, data, len, 0);
+    this->stream_overflow_bytes.fetch_add(len - sent_size);
+    return sent_size;
+}
+
+void McmRxPath::run_once()
+{
+    uint8_t chunk[MCM_RX_CHUNK_SIZE];
+    size_t size = xStreamBufferReceive(this->stream, chunk, sizeof(chunk), pdMS_TO_TICKS(MCM_RX_IDLE_TIMEOUT_MS));
+
+    if (!this->is_raw_cb(this->user_ctx))
+    {
+        // packet cut by the end of the transfer is not handed over
+        if (this->raw_len > 0)
+        {
+            this->give_slot(this->raw_slot);
+            this->raw_len = 0;
+        }
+        // frames are validated here, the loop only gets the complete ones
+        if (size > 0)
+        {
+            fp_reassembler_feed(&this->reassembler, chunk, (uint16_t)size, on_rx_path_frame, this);
+            this->publish_link_counters();
+        }
+        return;
+    }
+
+    // ymodem packet has no length field known here, line going idle ends it
+    if ((size > 0) && ((this->raw_len + size) <= MCM_RX_SLOT_SIZE))
+    {
+        if ((0 == this->raw_len) && !this->take_slot(&this->raw_slot))
+        {
+            this->items_dropped.fetch_add(1);
+            return;
+        }
+        memcpy(&this->pool[this->raw_slot][this->raw_len], chunk, size);
+        this->raw_len += size;
+        return;
+    }
+
+    if (this->raw_len > 0)
+    {
+        this->queue_item(MCM_RX_ITEM_TYPE::MCM_RX_ITEM_RAW, this->raw_slot, this->raw_len);
+        this->raw_len = 0;
+    }
+    // chunk that did not fit starts the next packet
+    if ((size > 0) && this->take_slot(&this->raw_slot))
+    {
+        memcpy(this->pool[this->raw_slot], chunk, size);
+        this->raw_len = size;
+    }
+}
+
+void McmRxPath::queue_frame(const uint8_t *data, uint16_t len)
+{
+    uint8_t slot;
+
+    if ((len > MCM_RX_SLOT_SIZE) || !this->take_slot(&slot))
+    {
+        this->items_dropped.fetch_add(1);
+        return;
+    }
+    memcpy(this->pool[slot], data, len);
+    this->queue_item(MCM_RX_ITEM_TYPE::MCM_RX_ITEM_FRAME, slot, len);
+}
+
+bool McmRxPath::receive(mcm_rx_item_t *item)
+{
+    return (pdTRUE == xQueueReceive(this->queue, item, 0));
+}
+
+uint8_t *McmRxPath::get_data(const mcm_rx_item_t *item)
+{
+    return this->pool[item->slot];
+}
+
+void McmRxPath::release(const mcm_rx_item_t *item)
+{
+    this->give_slot(item->slot);
+}
+
+uint32_t McmRxPath::get_waiting()
+{
+    return (uint32_t)uxQueueMessagesWaiting(this->queue);
+}
+
+void McmRxPath::get_stats(mcm_rx_stats_t *stats)
+{
+    stats->stream_overflow_bytes = this->stream_overflow_bytes.load();
+    stats->items_count = this->items_count.load();
+    stats->items_dropped = this->items_dropped.load();
+    stats->queue_high_water = this->queue_high_water.load();
+    stats->garbage_bytes = this->link_dropped_bytes.load();
+}
+
+void McmRxPath::add_link_metrics(api_metrics_t *metrics, bool reset)
+{
+    api_metrics_link_t now = {0};
+    now.u32_bytes_in = this->link_bytes_in.load();
+    now.u32_crc_errors = this->link_crc_errors.load();
+    now.u32_length_errors = this->link_length_errors.load();
+    now.u32_resync_count = this->link_resync_count.load();
+    now.u32_dropped_bytes = this->link_dropped_bytes.load();
+
+    // unsigned differences stay right when a counter wraps
+    metrics->h_link.u32_bytes_in += now.u32_bytes_in - this->link_base.u32_bytes_in;
+    metrics->h_link.u32_crc_errors += now.u32_crc_errors - this->link_base.u32_crc_errors;
+    metrics->h_link.u32_length_errors += now.u32_length_errors - this->link_base.u32_length_errors;
+    metrics->h_link.u32_resync_count += now.u32_resync_count - this->link_base.u32_resync_count;
+    metrics->h_link.u32_dropped_bytes += now.u32_dropped_bytes - this->link_base.u32_dropped_bytes;
+    if (reset)
+    {
+        this->link_base = now;
+    }
+}
+
+bool McmRxPath::take_slot(uint8_t *slot)
+{
+    // pool has a slot for every place an item can be, it only runs out if a slot is not released
+    return (pdTRUE == xQueueReceive(this->free_slots, slot, 0));
+}
+
+void McmRxPath::give_slot(uint8_t slot)
+{
+    xQueueSend(this->free_slots, &slot, 0);
+}
+
+void McmRxPath::publish_link_counters()
+{
+    this->link_bytes_in.store(this->reassembler.u32_bytes_in);
+    this->link_crc_errors.store(this->reassembler.u32_crc_errors);
+    this->link_length_errors.store(this->reassembler.u32_length_errors);
+    this->link_resync_count.store(this->reassembler.u32_resync_count);
+    this->link_dropped_bytes.store(this->reassembler.u32_dropped_bytes);
+}
+
+void McmRxPath::queue_item(MCM_RX_ITEM_TYPE type, uint8_t slot, uint16_t len)
+{
+    mcm_rx_item_t item = {type, slot, len};
+
+    if (pdTRUE == xQueueSend(this->queue, &item, 0))
+    {
+        this->items_count.fetch_add(1);
+        uint32_t waiting = this->get_waiting();
+        if (waiting > this->queue_high_water.load())
+        {
+            this->queue_high_water.store(waiting);
+        }
+    }
+    else
+    {
+        this->items_dropped.fetch_add(1);
+        this->give_slot(slot);
+    }
+}
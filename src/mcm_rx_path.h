@@ -0,0 +1,152 @@
+/**
+ * @file mcm_rx_path.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Serial rx path of one modem, from the uart callback to the loop
+ * @version 0.1
+ * @date 2025-02-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __MCM_RX_PATH_H__
+#define __MCM_RX_PATH_H__
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/stream_buffer.h>
+#include "api_metrics.h"
+#include "frame_parse.h"
+
+// mcm_rover.h includes this header inside extern "C"
+extern "C++" {
+#include <atomic>
+}
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define MCM_RX_STREAM_SIZE (2048)       // holds two 1k ymodem packets
+#define MCM_RX_CHUNK_SIZE (64)          // bytes moved per stream buffer access
+#define MCM_RX_QUEUE_DEPTH (4)          // frames waiting for the loop
+#define MCM_RX_IDLE_TIMEOUT_MS (20)     // line idle time closing a raw ymodem packet
+#define MCM_RX_SLOT_SIZE (1036)         // 1k ymodem packet with its header and crc
+// queued items, the raw packet the rx task builds and the item the loop handles
+#define MCM_RX_POOL_SLOTS (MCM_RX_QUEUE_DEPTH + 2)
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+enum class MCM_RX_ITEM_TYPE : uint8_t {
+    MCM_RX_ITEM_FRAME,  // validated response or notification frame
+    MCM_RX_ITEM_RAW     // bytes received while ymodem is running
+};
+
+/**
+ * @brief Item of the rx queue, the bytes stay in the slot of the pool
+ */
+typedef struct {
+    MCM_RX_ITEM_TYPE type;
+    uint8_t slot;
+    uint16_t len;
+} mcm_rx_item_t;
+
+typedef struct {
+    uint32_t stream_overflow_bytes; // bytes lost, stream buffer was full
+    uint32_t garbage_bytes;         // bytes discarded by the frame reassembler
+    uint32_t items_count;           // frames and raw packets queued for the loop
+    uint32_t items_dropped;         // frames and raw packets lost, rx queue was full
+    uint32_t queue_high_water;      // max items waiting in the rx queue
+} mcm_rx_stats_t;
+
+/**
+ * @brief Tells the rx task the bytes are a ymodem transfer, read from the rx task while the loop changes it
+ */
+typedef bool (*mcm_rx_is_raw_cb)(void *user_ctx);
+
+/**
+ * @brief Bytes of the modem from the uart callback to the loop
+ *
+ * write() runs in the uart event task and only fills the stream buffer. run_once() runs
+ * in the rx task, it turns the bytes into validated frames, or into raw ymodem packets
+ * closed by the line going idle while the raw callback says so, and queues them. A queue
+ * item is a slot index and a length, the bytes stay in the pool: the loop gets the slot
+ * from receive() and gives it back with release().
+ */
+class McmRxPath
+{
+public:
+    /**
+     * @brief Creates the stream buffer and the queues, before the first byte comes in
+     * @return false if they can not be created
+     */
+    bool begin(mcm_rx_is_raw_cb is_raw_cb, void *user_ctx);
+
+    /**
+     * @brief Bytes read from the uart, the ones which do not fit are counted as lost
+     * @return bytes which fit in the stream buffer
+     */
+    size_t write(const uint8_t *data, size_t len);
+
+    /**
+     * @brief One pass of the rx task, waits up to MCM_RX_IDLE_TIMEOUT_MS for bytes
+     */
+    void run_once();
+
+    /**
+     * @brief Next frame or raw packet for the loop, it owns the slot until release()
+     * @return false if none is waiting
+     */
+    bool receive(mcm_rx_item_t *item);
+    uint8_t *get_data(const mcm_rx_item_t *item);
+    void release(const mcm_rx_item_t *item);
+
+    uint32_t get_waiting();
+    void get_stats(mcm_rx_stats_t *stats);
+
+    /**
+     * @brief Adds the counters of the reassembler to the link metrics, loop only
+     *
+     * The rx task publishes the counters after each chunk and never clears them, a reset
+     * moves the base the loop counts from.
+     * @param reset next call counts from now on
+     */
+    void add_link_metrics(api_metrics_t *metrics, bool reset);
+
+    // frame callback of the reassembler, rx task only
+    void queue_frame(const uint8_t *data, uint16_t len);
+
+private:
+    bool take_slot(uint8_t *slot);
+    void give_slot(uint8_t slot);
+    void queue_item(MCM_RX_ITEM_TYPE type, uint8_t slot, uint16_t len);
+    void publish_link_counters();
+
+    StreamBufferHandle_t stream = NULL;
+    QueueHandle_t queue = NULL;
+    QueueHandle_t free_slots = NULL;    // indexes of the slots nobody owns
+    mcm_rx_is_raw_cb is_raw_cb = NULL;
+    void *user_ctx = NULL;
+    fp_reassembler_t reassembler;       // owned by the rx task
+    uint8_t raw_slot = 0;               // owned by the rx task while raw_len is not 0
+    uint16_t raw_len = 0;
+    // read by the loop while the uart task and the rx task count
+    std::atomic<uint32_t> stream_overflow_bytes{0};  // uart task
+    std::atomic<uint32_t> items_count{0};            // rx task, like the ones below
+    std::atomic<uint32_t> items_dropped{0};
+    std::atomic<uint32_t> queue_high_water{0};
+    // counters of the reassembler as the rx task last published them
+    std::atomic<uint32_t> link_bytes_in{0};
+    std::atomic<uint32_t> link_crc_errors{0};
+    std::atomic<uint32_t> link_length_errors{0};
+    std::atomic<uint32_t> link_resync_count{0};
+    std::atomic<uint32_t> link_dropped_bytes{0};
+    api_metrics_link_t link_base = {0};  // published counters at the last reset, loop only
+    uint8_t pool[MCM_RX_POOL_SLOTS][MCM_RX_SLOT_SIZE];
+};
+
+#endif // __MCM_RX_PATH_H__
@@ -165,6 +165,51 @@ static int protocol_switch_callback(const char *pu8_input_value, cli_send_bytes_
  */
 static int send_fw_update_request_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
 
+/**
+ * @brief Prints the serial link metrics.
+ *
+ * @param pu8_input_value "reset" to clear the metrics after printing.
+ * @param pfun_uart_tx Function to send bytes over UART.
+ * @return int Return status code.
+ */
+static int stats_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
+
+/**
+ * @brief Prints the trace records waiting in the trace buffer.
+ *
+ * @param pu8_input_value Not used.
+ * @param pfun_uart_tx Function to send bytes over UART.
+ * @return int Return status code.
+ */
+static int log_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
+
+/**
+ * @brief Prints the progress and the pending segments of the segmented file download.
+ *
+ * @param pu8_input_value Not used.
+ * @param pfun_uart_tx Function to send bytes over UART.
+ * @return int Return status code.
+ */
+static int fuota_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
+
+/**
+ * @brief Starts, stops, clears or dumps the capture of the MCM and GNSS UART traffic.
+ *
+ * @param pu8_input_value status, mcm, gnss, all, off, clear or dump, status when empty.
+ * @param pfun_uart_tx Function to send bytes over UART.
+ * @return int Return status code.
+ */
+static int capture_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
+
+/**
+ * @brief Times the checksums over a 1 KB block, as ymodem and the image check run them.
+ *
+ * @param pu8_input_value Not used.
+ * @param pfun_uart_tx Function to send bytes over UART.
+ * @return int Return status code.
+ */
+static int checksum_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx);
+
 /**
  * @brief cli_send_bytes call back to send the bytes
  *
@@ -213,6 +258,16 @@ void send_uplink_now();
 
 void send_fw_update_request();
 
+void print_link_stats(bool reset);
+
+void print_trace_log();
+
+void print_fuota_status();
+
+void run_capture_command(const char *arg);
+
+void print_checksum_timing();
+
 /******************************************************************************/
 /* enter_bootloader application variable */
 /******************************************************************************/
@@ -264,6 +319,37 @@ cli_command_t cli_commands[] = {{
                                                 "Switch protocol mode. Modes: lorawan, sw_ble, sw_fsk, sw_css",
                                                 protocol_switch_callback,
                                             },
+                                            {
+                                                "stats",
+                                                CLI_APP_NAME" stats [reset] <enter>",
+                                                "To print the serial link metrics, reset clears them after printing",
+                                                stats_callback,
+                                            },
+                                            {
+                                                "log",
+                                                CLI_APP_NAME" log <enter>",
+                                                "To print the trace records waiting in the trace buffer",
+                                                log_callback,
+                                            },
+                                            {
+                                                "fuota",
+                                                CLI_APP_NAME" fuota <enter>",
+                                                "To print the progress and the pending segments of the file download",
+                                                fuota_callback,
+                                            },
+                                            {
+                                                "capture",
+                                                CLI_APP_NAME" capture [status|mcm|gnss|all|off|clear|dump] <enter>",
+                                                "To capture the MCM and GNSS UART traffic, dump prints it for bench/uart_replay. "
+                                                "MCM only from the boot, the GNSS sentences fill the 16 KB ring in about 2 minutes",
+                                                capture_callback,
+                                            },
+                                            {
+                                                "checksum",
+                                                CLI_APP_NAME" checksum <enter>",
+                                                "To time the crc16, xor8 and crc32 checksums over a 1 KB block",
+                                                checksum_callback,
+                                            },
 
                                             };
 
@@ -534,6 +620,37 @@ static int send_fw_update_request_callback(const char *pu8_input_value, cli_send
     return 1;
 }
 
+static int stats_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
+{
+    bool reset = (pu8_input_value != NULL) && (strcmp(pu8_input_value, "reset") == 0);
+    print_link_stats(reset);
+    return 1;
+}
+
+static int log_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
+{
+    print_trace_log();
+    return 1;
+}
+
+static int fuota_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
+{
+    print_fuota_status();
+    return 1;
+}
+
+static int capture_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
+{
+    run_capture_command(pu8_input_value);
+    return 1;
+}
+
+static int checksum_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
+{
+    print_checksum_timing();
+    return 1;
+}
+
 static int protocol_switch_callback(const char *pu8_input_value, cli_send_bytes_t pfun_uart_tx)
 {
     // Check if user supplied a mode string
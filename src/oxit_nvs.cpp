@@ -94,11 +94,13 @@
 #define JOIN_EUI_KEY "join_eui"
 #define APP_KEY_KEY "app_key"
 #define REBOOT_COUNT_KEY "reboot_count" 
+#define FW_PROGRESS_KEY "fw_progress"
 
 #define REBOOT_LOC 0
 #define DEVEUI_LOC 8
 #define JOIN_EUI_LOC 24
 #define APP_KEY_LOC 40
+#define FW_PROGRESS_LOC 56
 
 /******************************************************************************
  * PRIVATE TYPEDEFS
@@ -510,6 +512,163 @@ bool nvs_storage_set_app_key(uint8_t *app_key)
     return return_value;
 }
 
+bool nvs_storage_get_fw_progress(uint8_t *progress, uint16_t len)
+{
+    bool return_value = false;
+    if (len > FW_PROGRESS_MAX_LEN)
+    {
+        return false;
+    }
+#if USE_INTERNAL_FLASH
+    nvs_handle_t storage_handle;
+    esp_err_t err;
+
+    err = nvs_open(STORAGE_NAMESPACE, NVS_READONLY, &storage_handle);
+    do
+    {
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to open NVS");
+            break;
+        }
+        size_t required_size = len;
+        err = nvs_get_blob(storage_handle, FW_PROGRESS_KEY, progress, &required_size);
+        // no record is the normal case, nothing to report
+        if ((err != ESP_OK) || (required_size > len))
+        {
+            break;
+        }
+        return_value = true;
+    } while (0);
+
+    nvs_close(storage_handle);
+#else
+    if(false == is_nvs_init)
+    {
+        return false;
+    }
+    if (0 == myMem.read(FW_PROGRESS_LOC, progress, len))
+    {
+        if(is_all_ff(progress, len))
+        {
+            return_value = false;
+        }
+        else
+        {
+            return_value = true;
+        }
+    }
+    else
+    {
+        return_value = false;
+    }
+#endif
+    return return_value;
+}
+
+bool nvs_storage_set_fw_progress(const uint8_t *progress, uint16_t len)
+{
+    bool return_value = false;
+    if (len > FW_PROGRESS_MAX_LEN)
+    {
+        return false;
+    }
+#if USE_INTERNAL_FLASH
+    nvs_handle_t storage_handle;
+    esp_err_t err;
+    err = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &storage_handle);
+    do
+    {
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to open NVS");
+            break;
+        }
+        err = nvs_set_blob(storage_handle, FW_PROGRESS_KEY, progress, len);
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to write fw_progress");
+            break;
+        }
+
+        err = nvs_commit(storage_handle);
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to commit updated fw_progress");
+            break;
+        }
+        return_value = true;
+    } while (0);
+    nvs_close(storage_handle);
+#else
+    if(false == is_nvs_init)
+    {
+        return false;
+    }
+
+    if (0 == myMem.write(FW_PROGRESS_LOC, (uint8_t *)progress, len))
+    {
+        return_value = true;
+    }
+    else
+    {
+        return_value = false;
+    }
+#endif
+    return return_value;
+}
+
+bool nvs_storage_clear_fw_progress()
+{
+    bool return_value = false;
+#if USE_INTERNAL_FLASH
+    nvs_handle_t storage_handle;
+    esp_err_t err;
+    err = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &storage_handle);
+    do
+    {
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to open NVS");
+            break;
+        }
+        err = nvs_erase_key(storage_handle, FW_PROGRESS_KEY);
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND)
+        {
+            Serial.println("Failed to erase fw_progress");
+            break;
+        }
+
+        err = nvs_commit(storage_handle);
+        if (err != ESP_OK)
+        {
+            Serial.println("Failed to commit erased fw_progress");
+            break;
+        }
+        return_value = true;
+    } while (0);
+    nvs_close(storage_handle);
+#else
+    if(false == is_nvs_init)
+    {
+        return false;
+    }
+
+    // the header of the record is enough, a record without its magic is not used
+    uint8_t erased[FW_PROGRESS_HEADER_LEN];
+    memset(erased, 0xFF, sizeof(erased));
+    if (0 == myMem.write(FW_PROGRESS_LOC, erased, sizeof(erased)))
+    {
+        return_value = true;
+    }
+    else
+    {
+        return_value = false;
+    }
+#endif
+    return return_value;
+}
+
 bool nvs_storage_erase()
 {
 #if USE_INTERNAL_FLASH
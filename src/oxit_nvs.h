@@ -74,6 +74,8 @@ extern "C" {
 /**********************************************************************************************************
  * MACROS AND DEFINES
  **********************************************************************************************************/
+#define FW_PROGRESS_MAX_LEN 1600     // fw_resume_record_t, the sector crcs of a 1.5 MB image
+#define FW_PROGRESS_HEADER_LEN 16    // magic, version, size and committed bytes of the record
 
 /**********************************************************************************************************
  * TYPEDEFS
@@ -141,6 +143,33 @@ bool nvs_storage_set_join_eui(uint8_t *join_eui);
  */
 bool nvs_storage_set_dev_eui(uint8_t *dev_eui);
 
+/**
+ * @brief Retrieves the progress record of the firmware download from the NVS (Non-Volatile Storage) module.
+ *
+ * @param progress Pointer to the buffer to store the record.
+ * @param len Size of the buffer, at most FW_PROGRESS_MAX_LEN, the stored record can be shorter.
+ *
+ * @return true if a record which fits the buffer is stored, false otherwise.
+ */
+bool nvs_storage_get_fw_progress(uint8_t *progress, uint16_t len);
+
+/**
+ * @brief Stores the progress record of the firmware download in the NVS (Non-Volatile Storage) module.
+ *
+ * @param progress Pointer to the buffer containing the record.
+ * @param len Size of the record, at most FW_PROGRESS_MAX_LEN.
+ *
+ * @return true if the record is successfully stored, false otherwise.
+ */
+bool nvs_storage_set_fw_progress(const uint8_t *progress, uint16_t len);
+
+/**
+ * @brief Erases the progress record of the firmware download from the NVS (Non-Volatile Storage) module.
+ *
+ * @return true if no record is left, false otherwise.
+ */
+bool nvs_storage_clear_fw_progress();
+
 /**
  * @brief Erases all data stored in the NVS (Non-Volatile Storage) module.
  *
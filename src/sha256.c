@@ -0,0 +1,276 @@
+/**
+ * @file sha256.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Streaming SHA-256, on the SHA peripheral of the esp32 when there is one.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "sha256.h"
+#include <stddef.h>
+#include <string.h>
+#if SHA256_USE_HW
+#include "mbedtls/version.h"
+#endif
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#if SHA256_USE_HW
+// mbedtls 2 named the functions returning a status with _ret
+#if MBEDTLS_VERSION_MAJOR < 3
+#define SHA256_HW_STARTS    mbedtls_sha256_starts_ret
+#define SHA256_HW_UPDATE    mbedtls_sha256_update_ret
+#define SHA256_HW_FINISH    mbedtls_sha256_finish_ret
+#else
+#define SHA256_HW_STARTS    mbedtls_sha256_starts
+#define SHA256_HW_UPDATE    mbedtls_sha256_update
+#define SHA256_HW_FINISH    mbedtls_sha256_finish
+#endif
+#else
+#define SHA256_ROTR(x, n)   (((x) >> (n)) | ((x) << (32 - (n))))
+#endif
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+#if !SHA256_USE_HW
+static const uint32_t sha256_k[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2};
+#endif
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+#if !SHA256_USE_HW
+static void sha256_compress(uint32_t *p_state, const uint8_t *p_block);
+#endif
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+#if !SHA256_USE_HW
+/**
+ * @brief Hashes one 64 byte block into the state
+ */
+static void sha256_compress(uint32_t *p_state, const uint8_t *p_block)
+{
+    uint32_t w[64];
+    uint32_t a = p_state[0], b = p_state[1], c = p_state[2], d = p_state[3];
+    uint32_t e = p_state[4], f = p_state[5], g = p_state[6], h = p_state[7];
+
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)p_block[4 * i] << 24) | ((uint32_t)p_block[4 * i + 1] << 16) |
+               ((uint32_t)p_block[4 * i + 2] << 8) | (uint32_t)p_block[4 * i + 3];
+    }
+    for (uint8_t i = 16; i < 64; i++)
+    {
+        uint32_t s0 = SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        uint32_t s1 = SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25);
+        uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t s0 = SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22);
+        uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    p_state[0] += a;
+    p_state[1] += b;
+    p_state[2] += c;
+    p_state[3] += d;
+    p_state[4] += e;
+    p_state[5] += f;
+    p_state[6] += g;
+    p_state[7] += h;
+}
+#endif
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+#if SHA256_USE_HW
+
+void sha256_init(sha256_t *p_sha)
+{
+    mbedtls_sha256_init(&p_sha->h_ctx);
+    SHA256_HW_STARTS(&p_sha->h_ctx, 0);
+}
+
+void sha256_update(sha256_t *p_sha, const uint8_t *p_data, uint32_t u32_len)
+{
+    // mbedtls uses the peripheral, or software when another hash holds it
+    SHA256_HW_UPDATE(&p_sha->h_ctx, p_data, u32_len);
+}
+
+void sha256_final(sha256_t *p_sha, uint8_t *p_digest)
+{
+    SHA256_HW_FINISH(&p_sha->h_ctx, p_digest);
+    mbedtls_sha256_free(&p_sha->h_ctx);
+}
+
+#else
+
+void sha256_init(sha256_t *p_sha)
+{
+    static const uint32_t sha256_h0[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+    memcpy(p_sha->u32_state, sha256_h0, sizeof(sha256_h0));
+    p_sha->u64_len = 0;
+    p_sha->u8_used = 0;
+}
+
+void sha256_update(sha256_t *p_sha, const uint8_t *p_data, uint32_t u32_len)
+{
+    if (NULL == p_data)
+    {
+        return;
+    }
+    p_sha->u64_len += u32_len;
+
+    if (0 != p_sha->u8_used)
+    {
+        uint32_t u32_copy = SHA256_BLOCK_SIZE - p_sha->u8_used;
+        if (u32_copy > u32_len)
+        {
+            u32_copy = u32_len;
+        }
+        memcpy(&p_sha->u8_block[p_sha->u8_used], p_data, u32_copy);
+        p_sha->u8_used += (uint8_t)u32_copy;
+        p_data += u32_copy;
+        u32_len -= u32_copy;
+        if (SHA256_BLOCK_SIZE != p_sha->u8_used)
+        {
+            return;
+        }
+        sha256_compress(p_sha->u32_state, p_sha->u8_block);
+        p_sha->u8_used = 0;
+    }
+
+    // whole blocks are hashed from the data, without a copy
+    while (u32_len >= SHA256_BLOCK_SIZE)
+    {
+        sha256_compress(p_sha->u32_state, p_data);
+        p_data += SHA256_BLOCK_SIZE;
+        u32_len -= SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(p_sha->u8_block, p_data, u32_len);
+    p_sha->u8_used = (uint8_t)u32_len;
+}
+
+void sha256_final(sha256_t *p_sha, uint8_t *p_digest)
+{
+    uint64_t u64_bits = p_sha->u64_len * 8;
+
+    p_sha->u8_block[p_sha->u8_used++] = 0x80;
+    if (p_sha->u8_used > (SHA256_BLOCK_SIZE - 8))
+    {
+        memset(&p_sha->u8_block[p_sha->u8_used], 0, SHA256_BLOCK_SIZE - p_sha->u8_used);
+        sha256_compress(p_sha->u32_state, p_sha->u8_block);
+        p_sha->u8_used = 0;
+    }
+    memset(&p_sha->u8_block[p_sha->u8_used], 0, (SHA256_BLOCK_SIZE - 8) - p_sha->u8_used);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        p_sha->u8_block[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(u64_bits >> (8 * i));
+    }
+    sha256_compress(p_sha->u32_state, p_sha->u8_block);
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        p_digest[4 * i] = (uint8_t)(p_sha->u32_state[i] >> 24);
+        p_digest[4 * i + 1] = (uint8_t)(p_sha->u32_state[i] >> 16);
+        p_digest[4 * i + 2] = (uint8_t)(p_sha->u32_state[i] >> 8);
+        p_digest[4 * i + 3] = (uint8_t)p_sha->u32_state[i];
+    }
+}
+
+#endif // SHA256_USE_HW
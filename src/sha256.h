@@ -0,0 +1,152 @@
+/**
+ * @file sha256.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the streaming SHA-256, on the SHA peripheral of the esp32 when there is one.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __SHA256_H__
+#define __SHA256_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+
+/**
+ * @brief 1 to hash on the SHA peripheral through mbedtls, 0 for the portable code used on the host
+ */
+#ifndef SHA256_USE_HW
+#if defined(ARDUINO_ARCH_ESP32)
+#define SHA256_USE_HW 1
+#else
+#define SHA256_USE_HW 0
+#endif
+#endif
+
+#if SHA256_USE_HW
+#include "mbedtls/sha256.h"
+#endif
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define SHA256_DIGEST_SIZE      32
+#define SHA256_BLOCK_SIZE       64
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+/**
+ * @brief State of a running hash
+ * Private members need not to be accessed directly.
+ */
+typedef struct
+{
+#if SHA256_USE_HW
+    mbedtls_sha256_context h_ctx;
+#else
+    uint32_t u32_state[8];
+    uint64_t u64_len;                       // bytes hashed so far
+    uint8_t u8_block[SHA256_BLOCK_SIZE];    // partial block
+    uint8_t u8_used;                        // bytes in the partial block
+#endif
+} sha256_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Starts a new hash
+ *
+ * @param[out] p_sha Pointer to the hash state
+ */
+void sha256_init(sha256_t *p_sha);
+
+/**
+ * @brief Adds data to the hash, the data can be given in parts of any size
+ *
+ * @param[in,out] p_sha Pointer to the hash state
+ * @param[in] p_data Pointer to the next part of the data
+ * @param[in] u32_len Length of the next part of the data
+ */
+void sha256_update(sha256_t *p_sha, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Ends the hash, the state must be initialized again before it is reused
+ *
+ * @param[in,out] p_sha Pointer to the hash state
+ * @param[out] p_digest Buffer of SHA256_DIGEST_SIZE bytes for the digest
+ */
+void sha256_final(sha256_t *p_sha, uint8_t *p_digest);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __SHA256_H__
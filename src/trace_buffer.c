@@ -0,0 +1,272 @@
+/**
+ * @file trace_buffer.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Deferred binary trace, records are formatted only when the application is idle.
+ * @version 0.1
+ * @date 2024-04-11
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "trace_buffer.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#if (TRACE_BUFFER_WORDS & (TRACE_BUFFER_WORDS - 1)) != 0
+#error "TRACE_BUFFER_WORDS must be a power of 2"
+#endif
+
+#define TRACE_BUFFER_MASK                   (TRACE_BUFFER_WORDS - 1)
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+/**
+ * @brief Ring of records, each one is [format][timestamp][level | nargs << 8][args...]
+ *        head and tail are free running, only the reader moves the tail
+ */
+static uintptr_t trace_words[TRACE_BUFFER_WORDS];
+static uint32_t trace_head = 0;
+static uint32_t trace_tail = 0;
+static trace_buffer_stats_t trace_stats;
+
+static trace_buffer_tick_cb trace_tick_cb = NULL;
+static trace_buffer_lock_cb trace_lock_cb = NULL;
+static trace_buffer_lock_cb trace_unlock_cb = NULL;
+static trace_buffer_output_cb trace_output_cb = NULL;
+
+static const char *const trace_level_names[] = {"", "E", "W", "I", "D"};
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void trace_buffer_lock(void);
+static void trace_buffer_unlock(void);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void trace_buffer_lock(void)
+{
+    if (NULL != trace_lock_cb)
+    {
+        trace_lock_cb();
+    }
+}
+
+static void trace_buffer_unlock(void)
+{
+    if (NULL != trace_unlock_cb)
+    {
+        trace_unlock_cb();
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+void trace_buffer_set_platform_cb(trace_buffer_tick_cb tick_cb, trace_buffer_lock_cb lock_cb,
+                                  trace_buffer_lock_cb unlock_cb, trace_buffer_output_cb output_cb)
+{
+    trace_tick_cb = tick_cb;
+    trace_lock_cb = lock_cb;
+    trace_unlock_cb = unlock_cb;
+    trace_output_cb = output_cb;
+}
+
+void trace_buffer_write(uint8_t u8_level, const char *p_fmt, uint8_t u8_nargs,
+                        uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4)
+{
+    uint32_t u32_time = (NULL != trace_tick_cb) ? trace_tick_cb() : 0;
+    uint32_t u32_words = TRACE_BUFFER_HEADER_WORDS + u8_nargs;
+    uint32_t u32_pending;
+
+    trace_buffer_lock();
+    do
+    {
+        u32_pending = trace_head - trace_tail;
+        if ((u32_pending + u32_words) > TRACE_BUFFER_WORDS)
+        {
+            trace_stats.u32_dropped++;
+            break;
+        }
+
+        trace_words[trace_head & TRACE_BUFFER_MASK] = (uintptr_t)p_fmt;
+        trace_words[(trace_head + 1) & TRACE_BUFFER_MASK] = (uintptr_t)u32_time;
+        trace_words[(trace_head + 2) & TRACE_BUFFER_MASK] = (uintptr_t)(u8_level | (u8_nargs << 8));
+        // arguments after the count are not stored
+        switch (u8_nargs)
+        {
+        case 4:
+            trace_words[(trace_head + 6) & TRACE_BUFFER_MASK] = a4;
+            // fall through
+        case 3:
+            trace_words[(trace_head + 5) & TRACE_BUFFER_MASK] = a3;
+            // fall through
+        case 2:
+            trace_words[(trace_head + 4) & TRACE_BUFFER_MASK] = a2;
+            // fall through
+        case 1:
+            trace_words[(trace_head + 3) & TRACE_BUFFER_MASK] = a1;
+            break;
+        default:
+            break;
+        }
+        trace_head += u32_words;
+
+        trace_stats.u32_written++;
+        u32_pending += u32_words;
+        if (u32_pending > trace_stats.u16_max_pending_words)
+        {
+            trace_stats.u16_max_pending_words = (uint16_t)u32_pending;
+        }
+    } while (0);
+    trace_buffer_unlock();
+}
+
+uint16_t trace_buffer_flush(uint16_t u16_max_records)
+{
+    char line[TRACE_BUFFER_LINE_SIZE];
+    uint16_t u16_count = 0;
+
+    while (u16_count < u16_max_records)
+    {
+        const char *p_fmt;
+        uint32_t u32_time;
+        uint8_t u8_level;
+        uint8_t u8_nargs;
+        uintptr_t args[TRACE_BUFFER_MAX_ARGS] = {0};
+
+        // copy the record out, so the lock is not held while formatting
+        trace_buffer_lock();
+        if (trace_head == trace_tail)
+        {
+            trace_buffer_unlock();
+            break;
+        }
+        p_fmt = (const char *)trace_words[trace_tail & TRACE_BUFFER_MASK];
+        u32_time = (uint32_t)trace_words[(trace_tail + 1) & TRACE_BUFFER_MASK];
+        u8_level = (uint8_t)(trace_words[(trace_tail + 2) & TRACE_BUFFER_MASK] & 0xFF);
+        u8_nargs = (uint8_t)((trace_words[(trace_tail + 2) & TRACE_BUFFER_MASK] >> 8) & 0xFF);
+        for (uint8_t i = 0; (i < u8_nargs) && (i < TRACE_BUFFER_MAX_ARGS); i++)
+        {
+            args[i] = trace_words[(trace_tail + TRACE_BUFFER_HEADER_WORDS + i) & TRACE_BUFFER_MASK];
+        }
+        trace_tail += TRACE_BUFFER_HEADER_WORDS + u8_nargs;
+        trace_stats.u32_flushed++;
+        trace_buffer_unlock();
+
+        int prefix = snprintf(line, sizeof(line), "[%10lu] %s ", (unsigned long)u32_time,
+                              (u8_level <= TRACE_LEVEL_DEBUG) ? trace_level_names[u8_level] : "?");
+        if ((prefix > 0) && ((size_t)prefix < sizeof(line)))
+        {
+            // unused arguments are ignored by the format
+            snprintf(&line[prefix], sizeof(line) - prefix, p_fmt, args[0], args[1], args[2], args[3]);
+        }
+
+        if (NULL != trace_output_cb)
+        {
+            trace_output_cb(line);
+        }
+        else
+        {
+            fputs(line, stdout);
+        }
+        u16_count++;
+    }
+
+    return u16_count;
+}
+
+bool trace_buffer_is_pending(void)
+{
+    return (trace_head != trace_tail);
+}
+
+void trace_buffer_get_stats(trace_buffer_stats_t *p_stats, bool b_reset)
+{
+    if (NULL == p_stats)
+    {
+        return;
+    }
+
+    trace_buffer_lock();
+    *p_stats = trace_stats;
+    p_stats->u16_pending_words = (uint16_t)(trace_head - trace_tail);
+    if (b_reset)
+    {
+        trace_stats.u32_written = 0;
+        trace_stats.u32_dropped = 0;
+        trace_stats.u32_flushed = 0;
+        trace_stats.u16_max_pending_words = 0;
+    }
+    trace_buffer_unlock();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file trace_buffer.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the deferred binary trace of the mcm library.
+ * @version 0.1
+ * @date 2024-04-11
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __TRACE_BUFFER_H__
+#define __TRACE_BUFFER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+/**
+ * @brief set the value 
+ *  0 to disable the trace buffer and 1 to enable the trace buffer
+ *  can be overridden by the build flags, e.g. for the benchmarks
+ * 
+ */
+#ifndef ENABLE_TRACE_BUFFER
+#define ENABLE_TRACE_BUFFER                         1
+#endif
+
+/**
+ * @brief Trace levels, a site is compiled only when its level is not above the level of its module
+ */
+#define TRACE_LEVEL_NONE                            0
+#define TRACE_LEVEL_ERROR                           1
+#define TRACE_LEVEL_WARN                            2
+#define TRACE_LEVEL_INFO                            3
+#define TRACE_LEVEL_DEBUG                           4
+
+/**
+ * @brief Level of each module, can be overridden by the build flags
+ *        A module selects its level by defining TRACE_MODULE_LEVEL before using the trace macros
+ */
+#ifndef TRACE_LEVEL_FRAME_PARSER
+#define TRACE_LEVEL_FRAME_PARSER                    TRACE_LEVEL_INFO
+#endif
+
+#ifndef TRACE_LEVEL_API_PROCESSOR
+#define TRACE_LEVEL_API_PROCESSOR                   TRACE_LEVEL_INFO
+#endif
+
+#ifndef TRACE_LEVEL_MCM
+#define TRACE_LEVEL_MCM                             TRACE_LEVEL_INFO
+#endif
+
+#if ENABLE_TRACE_BUFFER
+#define TRACE_LEVEL_MAX                             TRACE_LEVEL_DEBUG
+#else
+#define TRACE_LEVEL_MAX                             TRACE_LEVEL_NONE
+#endif
+
+/**
+ * @brief Size of the ring buffer in words, a record takes TRACE_BUFFER_HEADER_WORDS plus one word per argument
+ */
+#ifndef TRACE_BUFFER_WORDS
+#define TRACE_BUFFER_WORDS                          512
+#endif
+
+#define TRACE_BUFFER_HEADER_WORDS                   3
+#define TRACE_BUFFER_MAX_ARGS                       4
+
+/**
+ * @brief Maximum length of a formatted record, longer lines are truncated
+ */
+#define TRACE_BUFFER_LINE_SIZE                      128
+
+/**
+ * @brief Counts the arguments after the format string, 0 to TRACE_BUFFER_MAX_ARGS
+ */
+#define TRACE_NARGS_(fmt, a1, a2, a3, a4, n, ...)   n
+#define TRACE_NARGS(...)                            TRACE_NARGS_(__VA_ARGS__, 4, 3, 2, 1, 0, _)
+#define TRACE_CAT_(a, b)                            a##b
+#define TRACE_CAT(a, b)                             TRACE_CAT_(a, b)
+
+#define TRACE_WRITE_0(level, fmt)                   trace_buffer_write((level), (fmt), 0, 0, 0, 0, 0)
+#define TRACE_WRITE_1(level, fmt, a1)               trace_buffer_write((level), (fmt), 1, (uintptr_t)(a1), 0, 0, 0)
+#define TRACE_WRITE_2(level, fmt, a1, a2)           trace_buffer_write((level), (fmt), 2, (uintptr_t)(a1), (uintptr_t)(a2), 0, 0)
+#define TRACE_WRITE_3(level, fmt, a1, a2, a3)       trace_buffer_write((level), (fmt), 3, (uintptr_t)(a1), (uintptr_t)(a2), (uintptr_t)(a3), 0)
+#define TRACE_WRITE_4(level, fmt, a1, a2, a3, a4)   trace_buffer_write((level), (fmt), 4, (uintptr_t)(a1), (uintptr_t)(a2), (uintptr_t)(a3), (uintptr_t)(a4))
+
+/**
+ * @brief Writes a trace record, the format is only stored and formatted by trace_buffer_flush()
+ *
+ * The format must be a string literal, the arguments are integers or pointers
+ * to strings in static storage, at most TRACE_BUFFER_MAX_ARGS of them.
+ * Sites above the level of the module or of the build are removed by the compiler.
+ */
+#define TRACE_LOG(module_level, level, ...)         do                                                                  \
+                                                    {                                                                   \
+                                                        if (((level) <= (module_level)) && ((level) <= TRACE_LEVEL_MAX)) \
+                                                        {                                                               \
+                                                            TRACE_CAT(TRACE_WRITE_, TRACE_NARGS(__VA_ARGS__))((level), __VA_ARGS__); \
+                                                        }                                                               \
+                                                    } while (0)
+
+#define TRACE_ERROR(...)                            TRACE_LOG(TRACE_MODULE_LEVEL, TRACE_LEVEL_ERROR, __VA_ARGS__)
+#define TRACE_WARN(...)                             TRACE_LOG(TRACE_MODULE_LEVEL, TRACE_LEVEL_WARN, __VA_ARGS__)
+#define TRACE_INFO(...)                             TRACE_LOG(TRACE_MODULE_LEVEL, TRACE_LEVEL_INFO, __VA_ARGS__)
+#define TRACE_DEBUG(...)                            TRACE_LOG(TRACE_MODULE_LEVEL, TRACE_LEVEL_DEBUG, __VA_ARGS__)
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+/**
+ * @brief Returns the timestamp of a record, e.g. microseconds since boot
+ */
+typedef uint32_t (*trace_buffer_tick_cb)(void);
+
+/**
+ * @brief Lock and unlock of the ring buffer, needed when records are written from more than one task
+ *        Kept short, a record is copied under the lock
+ */
+typedef void (*trace_buffer_lock_cb)(void);
+
+/**
+ * @brief Receives a formatted record, a null terminated line
+ */
+typedef void (*trace_buffer_output_cb)(const char *p_line);
+
+/**
+ * @brief Counters of the trace buffer
+ */
+typedef struct
+{
+    uint32_t u32_written;                               // records written
+    uint32_t u32_dropped;                               // records dropped as the buffer was full
+    uint32_t u32_flushed;                               // records formatted
+    uint16_t u16_pending_words;                         // words waiting to be formatted
+    uint16_t u16_max_pending_words;                     // high water mark of the pending words
+} trace_buffer_stats_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Sets the platform callbacks, records already in the buffer are kept
+ *
+ * Any callback can be NULL: no timestamp, no locking, and printf as the output.
+ *
+ * @param[in] tick_cb Timestamp of the records
+ * @param[in] lock_cb Locks the ring buffer
+ * @param[in] unlock_cb Unlocks the ring buffer
+ * @param[in] output_cb Receives the formatted records
+ */
+void trace_buffer_set_platform_cb(trace_buffer_tick_cb tick_cb, trace_buffer_lock_cb lock_cb,
+                                  trace_buffer_lock_cb unlock_cb, trace_buffer_output_cb output_cb);
+
+/**
+ * @brief Writes a record, use the TRACE_ macros instead
+ *
+ * The record is dropped when the buffer is full, so a burst never blocks the caller.
+ *
+ * @param[in] u8_level Level of the record
+ * @param[in] p_fmt Format string, must outlive the record
+ * @param[in] u8_nargs Number of valid arguments
+ * @param[in] a1 First argument
+ * @param[in] a2 Second argument
+ * @param[in] a3 Third argument
+ * @param[in] a4 Fourth argument
+ */
+void trace_buffer_write(uint8_t u8_level, const char *p_fmt, uint8_t u8_nargs,
+                        uintptr_t a1, uintptr_t a2, uintptr_t a3, uintptr_t a4);
+
+/**
+ * @brief Formats the oldest records and passes them to the output callback
+ *
+ * @param[in] u16_max_records Maximum number of records to format
+ * @return Number of records formatted
+ */
+uint16_t trace_buffer_flush(uint16_t u16_max_records);
+
+/**
+ * @brief Tells if there are records waiting to be formatted
+ *
+ * @return true if the buffer is not empty
+ */
+bool trace_buffer_is_pending(void);
+
+/**
+ * @brief Reads the counters of the trace buffer
+ *
+ * @param[out] p_stats Pointer to the counters
+ * @param[in] b_reset Clears the counters after reading
+ */
+void trace_buffer_get_stats(trace_buffer_stats_t *p_stats, bool b_reset);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __TRACE_BUFFER_H__
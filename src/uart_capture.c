@@ -0,0 +1,421 @@
+/**
+ * @file uart_capture.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Capture of the raw uart bytes in a ring of timestamped records, the latest traffic is kept.
+ * @version 0.1
+ * @date 2024-12-13
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "uart_capture.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#if (UART_CAPTURE_BUFFER_SIZE & (UART_CAPTURE_BUFFER_SIZE - 1)) != 0
+#error "UART_CAPTURE_BUFFER_SIZE must be a power of 2"
+#endif
+
+#define UART_CAPTURE_MASK                   (UART_CAPTURE_BUFFER_SIZE - 1)
+#define UART_CAPTURE_MAX_DELTA_BYTES        5       // LEB128 of a 32 bit value
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+/**
+ * @brief Ring of records, head and tail are free running
+ *        The time of the tail is the one the delta of the oldest record is added to,
+ *        it moves with the tail when the oldest record is overwritten
+ */
+static uint8_t capture_ring[UART_CAPTURE_BUFFER_SIZE];
+static uint32_t capture_head = 0;
+static uint32_t capture_tail = 0;
+static uint32_t capture_head_time_us = 0;          // time of the newest record
+static uint32_t capture_tail_time_us = 0;
+static uint8_t capture_mask = 0;
+static uart_capture_stats_t capture_stats;
+
+static uart_capture_tick_cb capture_tick_cb = NULL;
+static uart_capture_lock_cb capture_lock_cb = NULL;
+static uart_capture_lock_cb capture_unlock_cb = NULL;
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void uart_capture_lock(void);
+static void uart_capture_unlock(void);
+static void uart_capture_put(uint8_t u8_data);
+static uint8_t uart_capture_encode_delta(uint32_t u32_delta_us, uint8_t *p_out);
+static void uart_capture_drop_oldest(void);
+static void uart_capture_write_file_header(uint8_t *p_header);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+static void uart_capture_lock(void)
+{
+    if (NULL != capture_lock_cb)
+    {
+        capture_lock_cb();
+    }
+}
+
+static void uart_capture_unlock(void)
+{
+    if (NULL != capture_unlock_cb)
+    {
+        capture_unlock_cb();
+    }
+}
+
+static void uart_capture_put(uint8_t u8_data)
+{
+    capture_ring[capture_head & UART_CAPTURE_MASK] = u8_data;
+    capture_head++;
+}
+
+static uint8_t uart_capture_encode_delta(uint32_t u32_delta_us, uint8_t *p_out)
+{
+    uint8_t u8_len = 0;
+
+    // seven bits per byte, the high bit tells that more bytes follow
+    do
+    {
+        uint8_t u8_byte = (uint8_t)(u32_delta_us & 0x7F);
+        u32_delta_us >>= 7;
+        p_out[u8_len++] = (0 != u32_delta_us) ? (u8_byte | 0x80) : u8_byte;
+    } while (0 != u32_delta_us);
+
+    return u8_len;
+}
+
+/**
+ * @brief Frees the oldest record, its time becomes the time of the tail
+ */
+static void uart_capture_drop_oldest(void)
+{
+    uint32_t u32_pos = capture_tail + 1;
+    uint32_t u32_delta_us = 0;
+    uint8_t u8_shift = 0;
+    uint8_t u8_byte;
+
+    do
+    {
+        u8_byte = capture_ring[u32_pos & UART_CAPTURE_MASK];
+        u32_delta_us |= (uint32_t)(u8_byte & 0x7F) << u8_shift;
+        u8_shift += 7;
+        u32_pos++;
+    } while (u8_byte & 0x80);
+
+    uint8_t u8_len = capture_ring[u32_pos & UART_CAPTURE_MASK];
+    capture_tail = u32_pos + 1 + u8_len;
+    capture_tail_time_us += u32_delta_us;
+    capture_stats.u32_overwritten++;
+}
+
+static void uart_capture_write_file_header(uint8_t *p_header)
+{
+    uint32_t u32_data_size = capture_head - capture_tail;
+
+    memcpy(&p_header[0], UART_CAPTURE_FILE_MAGIC, 4);
+    p_header[4] = UART_CAPTURE_FILE_VERSION;
+    p_header[5] = 0;
+    p_header[6] = (uint8_t)(UART_CAPTURE_FILE_HEADER_SIZE & 0xFF);
+    p_header[7] = (uint8_t)(UART_CAPTURE_FILE_HEADER_SIZE >> 8);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        p_header[8 + i] = (uint8_t)(capture_tail_time_us >> (8 * i));
+        p_header[12 + i] = (uint8_t)(capture_stats.u32_overwritten >> (8 * i));
+        p_header[16 + i] = (uint8_t)(u32_data_size >> (8 * i));
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+void uart_capture_set_platform_cb(uart_capture_tick_cb tick_cb, uart_capture_lock_cb lock_cb,
+                                  uart_capture_lock_cb unlock_cb)
+{
+    capture_tick_cb = tick_cb;
+    capture_lock_cb = lock_cb;
+    capture_unlock_cb = unlock_cb;
+}
+
+void uart_capture_start(uint8_t u8_mask)
+{
+    capture_mask = u8_mask & UART_CAPTURE_MASK_ALL;
+}
+
+uint8_t uart_capture_get_mask(void)
+{
+    return capture_mask;
+}
+
+void uart_capture_clear(void)
+{
+    uart_capture_lock();
+    capture_tail = capture_head;
+    memset(&capture_stats, 0, sizeof(capture_stats));
+    uart_capture_unlock();
+}
+
+void uart_capture_write(uint8_t u8_port, uint8_t u8_stream, const uint8_t *p_data, uint32_t u32_len)
+{
+    // checked without the lock, a stream is started or stopped from the cli only
+    if ((u8_port >= UART_CAPTURE_MAX_PORTS) || (u8_stream >= UART_CAPTURE_STREAM_COUNT) || (0 == (capture_mask & (1 << u8_stream))) ||
+        (NULL == p_data) || (0 == u32_len))
+    {
+        return;
+    }
+
+    uint32_t u32_time_us = (NULL != capture_tick_cb) ? capture_tick_cb() : 0;
+
+    uart_capture_lock();
+    if (capture_head == capture_tail)
+    {
+        // an empty ring starts at the time of its first record
+        capture_head_time_us = u32_time_us;
+        capture_tail_time_us = u32_time_us;
+    }
+    capture_stats.u32_bytes[u8_stream] += u32_len;
+
+    while (u32_len > 0)
+    {
+        uint8_t u8_header[UART_CAPTURE_MAX_RECORD_HEADER];
+        uint8_t u8_part = (u32_len > UART_CAPTURE_MAX_RECORD_DATA) ? UART_CAPTURE_MAX_RECORD_DATA : (uint8_t)u32_len;
+        uint8_t u8_header_len = 0;
+
+        // parts of a long write follow the first one with a delta of 0
+        u8_header[u8_header_len++] = (uint8_t)((u8_port << 4) | u8_stream);
+        u8_header_len += uart_capture_encode_delta(u32_time_us - capture_head_time_us, &u8_header[u8_header_len]);
+        u8_header[u8_header_len++] = u8_part;
+        capture_head_time_us = u32_time_us;
+
+        uint32_t u32_record_size = u8_header_len + u8_part;
+        while ((capture_head - capture_tail + u32_record_size) > UART_CAPTURE_BUFFER_SIZE)
+        {
+            uart_capture_drop_oldest();
+        }
+
+        for (uint8_t i = 0; i < u8_header_len; i++)
+        {
+            uart_capture_put(u8_header[i]);
+        }
+        // data is copied in at most two runs, before and after the end of the ring
+        uint32_t u32_pos = capture_head & UART_CAPTURE_MASK;
+        uint32_t u32_first = UART_CAPTURE_BUFFER_SIZE - u32_pos;
+        if (u32_first > u8_part)
+        {
+            u32_first = u8_part;
+        }
+        memcpy(&capture_ring[u32_pos], p_data, u32_first);
+        memcpy(&capture_ring[0], &p_data[u32_first], u8_part - u32_first);
+        capture_head += u8_part;
+
+        capture_stats.u32_records++;
+        p_data += u8_part;
+        u32_len -= u8_part;
+    }
+    uart_capture_unlock();
+}
+
+uint32_t uart_capture_get_file_size(void)
+{
+    uart_capture_lock();
+    uint32_t u32_size = UART_CAPTURE_FILE_HEADER_SIZE + (capture_head - capture_tail);
+    uart_capture_unlock();
+
+    return u32_size;
+}
+
+uint32_t uart_capture_read_file(uint32_t u32_offset, uint8_t *p_buf, uint32_t u32_size)
+{
+    uint32_t u32_read = 0;
+
+    if (NULL == p_buf)
+    {
+        return 0;
+    }
+
+    uart_capture_lock();
+    uint32_t u32_file_size = UART_CAPTURE_FILE_HEADER_SIZE + (capture_head - capture_tail);
+    if (u32_offset < UART_CAPTURE_FILE_HEADER_SIZE)
+    {
+        uint8_t u8_header[UART_CAPTURE_FILE_HEADER_SIZE];
+        uart_capture_write_file_header(u8_header);
+        while ((u32_offset < UART_CAPTURE_FILE_HEADER_SIZE) && (u32_read < u32_size))
+        {
+            p_buf[u32_read++] = u8_header[u32_offset++];
+        }
+    }
+    while ((u32_offset < u32_file_size) && (u32_read < u32_size))
+    {
+        p_buf[u32_read++] = capture_ring[(capture_tail + u32_offset - UART_CAPTURE_FILE_HEADER_SIZE) & UART_CAPTURE_MASK];
+        u32_offset++;
+    }
+    uart_capture_unlock();
+
+    return u32_read;
+}
+
+bool uart_capture_parse_header(const uint8_t *p_file, uint32_t u32_size, uart_capture_header_t *p_header)
+{
+    bool b_return = false;
+
+    do
+    {
+        if ((NULL == p_file) || (NULL == p_header) || (u32_size < UART_CAPTURE_FILE_HEADER_SIZE))
+        {
+            break;
+        }
+        if ((0 != memcmp(p_file, UART_CAPTURE_FILE_MAGIC, 4)) || (0 == p_file[4]) ||
+            (UART_CAPTURE_FILE_VERSION < p_file[4]))
+        {
+            break;
+        }
+
+        p_header->u8_version = p_file[4];
+        p_header->u16_header_size = (uint16_t)(p_file[6] | (p_file[7] << 8));
+        p_header->u32_start_us = 0;
+        p_header->u32_overwritten = 0;
+        p_header->u32_data_size = 0;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            p_header->u32_start_us |= (uint32_t)p_file[8 + i] << (8 * i);
+            p_header->u32_overwritten |= (uint32_t)p_file[12 + i] << (8 * i);
+            p_header->u32_data_size |= (uint32_t)p_file[16 + i] << (8 * i);
+        }
+
+        // a later version may have a longer header, the records follow it
+        if ((p_header->u16_header_size < UART_CAPTURE_FILE_HEADER_SIZE) || (p_header->u16_header_size > u32_size) ||
+            (p_header->u32_data_size > (u32_size - p_header->u16_header_size)))
+        {
+            break;
+        }
+        b_return = true;
+    } while (0);
+
+    return b_return;
+}
+
+bool uart_capture_next_record(const uint8_t *p_data, uint32_t u32_size, uint32_t *p_offset,
+                              uart_capture_record_t *p_record)
+{
+    bool b_return = false;
+
+    do
+    {
+        if ((NULL == p_data) || (NULL == p_offset) || (NULL == p_record) || (*p_offset >= u32_size))
+        {
+            break;
+        }
+
+        uint32_t u32_pos = *p_offset;
+        p_record->u8_port = p_data[u32_pos] >> 4;
+        p_record->u8_stream = p_data[u32_pos++] & 0x0F;
+        p_record->u32_delta_us = 0;
+
+        uint8_t u8_byte = 0x80;
+        for (uint8_t i = 0; (i < UART_CAPTURE_MAX_DELTA_BYTES) && (u8_byte & 0x80) && (u32_pos < u32_size); i++)
+        {
+            u8_byte = p_data[u32_pos++];
+            p_record->u32_delta_us |= (uint32_t)(u8_byte & 0x7F) << (7 * i);
+        }
+        if ((u8_byte & 0x80) || (u32_pos >= u32_size))
+        {
+            break;
+        }
+
+        p_record->u16_len = p_data[u32_pos++];
+        if ((0 == p_record->u16_len) || (p_record->u16_len > (u32_size - u32_pos)))
+        {
+            break;
+        }
+        p_record->p_data = &p_data[u32_pos];
+        *p_offset = u32_pos + p_record->u16_len;
+        b_return = true;
+    } while (0);
+
+    return b_return;
+}
+
+void uart_capture_get_stats(uart_capture_stats_t *p_stats)
+{
+    if (NULL == p_stats)
+    {
+        return;
+    }
+
+    uart_capture_lock();
+    *p_stats = capture_stats;
+    p_stats->u32_used = capture_head - capture_tail;
+    uart_capture_unlock();
+}
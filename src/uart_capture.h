@@ -0,0 +1,311 @@
+/**
+ * @file uart_capture.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the capture of the raw bytes of the mcm and gnss uarts.
+ * @version 0.1
+ * @date 2024-12-13
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __UART_CAPTURE_H__
+#define __UART_CAPTURE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+/**
+ * @brief set the value 
+ *  0 to remove the capture sites from the build and 1 to keep them
+ *  can be overridden by the build flags
+ * 
+ */
+#ifndef ENABLE_UART_CAPTURE
+#define ENABLE_UART_CAPTURE                         1
+#endif
+
+/**
+ * @brief Size of the ring buffer in bytes, the oldest records are overwritten when it is full
+ */
+#ifndef UART_CAPTURE_BUFFER_SIZE
+#define UART_CAPTURE_BUFFER_SIZE                    16384
+#endif
+
+/**
+ * @brief Bits of uart_capture_start(), one per stream
+ */
+#define UART_CAPTURE_MASK_MCM                       ((1 << UART_CAPTURE_MCM_RX) | (1 << UART_CAPTURE_MCM_TX))
+#define UART_CAPTURE_MASK_GNSS                      ((1 << UART_CAPTURE_GNSS_RX) | (1 << UART_CAPTURE_GNSS_TX))
+#define UART_CAPTURE_MASK_ALL                       (UART_CAPTURE_MASK_MCM | UART_CAPTURE_MASK_GNSS)
+
+/**
+ * @brief Capture file, the header then the records from the oldest one
+ *
+ *  header, little endian
+ *      [0]  "OXCP"
+ *      [4]  version, UART_CAPTURE_FILE_VERSION
+ *      [5]  reserved
+ *      [6]  header size
+ *      [8]  time in microseconds the delta of the first record is added to
+ *      [12] records overwritten before the capture was read
+ *      [16] size of the records
+ *  record
+ *      [0]  port in the high 4 bits, stream in the low 4 bits, uart_capture_stream_t
+ *      [1]  microseconds since the previous record, LEB128, 1 to 5 bytes
+ *      [n]  length of the data, 1 to UART_CAPTURE_MAX_RECORD_DATA
+ *      [n+1] data
+ */
+#define UART_CAPTURE_FILE_MAGIC                     "OXCP"
+#define UART_CAPTURE_FILE_VERSION                   2       // version 1 records have no port, they read as port 0
+#define UART_CAPTURE_FILE_HEADER_SIZE               20
+#define UART_CAPTURE_MAX_RECORD_DATA                255     // longer writes are split, the parts have a delta of 0
+#define UART_CAPTURE_MAX_RECORD_HEADER              7       // port and stream, delta and length
+#define UART_CAPTURE_MAX_PORTS                      16      // several modems interleave into the one ring
+#define UART_CAPTURE_GNSS_PORT                      0       // one gnss module, its own streams tell it apart
+
+/**
+ * @brief Capture file printed on the console, a line with its size, lines of hex bytes,
+ *        then a line with the CRC-16/XMODEM of the file, see checksum_crc16_update()
+ */
+#define UART_CAPTURE_DUMP_BEGIN                     "UART CAPTURE BEGIN"
+#define UART_CAPTURE_DUMP_LINE                      "CAP "
+#define UART_CAPTURE_DUMP_END                       "UART CAPTURE END"
+#define UART_CAPTURE_DUMP_LINE_BYTES                32
+
+/**
+ * @brief Capture site, removed by the compiler when ENABLE_UART_CAPTURE is 0
+ */
+#if ENABLE_UART_CAPTURE
+#define UART_CAPTURE(port, stream, p_data, len)     uart_capture_write((port), (stream), (const uint8_t *)(p_data), (uint32_t)(len))
+#else
+#define UART_CAPTURE(port, stream, p_data, len)     do { } while (0)
+#endif
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+/**
+ * @brief Captured streams, the bytes of each direction of each uart
+ */
+typedef enum
+{
+    UART_CAPTURE_MCM_RX = 0,                            // from the mcm, before the frame reassembler
+    UART_CAPTURE_MCM_TX,                                // to the mcm, the frames of the send callbacks
+    UART_CAPTURE_GNSS_RX,                               // nmea sentences and command responses
+    UART_CAPTURE_GNSS_TX,                               // commands to the gnss module
+    UART_CAPTURE_STREAM_COUNT
+} uart_capture_stream_t;
+
+/**
+ * @brief Returns the timestamp of a record in microseconds, e.g. micros()
+ */
+typedef uint32_t (*uart_capture_tick_cb)(void);
+
+/**
+ * @brief Lock and unlock of the ring buffer, needed when the streams are written from more than one task
+ */
+typedef void (*uart_capture_lock_cb)(void);
+
+/**
+ * @brief Header of a capture file
+ */
+typedef struct
+{
+    uint8_t u8_version;
+    uint16_t u16_header_size;
+    uint32_t u32_start_us;
+    uint32_t u32_overwritten;
+    uint32_t u32_data_size;
+} uart_capture_header_t;
+
+/**
+ * @brief Record read from a capture file, the data points into the file
+ */
+typedef struct
+{
+    uint8_t u8_port;                                    // modem or module the bytes belong to
+    uint8_t u8_stream;                                  // uart_capture_stream_t
+    uint32_t u32_delta_us;                              // since the previous record
+    uint16_t u16_len;
+    const uint8_t *p_data;
+} uart_capture_record_t;
+
+/**
+ * @brief Counters of the capture
+ */
+typedef struct
+{
+    uint32_t u32_records;                               // records written
+    uint32_t u32_overwritten;                           // oldest records overwritten by new ones
+    uint32_t u32_bytes[UART_CAPTURE_STREAM_COUNT];      // data bytes captured per stream
+    uint32_t u32_used;                                  // bytes of the ring in use
+} uart_capture_stats_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Sets the platform callbacks
+ *
+ * Any callback can be NULL: every record has the time 0, no locking.
+ *
+ * @param[in] tick_cb Timestamp of the records
+ * @param[in] lock_cb Locks the ring buffer
+ * @param[in] unlock_cb Unlocks the ring buffer
+ */
+void uart_capture_set_platform_cb(uart_capture_tick_cb tick_cb, uart_capture_lock_cb lock_cb,
+                                  uart_capture_lock_cb unlock_cb);
+
+/**
+ * @brief Starts the capture of the given streams, the records already in the ring are kept
+ *
+ * @param[in] u8_mask UART_CAPTURE_MASK_ bits, 0 stops the capture
+ */
+void uart_capture_start(uint8_t u8_mask);
+
+/**
+ * @brief Tells which streams are captured
+ *
+ * @return UART_CAPTURE_MASK_ bits
+ */
+uint8_t uart_capture_get_mask(void);
+
+/**
+ * @brief Empties the ring and clears the counters
+ */
+void uart_capture_clear(void);
+
+/**
+ * @brief Adds the bytes of a stream to the ring, use UART_CAPTURE() instead
+ *
+ * Nothing is written when the stream is not captured. The oldest records are
+ * overwritten to make room, so the ring keeps the latest traffic.
+ *
+ * @param[in] u8_port Port of the bytes, 0 to UART_CAPTURE_MAX_PORTS - 1, e.g. the mcm instance
+ * @param[in] u8_stream Stream of the bytes, uart_capture_stream_t
+ * @param[in] p_data Bytes sent or received
+ * @param[in] u32_len Number of bytes
+ */
+void uart_capture_write(uint8_t u8_port, uint8_t u8_stream, const uint8_t *p_data, uint32_t u32_len);
+
+/**
+ * @brief Size of the capture file of the records in the ring
+ *
+ * Stop the capture while the file is read, new records would overwrite the ones being read.
+ *
+ * @return Size of the header and the records in bytes
+ */
+uint32_t uart_capture_get_file_size(void);
+
+/**
+ * @brief Reads a part of the capture file of the records in the ring
+ *
+ * @param[in] u32_offset Offset in the file
+ * @param[out] p_buf Buffer for the part
+ * @param[in] u32_size Size of the buffer
+ * @return Bytes read, 0 at the end of the file
+ */
+uint32_t uart_capture_read_file(uint32_t u32_offset, uint8_t *p_buf, uint32_t u32_size);
+
+/**
+ * @brief Reads the header of a capture file
+ *
+ * @param[in] p_file Start of the file
+ * @param[in] u32_size Size of the file
+ * @param[out] p_header Header of the file
+ * @return true if the file is a capture file of a known version, all its records present
+ */
+bool uart_capture_parse_header(const uint8_t *p_file, uint32_t u32_size, uart_capture_header_t *p_header);
+
+/**
+ * @brief Reads the next record of the records of a capture file
+ *
+ * @param[in] p_data Start of the records, after the header
+ * @param[in] u32_size Size of the records
+ * @param[in,out] p_offset Offset of the record to read, moved past it
+ * @param[out] p_record The record
+ * @return true if a record was read, false at the end or on a truncated record
+ */
+bool uart_capture_next_record(const uint8_t *p_data, uint32_t u32_size, uint32_t *p_offset,
+                              uart_capture_record_t *p_record);
+
+/**
+ * @brief Reads the counters of the capture
+ *
+ * @param[out] p_stats Pointer to the counters
+ */
+void uart_capture_get_stats(uart_capture_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __UART_CAPTURE_H__
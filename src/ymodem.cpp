@@ -15,6 +15,8 @@
  ******************************************************************************/
 
 #include "ymodem.h"
+#include "checksum.h"
+#include "uart_capture.h"
 #include <SPIFFS.h>
 #include <Update.h>
 
@@ -25,7 +27,7 @@
 /******************************************************************************
  * PRIVATE MACROS AND DEFINES
  ******************************************************************************/
-#define FUOTA_FILE_NAME "/fota.bin"
+#define YMODEM_PATCH_READ_SIZE 256 // bytes of a staged patch decoded at a time
 /******************************************************************************
  * PRIVATE TYPEDEFS
  ******************************************************************************/
@@ -33,8 +35,10 @@
 /******************************************************************************
  * STATIC VARIABLES
  ******************************************************************************/
-uint8_t ymodem_buffer[1030] = {0};
-uint16_t ymodem_buffer_size = 0;
+// indexed by ymodem_state_t
+static const char *const ymodem_state_names[] = {"Idle", "Header", "Chunk", "Data", "Wait EOT", "Update", "End of batch"};
+static_assert(sizeof(ymodem_state_names) / sizeof(ymodem_state_names[0]) == COMPLETE + 1, "name every ymodem state");
+
 /******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
@@ -46,10 +50,53 @@ uint16_t ymodem_buffer_size = 0;
 /******************************************************************************
  * STATIC FUNCTIONS
  ******************************************************************************/
+static void on_ymodem_rx_event(ymodem_rx_event_t event, uint8_t block, const uint8_t *data, uint16_t len, void *ctx)
+{
+    YModem *curr_instance = (YModem *)ctx;
+    curr_instance->handleRxEvent(event, block, data, len);
+}
+
+static bool on_patch_read(uint32_t offset, uint8_t *data, uint32_t len, void *ctx)
+{
+    return ((YModem *)ctx)->readRunning(offset, data, len);
+}
+
+static bool on_patch_output(const uint8_t *data, uint32_t len, void *ctx)
+{
+    return ((YModem *)ctx)->writeDecoded(data, len);
+}
+
+static bool on_patch_update(const uint8_t *data, uint32_t len, void *ctx)
+{
+    return Update.write((uint8_t *)data, len) == len;
+}
+
+size_t YModem::copyPatch(File &file)
+{
+    uint8_t chunk[YMODEM_PATCH_READ_SIZE];
+    size_t len;
+    fw_patch_status_t status = fw_patch_init(&this->_patch, on_patch_read, on_patch_update, this);
+
+    while ((FW_PATCH_SUCCESS == status) && ((len = file.read(chunk, sizeof(chunk))) > 0))
+    {
+        status = fw_patch_feed(&this->_patch, chunk, len);
+    }
+    if (FW_PATCH_SUCCESS == status)
+    {
+        status = fw_patch_finish(&this->_patch);
+    }
+    if (FW_PATCH_SUCCESS != status)
+    {
+        Serial.printf("[YMODEM FW] ERR: Patch decoding failed (%d).\n", status);
+        return 0;
+    }
+    return fw_patch_get_image_size(&this->_patch);
+}
+
 bool YModem::update_esp32_firmware()
 {
     Serial.printf("[YMODEM FW] Opening firmware file...\n");
-    File file = SPIFFS.open(FUOTA_FILE_NAME, "r");
+    File file = SPIFFS.open(this->_file_name, "r");
 
     if (!file)
     {
@@ -60,6 +107,18 @@ bool YModem::update_esp32_firmware()
     size_t fileSize = file.size();
     Serial.printf("[YMODEM FW] File Size: %d bytes\n", fileSize);
 
+    // a patch is decoded while it is copied, the update gets the decoded image
+    uint8_t first[FW_PATCH_HEADER_SIZE];
+    fw_patch_header_t header;
+    bool is_patch = (file.read(first, sizeof(first)) == sizeof(first)) &&
+                    fw_patch_read_header(first, sizeof(first), &header);
+    file.seek(0);
+    if (is_patch)
+    {
+        fileSize = header.u32_image_size;
+        Serial.printf("[YMODEM FW] Patch decodes to %d bytes\n", fileSize);
+    }
+
     Serial.printf("[YMODEM FW] Starting OTA update...\n");
     if (!Update.begin(fileSize))
     {
@@ -69,7 +128,7 @@ bool YModem::update_esp32_firmware()
     }
 
     Serial.printf("[YMODEM FW] Writing firmware (%d bytes)...\n", fileSize);
-    size_t written = Update.writeStream(file);
+    size_t written = is_patch ? copyPatch(file) : Update.writeStream(file);
 
     if (written != fileSize)
     {
@@ -94,19 +153,161 @@ bool YModem::update_esp32_firmware()
         return false;
     }
 
-    Serial.printf("[YMODEM FW] Update successful. Rebooting in 5s...\n");
-    delay(5000);
-    ESP.restart();
-
-    // Clean up the firmware file if needed
-    if (SPIFFS.remove(FUOTA_FILE_NAME))
+    // Clean up the firmware file, the image is in the ota partition now
+    if (SPIFFS.remove(this->_file_name))
     {
         Serial.printf("[YMODEM FW] Firmware file removed.\n");
     }
 
+    restartAfterUpdate();
     return true;
 }
 
+bool YModem::writeBlock(const uint8_t *data, uint32_t len)
+{
+    if (YMODEM_FW_STAGED == this->_fw_mode)
+    {
+        if (!this->_file || (this->_file.write(data, len) != len))
+        {
+            return false;
+        }
+        // a staged patch is decoded here only for the digest, and again when it is copied
+        return !this->_is_patch || (FW_PATCH_SUCCESS == fw_patch_feed(&this->_patch, data, len));
+    }
+    if (this->_is_patch)
+    {
+        fw_patch_status_t status = fw_patch_feed(&this->_patch, data, len);
+        if (FW_PATCH_BASE_MISMATCH == status)
+        {
+            Serial.printf("[YMODEM RX] ERR: Patch is not made for the running firmware\n");
+        }
+        return FW_PATCH_SUCCESS == status;
+    }
+
+    switch (fw_resume_check_block(&this->_resume, data, len))
+    {
+    case FW_RESUME_SKIP:
+        // committed before the reset, the partition holds it already
+        return true;
+    case FW_RESUME_REWRITE:
+    {
+        // the sectors before it are kept, this one and the ones after it are written again
+        uint32_t offset;
+        uint32_t sector_len;
+        const uint8_t *sector = fw_resume_get_sector(&this->_resume, &offset, &sector_len);
+        Serial.printf("[YMODEM RX] Image differs from the interrupted one at %lu B, written again from there\n",
+                      (unsigned long)offset);
+        if (!this->_partition->resume(this->_initial_file_size, offset) || !this->_partition->write(sector, sector_len))
+        {
+            return false;
+        }
+        fw_resume_commit(&this->_resume, sector, sector_len);
+        return true;
+    }
+    case FW_RESUME_MISMATCH:
+        Serial.printf("[YMODEM RX] ERR: Image differs from the interrupted one, next transfer starts over\n");
+        fw_resume_finish(&this->_resume);
+        return false;
+    default:
+        break;
+    }
+
+    if (!this->_partition->write(data, len))
+    {
+        return false;
+    }
+    fw_resume_commit(&this->_resume, data, len);
+    return true;
+}
+
+bool YModem::writeDecoded(const uint8_t *data, uint32_t len)
+{
+    // a staged patch is decoded while received only for its digest
+    if ((YMODEM_FW_STREAM == this->_fw_mode) && !this->_partition->write(data, len))
+    {
+        return false;
+    }
+    fw_digest_update(&this->_digest, data, len);
+    return true;
+}
+
+bool YModem::readRunning(uint32_t offset, uint8_t *data, uint32_t len)
+{
+    return (NULL != this->_partition) && this->_partition->read_running(offset, data, len);
+}
+
+bool YModem::verifyDigest()
+{
+    switch (fw_digest_check(&this->_digest))
+    {
+    case FW_DIGEST_MATCH:
+        Serial.printf("[YMODEM FW] SHA-256 of the image verified.\n");
+        return true;
+    case FW_DIGEST_MISMATCH:
+        Serial.printf("[YMODEM FW] ERR: SHA-256 of the image does not match.\n");
+        return false;
+    default:
+#if YMODEM_REQUIRE_DIGEST
+        Serial.printf("[YMODEM FW] ERR: No SHA-256 to verify the image with.\n");
+        return false;
+#else
+        Serial.printf("[YMODEM FW] No SHA-256 to verify the image with, flashed unchecked.\n");
+        return true;
+#endif
+    }
+}
+
+bool YModem::finishUpdate()
+{
+    // the last decoded bytes of a patch complete the image and its digest
+    fw_patch_status_t patch_status = this->_is_patch ? fw_patch_finish(&this->_patch) : FW_PATCH_SUCCESS;
+    if (FW_PATCH_SUCCESS != patch_status)
+    {
+        Serial.printf("[YMODEM FW] ERR: Patch decoding failed (%d).\n", patch_status);
+    }
+    // the digest is complete with the last block, checking it costs nothing more than the final round
+    bool is_verified = (FW_PATCH_SUCCESS == patch_status) && verifyDigest();
+
+    if (YMODEM_FW_STAGED == this->_fw_mode)
+    {
+        if (!is_verified)
+        {
+            SPIFFS.remove(this->_file_name);
+            return false;
+        }
+        return update_esp32_firmware();
+    }
+
+    if (!is_verified)
+    {
+        // nor is the corrupt image resumed by the next transfer
+        this->_partition->abort();
+        fw_resume_finish(&this->_resume);
+        Serial.printf("[YMODEM FW] ERR: Streamed image rejected.\n");
+        return false;
+    }
+
+    Serial.printf("[YMODEM FW] Verifying streamed image (%lu bytes)...\n", (unsigned long)this->_partition->get_written());
+    bool is_valid = this->_partition->end();
+    // a rejected image is not resumed either
+    fw_resume_finish(&this->_resume);
+    if (!is_valid)
+    {
+        Serial.printf("[YMODEM FW] ERR: Streamed image rejected.\n");
+        return false;
+    }
+
+    restartAfterUpdate();
+    return true;
+}
+
+void YModem::restartAfterUpdate()
+{
+    Serial.printf("[YMODEM FW] Update successful. Rebooting in 5s...\n");
+    delay(5000);
+    ESP.restart();
+}
+
 /******************************************************************************
  * GLOBAL FUNCTIONS
  ******************************************************************************/
@@ -124,6 +325,7 @@ void YModem::sendACK()
     this->_timeout = millis();
     //Serial.printf("[YMODEM TX] ACK sent\n");
     uint8_t ack = ACK;
+    UART_CAPTURE(this->_capture_port, UART_CAPTURE_MCM_TX, &ack, 1);
     this->__ymodem_serial.write(&ack, 1);
 }
 
@@ -132,137 +334,330 @@ void YModem::sendNAK()
     this->_timeout = millis();
     Serial.printf("[YMODEM TX] NAK sent\n");
     uint8_t nak = NAK;
+    UART_CAPTURE(this->_capture_port, UART_CAPTURE_MCM_TX, &nak, 1);
     this->__ymodem_serial.write(&nak, 1);
 }
 
+void YModem::sendCAN()
+{
+    this->_timeout = millis();
+    Serial.printf("[YMODEM TX] CAN sent\n");
+    uint8_t can[2] = {CAN, CAN};
+    UART_CAPTURE(this->_capture_port, UART_CAPTURE_MCM_TX, can, sizeof(can));
+    this->__ymodem_serial.write(can, sizeof(can));
+}
+
 void YModem::sendCRCRequest()
 {
     this->_timeout = millis();
     Serial.printf("[YMODEM TX] CRC Request sent\n");
     uint8_t crc16 = CRC16;
+    UART_CAPTURE(this->_capture_port, UART_CAPTURE_MCM_TX, &crc16, 1);
     this->__ymodem_serial.write(&crc16, 1);
 }
 
-// Calculates the CRC for a given data buffer
-uint16_t YModem::calculateCRC(const uint8_t *data, uint16_t length)
+void YModem::receivePacket(uint8_t *buffer, uint16_t &size)
 {
-    uint16_t crc = 0;
-    for (uint16_t i = 0; i < length; i++)
+    if (this->_state == YMODEM_IDLE)
     {
-        crc ^= data[i] << 8;
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
-        }
+        // Idle state – no processing required.
+        return;
     }
-    return crc;
+    ymodem_rx_feed(&this->_rx, buffer, size, millis(), on_ymodem_rx_event, this);
 }
 
-void YModem::receivePacket(uint8_t *buffer, uint16_t &size)
+void YModem::handleHeader(const uint8_t *data, uint16_t len)
 {
-    // static variables to keep track of the file transfer progress
-    static int32_t fileSize = 0;
-    static int32_t initialFileSize = 0;
-    static File file;
-
-    switch (this->_state)
+    // header block: file name, a null, then the size in decimal
+    uint16_t name_len = 0;
+    while ((name_len < len) && (data[name_len] != '\0'))
     {
-    case YMODEM_IDLE:
-        // Idle state – no processing required.
-        break;
+        name_len++;
+    }
 
-    case WAIT_FOR_HEADER:
+    if (name_len == 0)
     {
-        if (buffer[0] == SOH || buffer[0] == STX)
+        // empty header ends the batch, the image received before it is flashed now
+        Serial.printf("[YMODEM RX] End of batch.\n");
+        sendACK();
+        if (this->_state == COMPLETE)
         {
-            this->_timeout = millis();
-            char fileName[128];
-            sscanf((char *)&buffer[2], "%127s", fileName);
-            sscanf((char *)&buffer[2 + strlen(fileName) + 1], "%lu", &fileSize);
-            initialFileSize = fileSize;
+            finishTransfer();
+        }
+        setState(YMODEM_IDLE);
+        return;
+    }
 
-            Serial.printf("[YMODEM RX] HDR: '%s' (%ld B)\n", fileName, fileSize);
+    if (this->_state == COMPLETE)
+    {
+        Serial.printf("[YMODEM RX] ERR: One file per batch, '%.*s' refused\n", (int)name_len, (const char *)data);
+        cancelTransfer();
+        return;
+    }
 
-            file = SPIFFS.open(FUOTA_FILE_NAME, FILE_WRITE, true);
-            if (!file)
-            {
-                Serial.printf("[YMODEM] ERR: Cannot open file for writing\n");
-                return;
-            }
-            memset(ymodem_buffer, 0, sizeof(ymodem_buffer));
-            ymodem_buffer_size = 0;
-            setState(RECEIVE_DATA);
-            sendACK();
-            delay(10);
-            sendCRCRequest();
+    int32_t file_size = 0;
+    for (uint16_t i = name_len + 1; (i < len) && (data[i] >= '0') && (data[i] <= '9'); i++)
+    {
+        file_size = (file_size * 10) + (data[i] - '0');
+    }
+    if ((name_len == len) || (file_size <= 0))
+    {
+        Serial.printf("[YMODEM RX] ERR: Invalid header\n");
+        cancelTransfer();
+        return;
+    }
+    this->_file_size = file_size;
+    this->_initial_file_size = this->_file_size;
+
+    Serial.printf("[YMODEM RX] HDR: '%.*s' (%ld B)\n", (int)name_len, (const char *)data, (long)this->_file_size);
+
+    // an expected digest may follow the size, otherwise the one appended to the image is used
+    this->_has_expected_digest = fw_digest_parse_header(&data[name_len + 1], len - name_len - 1, this->_expected_digest);
+
+    if (YMODEM_FW_STREAM == this->_fw_mode)
+    {
+        // blocks go straight into the inactive partition, nothing is staged,
+        // it is prepared with the first block which tells a patch from a plain image
+        if (NULL == this->_partition)
+        {
+            Serial.printf("[YMODEM] ERR: Cannot prepare the firmware partition\n");
+            cancelTransfer();
+            return;
         }
     }
-    break;
+    else
+    {
+        this->_file = SPIFFS.open(this->_file_name, FILE_WRITE, true);
+        if (!this->_file)
+        {
+            Serial.printf("[YMODEM] ERR: Cannot open file for writing\n");
+            cancelTransfer();
+            return;
+        }
+    }
+    setState(RECEIVE_DATA);
+    sendACK();
+    delay(10);
+    sendCRCRequest();
+}
+
+bool YModem::startImage(const uint8_t *data, uint32_t len)
+{
+    fw_patch_header_t header;
+    const uint8_t *expected = this->_has_expected_digest ? this->_expected_digest : NULL;
 
-    case RECEIVE_DATA:
+    this->_is_patch = fw_patch_read_header(data, len, &header);
+    if (this->_is_patch)
     {
-        if (buffer[0] == EOT)
+        Serial.printf("[YMODEM] %s image, %lu B once decoded\n", (0 != header.u32_base_size) ? "Delta" : "Compressed",
+                      (unsigned long)header.u32_image_size);
+        fw_digest_begin(&this->_digest, header.u32_image_size, expected);
+        fw_patch_init(&this->_patch, on_patch_read, on_patch_output, this);
+        if (YMODEM_FW_STAGED == this->_fw_mode)
         {
-            this->_timeout = millis();
-            Serial.printf("[YMODEM RX] EOT received. Finalizing...\n");
-            sendACK();
-            file.close();
-            Serial.printf("[YMODEM] FW update initiated.\n");
-            update_esp32_firmware();
-            setState(YMODEM_IDLE);
+            return true;
         }
-        else if (buffer[0] == SOH || buffer[0] == STX)
+        // the decoder state is not saved, a patch starts over after a reset
+        fw_resume_finish(&this->_resume);
+        if (!this->_partition->begin(header.u32_image_size))
         {
-            this->_timeout = millis();
-            uint16_t received_crc = (buffer[size - 2] << 8) | buffer[size - 1];
-            uint16_t calculated_crc = calculateCRC(buffer + 3, 1024);
+            Serial.printf("[YMODEM] ERR: Cannot prepare the firmware partition\n");
+            return false;
+        }
+        return true;
+    }
 
-            if (received_crc == calculated_crc)
-            {
-                uint32_t size_to_write = (fileSize > 1024) ? 1024 : fileSize;
-                if (file)
-                {
-                    file.write(buffer + 3, size_to_write);
-                }
-                fileSize -= size_to_write;
-                int progress = (int)(((initialFileSize - fileSize) * 100) / initialFileSize);
-                Serial.printf("File Transfer Progress:\t\t %d %% Completed \n",progress);
-                sendACK();
-            }
-            else
-            {
-                Serial.printf("[YMODEM RX] ERR: CRC mismatch (rec=0x%04X, calc=0x%04X)\n", received_crc, calculated_crc);
-                sendNAK();
-            }
+    fw_digest_begin(&this->_digest, this->_initial_file_size, expected);
+    if (YMODEM_FW_STAGED == this->_fw_mode)
+    {
+        return true;
+    }
+
+    uint32_t resume_offset = fw_resume_begin(&this->_resume, this->_image_version, this->_initial_file_size);
+    if ((0 != resume_offset) && !this->_partition->resume(this->_initial_file_size, resume_offset))
+    {
+        Serial.printf("[YMODEM] Committed part of the image is lost, starting over\n");
+        fw_resume_finish(&this->_resume);
+        resume_offset = fw_resume_begin(&this->_resume, this->_image_version, this->_initial_file_size);
+    }
+    if (0 != resume_offset)
+    {
+        // the sender starts from the first block again, the committed ones are only checked
+        Serial.printf("[YMODEM] Resuming after %lu B, re-sent blocks are not written again\n",
+                      (unsigned long)resume_offset);
+    }
+    else if (!this->_partition->begin(this->_initial_file_size))
+    {
+        Serial.printf("[YMODEM] ERR: Cannot prepare the firmware partition\n");
+        return false;
+    }
+    return true;
+}
+
+void YModem::handleRxEvent(ymodem_rx_event_t event, uint8_t block, const uint8_t *data, uint16_t len)
+{
+    this->_timeout = millis();
+
+    switch (event)
+    {
+    case YMODEM_RX_EVT_BLOCK:
+    {
+        this->_retries = 0;
+        if ((this->_state == WAIT_FOR_HEADER) || (this->_state == COMPLETE))
+        {
+            handleHeader(data, len);
+            break;
         }
+
+        uint32_t size_to_write = ((uint32_t)this->_file_size > len) ? len : this->_file_size;
+        bool is_first = (this->_file_size == this->_initial_file_size);
+        if ((is_first && !startImage(data, size_to_write)) || !writeBlock(data, size_to_write))
+        {
+            Serial.printf("[YMODEM RX] ERR: Firmware write failed, cancelling\n");
+            cancelTransfer();
+            break;
+        }
+        // skipped blocks of a resumed image are hashed as well, the digest covers the whole image,
+        // a patch hashes its decoded bytes instead
+        if (!this->_is_patch)
+        {
+            fw_digest_update(&this->_digest, data, size_to_write);
+        }
+        this->_file_size -= size_to_write;
+        int progress = (int)(((this->_initial_file_size - this->_file_size) * 100) / this->_initial_file_size);
+        Serial.printf("File Transfer Progress:\t\t %d %% Completed \n",progress);
+        sendACK();
     }
     break;
 
-    case WAIT_EOT:
-    {
-        if (buffer[0] == EOT)
+    case YMODEM_RX_EVT_DUPLICATE:
+        // our ack was lost and the sender repeats the block, it is written already
+        sendACK();
+        if (block == 0)
+        {
+            sendCRCRequest();
+        }
+        break;
+
+    case YMODEM_RX_EVT_RETRY:
+        if (++this->_retries > YMODEM_MAX_RETRIES)
+        {
+            Serial.printf("[YMODEM RX] ERR: Too many retries, cancelling\n");
+            cancelTransfer();
+        }
+        else
+        {
+            sendNAK();
+        }
+        break;
+
+    case YMODEM_RX_EVT_OUT_OF_SEQUENCE:
+        Serial.printf("[YMODEM RX] ERR: Block %d out of sequence, cancelling\n", block);
+        cancelTransfer();
+        break;
+
+    case YMODEM_RX_EVT_EOT:
+        if (this->_state != RECEIVE_DATA)
         {
-            Serial.printf("[YMODEM RX] EOT confirmed.\n");
             sendACK();
-            setState(YMODEM_IDLE);
+            // our ack was lost, the sender waits for the request of the header that ends the batch
+            if (this->_state == COMPLETE)
+            {
+                sendCRCRequest();
+            }
+            break;
         }
+        Serial.printf("[YMODEM RX] EOT received. Finalizing...\n");
+        sendACK();
+        if (YMODEM_FW_STAGED == this->_fw_mode)
+        {
+            this->_file.close();
+        }
+        // the sender ends the batch with an empty header, it is acked before the update restarts the esp32
+        setState(COMPLETE);
+        sendCRCRequest();
+        break;
+
+    case YMODEM_RX_EVT_CANCEL:
+        Serial.printf("[YMODEM RX] Transfer cancelled by the sender.\n");
+        cancelTransfer();
+        break;
     }
-    break;
+}
+
+void YModem::finishTransfer()
+{
+    Serial.printf("[YMODEM] FW update initiated.\n");
+    finishUpdate();
+}
 
-    case COMPLETE:
-        Serial.printf("[YMODEM] Transfer complete. Resetting.\n");
+void YModem::cancelTransfer()
+{
+    if (this->_state == COMPLETE)
+    {
+        // the image is whole, only the end of the batch is missing
+        sendCAN();
+        finishTransfer();
         setState(YMODEM_IDLE);
-        break;
+        return;
+    }
+
+    // a partly written image must never become the boot one,
+    // its committed part stays in the partition for the next transfer to resume
+    if ((YMODEM_FW_STREAM == this->_fw_mode) && (NULL != this->_partition))
+    {
+        this->_partition->abort();
+    }
+    else if (YMODEM_FW_STAGED == this->_fw_mode)
+    {
+        this->_file.close();
     }
+    sendCAN();
+    setState(YMODEM_IDLE);
 }
 
 void YModem::setState(ymodem_state_t state)
 {
-    const char* stateNames[] = {"Idle", "Header", "Data", "Wait EOT", "Complete"};
-    //Serial.printf("[YMODEM] State changed to: %s\n", stateNames[state]);
+    if ((state == WAIT_FOR_HEADER) || (state == COMPLETE))
+    {
+        // header is block 0, data blocks follow from 1, the header that ends the batch is block 0 again
+        ymodem_rx_init(&this->_rx, 0);
+        this->_retries = 0;
+    }
     this->_state = state;
 }
 
+void YModem::setFileName(const char *file_name)
+{
+    strncpy(this->_file_name, file_name, sizeof(this->_file_name) - 1);
+    this->_file_name[sizeof(this->_file_name) - 1] = '\0';
+}
+
+void YModem::setFirmwareMode(ymodem_fw_mode_t mode)
+{
+    this->_fw_mode = mode;
+}
+
+void YModem::setPartition(FwPartition *partition)
+{
+    this->_partition = partition;
+}
+
+void YModem::setProgressStorage(fw_resume_load_cb load_cb, fw_resume_save_cb save_cb, void *user_context)
+{
+    fw_resume_init(&this->_resume, load_cb, save_cb, user_context);
+}
+
+void YModem::setImageVersion(uint32_t version)
+{
+    this->_image_version = version;
+}
+
+void YModem::setCapturePort(uint8_t port)
+{
+    this->_capture_port = port;
+}
+
 ymodem_state_t YModem::getState()
 {
     // Optionally, you can add a user-friendly log here if needed.
@@ -273,10 +668,16 @@ void YModem::process_timeout()
 {
     if (this->_state == YMODEM_IDLE)
         return;
-    
+
+    // NAK after a bad or stalled packet
+    ymodem_rx_poll(&this->_rx, millis(), on_ymodem_rx_event, this);
+    if (this->_state == YMODEM_IDLE)
+        return;
+
     if ((millis() - this->_timeout) > YMODEM_TIMEOUT)
     {
-        Serial.printf("[YMODEM] Timeout (%lu ms elapsed) in state %d. Resetting.\n", millis() - this->_timeout, this->_state);
-        setState(YMODEM_IDLE);
+        Serial.printf("[YMODEM] Timeout (%lu ms elapsed) in state %s. Resetting.\n", millis() - this->_timeout,
+                      ymodem_state_names[this->_state.load()]);
+        cancelTransfer();
     }
 }
\ No newline at end of file
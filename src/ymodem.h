@@ -15,21 +15,34 @@
  * INCLUDES
  **********************************************************************************************************/
 #include <stdint.h>
+// mcm_rover.h includes this header inside extern "C"
+extern "C++" {
+#include <atomic>
+}
 #include <Arduino.h>
+#include <FS.h>
+#include "fw_digest.h"
+#include "fw_partition.h"
+#include "fw_patch.h"
+#include "fw_resume.h"
+#include "ymodem_rx.h"
 
 /**********************************************************************************************************
  * MACROS AND DEFINES
  **********************************************************************************************************/
 
-#define SOH 0x01   // Start of 128-byte data packet
-#define STX 0x02   // Start of 1024-byte data packet
-#define EOT 0x04   // End of transmission
-#define ACK 0x06   // Acknowledge
-#define NAK 0x15   // Negative Acknowledge
-#define CRC16 0x43 // 'C' byte to request CRC16
-
 #define YMODEM_TIMEOUT (30*1000)
 
+#define YMODEM_DEFAULT_FILE_NAME "/fota.bin"
+#define YMODEM_FILE_NAME_SIZE 32
+
+#define YMODEM_MAX_RETRIES 10 // consecutive NAKs before the transfer is cancelled
+
+// an image without a sha-256 in the header or appended to it is rejected, -DYMODEM_REQUIRE_DIGEST=0 flashes it unchecked
+#ifndef YMODEM_REQUIRE_DIGEST
+#define YMODEM_REQUIRE_DIGEST 1
+#endif
+
 /**********************************************************************************************************
  * TYPEDEFS
  **********************************************************************************************************/
@@ -42,34 +55,91 @@ typedef enum
     RECEIVE_DATA,
     WAIT_EOT,
     UPDATE_ESP32,
-    COMPLETE
+    COMPLETE            // image received, waiting for the empty header that ends the batch
 } ymodem_state_t;
 
+typedef enum
+{
+    YMODEM_FW_STREAM, // blocks are written into the firmware partition as they arrive
+    YMODEM_FW_STAGED  // image is kept in a file first and copied when complete
+} ymodem_fw_mode_t;
+
 
 
 class YModem
 {
 public:
     // Add constructor to initialize the reference
-    YModem(HardwareSerial& serial) : __ymodem_serial(serial) {}
+    YModem(HardwareSerial& serial) : __ymodem_serial(serial)
+    {
+        setFileName(YMODEM_DEFAULT_FILE_NAME);
+        fw_resume_init(&this->_resume, NULL, NULL, NULL);
+    }
 
     void setState(ymodem_state_t state);
+    // each modem needs its own file when several transfers run at once
+    void setFileName(const char *file_name);
+    // staged mode needs space for the image in the file system and a second pass
+    void setFirmwareMode(ymodem_fw_mode_t mode);
+    // destination of the streamed image, the inactive ota partition by default
+    void setPartition(FwPartition *partition);
+    // storage of the progress record, a streamed image resumes after a reset when it is set
+    void setProgressStorage(fw_resume_load_cb load_cb, fw_resume_save_cb save_cb, void *user_context);
+    // version of the image the modem is about to send, see FW_RESUME_VERSION()
+    void setImageVersion(uint32_t version);
+    // port of the uart capture records of the modem
+    void setCapturePort(uint8_t port);
 
+    // bytes can be split or merged at any boundary
     void receivePacket(uint8_t *buffer, uint16_t &size);
+    void handleRxEvent(ymodem_rx_event_t event, uint8_t block, const uint8_t *data, uint16_t len);
+    // decoded bytes of a compressed or delta image
+    bool writeDecoded(const uint8_t *data, uint32_t len);
+    bool readRunning(uint32_t offset, uint8_t *data, uint32_t len);
     ymodem_state_t getState();
     void sendCRCRequest();
     bool update_esp32_firmware();
     void process_timeout();
     
 private:
-    ymodem_state_t _state = YMODEM_IDLE;
+    std::atomic<ymodem_state_t> _state{YMODEM_IDLE};   // read by the rx task of the mcm
     HardwareSerial& __ymodem_serial;
+    uint8_t _capture_port = 0;
     uint64_t _timeout;
+    // transfer in progress
+    int32_t _file_size = 0;
+    int32_t _initial_file_size = 0;
+    File _file;
+    char _file_name[YMODEM_FILE_NAME_SIZE];
+    ymodem_fw_mode_t _fw_mode = YMODEM_FW_STREAM;
+#ifdef ARDUINO
+    OtaFwPartition _ota_partition;
+    FwPartition *_partition = &_ota_partition;
+#else
+    FwPartition *_partition = NULL;
+#endif
+    ymodem_rx_t _rx;
+    fw_resume_t _resume;
+    fw_digest_t _digest;
+    uint8_t _expected_digest[SHA256_DIGEST_SIZE];
+    bool _has_expected_digest = false;
+    // the image is sent as a patch, decoded as it is received
+    fw_patch_t _patch;
+    bool _is_patch = false;
+    uint32_t _image_version = 0;
+    uint8_t _retries = 0;
+    void handleHeader(const uint8_t *data, uint16_t len);
+    bool startImage(const uint8_t *data, uint32_t len);
+    void cancelTransfer();
+    void finishTransfer();
+    bool writeBlock(const uint8_t *data, uint32_t len);
+    size_t copyPatch(File &file);
+    bool verifyDigest();
+    bool finishUpdate();
+    void restartAfterUpdate();
     void sendACK();
     void sendNAK();
-
-    // Calculates the CRC for a given data buffer
-    uint16_t calculateCRC(const uint8_t *data, uint16_t length);
+    void sendCAN();
 };
 
 /**********************************************************************************************************
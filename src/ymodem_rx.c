@@ -0,0 +1,266 @@
+/**
+ * @file ymodem_rx.c
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Incremental receiver of the ymodem packets, independent of how the uart splits them.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "ymodem_rx.h"
+#include "checksum.h"
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ * EXTERN VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE MACROS AND DEFINES
+ ******************************************************************************/
+#define YMODEM_RX_CAN_TO_CANCEL     2   // a single CAN may be line noise
+
+/******************************************************************************
+ * PRIVATE TYPEDEFS
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ******************************************************************************/
+
+/******************************************************************************
+ * STATIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void ymodem_rx_check_packet(ymodem_rx_t *p_rx, ymodem_rx_cb event_cb, void *user_context);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Validates the complete packet in the buffer and raises its event
+ */
+static void ymodem_rx_check_packet(ymodem_rx_t *p_rx, ymodem_rx_cb event_cb, void *user_context)
+{
+    uint8_t u8_block = p_rx->u8_buffer[1];
+    uint8_t u8_block_complement = 0xFF - u8_block;
+    uint16_t u16_data_len = p_rx->u16_packet_len - YMODEM_PACKET_OVERHEAD;
+    uint16_t u16_received_crc = (p_rx->u8_buffer[3 + u16_data_len] << 8) | p_rx->u8_buffer[4 + u16_data_len];
+
+    // buffer is free for the next packet, the callback still sees this one
+    p_rx->u16_index = 0;
+
+    if ((p_rx->u8_buffer[2] != u8_block_complement) ||
+        (u16_received_crc != checksum_crc16_update(CHECKSUM_CRC16_INIT, &p_rx->u8_buffer[3], u16_data_len)))
+    {
+        p_rx->u32_bad_packets++;
+        p_rx->b_purging = true;
+        return;
+    }
+
+    if (u8_block == p_rx->u8_next_block)
+    {
+        p_rx->u8_next_block++;
+        p_rx->u32_blocks++;
+        event_cb(YMODEM_RX_EVT_BLOCK, u8_block, &p_rx->u8_buffer[3], u16_data_len, user_context);
+    }
+    else if (u8_block == (uint8_t)(p_rx->u8_next_block - 1))
+    {
+        p_rx->u32_duplicates++;
+        event_cb(YMODEM_RX_EVT_DUPLICATE, u8_block, &p_rx->u8_buffer[3], u16_data_len, user_context);
+    }
+    else
+    {
+        event_cb(YMODEM_RX_EVT_OUT_OF_SEQUENCE, u8_block, NULL, 0, user_context);
+    }
+}
+
+/******************************************************************************
+ * GLOBAL FUNCTIONS
+ ******************************************************************************/
+ymodem_rx_status_t ymodem_rx_init(ymodem_rx_t *p_rx, uint8_t u8_first_block)
+{
+    if (NULL == p_rx)
+    {
+        return YMODEM_RX_INVALID_PARAMETERS;
+    }
+
+    memset(p_rx, 0, sizeof(ymodem_rx_t));
+    p_rx->u8_next_block = u8_first_block;
+
+    return YMODEM_RX_SUCCESS;
+}
+
+ymodem_rx_status_t ymodem_rx_feed(ymodem_rx_t *p_rx, const uint8_t *p_data, uint16_t u16_len, uint32_t u32_now_ms,
+                                  ymodem_rx_cb event_cb, void *user_context)
+{
+    ymodem_rx_status_t return_status = YMODEM_RX_INVALID_PARAMETERS;
+
+    do
+    {
+        if ((NULL == p_rx) || (NULL == p_data) || (NULL == event_cb))
+        {
+            break;
+        }
+
+        if (u16_len > 0)
+        {
+            p_rx->u32_last_byte_ms = u32_now_ms;
+        }
+
+        uint16_t u16_pos = 0;
+        while (u16_pos < u16_len)
+        {
+            if (p_rx->b_purging)
+            {
+                p_rx->u32_dropped_bytes += (u16_len - u16_pos);
+                break;
+            }
+
+            if (0 == p_rx->u16_index)
+            {
+                uint8_t u8_byte = p_data[u16_pos++];
+
+                if (CAN != u8_byte)
+                {
+                    p_rx->u8_can_count = 0;
+                }
+
+                switch (u8_byte)
+                {
+                case SOH:
+                    p_rx->u16_packet_len = YMODEM_BLOCK_SIZE_SOH + YMODEM_PACKET_OVERHEAD;
+                    p_rx->u8_buffer[p_rx->u16_index++] = u8_byte;
+                    break;
+                case STX:
+                    p_rx->u16_packet_len = YMODEM_BLOCK_SIZE_STX + YMODEM_PACKET_OVERHEAD;
+                    p_rx->u8_buffer[p_rx->u16_index++] = u8_byte;
+                    break;
+                case EOT:
+                    event_cb(YMODEM_RX_EVT_EOT, 0, NULL, 0, user_context);
+                    break;
+                case CAN:
+                    if (++p_rx->u8_can_count >= YMODEM_RX_CAN_TO_CANCEL)
+                    {
+                        p_rx->u8_can_count = 0;
+                        event_cb(YMODEM_RX_EVT_CANCEL, 0, NULL, 0, user_context);
+                    }
+                    break;
+                default:
+                    // not the start of a packet, e.g. the rest of a packet we already gave up
+                    p_rx->u32_dropped_bytes++;
+                    break;
+                }
+                continue;
+            }
+
+            // copy as much of the packet as this read has
+            uint16_t u16_copy = p_rx->u16_packet_len - p_rx->u16_index;
+            if (u16_copy > (u16_len - u16_pos))
+            {
+                u16_copy = u16_len - u16_pos;
+            }
+            memcpy(&p_rx->u8_buffer[p_rx->u16_index], &p_data[u16_pos], u16_copy);
+            p_rx->u16_index += u16_copy;
+            u16_pos += u16_copy;
+
+            if (p_rx->u16_index == p_rx->u16_packet_len)
+            {
+                ymodem_rx_check_packet(p_rx, event_cb, user_context);
+            }
+        }
+
+        return_status = YMODEM_RX_SUCCESS;
+    } while (0);
+
+    return return_status;
+}
+
+ymodem_rx_status_t ymodem_rx_poll(ymodem_rx_t *p_rx, uint32_t u32_now_ms, ymodem_rx_cb event_cb, void *user_context)
+{
+    ymodem_rx_status_t return_status = YMODEM_RX_INVALID_PARAMETERS;
+
+    do
+    {
+        if ((NULL == p_rx) || (NULL == event_cb))
+        {
+            break;
+        }
+
+        uint32_t u32_idle_ms = u32_now_ms - p_rx->u32_last_byte_ms;
+
+        if (p_rx->b_purging && (u32_idle_ms >= YMODEM_RX_PURGE_MS))
+        {
+            p_rx->b_purging = false;
+            event_cb(YMODEM_RX_EVT_RETRY, 0, NULL, 0, user_context);
+        }
+        else if ((0 != p_rx->u16_index) && (u32_idle_ms >= YMODEM_RX_PACKET_TIMEOUT_MS))
+        {
+            p_rx->u32_timeouts++;
+            p_rx->u16_index = 0;
+            event_cb(YMODEM_RX_EVT_RETRY, 0, NULL, 0, user_context);
+        }
+
+        return_status = YMODEM_RX_SUCCESS;
+    } while (0);
+
+    return return_status;
+}
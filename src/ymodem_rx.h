@@ -0,0 +1,212 @@
+/**
+ * @file ymodem_rx.h
+ * @author Ankit Bansal (ankit.bansal@oxit.com)
+ * @brief Header file for the incremental receiver of the ymodem packets.
+ * @version 0.1
+ * @date 2024-12-06
+ * 
+* @copyright Copyright (c) 2024
+ * Confidentiality and Proprietary Rights Statement
+ * The sample, Code and Hardware, provided at no cost to the customer,
+ * contains confidential and proprietary information belonging exclusively
+ * to Oxit LLC. All contents, including but not limited to concepts, ideas,
+ * designs, methodologies, processes, technologies, and intellectual property,
+ * are the sole property of Oxit LLC and are provided for evaluation purposes
+ * only.
+ *
+ * Oxit LLC does not grant any intellectual property rights or permit any
+ * other usage of the sample hardware and code beyond evaluation.
+ *
+ * Unauthorized use, disclosure, distribution, copying, or any form of
+ * dissemination of the information contained in this sample is strictly
+ * prohibited and may result in legal action.
+ *
+ * The recipient of this sample agrees to maintain the information's
+ * confidentiality and use it only for the purposes explicitly permitted under
+ * this agreement.
+ *
+ * Any exceptions to the proprietary rights and ownership as stated herein must
+ * be explicitly acknowledged and agreed upon in writing by Oxit LLC.
+ * Failure to comply with these terms may result in immediate termination of any
+ * agreements and potential legal consequences.
+ *
+ * By accessing this sample, you acknowledge and agree to these terms:
+ *
+ * 1. Limited Use: You may use this Code and Hardware solely to evaluate the
+ *    hardware specified by Oxit, LLC in a non-production environment.
+ *    Any other use is strictly prohibited.
+ *
+ * 2. No Rights Granted: This Code and Hardware does not convey any rights,
+ *    licenses, or permissions beyond limited evaluation use. Oxit, LLC
+ *    retains all intellectual property rights in the Code and Hardware.
+ *
+ * 3. No Commercial Use: You do not have any rights to use this Code and
+ *    Hardware for commercial purposes, incorporate it into any product or
+ *    service, or otherwise exploit it commercially.
+ *
+ * 4. No Distribution: You may not distribute, share, sublicense, or transfer
+ *    this Code and Hardware to any third parties without express written
+ *    consent from Oxit, LLC.
+ *
+ * 5. Confidentiality: You agree to keep this Code and Hardware confidential
+ *    and not disclose it to unauthorized parties.
+ *
+ * 6. No Warranty: This Code and Hardware is provided "AS IS" without any
+ *    warranties, express or implied.
+ *
+ * 7. Termination: Your right to use this Code and Hardware terminates
+ *    automatically if you breach any of these terms or upon request from
+ *    Oxit, LLC.
+ *
+ * If you do not agree to these terms, you must immediately cease any use of
+ * this Code and Hardware and return all copies to Oxit, LLC.
+ */
+
+
+#ifndef __YMODEM_RX_H__
+#define __YMODEM_RX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************
+ * MACROS AND DEFINES
+ **********************************************************************************************************/
+#define SOH 0x01   // Start of 128-byte data packet
+#define STX 0x02   // Start of 1024-byte data packet
+#define EOT 0x04   // End of transmission
+#define ACK 0x06   // Acknowledge
+#define NAK 0x15   // Negative Acknowledge
+#define CAN 0x18   // Cancel the transfer
+#define CRC16 0x43 // 'C' byte to request CRC16
+
+#define YMODEM_BLOCK_SIZE_SOH 128
+#define YMODEM_BLOCK_SIZE_STX 1024
+#define YMODEM_PACKET_OVERHEAD 5 // start, block number, its complement and the crc
+#define YMODEM_PACKET_MAX_SIZE (YMODEM_BLOCK_SIZE_STX + YMODEM_PACKET_OVERHEAD)
+
+/**
+ * @brief Partial packet is dropped when no byte comes for this long
+ */
+#define YMODEM_RX_PACKET_TIMEOUT_MS 1000
+
+/**
+ * @brief After a bad packet bytes are dropped until the line is idle for this long,
+ *        so the rest of the bad packet is not taken as the start of the next one
+ */
+#define YMODEM_RX_PURGE_MS 100
+
+/**********************************************************************************************************
+ * TYPEDEFS
+ **********************************************************************************************************/
+typedef enum
+{
+    YMODEM_RX_SUCCESS = 0,
+    YMODEM_RX_INVALID_PARAMETERS
+} ymodem_rx_status_t;
+
+typedef enum
+{
+    YMODEM_RX_EVT_BLOCK,            // next block in sequence, answer ACK
+    YMODEM_RX_EVT_DUPLICATE,        // block received again as the ACK was lost, answer ACK without using it
+    YMODEM_RX_EVT_RETRY,            // bad or incomplete packet is dropped, answer NAK
+    YMODEM_RX_EVT_OUT_OF_SEQUENCE,  // block number skipped, the transfer can not continue
+    YMODEM_RX_EVT_EOT,              // sender has no more data
+    YMODEM_RX_EVT_CANCEL            // sender cancelled the transfer
+} ymodem_rx_event_t;
+
+/**
+ * @brief Callback invoked for every event of the receiver
+ *
+ * The block data is owned by the receiver and is only valid for the duration of
+ * the callback. u8_block, p_data and u16_len are only set for the block events.
+ */
+typedef void (*ymodem_rx_cb)(ymodem_rx_event_t event, uint8_t u8_block, const uint8_t *p_data, uint16_t u16_len, void *user_context);
+
+/**
+ * @brief State of the incremental ymodem receiver
+ *
+ * Bytes can be fed at any boundary, a packet can be split over many reads or a
+ * read can hold the end of one packet and the start of the next.
+ * Private members need not to be accessed directly.
+ */
+typedef struct
+{
+    uint8_t u8_buffer[YMODEM_PACKET_MAX_SIZE];  // partially received packet
+    uint16_t u16_index;                         // number of bytes present in the buffer
+    uint16_t u16_packet_len;                    // length of the packet being received
+    uint8_t u8_next_block;                      // block number expected next
+    uint8_t u8_can_count;                       // consecutive CAN bytes
+    bool b_purging;                             // bytes are dropped until the line is idle
+    uint32_t u32_last_byte_ms;                  // time of the last byte fed
+    uint32_t u32_blocks;                        // number of blocks received in sequence
+    uint32_t u32_duplicates;                    // number of blocks received again
+    uint32_t u32_bad_packets;                   // number of packets with invalid crc or block number complement
+    uint32_t u32_timeouts;                      // number of partial packets dropped after the packet timeout
+    uint32_t u32_dropped_bytes;                 // number of bytes outside a packet
+} ymodem_rx_t;
+
+/**********************************************************************************************************
+ * EXPORTED VARIABLES
+ **********************************************************************************************************/
+
+/**********************************************************************************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ **********************************************************************************************************/
+/**
+ * @brief Initializes the receiver for a new transfer
+ *
+ * @param[out] p_rx Pointer to the receiver state
+ * @param[in] u8_first_block Block number expected first, 0 for the ymodem header block
+ *
+ * @retval YMODEM_RX_SUCCESS The receiver is initialized
+ * @retval YMODEM_RX_INVALID_PARAMETERS Invalid receiver pointer
+ */
+ymodem_rx_status_t ymodem_rx_init(ymodem_rx_t *p_rx, uint8_t u8_first_block);
+
+/**
+ * @brief Feeds received bytes to the receiver
+ *
+ * Every complete packet is checked for its block number complement and its CRC.
+ * A bad packet is dropped together with the bytes following it, the retry event
+ * comes from ymodem_rx_poll() once the line is idle.
+ *
+ * @param[in,out] p_rx Pointer to the receiver state
+ * @param[in] p_data Pointer to the received bytes
+ * @param[in] u16_len Number of received bytes
+ * @param[in] u32_now_ms Current time in milliseconds
+ * @param[in] event_cb Callback invoked for every event
+ * @param[in] user_context User context passed to the callback
+ *
+ * @retval YMODEM_RX_SUCCESS All bytes are consumed
+ * @retval YMODEM_RX_INVALID_PARAMETERS Invalid receiver, data pointer or callback
+ */
+ymodem_rx_status_t ymodem_rx_feed(ymodem_rx_t *p_rx, const uint8_t *p_data, uint16_t u16_len, uint32_t u32_now_ms,
+                                  ymodem_rx_cb event_cb, void *user_context);
+
+/**
+ * @brief Checks the timeouts of the receiver, call it periodically while a transfer runs
+ *
+ * Raises the retry event when a purge ends or when a partial packet stops coming.
+ *
+ * @param[in,out] p_rx Pointer to the receiver state
+ * @param[in] u32_now_ms Current time in milliseconds
+ * @param[in] event_cb Callback invoked for every event
+ * @param[in] user_context User context passed to the callback
+ *
+ * @retval YMODEM_RX_SUCCESS Timeouts are checked
+ * @retval YMODEM_RX_INVALID_PARAMETERS Invalid receiver pointer or callback
+ */
+ymodem_rx_status_t ymodem_rx_poll(ymodem_rx_t *p_rx, uint32_t u32_now_ms, ymodem_rx_cb event_cb, void *user_context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __YMODEM_RX_H__